@@ -0,0 +1,243 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_AUGMENTED_INDEX_HPP
+#define BOOST_MULTI_INDEX_AUGMENTED_INDEX_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/augmented_index_fwd.hpp>
+#include <boost/multi_index/detail/aug_index_ops.hpp>
+#include <boost/multi_index/detail/ord_index_impl.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* augmented_index keeps, for each node, a user-provided summary of its
+ * element and of its whole subtree, so that the summary of any range
+ * can be calculated in logarithmic time.
+ */
+
+template<typename OrderedIndexNodeImpl,typename Summary>
+struct summary_node:OrderedIndexNodeImpl
+{
+  typedef typename Summary::result_type summary_type;
+
+  /* nodes are not constructed as such, hence the requirement below */
+
+  BOOST_STATIC_ASSERT((has_trivial_destructor<summary_type>::value));
+
+  summary_type element_summary;
+  summary_type summary;
+};
+
+template<typename OrderedIndexImpl,typename Summary>
+class augmented_index:public OrderedIndexImpl
+{
+  typedef          OrderedIndexImpl         super;
+
+protected:
+  typedef typename super::index_node_type   index_node_type;
+  typedef typename super::node_impl_pointer node_impl_pointer;
+
+public:
+  typedef typename super::ctor_args_list    ctor_args_list;
+  typedef typename super::allocator_type    allocator_type;
+  typedef typename super::iterator          iterator;
+  typedef Summary                           summary_function;
+  typedef typename Summary::result_type     summary_type;
+
+  /* summary operations */
+
+  summary_type aggregate()const
+  {
+    return augmented_node_summary(
+      node_impl_pointer(this->header()->parent()),summary_function());
+  }
+
+  summary_type aggregate(iterator first,iterator last)const
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(first);
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(last);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(first,*this);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(last,*this);
+    BOOST_MULTI_INDEX_CHECK_VALID_RANGE(first,last);
+
+    return augmented_index_aggregate(
+      first.get_node()->impl(),last.get_node()->impl(),
+      this->header()->impl(),summary_function());
+  }
+
+protected:
+  augmented_index(const augmented_index& x):super(x){};
+
+  augmented_index(const augmented_index& x,do_not_copy_elements_tag):
+    super(x,do_not_copy_elements_tag()){};
+
+  augmented_index(
+    const ctor_args_list& args_list,const allocator_type& al):
+    super(args_list,al){}
+};
+
+/* augmenting policy for ordered_index */
+
+template<typename Summary>
+struct summary_policy
+{
+  template<typename OrderedIndexNodeImpl>
+  struct augmented_node
+  {
+    typedef summary_node<OrderedIndexNodeImpl,Summary> type;
+  };
+
+  template<typename OrderedIndexImpl>
+  struct augmented_interface
+  {
+    typedef augmented_index<OrderedIndexImpl,Summary> type;
+  };
+
+  /* algorithmic stuff */
+
+  template<typename Pointer>
+  static void add(Pointer x,Pointer root)
+  {
+    update(x,root);
+  }
+
+  /* rebalance_for_extract takes care of recalculating the summaries */
+
+  template<typename Pointer>
+  static void remove(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void copy(Pointer x,Pointer y)
+  {
+    y->summary=x->summary;
+  }
+
+  template<typename Pointer>
+  static void rotate_left(Pointer x,Pointer y) /* in: x==y->left() */
+  {
+    y->summary=x->summary;
+    build(x);
+  }
+
+  template<typename Pointer>
+  static void rotate_right(Pointer x,Pointer y) /* in: x==y->right() */
+  {
+    rotate_left(x,y);
+  }
+
+  template<typename Pointer>
+  static void build(Pointer x) /* in: subtrees of x already built */
+  {
+    Summary s;
+    x->summary=s(
+      s(augmented_node_summary(x->left(),s),x->element_summary),
+      augmented_node_summary(x->right(),s));
+  }
+
+  template<typename Pointer>
+  static void update(Pointer x,Pointer root)
+  {
+    for(;;){
+      build(x);
+      if(x==root)break;
+      x=x->parent();
+    }
+  }
+
+  template<typename Pointer,typename Value,typename KeyFromValue>
+  static void assign(Pointer x,const Value& v,const KeyFromValue&)
+  {
+    x->element_summary=Summary()(v);
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  /* invariant stuff */
+
+  template<typename Pointer>
+  static bool invariant(Pointer x)
+  {
+    Summary s;
+    return x->summary==s(
+      s(augmented_node_summary(x->left(),s),x->element_summary),
+      augmented_node_summary(x->right(),s));
+  }
+#endif
+};
+
+} /* namespace multi_index::detail */
+
+/* augmented_index specifiers */
+
+template<typename Summary,typename Arg1,typename Arg2,typename Arg3>
+struct augmented_unique
+{
+  typedef typename detail::ordered_index_args<
+    Arg1,Arg2,Arg3>                                index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::compare_type        compare_type;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_index_node<
+      detail::summary_policy<Summary>,Super>       type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type,detail::ordered_unique_tag,
+      detail::summary_policy<Summary> >            type;
+  };
+};
+
+template<typename Summary,typename Arg1,typename Arg2,typename Arg3>
+struct augmented_non_unique
+{
+  typedef detail::ordered_index_args<
+    Arg1,Arg2,Arg3>                                index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::compare_type        compare_type;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_index_node<
+      detail::summary_policy<Summary>,Super>       type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type,detail::ordered_non_unique_tag,
+      detail::summary_policy<Summary> >            type;
+  };
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
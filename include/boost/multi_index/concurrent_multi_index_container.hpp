@@ -0,0 +1,659 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_CONCURRENT_MULTI_INDEX_CONTAINER_HPP
+#define BOOST_MULTI_INDEX_CONCURRENT_MULTI_INDEX_CONTAINER_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <atomic>
+#include <boost/core/addressof.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/mpl/size.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/auto_space.hpp>
+#include <boost/multi_index/detail/bucket_array.hpp>
+#include <boost/multi_index/detail/concurrent_hash_layer.hpp>
+#include <boost/multi_index/detail/parallel_run.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/indexed_by.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Lock stripe: the mutex protecting a range of buckets of one index and,
+ * for the first index, the number of elements in those buckets. Stripes
+ * are padded so that adjacent ones do not share a cache line.
+ */
+
+struct concurrent_hash_stripe
+{
+  concurrent_hash_stripe():count(0){}
+
+  std::mutex               mutex;
+  std::atomic<std::size_t> count;
+  char                     pad[64];
+};
+
+/* RAII holder of up to N stripe locks */
+
+template<std::size_t N>
+class concurrent_hash_lock_set:private noncopyable
+{
+public:
+  concurrent_hash_lock_set():n(0){}
+  ~concurrent_hash_lock_set(){unlock();}
+
+  void lock(std::mutex& m)
+  {
+    m.lock();
+    locked[n++]=&m;
+  }
+
+  bool try_lock(std::mutex& m)
+  {
+    if(!m.try_lock())return false;
+    locked[n++]=&m;
+    return true;
+  }
+
+  void unlock()
+  {
+    while(n)locked[--n]->unlock();
+  }
+
+private:
+  std::mutex* locked[N];
+  std::size_t n;
+};
+
+} /* namespace multi_index::detail */
+
+/* concurrent_multi_index_container is a variant of multi_index_container
+ * for indices which are all hashed, safe for concurrent use by multiple
+ * threads. Each index divides its buckets into contiguous ranges guarded by
+ * a stripe lock: an operation locks the stripes of the buckets it touches,
+ * one per index at most, always in increasing index order. Growing the
+ * bucket arrays takes the resize mutex and then every stripe lock; as
+ * stripes are located from the current bucket count without any lock,
+ * operations check after locking that the bucket count has not changed in
+ * the meantime, and retry otherwise.
+ * Elements are not exposed through iterators: lookup is done by visitation
+ * of the elements with a given key under the lock of their bucket.
+ */
+
+template<
+  typename Value,typename IndexSpecifierList,
+  typename Allocator=std::allocator<Value> >
+class concurrent_multi_index_container:private noncopyable
+{
+  BOOST_STATIC_CONSTANT(
+    std::size_t,num_indices=mpl::size<IndexSpecifierList>::value);
+  BOOST_STATIC_ASSERT(num_indices>0);
+
+  typedef detail::concurrent_hash_node<Value,num_indices> node_type;
+  typedef detail::concurrent_hash_layer<
+    node_type,IndexSpecifierList,0>                       layers_type;
+  typedef typename detail::rebind_alloc_for<
+    Allocator,node_type
+  >::type                                                 node_allocator;
+  typedef detail::allocator_traits<node_allocator>        node_alloc_traits;
+  typedef typename node_alloc_traits::pointer             node_pointer;
+  typedef detail::auto_space<node_type*,Allocator>        bucket_space;
+  typedef detail::concurrent_hash_stripe                  stripe_type;
+  typedef detail::concurrent_hash_lock_set<num_indices>   lock_set;
+
+  template<int N>
+  struct layer
+  {
+    typedef detail::concurrent_hash_layer<
+      node_type,IndexSpecifierList,N>                     type;
+  };
+
+  class bucket_policy:private detail::bucket_array_base<>
+  {
+    typedef detail::bucket_array_base<> super;
+
+  public:
+    static std::size_t size_index(std::size_t n){return super::size_index(n);}
+    static std::size_t size(std::size_t i){return super::size(i);}
+    static std::size_t position(std::size_t h,std::size_t i)
+    {
+      return super::position(h,i);
+    }
+  };
+
+public:
+  typedef Value                                  value_type;
+  typedef IndexSpecifierList                     index_specifier_type_list;
+  typedef Allocator                              allocator_type;
+  typedef std::size_t                            size_type;
+
+  explicit concurrent_multi_index_container(
+    size_type n=0,std::size_t num_stripes=0,
+    const allocator_type& al=allocator_type()):
+    stripes_(num_stripes?num_stripes:default_num_stripes()),
+    stripes(stripes_*num_indices),
+    al_(al),
+    size_index_(bucket_policy::size_index((std::max)(n,stripes_))),
+    spc(al,num_indices*bucket_count()),
+    mlf(1.0f)
+  {
+    std::fill_n(buckets_begin(),num_indices*bucket_count(),(node_type*)0);
+    max_load_.store(calculate_max_load(bucket_count()));
+  }
+
+  ~concurrent_multi_index_container()
+  {
+    delete_all_nodes();
+  }
+
+  allocator_type get_allocator()const BOOST_NOEXCEPT
+  {
+    return allocator_type(al_);
+  }
+
+  /* size is exact only in the absence of concurrent modifications */
+
+  bool empty()const BOOST_NOEXCEPT{return size()==0;}
+
+  size_type size()const BOOST_NOEXCEPT
+  {
+    size_type s=0;
+    for(std::size_t i=0;i<stripes_;++i){
+      s+=stripes[i].count.load(std::memory_order_relaxed);
+    }
+    return s;
+  }
+
+  /* modifiers */
+
+  bool insert(const value_type& x)
+  {
+    return insert_(create_node(x));
+  }
+
+  bool insert(value_type&& x)
+  {
+    return insert_(create_node(std::move(x)));
+  }
+
+  template<int N,typename CompatibleKey>
+  size_type erase(const CompatibleKey& k)
+  {
+    BOOST_STATIC_ASSERT(N>=0&&N<(int)num_indices);
+    std::size_t h=get_layer<N>().hash(k);
+    size_type   n=0;
+    while(erase_one<N>(k,h)){
+      ++n;
+      if(layer<N>::type::is_unique)break;
+    }
+    return n;
+  }
+
+  void clear()
+  {
+    exclusive_lock lck(*this);
+    delete_all_nodes();
+    std::fill_n(buckets_begin(),num_indices*bucket_count(),(node_type*)0);
+    for(std::size_t i=0;i<stripes_;++i){
+      stripes[i].count.store(0,std::memory_order_relaxed);
+    }
+  }
+
+  /* lookup: f is invoked on each element with key k in the N-th index
+   * while the lock of its bucket is held, so it must not access the
+   * container.
+   */
+
+  template<int N,typename CompatibleKey,typename F>
+  size_type visit(const CompatibleKey& k,F f)const
+  {
+    BOOST_STATIC_ASSERT(N>=0&&N<(int)num_indices);
+    typedef typename layer<N>::type layer_type;
+
+    const layer_type& l=get_layer<N>();
+    std::size_t       h=l.hash(k);
+    for(;;){
+      lock_set    lck;
+      std::size_t si=size_index_.load(std::memory_order_relaxed),
+                  pos=bucket_policy::position(h,si);
+      lck.lock(stripe(N,stripe_of(pos,si)).mutex);
+      if(si!=size_index_.load(std::memory_order_relaxed))continue;
+
+      size_type n=0;
+      for(node_type* x=bucket(N,pos);x;x=x->next[N]){
+        if(l.eq(k,l.key(x->value()))){
+          const value_type& v=x->value();
+          f(v);
+          ++n;
+          if(layer_type::is_unique)break;
+        }
+      }
+      return n;
+    }
+  }
+
+  template<int N,typename CompatibleKey>
+  size_type count(const CompatibleKey& k)const
+  {
+    return visit<N>(k,no_op());
+  }
+
+  template<int N,typename CompatibleKey>
+  bool contains(const CompatibleKey& k)const
+  {
+    return count<N>(k)!=0;
+  }
+
+  /* copies into x some element with key k in the N-th index */
+
+  template<int N,typename CompatibleKey>
+  bool find(const CompatibleKey& k,value_type& x)const
+  {
+    return visit<N>(k,assign_to(x))!=0;
+  }
+
+  /* f is invoked on every element, one lock stripe at a time. Resizing is
+   * held off meanwhile so that no element is visited twice or skipped.
+   */
+
+  template<typename F>
+  void visit_all(F f)const
+  {
+    std::lock_guard<std::mutex> lck(resize_mutex);
+    std::size_t si=size_index_.load(std::memory_order_relaxed),
+                bc=bucket_policy::size(si),
+                range=stripe_range(si);
+    for(std::size_t s=0;s<stripes_;++s){
+      std::lock_guard<std::mutex> slck(stripe(0,s).mutex);
+      for(std::size_t pos=s*range,end=(std::min)(pos+range,bc);
+          pos<end;++pos){
+        for(node_type* x=bucket(0,pos);x;x=x->next[0]){
+          const value_type& v=x->value();
+          f(v);
+        }
+      }
+    }
+  }
+
+  /* hash policy */
+
+  size_type bucket_count()const BOOST_NOEXCEPT
+  {
+    return bucket_policy::size(size_index_.load(std::memory_order_relaxed));
+  }
+
+  std::size_t stripe_count()const BOOST_NOEXCEPT{return stripes_;}
+
+  float max_load_factor()const BOOST_NOEXCEPT
+  {
+    std::lock_guard<std::mutex> lck(resize_mutex);
+    return mlf;
+  }
+
+  void max_load_factor(float z)
+  {
+    exclusive_lock lck(*this);
+    mlf=z;
+    max_load_.store(calculate_max_load(bucket_count()));
+    reserve_for(size_());
+  }
+
+  void rehash(size_type n)
+  {
+    exclusive_lock lck(*this);
+    std::size_t si=bucket_policy::size_index((std::max)(n,stripes_));
+    if(si!=size_index_.load(std::memory_order_relaxed)&&
+       calculate_max_load(bucket_policy::size(si))>=size_()){
+      unchecked_rehash(si);
+    }
+    reserve_for(size_());
+  }
+
+private:
+  struct no_op
+  {
+    void operator()(const value_type&)const{}
+  };
+
+  struct assign_to
+  {
+    assign_to(value_type& x_):x(&x_){}
+    void operator()(const value_type& v)const{*x=v;}
+
+    value_type* x;
+  };
+
+  struct buckets_accessor
+  {
+    buckets_accessor(const concurrent_multi_index_container& c_):c(&c_){}
+
+    node_type* operator()(std::size_t n,std::size_t pos)const
+    {
+      return c->bucket(n,pos);
+    }
+
+    const concurrent_multi_index_container* c;
+  };
+
+  /* resize mutex and then every stripe */
+
+  class exclusive_lock:private noncopyable
+  {
+  public:
+    exclusive_lock(const concurrent_multi_index_container& c_):c(c_)
+    {
+      c.resize_mutex.lock();
+      for(std::size_t i=0;i<c.stripes.size();++i)c.stripes[i].mutex.lock();
+    }
+
+    ~exclusive_lock()
+    {
+      for(std::size_t i=c.stripes.size();i--;)c.stripes[i].mutex.unlock();
+      c.resize_mutex.unlock();
+    }
+
+  private:
+    const concurrent_multi_index_container& c;
+  };
+
+  static std::size_t default_num_stripes()
+  {
+    return 4*detail::parallel_run_concurrency()<16?
+      16:4*detail::parallel_run_concurrency();
+  }
+
+  template<int N>
+  const typename layer<N>::type& get_layer()const
+  {
+    return layers;
+  }
+
+  node_type** buckets_begin()const
+  {
+    return detail::raw_ptr<node_type**>(spc.data());
+  }
+
+  node_type*& bucket(std::size_t n,std::size_t pos)const
+  {
+    return buckets_begin()[n*bucket_count()+pos];
+  }
+
+  stripe_type& stripe(std::size_t n,std::size_t s)const
+  {
+    return stripes[n*stripes_+s];
+  }
+
+  std::size_t stripe_range(std::size_t si)const
+  {
+    return (bucket_policy::size(si)+stripes_-1)/stripes_;
+  }
+
+  std::size_t stripe_of(std::size_t pos,std::size_t si)const
+  {
+    return pos/stripe_range(si);
+  }
+
+  void positions(
+    const std::size_t* h,std::size_t si,std::size_t* pos,std::size_t* s)const
+  {
+    for(std::size_t n=0;n<num_indices;++n){
+      pos[n]=bucket_policy::position(h[n],si);
+      s[n]=stripe_of(pos[n],si);
+    }
+  }
+
+  size_type size_()const{return size();}
+
+  size_type calculate_max_load(size_type bc)const
+  {
+    float fml=mlf*static_cast<float>(bc);
+    return fml>=static_cast<float>((std::numeric_limits<size_type>::max)())?
+      (std::numeric_limits<size_type>::max)():static_cast<size_type>(fml);
+  }
+
+  template<typename T>
+  node_type* create_node(T&& x)
+  {
+    node_type* p=detail::raw_ptr<node_type*>(
+      node_alloc_traits::allocate(al_,1));
+    BOOST_TRY{
+      node_alloc_traits::construct(
+        al_,boost::addressof(p->value()),std::forward<T>(x));
+    }
+    BOOST_CATCH(...){
+      node_alloc_traits::deallocate(al_,static_cast<node_pointer>(p),1);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    return p;
+  }
+
+  void delete_node(node_type* x)
+  {
+    node_alloc_traits::destroy(al_,boost::addressof(x->value()));
+    node_alloc_traits::deallocate(al_,static_cast<node_pointer>(x),1);
+  }
+
+  void delete_all_nodes()
+  {
+    for(std::size_t pos=0,bc=bucket_count();pos<bc;++pos){
+      for(node_type* x=bucket(0,pos);x;){
+        node_type* y=x->next[0];
+        delete_node(x);
+        x=y;
+      }
+    }
+  }
+
+  bool insert_(node_type* x)
+  {
+    std::size_t h[num_indices],pos[num_indices],s[num_indices];
+    BOOST_TRY{
+      layers.hash_values(x->value(),h);
+      for(;;){
+        lock_set    lck;
+        std::size_t si=size_index_.load(std::memory_order_relaxed);
+        positions(h,si,pos,s);
+        for(std::size_t n=0;n<num_indices;++n)lck.lock(stripe(n,s[n]).mutex);
+        if(si!=size_index_.load(std::memory_order_relaxed))continue;
+
+        if(layers.collides(x->value(),buckets_accessor(*this),pos)){
+          lck.unlock();
+          delete_node(x);
+          return false;
+        }
+        for(std::size_t n=0;n<num_indices;++n){
+          x->next[n]=bucket(n,pos[n]);
+          bucket(n,pos[n])=x;
+        }
+        stripe_type& st=stripe(0,s[0]);
+        st.count.store(
+          st.count.load(std::memory_order_relaxed)+1,
+          std::memory_order_relaxed);
+        break;
+      }
+    }
+    BOOST_CATCH(...){
+      delete_node(x);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+
+    /* The stripe holding more than its share of the maximum load is what
+     * prompts computing the total size.
+     */
+
+    size_type ml=max_load_.load(std::memory_order_relaxed);
+    if(stripe(0,s[0]).count.load(std::memory_order_relaxed)>ml/stripes_&&
+       size()>ml){
+      grow();
+    }
+    return true;
+  }
+
+  template<int N,typename CompatibleKey>
+  bool erase_one(const CompatibleKey& k,std::size_t hk)
+  {
+    typedef typename layer<N>::type layer_type;
+
+    const layer_type& l=get_layer<N>();
+    for(;;){
+      lock_set    lck;
+      std::size_t h[num_indices],pos[num_indices],s[num_indices];
+      std::size_t si=size_index_.load(std::memory_order_relaxed),
+                  posk=bucket_policy::position(hk,si);
+      lck.lock(stripe(N,stripe_of(posk,si)).mutex);
+      if(si!=size_index_.load(std::memory_order_relaxed))continue;
+
+      node_type* x=bucket(N,posk);
+      while(x&&!l.eq(k,l.key(x->value())))x=x->next[N];
+      if(!x)return false;
+      layers.hash_values(x->value(),h);
+      positions(h,si,pos,s);
+
+      /* Locks of lower indices can only be tried while holding that of
+       * the N-th index; if some fails, start over taking all in order.
+       */
+
+      bool acquired=true;
+      for(std::size_t n=0;n<num_indices&&acquired;++n){
+        if(n<(std::size_t)N)acquired=lck.try_lock(stripe(n,s[n]).mutex);
+        else if(n>(std::size_t)N)lck.lock(stripe(n,s[n]).mutex);
+      }
+      if(!acquired){
+        lck.unlock();
+        for(std::size_t n=0;n<num_indices;++n)lck.lock(stripe(n,s[n]).mutex);
+        if(si!=size_index_.load(std::memory_order_relaxed)||
+           !relocated(x,N,pos)||!l.eq(k,l.key(x->value())))continue;
+        std::size_t h2[num_indices];
+        layers.hash_values(x->value(),h2);
+        if(!std::equal(h,h+num_indices,h2))continue;
+      }
+
+      for(std::size_t n=0;n<num_indices;++n){
+        node_type** pp=&bucket(n,pos[n]);
+        while(*pp!=x)pp=&(*pp)->next[n];
+        *pp=x->next[n];
+      }
+      stripe_type& st=stripe(0,s[0]);
+      st.count.store(
+        st.count.load(std::memory_order_relaxed)-1,
+        std::memory_order_relaxed);
+      lck.unlock();
+      delete_node(x);
+      return true;
+    }
+  }
+
+  /* whether x is still linked in bucket pos[n] of the n-th index */
+
+  bool relocated(node_type* x,std::size_t n,const std::size_t* pos)const
+  {
+    for(node_type* y=bucket(n,pos[n]);y;y=y->next[n]){
+      if(y==x)return true;
+    }
+    return false;
+  }
+
+  void grow()
+  {
+    exclusive_lock lck(*this);
+    reserve_for(size_());
+  }
+
+  void reserve_for(size_type n)
+  {
+    if(n>max_load_.load(std::memory_order_relaxed)){
+      size_type bc=(std::numeric_limits<size_type>::max)();
+      float     fbc=1.0f+static_cast<float>(n)/mlf;
+      if(bc>fbc)bc=static_cast<size_type>(fbc);
+      std::size_t si=bucket_policy::size_index(bc);
+      if(si!=size_index_.load(std::memory_order_relaxed))unchecked_rehash(si);
+    }
+  }
+
+  /* All hash values are calculated before relinking any node, so that
+   * an exception leaves the container untouched.
+   */
+
+  void unchecked_rehash(std::size_t si)
+  {
+    typedef detail::auto_space<std::size_t,Allocator> hash_space;
+
+    size_type   n=size_(),bc=bucket_policy::size(si);
+    bucket_space new_spc(get_allocator(),num_indices*bc);
+    hash_space   hashes(get_allocator(),n*num_indices);
+    std::size_t* h=detail::raw_ptr<std::size_t*>(hashes.data());
+    std::vector<std::size_t> counts(stripes_,0);
+
+    std::size_t i=0;
+    for(std::size_t pos=0,old_bc=bucket_count();pos<old_bc;++pos){
+      for(node_type* x=bucket(0,pos);x;x=x->next[0],i+=num_indices){
+        layers.hash_values(x->value(),h+i);
+      }
+    }
+
+    node_type** buckets=detail::raw_ptr<node_type**>(new_spc.data());
+    std::fill_n(buckets,num_indices*bc,(node_type*)0);
+    std::size_t range=(bc+stripes_-1)/stripes_;
+    i=0;
+    for(std::size_t pos=0,old_bc=bucket_count();pos<old_bc;++pos){
+      for(node_type* x=bucket(0,pos);x;i+=num_indices){
+        node_type* y=x->next[0];
+        for(std::size_t m=0;m<num_indices;++m){
+          node_type*& b=buckets[m*bc+bucket_policy::position(h[i+m],si)];
+          if(m==0)++counts[bucket_policy::position(h[i],si)/range];
+          x->next[m]=b;
+          b=x;
+        }
+        x=y;
+      }
+    }
+
+    spc.swap(new_spc);
+    for(std::size_t s=0;s<stripes_;++s){
+      stripe(0,s).count.store(counts[s],std::memory_order_relaxed);
+    }
+    size_index_.store(si,std::memory_order_relaxed);
+    max_load_.store(calculate_max_load(bc),std::memory_order_relaxed);
+  }
+
+  layers_type                      layers;
+  std::size_t                      stripes_;
+  mutable std::vector<stripe_type> stripes;
+  mutable std::mutex               resize_mutex;
+  node_allocator                   al_;
+  std::atomic<std::size_t>         size_index_;
+  bucket_space                     spc;
+  float                            mlf;
+  std::atomic<size_type>           max_load_;
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
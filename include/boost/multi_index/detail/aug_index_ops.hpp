@@ -0,0 +1,119 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_AUG_INDEX_OPS_HPP
+#define BOOST_MULTI_INDEX_DETAIL_AUG_INDEX_OPS_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Common code for augmented_index memfuns. Nodes store the summary of
+ * their own element and that of their whole subtree.
+ */
+
+template<typename Pointer,typename Summary>
+inline typename Summary::result_type augmented_node_summary(
+  Pointer x,const Summary& s)
+{
+  return x!=Pointer(0)?x->summary:s();
+}
+
+/* summary of the elements of the subtree of y not going before x, with x
+ * in the left subtree of y (or y the header)
+ */
+
+template<typename Pointer,typename Summary>
+inline typename Summary::result_type augmented_index_left_part(
+  Pointer x,Pointer y,const Summary& s)
+{
+  typename Summary::result_type res=
+    s(x->element_summary,augmented_node_summary(x->right(),s));
+  for(Pointer z=x->parent();z!=y;x=z,z=z->parent()){
+    if(x==z->left()){
+      res=s(res,s(z->element_summary,augmented_node_summary(z->right(),s)));
+    }
+  }
+  return res;
+}
+
+/* summary of the elements of the subtree of y going before x, with x
+ * in the right subtree of y
+ */
+
+template<typename Pointer,typename Summary>
+inline typename Summary::result_type augmented_index_right_part(
+  Pointer x,Pointer y,const Summary& s)
+{
+  typename Summary::result_type res=augmented_node_summary(x->left(),s);
+  for(Pointer z=x->parent();z!=y;x=z,z=z->parent()){
+    if(x==z->right()){
+      res=s(s(augmented_node_summary(z->left(),s),z->element_summary),res);
+    }
+  }
+  return res;
+}
+
+template<typename Pointer>
+inline std::size_t augmented_index_depth(Pointer x,Pointer top)
+{
+  std::size_t d=0;
+  for(;x!=top;x=x->parent())++d;
+  return d;
+}
+
+/* summary of [first,last), combining the parts hanging from the paths
+ * that go from first and last up to their lowest common ancestor
+ */
+
+template<typename Pointer,typename Summary>
+inline typename Summary::result_type augmented_index_aggregate(
+  Pointer first,Pointer last,Pointer end_,const Summary& s)
+{
+  if(first==last)return s();
+  if(last==end_)return augmented_index_left_part(first,end_,s);
+
+  Pointer     top=end_->parent(),x=first,y=last;
+  std::size_t dx=augmented_index_depth(x,top),
+              dy=augmented_index_depth(y,top);
+  for(;dx>dy;--dx)x=x->parent();
+  for(;dy>dx;--dy)y=y->parent();
+  while(x!=y){
+    x=x->parent();
+    y=y->parent();
+  }
+
+  if(x==first){
+    return s(first->element_summary,augmented_index_right_part(last,x,s));
+  }
+  else if(x==last){
+    return augmented_index_left_part(first,x,s);
+  }
+  else{
+    return s(
+      s(augmented_index_left_part(first,x,s),x->element_summary),
+      augmented_index_right_part(last,x,s));
+  }
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
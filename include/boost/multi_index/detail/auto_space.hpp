@@ -62,6 +62,7 @@ struct auto_space:private noncopyable
   Allocator get_allocator()const{return al_;}
 
   pointer data()const{return data_;}
+  size_type size()const{return n_;}
 
   void swap(auto_space& x)
   {
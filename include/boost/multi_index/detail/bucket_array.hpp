@@ -1,4 +1,4 @@
-/* Copyright 2003-2020 Joaquin M Lopez Munoz.
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
  * Distributed under the Boost Software License, Version 1.0.
  * (See accompanying file LICENSE_1_0.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt)
@@ -40,6 +40,14 @@ namespace detail{
 
 /* bucket structure for use by hashed indices */
 
+/* Bucket size policies provide static functions
+ *   size_index(n): index of the smallest supported size not less than n
+ *     (or of the largest size if none exists),
+ *   size(i): size of index i,
+ *   position(hash,i): bucket of a given hash value for size of index i.
+ * bucket_array_base uses prime sizes and is the default policy.
+ */
+
 #define BOOST_MULTI_INDEX_BA_SIZES_32BIT                                  \
 (53ul)(97ul)(193ul)(389ul)(769ul)                                         \
 (1543ul)(3079ul)(6151ul)(12289ul)(24593ul)                                \
@@ -88,6 +96,11 @@ protected:
     return bound-sizes;
   }
 
+  static std::size_t size(std::size_t size_index_)
+  {
+    return sizes[size_index_];
+  }
+
 #define BOOST_MULTI_INDEX_BA_POSITION_CASE(z,n,_)                    \
   case n:return hash%BOOST_PP_SEQ_ELEM(n,BOOST_MULTI_INDEX_BA_SIZES);
 
@@ -124,10 +137,51 @@ const std::size_t bucket_array_base<_>::sizes_length=
 #undef BOOST_MULTI_INDEX_BA_SIZES
 #undef BOOST_MULTI_INDEX_BA_SIZES_32BIT
 
-template<typename Allocator>
-class bucket_array:bucket_array_base<>
+/* Power-of-two sizes: the bucket is obtained with Fibonacci hashing, i.e.
+ * the high bits of hash*2^w/phi, w being the width of std::size_t, so that
+ * hash functions not mixing their low bits (like boost::hash for integral
+ * types) still spread well; this takes a multiplication and a shift
+ * rather than the modulo operation required by prime sizes.
+ */
+
+class pow2_bucket_array_base:private noncopyable
 {
-  typedef bucket_array_base<>                        super;
+protected:
+  static std::size_t size_index(std::size_t n)
+  {
+    std::size_t i=min_size_index;
+    while(i<max_size_index&&(std::size_t(1)<<i)<n)++i;
+    return i;
+  }
+
+  static std::size_t size(std::size_t size_index_)
+  {
+    return std::size_t(1)<<size_index_;
+  }
+
+  static std::size_t position(std::size_t hash,std::size_t size_index_)
+  {
+    return (hash*fibonacci_multiplier)>>(size_t_bits-size_index_);
+  }
+
+private:
+  BOOST_STATIC_CONSTANT(
+    std::size_t,size_t_bits=sizeof(std::size_t)*CHAR_BIT);
+  BOOST_STATIC_CONSTANT(std::size_t,min_size_index=5);
+  BOOST_STATIC_CONSTANT(std::size_t,max_size_index=size_t_bits-1);
+
+#if ((((ULONG_MAX>>16)>>16)>>16)>>15)==0 /* unsigned long less than 64 bits */
+  BOOST_STATIC_CONSTANT(std::size_t,fibonacci_multiplier=2654435769ul);
+#else
+  BOOST_STATIC_CONSTANT(
+    std::size_t,fibonacci_multiplier=11400714819323198485ul);
+#endif
+};
+
+template<typename Allocator,typename SizePolicy=bucket_array_base<> >
+class bucket_array:SizePolicy
+{
+  typedef SizePolicy                                 super;
   typedef hashed_index_base_node_impl<
     typename rebind_alloc_for<
       Allocator,
@@ -141,14 +195,36 @@ public:
 
   bucket_array(const Allocator& al,pointer end_,std::size_t size_):
     size_index_(super::size_index(size_)),
-    spc(al,static_cast<auto_space_size_type>(super::sizes[size_index_]+1))
+    spc(al,static_cast<auto_space_size_type>(super::size(size_index_)+1))
   {
     clear(end_);
   }
 
+  /* The following are used by the incremental rehashing machinery of
+   * hashed indices: a null array holds no buckets at all, whereas the
+   * buckets of an array constructed without an end node are left
+   * uninitialized, to be set up piecemeal with initialize() (the end
+   * bucket is not touched by the latter).
+   */
+
+  explicit bucket_array(const Allocator& al):
+    size_index_(0),
+    spc(al,0)
+  {}
+
+  bucket_array(const Allocator& al,std::size_t size_):
+    size_index_(super::size_index(size_)),
+    spc(al,static_cast<auto_space_size_type>(super::size(size_index_)+1))
+  {}
+
+  void initialize(std::size_t first,std::size_t last)
+  {
+    for(base_pointer x=at(first),y=at(last);x!=y;++x)x->prior()=pointer(0);
+  }
+
   std::size_t size()const
   {
-    return super::sizes[size_index_];
+    return super::size(size_index_);
   }
 
   std::size_t position(std::size_t hash)const
@@ -156,6 +232,16 @@ public:
     return super::position(hash,size_index_);
   }
 
+  static std::size_t size_for(std::size_t size_)
+  {
+    return super::size(super::size_index(size_));
+  }
+
+  std::size_t memory_size()const
+  {
+    return static_cast<std::size_t>(spc.size())*sizeof(base_node_impl_type);
+  }
+
   base_pointer begin()const{return buckets();}
   base_pointer end()const{return buckets()+size();}
   base_pointer at(std::size_t n)const{return buckets()+n;}
@@ -207,8 +293,9 @@ private:
 #endif
 };
 
-template<typename Allocator>
-void swap(bucket_array<Allocator>& x,bucket_array<Allocator>& y)
+template<typename Allocator,typename SizePolicy>
+void swap(
+  bucket_array<Allocator,SizePolicy>& x,bucket_array<Allocator,SizePolicy>& y)
 {
   x.swap(y);
 }
@@ -231,9 +318,9 @@ namespace multi_index{
 namespace detail{
 #endif
 
-template<class Archive,typename Allocator>
+template<class Archive,typename Allocator,typename SizePolicy>
 inline void load_construct_data(
-  Archive&,boost::multi_index::detail::bucket_array<Allocator>*,
+  Archive&,boost::multi_index::detail::bucket_array<Allocator,SizePolicy>*,
   const unsigned int)
 {
   throw_exception(
@@ -0,0 +1,160 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_CONCURRENT_HASH_LAYER_HPP
+#define BOOST_MULTI_INDEX_DETAIL_CONCURRENT_HASH_LAYER_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/mpl/at.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/size.hpp>
+#include <boost/multi_index/detail/index_node_base.hpp>
+#include <boost/multi_index/hashed_forward_index_fwd.hpp>
+#include <boost/multi_index/hashed_index_fwd.hpp>
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Nodes of concurrent_multi_index_container hold the value and, for each
+ * of the N indices, the pointer to the next node in the bucket the node
+ * belongs to. Buckets are null-terminated chains independent from one
+ * another, so that any operation on an index only touches the buckets of
+ * the elements involved.
+ */
+
+template<typename Value,std::size_t N>
+struct concurrent_hash_node:private pod_value_holder<Value>
+{
+  typedef Value value_type;
+
+  concurrent_hash_node* next[N];
+
+#include <boost/multi_index/detail/ignore_wstrict_aliasing.hpp>
+
+  value_type& value()
+  {
+    return *reinterpret_cast<value_type*>(&this->space);
+  }
+
+  const value_type& value()const
+  {
+    return *reinterpret_cast<const value_type*>(&this->space);
+  }
+
+#include <boost/multi_index/detail/restore_wstrict_aliasing.hpp>
+};
+
+/* Only hashed index specifiers are accepted by
+ * concurrent_multi_index_container.
+ */
+
+template<typename IndexSpecifier>
+struct concurrent_hash_is_unique; /* undefined for other specifiers */
+
+template<
+  typename Arg1,typename Arg2,typename Arg3,typename Arg4,typename Arg5
+>
+struct concurrent_hash_is_unique<
+  hashed_unique<Arg1,Arg2,Arg3,Arg4,Arg5> >:mpl::true_{};
+
+template<
+  typename Arg1,typename Arg2,typename Arg3,typename Arg4,typename Arg5
+>
+struct concurrent_hash_is_unique<
+  hashed_non_unique<Arg1,Arg2,Arg3,Arg4,Arg5> >:mpl::false_{};
+
+template<typename Arg1,typename Arg2,typename Arg3,typename Arg4>
+struct concurrent_hash_is_unique<
+  hashed_forward_unique<Arg1,Arg2,Arg3,Arg4> >:mpl::true_{};
+
+/* concurrent_hash_layer<Node,IndexSpecifierList,N> holds the key
+ * extractor, hash function and equality predicate of the N-th index and
+ * derives from the layer of the (N+1)-th, much as indices are layered in
+ * multi_index_container. Operations spanning all indices recurse down the
+ * hierarchy. Bucket positions and hash values are passed around in arrays
+ * indexed by index number; bucket(n,pos) returns the head of bucket pos of
+ * the n-th index.
+ */
+
+template<
+  typename Node,typename IndexSpecifierList,int N,
+  bool End=(N==mpl::size<IndexSpecifierList>::value)
+>
+class concurrent_hash_layer:
+  public concurrent_hash_layer<Node,IndexSpecifierList,N+1>
+{
+  typedef concurrent_hash_layer<Node,IndexSpecifierList,N+1> super;
+  typedef typename mpl::at_c<IndexSpecifierList,N>::type     specifier;
+
+public:
+  typedef typename Node::value_type                      value_type;
+  typedef typename specifier::key_from_value_type        key_from_value;
+  typedef typename key_from_value::result_type           key_type;
+  typedef typename specifier::hash_type                  hasher;
+  typedef typename specifier::pred_type                  key_equal;
+
+  BOOST_STATIC_CONSTANT(
+    bool,is_unique=concurrent_hash_is_unique<specifier>::value);
+
+  concurrent_hash_layer():key(),hash(),eq(){}
+
+  void hash_values(const value_type& v,std::size_t* h)const
+  {
+    h[N]=hash(key(v));
+    super::hash_values(v,h);
+  }
+
+  /* whether v clashes with some element of a unique index */
+
+  template<typename Buckets>
+  bool collides(
+    const value_type& v,const Buckets& buckets,const std::size_t* pos)const
+  {
+    if(is_unique){
+      for(Node* x=buckets(N,pos[N]);x;x=x->next[N]){
+        if(eq(key(v),key(x->value())))return true;
+      }
+    }
+    return super::collides(v,buckets,pos);
+  }
+
+  key_from_value key;
+  hasher         hash;
+  key_equal      eq;
+};
+
+template<typename Node,typename IndexSpecifierList,int N>
+class concurrent_hash_layer<Node,IndexSpecifierList,N,true>
+{
+public:
+  typedef typename Node::value_type value_type;
+
+  void hash_values(const value_type&,std::size_t*)const{}
+
+  template<typename Buckets>
+  bool collides(const value_type&,const Buckets&,const std::size_t*)const
+  {
+    return false;
+  }
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
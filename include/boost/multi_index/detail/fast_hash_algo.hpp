@@ -0,0 +1,296 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_FAST_HASH_ALGO_HPP
+#define BOOST_MULTI_INDEX_DETAIL_FAST_HASH_ALGO_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstring>
+
+/* This user_definable macro disables the use of SIMD instructions in the
+ * hashing of long byte sequences by fast_hash (done only on platforms
+ * lacking a native 64x64->128 bit multiplication), reverting to portable
+ * code which yields the same hash values.
+ */
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_FAST_HASH_SIMD)
+#if defined(__SSE2__)||defined(_M_X64)||\
+    (defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define BOOST_MULTI_INDEX_FAST_HASH_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+#if defined(BOOST_HAS_INT128)
+#define BOOST_MULTI_INDEX_FAST_HASH_WIDE_MUL
+#elif defined(_MSC_VER)&&defined(_M_X64)
+#define BOOST_MULTI_INDEX_FAST_HASH_WIDE_MUL
+#include <intrin.h>
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Hashing algorithms used by fast_hash:
+ *   - Integers go through the finalizer of MurmurHash3, a bijection with
+ *     full avalanche, so that distinct integers keep distinct hash values.
+ *   - Byte sequences are hashed as in wyhash, folding 16 or 48 bytes at a
+ *     time with 64x64->128 bit multiplications.
+ *   - Where there is no native 64x64->128 bit multiplication (32-bit
+ *     platforms, mainly), sequences longer than stripe_threshold are hashed
+ *     as in XXH3 instead: eight 64-bit accumulators consume 64-byte stripes
+ *     with 32x32->64 bit multiplications, which SSE2 does two at a time, and
+ *     are scrambled every 16 stripes. With a native wide multiplication
+ *     wyhash is faster at all lengths.
+ * Hash values depend on the endianness and the width of std::size_t of the
+ * platform and are not meant to be persisted.
+ */
+
+struct fast_hash_algo
+{
+  typedef boost::uint64_t uint64;
+
+  static std::size_t mix(uint64 x)
+  {
+    x^=x>>33;
+    x*=UINT64_C(0xff51afd7ed558ccd);
+    x^=x>>33;
+    x*=UINT64_C(0xc4ceb9fe1a85ec53);
+    x^=x>>33;
+    return fold(x);
+  }
+
+  static std::size_t hash_bytes(const void* p,std::size_t n)
+  {
+    const unsigned char* q=static_cast<const unsigned char*>(p);
+#if defined(BOOST_MULTI_INDEX_FAST_HASH_WIDE_MUL)
+    return fold(wy_hash(q,n));
+#else
+    return fold(n<=stripe_threshold?wy_hash(q,n):stripe_hash(q,n));
+#endif
+  }
+
+private:
+  static std::size_t fold(uint64 x)
+  {
+    return static_cast<std::size_t>(
+      sizeof(std::size_t)<sizeof(uint64)?x^(x>>32):x);
+  }
+
+  static uint64 secret(std::size_t i)
+  {
+    static const uint64 s[]={
+      UINT64_C(0xa0761d6478bd642f),UINT64_C(0xe7037ed1a0b428db),
+      UINT64_C(0x8ebc6af09c88c6e3),UINT64_C(0x589965cc75374cc3)
+    };
+    return s[i];
+  }
+
+  /* XXH3 stripe keys are taken at 8-byte offsets within the 192 bytes
+   * below, which makes for 24 64-bit words.
+   */
+
+  static const uint64* long_secret()
+  {
+    static const uint64 s[]={
+      UINT64_C(0x6e789e6aa1b965f4),UINT64_C(0x06c45d188009454f),
+      UINT64_C(0xf88bb8a8724c81ec),UINT64_C(0x1b39896a51a8749b),
+      UINT64_C(0x53cb9f0c747ea2ea),UINT64_C(0x2c829abe1f4532e1),
+      UINT64_C(0xc584133ac916ab3c),UINT64_C(0x3ee5789041c98ac3),
+      UINT64_C(0xf3b8488c368cb0a6),UINT64_C(0x657eecdd3cb13d09),
+      UINT64_C(0xc2d326e0055bdef6),UINT64_C(0x8621a03fe0bbdb7b),
+      UINT64_C(0x8e1f7555983aa92f),UINT64_C(0xb54e0f1600cc4d19),
+      UINT64_C(0x84bb3f97971d80ab),UINT64_C(0x7d29825c75521255),
+      UINT64_C(0xc3cf17102b7f7f86),UINT64_C(0x3466e9a083914f64),
+      UINT64_C(0xd81a8d2b5a4485ac),UINT64_C(0xdb01602b100b9ed7),
+      UINT64_C(0xa9038a921825f10d),UINT64_C(0xedf5f1d90dca2f6a),
+      UINT64_C(0x54496ad67bd2634c),UINT64_C(0xdd7c01d4f5407269)
+    };
+    return s;
+  }
+
+  BOOST_STATIC_CONSTANT(std::size_t,stripe_threshold=256);
+  BOOST_STATIC_CONSTANT(std::size_t,stripe_size=64);
+  BOOST_STATIC_CONSTANT(std::size_t,stripes_per_block=16);
+  BOOST_STATIC_CONSTANT(std::size_t,scramble_key=16);
+  BOOST_STATIC_CONSTANT(std::size_t,last_stripe_key=9);
+
+  static uint64 read64(const unsigned char* p)
+  {
+    uint64 x;
+    std::memcpy(&x,p,sizeof(x));
+    return x;
+  }
+
+  static uint64 read32(const unsigned char* p)
+  {
+    boost::uint32_t x;
+    std::memcpy(&x,p,sizeof(x));
+    return x;
+  }
+
+  static uint64 read_up_to_3(const unsigned char* p,std::size_t n)
+  {
+    return (uint64(p[0])<<16)|(uint64(p[n>>1])<<8)|p[n-1];
+  }
+
+  /* 128-bit product of a and b, whose low and high halves are xored */
+
+  static uint64 mum(uint64 a,uint64 b)
+  {
+#if defined(BOOST_HAS_INT128)
+    boost::uint128_type r=static_cast<boost::uint128_type>(a)*b;
+    return static_cast<uint64>(r)^static_cast<uint64>(r>>64);
+#elif defined(_MSC_VER)&&defined(_M_X64)
+    uint64 hi,lo=_umul128(a,b,&hi);
+    return lo^hi;
+#else
+    uint64 ha=a>>32,hb=b>>32,la=a&0xfffffffful,lb=b&0xfffffffful,
+           rh=ha*hb,rm0=ha*lb,rm1=hb*la,rl=la*lb,
+           t=rl+(rm0<<32),c=t<rl,
+           lo=t+(rm1<<32);
+    c+=lo<t;
+    return lo^(rh+(rm0>>32)+(rm1>>32)+c);
+#endif
+  }
+
+  static uint64 wy_hash(const unsigned char* p,std::size_t n)
+  {
+    uint64 seed=mum(secret(0),secret(1)),a,b;
+    if(n<=16){
+      if(n>=4){
+        std::size_t d=(n>>3)<<2;
+        a=(read32(p)<<32)|read32(p+d);
+        b=(read32(p+n-4)<<32)|read32(p+n-4-d);
+      }
+      else if(n>0){
+        a=read_up_to_3(p,n);
+        b=0;
+      }
+      else a=b=0;
+    }
+    else{
+      std::size_t i=n;
+      if(i>48){
+        uint64 see1=seed,see2=seed;
+        do{
+          seed=mum(read64(p)^secret(1),read64(p+8)^seed);
+          see1=mum(read64(p+16)^secret(2),read64(p+24)^see1);
+          see2=mum(read64(p+32)^secret(3),read64(p+40)^see2);
+          p+=48;
+          i-=48;
+        }while(i>48);
+        seed^=see1^see2;
+      }
+      while(i>16){
+        seed=mum(read64(p)^secret(1),read64(p+8)^seed);
+        p+=16;
+        i-=16;
+      }
+      a=read64(p+i-16);
+      b=read64(p+i-8);
+    }
+    return mum(secret(1)^n,mum(a^secret(1),b^seed));
+  }
+
+#if defined(BOOST_MULTI_INDEX_FAST_HASH_SSE2)
+  static void accumulate(uint64* acc,const unsigned char* p,const uint64* key)
+  {
+    for(std::size_t i=0;i<4;++i){
+      __m128i a=_mm_loadu_si128(reinterpret_cast<const __m128i*>(acc)+i),
+              d=_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)+i),
+              k=_mm_loadu_si128(reinterpret_cast<const __m128i*>(key)+i),
+              dk=_mm_xor_si128(d,k),
+              prod=_mm_mul_epu32(dk,_mm_shuffle_epi32(dk,0x31)),
+              swap=_mm_shuffle_epi32(d,0x4E);
+      a=_mm_add_epi64(a,_mm_add_epi64(prod,swap));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(acc)+i,a);
+    }
+  }
+
+  static void scramble(uint64* acc,const uint64* key)
+  {
+    const __m128i prime=_mm_set1_epi32(static_cast<int>(0x9E3779B1u));
+    for(std::size_t i=0;i<4;++i){
+      __m128i a=_mm_loadu_si128(reinterpret_cast<const __m128i*>(acc)+i),
+              k=_mm_loadu_si128(reinterpret_cast<const __m128i*>(key)+i);
+      a=_mm_xor_si128(_mm_xor_si128(a,_mm_srli_epi64(a,47)),k);
+      __m128i lo=_mm_mul_epu32(a,prime),
+              hi=_mm_mul_epu32(_mm_shuffle_epi32(a,0x31),prime);
+      a=_mm_add_epi64(lo,_mm_slli_epi64(hi,32));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(acc)+i,a);
+    }
+  }
+#else
+  static void accumulate(uint64* acc,const unsigned char* p,const uint64* key)
+  {
+    for(std::size_t i=0;i<8;++i){
+      uint64 d=read64(p+8*i),dk=d^key[i];
+      acc[i^1]+=d;
+      acc[i]+=(dk&0xfffffffful)*(dk>>32);
+    }
+  }
+
+  static void scramble(uint64* acc,const uint64* key)
+  {
+    for(std::size_t i=0;i<8;++i){
+      uint64 a=acc[i];
+      a^=a>>47;
+      a^=key[i];
+      acc[i]=a*0x9E3779B1ul;
+    }
+  }
+#endif
+
+  static uint64 stripe_hash(const unsigned char* p,std::size_t n)
+  {
+    uint64 acc[8]={
+      0xC2B2AE3Dul,UINT64_C(0x9E3779B185EBCA87),
+      UINT64_C(0xC2B2AE3D27D4EB4F),UINT64_C(0x165667B19E3779F9),
+      UINT64_C(0x85EBCA77C2B2AE63),0x85EBCA77ul,
+      UINT64_C(0x27D4EB2F165667C5),0x9E3779B1ul
+    };
+    const uint64*        key=long_secret();
+    const unsigned char* last=p+n-stripe_size;
+    std::size_t          s=0;
+    for(;p<last;p+=stripe_size){
+      accumulate(acc,p,key+s);
+      if(++s==stripes_per_block){
+        scramble(acc,key+scramble_key);
+        s=0;
+      }
+    }
+    accumulate(acc,last,key+last_stripe_key);
+
+    uint64 h=n*UINT64_C(0x9E3779B185EBCA87);
+    for(std::size_t i=0;i<8;i+=2){
+      h+=mum(acc[i]^key[i+3],acc[i+1]^key[i+4]);
+    }
+    h^=h>>37;
+    h*=UINT64_C(0x165667919E3779F9);
+    h^=h>>32;
+    return h;
+  }
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,166 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_HASH_FLAT_INDEX_GROUP_HPP
+#define BOOST_MULTI_INDEX_DETAIL_HASH_FLAT_INDEX_GROUP_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <cstddef>
+
+/* This user_definable macro disables the use of SIMD instructions in the
+ * probing of flat hashed indices, reverting to portable code.
+ */
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_FLAT_HASH_SIMD)
+#if defined(__SSE2__)||defined(_M_X64)||\
+    (defined(_M_IX86_FP)&&_M_IX86_FP>=2)
+#define BOOST_MULTI_INDEX_FLAT_HASH_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON)||defined(_M_ARM64))&&\
+      (defined(__aarch64__)||defined(_M_ARM64))
+#define BOOST_MULTI_INDEX_FLAT_HASH_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)&&!defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Control bytes of flat hashed indices are arranged in groups of 16, each
+ * byte describing one slot of the table: an empty slot is marked by 0x80,
+ * an erased one by 0xFE, and an occupied slot holds a 7-bit fingerprint
+ * of the hash value of its element. The match functions below return a
+ * 16-bit mask with bit i set iff the i-th byte of the group passes the
+ * test; with SSE2 or NEON the whole group is processed at once.
+ */
+
+struct hashed_flat_index_group
+{
+  BOOST_STATIC_CONSTANT(std::size_t,size=16);
+  BOOST_STATIC_CONSTANT(unsigned char,empty=0x80);
+  BOOST_STATIC_CONSTANT(unsigned char,deleted=0xFE);
+
+#if defined(BOOST_MULTI_INDEX_FLAT_HASH_SSE2)
+  static unsigned int match(const unsigned char* p,unsigned char fp)
+  {
+    return static_cast<unsigned int>(
+      _mm_movemask_epi8(
+        _mm_cmpeq_epi8(load(p),_mm_set1_epi8(static_cast<char>(fp)))));
+  }
+
+  static unsigned int match_empty(const unsigned char* p)
+  {
+    return match(p,empty);
+  }
+
+  static unsigned int match_available(const unsigned char* p)
+  {
+    /* both empty and deleted have the high bit set */
+
+    return static_cast<unsigned int>(_mm_movemask_epi8(load(p)));
+  }
+
+private:
+  static __m128i load(const unsigned char* p)
+  {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+
+#elif defined(BOOST_MULTI_INDEX_FLAT_HASH_NEON)
+  static unsigned int match(const unsigned char* p,unsigned char fp)
+  {
+    return mask(vceqq_u8(vld1q_u8(p),vdupq_n_u8(fp)));
+  }
+
+  static unsigned int match_empty(const unsigned char* p)
+  {
+    return match(p,empty);
+  }
+
+  static unsigned int match_available(const unsigned char* p)
+  {
+    return mask(vtstq_u8(vld1q_u8(p),vdupq_n_u8(0x80)));
+  }
+
+private:
+  static unsigned int mask(uint8x16_t v)
+  {
+    /* NEON lacks a movemask instruction: each byte of v (0x00 or 0xFF) is
+     * ANDed with its bit weight inside its half and the halves summed up.
+     */
+
+    static const unsigned char weights[16]={
+      1,2,4,8,16,32,64,128,1,2,4,8,16,32,64,128};
+    uint8x16_t m=vandq_u8(v,vld1q_u8(weights));
+    return
+      static_cast<unsigned int>(vaddv_u8(vget_low_u8(m)))|
+      (static_cast<unsigned int>(vaddv_u8(vget_high_u8(m)))<<8);
+  }
+
+#else
+  static unsigned int match(const unsigned char* p,unsigned char fp)
+  {
+    unsigned int res=0;
+    for(std::size_t i=0;i<size;++i){
+      if(p[i]==fp)res|=1u<<i;
+    }
+    return res;
+  }
+
+  static unsigned int match_empty(const unsigned char* p)
+  {
+    return match(p,empty);
+  }
+
+  static unsigned int match_available(const unsigned char* p)
+  {
+    unsigned int res=0;
+    for(std::size_t i=0;i<size;++i){
+      if(p[i]&0x80)res|=1u<<i;
+    }
+    return res;
+  }
+#endif
+
+public:
+  /* position of the lowest bit set in a nonzero mask */
+
+  static std::size_t first(unsigned int m)
+  {
+#if defined(__GNUC__)||defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctz(m));
+#elif defined(_MSC_VER)
+    unsigned long r;
+    _BitScanForward(&r,m);
+    return static_cast<std::size_t>(r);
+#else
+    std::size_t r=0;
+    while(!(m&1u)){m>>=1;++r;}
+    return r;
+#endif
+  }
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,150 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_HASH_FLAT_INDEX_NODE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_HASH_FLAT_INDEX_NODE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Nodes of flat hashed indices do not link to one another: each node
+ * just points to the slot of the open-addressing table holding it, much
+ * as random access index nodes point back to their position in the
+ * pointer array. Empty slots hold a null pointer and the table is
+ * terminated by an extra slot pointing to the header, so that traversal
+ * amounts to scanning the slots until a non-null pointer is found.
+ */
+
+template<typename Allocator>
+struct hashed_flat_index_node_impl
+{
+  typedef typename rebind_alloc_for<
+    Allocator,hashed_flat_index_node_impl
+  >::type                                             node_allocator;
+  typedef allocator_traits<node_allocator>            node_alloc_traits;
+  typedef typename node_alloc_traits::pointer         pointer;
+  typedef typename node_alloc_traits::const_pointer   const_pointer;
+  typedef typename node_alloc_traits::difference_type difference_type;
+  typedef typename rebind_alloc_for<
+    Allocator,pointer
+  >::type                                             ptr_allocator;
+  typedef allocator_traits<ptr_allocator>             ptr_alloc_traits;
+  typedef typename ptr_alloc_traits::pointer          ptr_pointer;
+
+  ptr_pointer& up(){return up_;}
+  ptr_pointer  up()const{return up_;}
+
+  /* interoperability with hashed_flat_index_iterator */
+
+  static void increment(pointer& x)
+  {
+    ptr_pointer p=x->up();
+    do{++p;}while(*p==pointer(0));
+    x=*p;
+  }
+
+  static pointer first(ptr_pointer p)
+  {
+    while(*p==pointer(0))++p;
+    return *p;
+  }
+
+private:
+  ptr_pointer up_;
+};
+
+template<typename Super>
+struct hashed_flat_index_node_trampoline:
+  hashed_flat_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  >
+{
+  typedef hashed_flat_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  > impl_type;
+};
+
+template<typename Super>
+struct hashed_flat_index_node:
+  Super,hashed_flat_index_node_trampoline<Super>
+{
+private:
+  typedef hashed_flat_index_node_trampoline<Super> trampoline;
+
+public:
+  typedef typename trampoline::impl_type         impl_type;
+  typedef typename trampoline::pointer           impl_pointer;
+  typedef typename trampoline::const_pointer     const_impl_pointer;
+  typedef typename trampoline::difference_type   difference_type;
+  typedef typename trampoline::ptr_pointer       impl_ptr_pointer;
+
+  impl_ptr_pointer& up(){return trampoline::up();}
+  impl_ptr_pointer  up()const{return trampoline::up();}
+
+  impl_pointer impl()
+  {
+    return static_cast<impl_pointer>(
+      static_cast<impl_type*>(static_cast<trampoline*>(this)));
+  }
+
+  const_impl_pointer impl()const
+  {
+    return static_cast<const_impl_pointer>(
+      static_cast<const impl_type*>(static_cast<const trampoline*>(this)));
+  }
+
+  static hashed_flat_index_node* from_impl(impl_pointer x)
+  {
+    return
+      static_cast<hashed_flat_index_node*>(
+        static_cast<trampoline*>(
+          raw_ptr<impl_type*>(x)));
+  }
+
+  static const hashed_flat_index_node* from_impl(const_impl_pointer x)
+  {
+    return
+      static_cast<const hashed_flat_index_node*>(
+        static_cast<const trampoline*>(
+          raw_ptr<const impl_type*>(x)));
+  }
+
+  /* interoperability with hashed_flat_index_iterator */
+
+  static void increment(hashed_flat_index_node*& x)
+  {
+    impl_pointer xi=x->impl();
+    trampoline::increment(xi);
+    x=from_impl(xi);
+  }
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
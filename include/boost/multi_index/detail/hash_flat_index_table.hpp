@@ -0,0 +1,334 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_HASH_FLAT_INDEX_TABLE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_HASH_FLAT_INDEX_TABLE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/auto_space.hpp>
+#include <boost/multi_index/detail/hash_flat_index_group.hpp>
+#include <boost/multi_index/detail/hash_flat_index_node.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <cstring>
+#include <limits.h>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Open-addressing table of node pointers used by flat hashed indices.
+ * The capacity is a power of two multiple of the group size. A hash value
+ * is mixed by Fibonacci hashing: the top 7 bits of the result make the
+ * fingerprint stored in the control byte and the following bits select
+ * the initial group, from which probing proceeds over whole groups in
+ * triangular steps. A lookup stops at the first group with an empty slot,
+ * so in a table with at most 7/8 of its slots occupied or deleted most
+ * unsuccessful searches inspect one group of control bytes only.
+ *
+ * Erased slots are marked as deleted unless their group has some empty
+ * slot left: in that case no probe sequence has ever gone past the group
+ * and the slot can be marked empty. Deleted slots count against the
+ * maximum load and are purged upon rehashing.
+ */
+
+template<typename Allocator>
+class hashed_flat_index_table:private noncopyable
+{
+  typedef hashed_flat_index_node_impl<
+    typename rebind_alloc_for<
+      Allocator,
+      char
+    >::type
+  >                                           node_impl_type;
+  typedef hashed_flat_index_group             group_type;
+
+public:
+  typedef typename node_impl_type::pointer     value_type;
+  typedef typename node_impl_type::ptr_pointer pointer;
+
+  hashed_flat_index_table(const Allocator& al,value_type end_,std::size_t n):
+    size_index_(size_index(n)),
+    size_(0),
+    deleted_(0),
+    ctrl_spc(al,static_cast<ctrl_size_type>(capacity())),
+    slot_spc(al,static_cast<slot_size_type>(capacity()+1))
+  {
+    initialize();
+    *end()=end_;
+    end_->up()=end();
+  }
+
+  std::size_t capacity()const{return group_type::size<<size_index_;}
+  std::size_t size()const{return size_;}
+  std::size_t max_load()const{return capacity()-capacity()/8;}
+  bool        room_for_one()const{return size_+deleted_<max_load();}
+
+  /* minimum capacity for n elements to stay within the maximum load */
+
+  static std::size_t capacity_for(std::size_t n)
+  {
+    std::size_t i=size_index(n);
+    while(i<max_size_index&&n>(group_type::size<<i)-(group_type::size<<i)/8){
+      ++i;
+    }
+    return group_type::size<<i;
+  }
+
+  pointer begin()const{return slots();}
+  pointer end()const{return slots()+capacity();}
+
+  template<typename Match>
+  pointer find(std::size_t h,const Match& match)const
+  {
+    unsigned char fp=fingerprint(h);
+    for(prober pr(position(h),group_mask());;){
+      std::size_t          pos=pr.get()*group_type::size;
+      const unsigned char* g=ctrls()+pos;
+      for(unsigned int m=group_type::match(g,fp);m;m&=m-1){
+        pointer p=slots()+pos+group_type::first(m);
+        if(match(*p))return p;
+      }
+      if(group_type::match_empty(g)||!pr.next())return pointer(0);
+    }
+  }
+
+  /* x is reachable from h and no other element passes match */
+
+  template<typename Match>
+  bool in_place(value_type x,std::size_t h,const Match& match)const
+  {
+    unsigned char fp=fingerprint(h);
+    bool          found=false;
+    for(prober pr(position(h),group_mask());;){
+      std::size_t          pos=pr.get()*group_type::size;
+      const unsigned char* g=ctrls()+pos;
+      for(unsigned int m=group_type::match(g,fp);m;m&=m-1){
+        value_type y=slots()[pos+group_type::first(m)];
+        if(y==x)found=true;
+        else if(match(y))return false;
+      }
+      if(group_type::match_empty(g)||!pr.next())return found;
+    }
+  }
+
+  /* first empty or deleted slot in the probe sequence of h */
+
+  pointer available(std::size_t h)const
+  {
+    for(prober pr(position(h),group_mask());;pr.next()){
+      std::size_t  pos=pr.get()*group_type::size;
+      unsigned int m=group_type::match_available(ctrls()+pos);
+      if(m)return slots()+pos+group_type::first(m);
+    }
+  }
+
+  void occupy(pointer p,std::size_t h,value_type x)
+  {
+    unsigned char& c=ctrls()[p-slots()];
+    if(c==group_type::deleted)--deleted_;
+    c=fingerprint(h);
+    *p=x;
+    x->up()=p;
+    ++size_;
+  }
+
+  void erase(value_type x)
+  {
+    std::size_t n=static_cast<std::size_t>(x->up()-slots());
+    if(group_type::match_empty(ctrls()+(n&~(group_type::size-1)))){
+      ctrls()[n]=group_type::empty;
+    }
+    else{
+      ctrls()[n]=group_type::deleted;
+      ++deleted_;
+    }
+    *(x->up())=value_type(0);
+    --size_;
+  }
+
+  /* replicates the layout of x, which has the same capacity as *this */
+
+  template<typename NodeMap>
+  void copy(const hashed_flat_index_table& x,const NodeMap& map)
+  {
+    std::memcpy(ctrls(),x.ctrls(),capacity());
+    for(std::size_t i=0,n=capacity();i<n;++i){
+      value_type y=x.slots()[i];
+      if(y!=value_type(0)){
+        value_type z=map(y);
+        slots()[i]=z;
+        z->up()=slots()+i;
+      }
+    }
+    size_=x.size_;
+    deleted_=x.deleted_;
+  }
+
+  void clear()
+  {
+    initialize();
+    size_=0;
+    deleted_=0;
+  }
+
+  /* Rehashing to capacity n (rounded up as needed) relies on hash_of to
+   * compute the hash value of each element. The new table is fully
+   * built before the nodes are made to point to it, so if hash_of throws
+   * *this is left untouched.
+   */
+
+  template<typename HashOf>
+  void rehash(std::size_t n,const HashOf& hash_of)
+  {
+    hashed_flat_index_table cpy(ctrl_spc.get_allocator(),size_index(n));
+    for(pointer p=begin(),p_end=end();p!=p_end;++p){
+      if(*p!=value_type(0)){
+        std::size_t h=hash_of(*p);
+        pointer     q=cpy.available(h);
+        cpy.ctrls()[q-cpy.slots()]=fingerprint(h);
+        *q=*p;
+        ++cpy.size_;
+      }
+    }
+
+    *cpy.end()=*end();
+    for(pointer p=cpy.begin(),p_end=cpy.end()+1;p!=p_end;++p){
+      if(*p!=value_type(0))(*p)->up()=p;
+    }
+    swap(cpy);
+  }
+
+  void swap(hashed_flat_index_table& x)
+  {
+    std::swap(size_index_,x.size_index_);
+    std::swap(size_,x.size_);
+    std::swap(deleted_,x.deleted_);
+    ctrl_spc.swap(x.ctrl_spc);
+    slot_spc.swap(x.slot_spc);
+  }
+
+  template<typename BoolConstant>
+  void swap(hashed_flat_index_table& x,BoolConstant swap_allocators)
+  {
+    std::swap(size_index_,x.size_index_);
+    std::swap(size_,x.size_);
+    std::swap(deleted_,x.deleted_);
+    ctrl_spc.swap(x.ctrl_spc,swap_allocators);
+    slot_spc.swap(x.slot_spc,swap_allocators);
+  }
+
+private:
+  typedef auto_space<unsigned char,Allocator>  ctrl_space_type;
+  typedef typename ctrl_space_type::size_type  ctrl_size_type;
+  typedef auto_space<value_type,Allocator>     slot_space_type;
+  typedef typename slot_space_type::size_type  slot_size_type;
+
+  BOOST_STATIC_CONSTANT(
+    std::size_t,size_t_bits=sizeof(std::size_t)*CHAR_BIT);
+  BOOST_STATIC_CONSTANT(std::size_t,max_size_index=size_t_bits-12);
+
+#if ((((ULONG_MAX>>16)>>16)>>16)>>15)==0 /* unsigned long less than 64 bits */
+  BOOST_STATIC_CONSTANT(std::size_t,fibonacci_multiplier=2654435769ul);
+#else
+  BOOST_STATIC_CONSTANT(
+    std::size_t,fibonacci_multiplier=11400714819323198485ul);
+#endif
+
+  struct prober
+  {
+    prober(std::size_t pos_,std::size_t mask_):pos(pos_),step(0),mask(mask_){}
+
+    std::size_t get()const{return pos;}
+
+    /* triangular steps visit every group exactly once */
+
+    bool next()
+    {
+      if(step==mask)return false;
+      pos=(pos+(++step))&mask;
+      return true;
+    }
+
+  private:
+    std::size_t pos,step,mask;
+  };
+
+  hashed_flat_index_table(const Allocator& al,std::size_t si):
+    size_index_(si),
+    size_(0),
+    deleted_(0),
+    ctrl_spc(al,static_cast<ctrl_size_type>(capacity())),
+    slot_spc(al,static_cast<slot_size_type>(capacity()+1))
+  {
+    initialize();
+  }
+
+  static std::size_t size_index(std::size_t n)
+  {
+    std::size_t i=0;
+    while(i<max_size_index&&(group_type::size<<i)<n)++i;
+    return i;
+  }
+
+  std::size_t group_mask()const{return (std::size_t(1)<<size_index_)-1;}
+
+  std::size_t position(std::size_t h)const
+  {
+    /* bits below the fingerprint; the double shift avoids shifting by
+     * size_t_bits when there is only one group
+     */
+
+    return (((h*fibonacci_multiplier)<<7)>>1)>>(size_t_bits-1-size_index_);
+  }
+
+  static unsigned char fingerprint(std::size_t h)
+  {
+    return static_cast<unsigned char>(
+      (h*fibonacci_multiplier)>>(size_t_bits-7));
+  }
+
+  unsigned char* ctrls()const{return raw_ptr<unsigned char*>(ctrl_spc.data());}
+  pointer        slots()const{return slot_spc.data();}
+
+  void initialize()
+  {
+    std::memset(ctrls(),group_type::empty,capacity());
+    for(pointer p=begin(),p_end=end();p!=p_end;++p)*p=value_type(0);
+  }
+
+  std::size_t     size_index_;
+  std::size_t     size_;
+  std::size_t     deleted_;
+  ctrl_space_type ctrl_spc;
+  slot_space_type slot_spc;
+};
+
+template<typename Allocator>
+void swap(
+  hashed_flat_index_table<Allocator>& x,hashed_flat_index_table<Allocator>& y)
+{
+  x.swap(y);
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,138 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_HASH_FORWARD_INDEX_BUCKET_ARRAY_HPP
+#define BOOST_MULTI_INDEX_DETAIL_HASH_FORWARD_INDEX_BUCKET_ARRAY_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/auto_space.hpp>
+#include <boost/multi_index/detail/bucket_array.hpp>
+#include <boost/multi_index/detail/hash_forward_index_node.hpp>
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Bucket entries of forward hashed indices, with prime sizes as in
+ * bucket_array. The end node ending the last bucket is not part of the
+ * array: it is passed in by the index where needed.
+ */
+
+template<typename Allocator>
+class hashed_forward_index_bucket_array:bucket_array_base<>
+{
+  typedef bucket_array_base<>                        super;
+  typedef hashed_forward_index_node_impl<
+    typename rebind_alloc_for<
+      Allocator,
+      char
+    >::type
+  >                                                  node_impl_type;
+
+public:
+  typedef typename node_impl_type::pointer           pointer;
+
+  hashed_forward_index_bucket_array(
+    const Allocator& al,pointer end_,std::size_t size_):
+    size_index_(super::size_index(size_)),
+    spc(al,static_cast<auto_space_size_type>(super::size(size_index_)))
+  {
+    clear(end_);
+  }
+
+  std::size_t size()const
+  {
+    return super::size(size_index_);
+  }
+
+  std::size_t position(std::size_t hash)const
+  {
+    return super::position(hash,size_index_);
+  }
+
+  static std::size_t size_for(std::size_t size_)
+  {
+    return super::size(super::size_index(size_));
+  }
+
+  pointer begin()const{return buckets();}
+  pointer at(std::size_t n)const{return buckets()+n;}
+
+  /* bucket entry of node x */
+
+  pointer bucket_of(pointer x,pointer end_)const
+  {
+    pointer y=node_impl_type::chain_end(x);
+    return y==end_?at(size()-1):y-1;
+  }
+
+  /* entry (or end node) ending bucket n */
+
+  pointer next_of(std::size_t n,pointer end_)const
+  {
+    return n+1==size()?end_:at(n+1);
+  }
+
+  void clear(pointer end_)
+  {
+    for(std::size_t n=0,s=size();n!=s;++n){
+      at(n)->set_next(next_of(n,end_),true);
+    }
+    end_->set_next(end_,true);
+  }
+
+  void swap(hashed_forward_index_bucket_array& x)
+  {
+    std::swap(size_index_,x.size_index_);
+    spc.swap(x.spc);
+  }
+
+  template<typename BoolConstant>
+  void swap(hashed_forward_index_bucket_array& x,BoolConstant swap_allocators)
+  {
+    std::swap(size_index_,x.size_index_);
+    spc.swap(x.spc,swap_allocators);
+  }
+
+private:
+  typedef auto_space<node_impl_type,Allocator>      auto_space_type;
+  typedef typename auto_space_type::size_type       auto_space_size_type;
+
+  std::size_t      size_index_;
+  auto_space_type  spc;
+
+  pointer buckets()const
+  {
+    return spc.data();
+  }
+};
+
+template<typename Allocator>
+void swap(
+  hashed_forward_index_bucket_array<Allocator>& x,
+  hashed_forward_index_bucket_array<Allocator>& y)
+{
+  x.swap(y);
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,287 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_HASH_FORWARD_INDEX_NODE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_HASH_FORWARD_INDEX_NODE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/mpl/if.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/multi_index/detail/uintptr_type.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Forward hashed indices link their nodes in a single list with one pointer
+ * per node. Buckets are entries with the same layout as the node headers,
+ * threaded into the list in front of the nodes they hold, and the last node
+ * of a bucket (or the bucket entry itself if empty) points to the entry of
+ * the following bucket, marking the link as such:
+ *
+ *   +----+   +---+   +---+   +----+   +----+   +---+
+ *   | B0 +-->| N +-->| N +-->| B1 +-->| B2 +-->| N +--> ... --> end
+ *   +----+   +---+   +---+ * +----+ * +----+   +---+ *
+ *
+ * (* denotes a bucket-ending link.) The last bucket ends at the header node,
+ * which points to itself. So, lookup stops at the first bucket-ending link
+ * and the bucket of a node is found by walking to the end of its chain,
+ * without hashing, which is what erasure needs to reach the predecessor
+ * of the node from its bucket entry.
+ * The bucket-ending mark is kept in the least significant bit of the next
+ * pointer when possible, in which case nodes carry exactly one pointer.
+ */
+
+template<typename Allocator>
+struct hashed_forward_index_node_impl; /* fwd decl. */
+
+template<typename Allocator>
+struct hashed_forward_index_node_traits
+{
+  typedef typename rebind_alloc_for<
+    Allocator,
+    hashed_forward_index_node_impl<Allocator>
+  >::type                                            allocator;
+  typedef allocator_traits<allocator>                alloc_traits;
+  typedef typename alloc_traits::pointer             pointer;
+  typedef typename alloc_traits::const_pointer       const_pointer;
+  typedef typename alloc_traits::difference_type     difference_type;
+};
+
+template<typename Allocator>
+struct hashed_forward_index_node_std_base
+{
+  typedef hashed_forward_index_node_traits<
+    Allocator>                                  node_traits;
+  typedef typename node_traits::pointer         pointer;
+  typedef typename node_traits::const_pointer   const_pointer;
+  typedef typename node_traits::difference_type difference_type;
+
+  pointer next()const{return next_;}
+  bool    last()const{return last_;}
+
+  void set_next(pointer x,bool l)
+  {
+    next_=x;
+    last_=l;
+  }
+
+private:
+  pointer next_;
+  bool    last_;
+};
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_COMPRESSED_HASHED_FORWARD_INDEX_NODES)
+/* As with compressed ordered index nodes, the bucket-ending mark is stored
+ * in the least significant bit of the next pointer if
+ * hashed_forward_index_node_impl has even alignment.
+ */
+
+#if defined(BOOST_MSVC)
+#pragma warning(push)
+#pragma warning(disable:4312 4311)
+#endif
+
+template<typename Allocator>
+struct hashed_forward_index_node_compressed_base
+{
+  typedef hashed_forward_index_node_traits<
+    Allocator>                                  node_traits;
+  typedef hashed_forward_index_node_impl<
+    Allocator>*                                 pointer;
+  typedef const hashed_forward_index_node_impl<
+    Allocator>*                                 const_pointer;
+  typedef typename node_traits::difference_type difference_type;
+
+  pointer next()const
+  {
+    return (pointer)(void*)(nextlast_&~uintptr_type(1));
+  }
+
+  bool last()const
+  {
+    return (nextlast_&uintptr_type(1))!=0;
+  }
+
+  void set_next(pointer x,bool l)
+  {
+    nextlast_=((uintptr_type)(void*)x)|uintptr_type(l);
+  }
+
+private:
+  uintptr_type nextlast_;
+};
+
+#if defined(BOOST_MSVC)
+#pragma warning(pop)
+#endif
+#endif
+
+template<typename Allocator>
+struct hashed_forward_index_node_impl_base:
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_COMPRESSED_HASHED_FORWARD_INDEX_NODES)
+  mpl::if_c<
+    !(has_uintptr_type::value)||
+    (alignment_of<
+      hashed_forward_index_node_compressed_base<Allocator>
+     >::value%2)||
+    !(is_same<
+      typename hashed_forward_index_node_traits<Allocator>::pointer,
+      hashed_forward_index_node_impl<Allocator>*>::value),
+    hashed_forward_index_node_std_base<Allocator>,
+    hashed_forward_index_node_compressed_base<Allocator>
+  >::type
+#else
+  hashed_forward_index_node_std_base<Allocator>
+#endif
+
+{};
+
+template<typename Allocator>
+struct hashed_forward_index_node_impl:
+  hashed_forward_index_node_impl_base<Allocator>
+{
+private:
+  typedef hashed_forward_index_node_impl_base<Allocator> super;
+
+public:
+  typedef typename super::pointer                        pointer;
+  typedef typename super::const_pointer                  const_pointer;
+  typedef typename super::difference_type                difference_type;
+
+  /* interoperability with hashed_flat_index_iterator */
+
+  static void increment(pointer& x)
+  {
+    x=x->last()?first(x->next()):x->next();
+  }
+
+  /* first node from bucket entry x onwards, or the end node */
+
+  static pointer first(pointer x)
+  {
+    while(x->last()&&x->next()!=x)x=x->next();
+    return x->last()?x:x->next();
+  }
+
+  /* entry (or end node) the bucket chain of x links to */
+
+  static pointer chain_end(pointer x)
+  {
+    while(!x->last())x=x->next();
+    return x->next();
+  }
+
+  /* algorithmic stuff */
+
+  static void link(pointer x,pointer buc)
+  {
+    x->set_next(buc->next(),buc->last());
+    buc->set_next(x,false);
+  }
+
+  /* returns the predecessor of x, for use by relink */
+
+  static pointer unlink(pointer x,pointer buc)
+  {
+    while(buc->next()!=x)buc=buc->next();
+    buc->set_next(x->next(),x->last());
+    return buc;
+  }
+
+  static void relink(pointer x,pointer prev)
+  {
+    prev->set_next(x,false);
+  }
+};
+
+template<typename Super>
+struct hashed_forward_index_node_trampoline:
+  hashed_forward_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  >
+{
+  typedef hashed_forward_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  > impl_type;
+};
+
+template<typename Super>
+struct hashed_forward_index_node:
+  Super,hashed_forward_index_node_trampoline<Super>
+{
+private:
+  typedef hashed_forward_index_node_trampoline<Super> trampoline;
+
+public:
+  typedef typename trampoline::impl_type         impl_type;
+  typedef typename trampoline::pointer           impl_pointer;
+  typedef typename trampoline::const_pointer     const_impl_pointer;
+  typedef typename trampoline::difference_type   difference_type;
+
+  impl_pointer impl()
+  {
+    return static_cast<impl_pointer>(
+      static_cast<impl_type*>(static_cast<trampoline*>(this)));
+  }
+
+  const_impl_pointer impl()const
+  {
+    return static_cast<const_impl_pointer>(
+      static_cast<const impl_type*>(static_cast<const trampoline*>(this)));
+  }
+
+  static hashed_forward_index_node* from_impl(impl_pointer x)
+  {
+    return
+      static_cast<hashed_forward_index_node*>(
+        static_cast<trampoline*>(
+          raw_ptr<impl_type*>(x)));
+  }
+
+  static const hashed_forward_index_node* from_impl(const_impl_pointer x)
+  {
+    return
+      static_cast<const hashed_forward_index_node*>(
+        static_cast<const trampoline*>(
+          raw_ptr<const impl_type*>(x)));
+  }
+
+  /* interoperability with hashed_flat_index_iterator */
+
+  static void increment(hashed_forward_index_node*& x)
+  {
+    impl_pointer xi=x->impl();
+    trampoline::increment(xi);
+    x=from_impl(xi);
+  }
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -1,4 +1,4 @@
-/* Copyright 2003-2013 Joaquin M Lopez Munoz.
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
  * Distributed under the Boost Software License, Version 1.0.
  * (See accompanying file LICENSE_1_0.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt)
@@ -16,9 +16,11 @@
 #include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
 #include <boost/functional/hash.hpp>
 #include <boost/mpl/aux_/na.hpp>
+#include <boost/mpl/bool.hpp>
 #include <boost/mpl/eval_if.hpp>
 #include <boost/mpl/identity.hpp>
 #include <boost/mpl/if.hpp>
+#include <boost/multi_index/hashed_index_options.hpp>
 #include <boost/multi_index/tag.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/type_traits/is_same.hpp>
@@ -35,13 +37,17 @@ namespace detail{
  *   (hashed_unique|hashed_non_unique)<
  *     KeyFromValue,
  *     Hash=boost::hash<KeyFromValue::result_type>,
- *     Pred=std::equal_to<KeyFromValue::result_type> >
+ *     Pred=std::equal_to<KeyFromValue::result_type>,
+ *     Options=mpl::na >
  *   (hashed_unique|hashed_non_unique)<
  *     TagList,
  *     KeyFromValue,
  *     Hash=boost::hash<KeyFromValue::result_type>,
- *     Pred=std::equal_to<KeyFromValue::result_type> >
+ *     Pred=std::equal_to<KeyFromValue::result_type>,
+ *     Options=mpl::na >
  *
+ * where Options, if present, can take the place of Hash or Pred, which
+ * then assume their default values.
  * hashed_index_args implements the machinery to accept this
  * argument-dependent polymorphism.
  */
@@ -58,7 +64,9 @@ struct index_args_default_pred
   typedef std::equal_to<typename KeyFromValue::result_type> type;
 };
 
-template<typename Arg1,typename Arg2,typename Arg3,typename Arg4>
+template<
+  typename Arg1,typename Arg2,typename Arg3,typename Arg4,typename Arg5
+>
 struct hashed_index_args
 {
   typedef is_tag<Arg1> full_form;
@@ -74,26 +82,62 @@ struct hashed_index_args
   typedef typename mpl::if_<
     full_form,
     Arg3,
-    Arg2>::type                                      supplied_hash_type;
+    Arg2>::type                                      hash_arg;
+  typedef typename mpl::if_<
+    full_form,
+    Arg4,
+    Arg3>::type                                      pred_arg;
+  typedef typename mpl::if_<
+    full_form,
+    Arg5,
+    Arg4>::type                                      options_arg;
+  typedef mpl::bool_<
+    is_hashed_index_option<hash_arg>::value>         options_at_hash;
+  typedef mpl::bool_<
+    options_at_hash::value||
+    is_hashed_index_option<pred_arg>::value>         options_at_pred;
+  typedef typename mpl::if_<
+    options_at_hash,
+    mpl::na,
+    hash_arg>::type                                  supplied_hash_type;
   typedef typename mpl::eval_if<
     mpl::is_na<supplied_hash_type>,
     index_args_default_hash<key_from_value_type>,
     mpl::identity<supplied_hash_type>
   >::type                                            hash_type;
   typedef typename mpl::if_<
-    full_form,
-    Arg4,
-    Arg3>::type                                      supplied_pred_type;
+    options_at_pred,
+    mpl::na,
+    pred_arg>::type                                  supplied_pred_type;
   typedef typename mpl::eval_if<
     mpl::is_na<supplied_pred_type>,
     index_args_default_pred<key_from_value_type>,
     mpl::identity<supplied_pred_type>
   >::type                                            pred_type;
+  typedef typename mpl::if_<
+    options_at_hash,
+    hash_arg,
+    typename mpl::if_<
+      options_at_pred,
+      pred_arg,
+      options_arg>::type
+  >::type                                            supplied_options_type;
+  typedef typename hashed_index_options_traits<
+    supplied_options_type>::type                     options_type;
 
   BOOST_STATIC_ASSERT(is_tag<tag_list_type>::value);
   BOOST_STATIC_ASSERT(!mpl::is_na<key_from_value_type>::value);
   BOOST_STATIC_ASSERT(!mpl::is_na<hash_type>::value);
   BOOST_STATIC_ASSERT(!mpl::is_na<pred_type>::value);
+  BOOST_STATIC_ASSERT(
+    mpl::is_na<supplied_options_type>::value||
+    is_hashed_index_option<supplied_options_type>::value);
+  BOOST_STATIC_ASSERT(
+    !options_at_hash::value||
+    (mpl::is_na<pred_arg>::value&&mpl::is_na<options_arg>::value));
+  BOOST_STATIC_ASSERT(
+    options_at_hash::value||!options_at_pred::value||
+    mpl::is_na<options_arg>::value);
 };
 
 } /* namespace multi_index::detail */
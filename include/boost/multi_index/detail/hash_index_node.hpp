@@ -1,4 +1,4 @@
-/* Copyright 2003-2020 Joaquin M Lopez Munoz.
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
  * Distributed under the Boost Software License, Version 1.0.
  * (See accompanying file LICENSE_1_0.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt)
@@ -16,6 +16,8 @@
 #include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
 #include <boost/multi_index/detail/allocator_traits.hpp>
 #include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/multi_index/hashed_index_options.hpp>
+#include <cstddef>
 #include <utility>
 
 namespace boost{
@@ -366,6 +368,11 @@ struct hashed_index_node_alg<Node,hashed_non_unique_tag>
       x->next()->prior()->prior()->next()==base_pointer_from(x);
   }
 
+  static bool is_last_of_bucket(pointer x)
+  {
+    return x->next()->prior()->prior()==x;
+  }
+
   static pointer after(pointer x)
   {
     if(x->next()->prior()==x)return pointer_from(x->next());
@@ -590,11 +597,6 @@ private:
     return Node::base_pointer_from(x);
   }
 
-  static bool is_last_of_bucket(pointer x)
-  {
-    return x->next()->prior()->prior()==x;
-  }
-
   template<typename Assigner>
   static void left_unlink(pointer x,Assigner& assign)
   {
@@ -700,12 +702,53 @@ struct hashed_index_node_trampoline:
   typedef hashed_index_node_impl<impl_allocator_type> impl_type;
 };
 
+/* Optional storage for the hash value of the element, see store_hash.
+ * Super is used as a discriminant so that empty instances belonging to
+ * different indices do not defeat the empty base optimization.
+ */
+
+template<typename Super,bool StoresHash>
+struct hashed_index_node_hash{};
+
 template<typename Super>
+struct hashed_index_node_hash<Super,true>
+{
+  std::size_t&      stored_hash(){return hash_;}
+  std::size_t       stored_hash()const{return hash_;}
+
+private:
+  std::size_t hash_;
+};
+
+/* Optional storage for the size of the group of equivalent elements a node
+ * belongs to, see store_group_size: it is kept by the first node of each
+ * group, and is zero for the rest.
+ */
+
+template<typename Super,bool StoresGroupSize>
+struct hashed_index_node_group_size{};
+
+template<typename Super>
+struct hashed_index_node_group_size<Super,true>
+{
+  std::size_t&      group_size(){return size_;}
+  std::size_t       group_size()const{return size_;}
+
+private:
+  std::size_t size_;
+};
+
+template<typename Super,typename Options=default_hashed_index_options>
 struct hashed_index_node:
-  Super,hashed_index_node_trampoline<Super>
+  Super,hashed_index_node_trampoline<Super>,
+  hashed_index_node_hash<Super,Options::stores_hash>,
+  hashed_index_node_group_size<Super,Options::stores_group_size>
 {
 private:
-  typedef hashed_index_node_trampoline<Super> trampoline;
+  typedef hashed_index_node_trampoline<Super>                trampoline;
+  typedef hashed_index_node_hash<Super,Options::stores_hash> hash_holder;
+  typedef hashed_index_node_group_size<
+    Super,Options::stores_group_size>                        group_size_holder;
 
 public:
   typedef typename trampoline::impl_type          impl_type;
@@ -725,6 +768,16 @@ public:
   impl_base_pointer& next(){return trampoline::next();}
   impl_base_pointer  next()const{return trampoline::next();}
 
+  /* only usable if Options::stores_hash */
+
+  std::size_t& stored_hash(){return hash_holder::stored_hash();}
+  std::size_t  stored_hash()const{return hash_holder::stored_hash();}
+
+  /* only usable if Options::stores_group_size */
+
+  std::size_t& group_size(){return group_size_holder::group_size();}
+  std::size_t  group_size()const{return group_size_holder::group_size();}
+
   impl_pointer impl()
   {
     return static_cast<impl_pointer>(
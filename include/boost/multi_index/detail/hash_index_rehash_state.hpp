@@ -0,0 +1,109 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_HASH_INDEX_REHASH_STATE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_HASH_INDEX_REHASH_STATE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/mpl/if.hpp>
+#include <boost/multi_index/detail/bucket_array.hpp>
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* State of an incremental rehash of a hashed index, as described in
+ * hashed_index.hpp. Hashed indices derive from it so that, for those not
+ * rehashing incrementally, the empty specialization takes no space; Index
+ * is the deriving index, which keeps the bases of different hashed indices
+ * of a container distinct.
+ */
+
+template<
+  typename Index,typename Allocator,typename Options,
+  bool Incremental=Options::rehashes_incrementally
+>
+struct hashed_index_rehash_state
+{
+  typedef bucket_array<
+    Allocator,
+    typename mpl::if_c<
+      Options::pow2_buckets,
+      pow2_bucket_array_base,
+      bucket_array_base<>
+    >::type
+  >                                      bucket_array_type;
+
+  template<typename ValueAllocator>
+  explicit hashed_index_rehash_state(const ValueAllocator& al):
+    old_buckets(al),next(0),step(0),
+    spare_buckets(al),initialized(0),chunk(0){}
+
+  void swap(hashed_index_rehash_state& x)
+  {
+    old_buckets.swap(x.old_buckets);
+    std::swap(next,x.next);
+    std::swap(step,x.step);
+    spare_buckets.swap(x.spare_buckets);
+    std::swap(initialized,x.initialized);
+    std::swap(chunk,x.chunk);
+  }
+
+  template<typename BoolConstant>
+  void swap(hashed_index_rehash_state& x,BoolConstant swap_allocators)
+  {
+    old_buckets.swap(x.old_buckets,swap_allocators);
+    std::swap(next,x.next);
+    std::swap(step,x.step);
+    spare_buckets.swap(x.spare_buckets,swap_allocators);
+    std::swap(initialized,x.initialized);
+    std::swap(chunk,x.chunk);
+  }
+
+  bucket_array_type old_buckets;
+  std::size_t       next,step;
+  bucket_array_type spare_buckets;
+  std::size_t       initialized,chunk;
+};
+
+template<typename Index,typename Allocator,typename Options>
+struct hashed_index_rehash_state<Index,Allocator,Options,false>
+{
+  typedef bucket_array<
+    Allocator,
+    typename mpl::if_c<
+      Options::pow2_buckets,
+      pow2_bucket_array_base,
+      bucket_array_base<>
+    >::type
+  >                                      bucket_array_type;
+
+  template<typename ValueAllocator>
+  explicit hashed_index_rehash_state(const ValueAllocator&){}
+
+  void swap(hashed_index_rehash_state&){}
+
+  template<typename BoolConstant>
+  void swap(hashed_index_rehash_state&,BoolConstant){}
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
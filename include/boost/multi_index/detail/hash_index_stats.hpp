@@ -0,0 +1,60 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_HASH_INDEX_STATS_HPP
+#define BOOST_MULTI_INDEX_DETAIL_HASH_INDEX_STATS_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Distribution of the elements of a hashed index among its buckets, as
+ * returned by hashed_index::stats(). chain_length_histogram[i] is the number
+ * of buckets holding i elements, save for the last entry, which counts all
+ * buckets with chain_length_histogram_size-1 elements or more.
+ */
+
+struct hashed_index_stats
+{
+  BOOST_STATIC_CONSTANT(std::size_t,chain_length_histogram_size=16);
+
+  hashed_index_stats():
+    bucket_count(0),empty_bucket_count(0),max_chain_length(0),
+    group_count(0),max_group_size(0),bucket_bytes(0),node_bytes(0)
+  {
+    for(std::size_t i=0;i<chain_length_histogram_size;++i){
+      chain_length_histogram[i]=0;
+    }
+  }
+
+  std::size_t bucket_count;
+  std::size_t empty_bucket_count;
+  std::size_t chain_length_histogram[chain_length_histogram_size];
+  std::size_t max_chain_length;
+  std::size_t group_count;     /* groups of equivalent elements */
+  std::size_t max_group_size;
+  std::size_t bucket_bytes;
+  std::size_t node_bytes;
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -182,6 +182,14 @@ protected:
 
   bool check_rollback_(index_node_type*)const{return true;}
 
+  /* Insertion of a range of elements is bracketed by these so that indices
+   * can take advantage of elements coming in order. Indices not interested
+   * need not implement them.
+   */
+
+  void bulk_insert_begin_(){}
+  void bulk_insert_end_(){}
+
 #if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
   /* serialization */
 
@@ -229,6 +237,14 @@ protected:
     return final().emplace_(BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
   }
 
+  template<typename Variant,BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
+  std::pair<final_node_type*,bool> final_emplace_variant_(
+    Variant variant,BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
+  {
+    return final().emplace_variant_(
+      variant,BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
+  }
+
   std::pair<final_node_type*,bool> final_insert_(
     const value_type& x,final_node_type* position)
     {return final().insert_(x,position);}
@@ -266,6 +282,10 @@ protected:
   void final_delete_all_nodes_(){final().delete_all_nodes_();}
   void final_clear_(){final().clear_();}
 
+  void final_bulk_insert_begin_(){final().bulk_insert_begin_();}
+  void final_bulk_insert_end_(){final().bulk_insert_end_();}
+  void final_set_size_(size_type n){final().set_size_(n);}
+
   void final_swap_(final_type& x){final().swap_(x);}
 
   bool final_replace_(
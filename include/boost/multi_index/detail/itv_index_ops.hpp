@@ -0,0 +1,238 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ITV_INDEX_OPS_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ITV_INDEX_OPS_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <iterator>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Interval indices are augmented indices sorted by start point whose
+ * summary is the maximum end point of the elements involved.
+ */
+
+template<typename Key,typename Compare>
+struct interval_end_summary
+{
+  Key  end;
+  bool empty;
+};
+
+template<typename Key,typename Compare>
+inline bool operator==(
+  const interval_end_summary<Key,Compare>& x,
+  const interval_end_summary<Key,Compare>& y)
+{
+  if(x.empty||y.empty)return x.empty==y.empty;
+  Compare comp;
+  return !comp(x.end,y.end)&&!comp(y.end,x.end);
+}
+
+template<typename EndKeyFromValue,typename Compare>
+struct interval_max_end
+{
+  typedef typename remove_cv<
+    typename remove_reference<
+      typename EndKeyFromValue::result_type
+    >::type
+  >::type                                         end_type;
+  typedef interval_end_summary<end_type,Compare>  result_type;
+
+  result_type operator()()const
+  {
+    result_type res;
+    res.end=end_type();
+    res.empty=true;
+    return res;
+  }
+
+  template<typename Value>
+  result_type operator()(const Value& x)const
+  {
+    result_type res;
+    res.end=EndKeyFromValue()(x);
+    res.empty=false;
+    return res;
+  }
+
+  result_type operator()(const result_type& x,const result_type& y)const
+  {
+    if(x.empty)return y;
+    if(y.empty)return x;
+    return Compare()(x.end,y.end)?y:x;
+  }
+};
+
+/* Search for the elements [start,end] with !(b<start) and !(end<a), in
+ * order of start point. Subtrees whose maximum end point goes before a
+ * are skipped, and the traversal stops at the first start point after b.
+ */
+
+template<
+  typename Node,typename KeyFromValue,typename Compare,typename Key
+>
+struct interval_overlap_query
+{
+  typedef typename Node::impl_pointer impl_pointer;
+
+  interval_overlap_query(
+    Node* header_,const KeyFromValue& key_,const Compare& comp_,
+    const Key& a_,const Key& b_):
+    header(header_),key(key_),comp(comp_),a(a_),b(b_)
+  {}
+
+  Node* first()const
+  {
+    impl_pointer x=first(impl_pointer(header->parent()));
+    return x!=impl_pointer(0)?Node::from_impl(x):header;
+  }
+
+  Node* next(Node* x)const
+  {
+    impl_pointer y=next(x->impl());
+    return y!=impl_pointer(0)?Node::from_impl(y):header;
+  }
+
+  Node*        header;
+  KeyFromValue key;
+  Compare      comp;
+  Key          a,b;
+
+private:
+  bool starts_after(impl_pointer x)const
+  {
+    return comp(b,key(Node::from_impl(x)->value()));
+  }
+
+  bool ends_before(impl_pointer x)const
+  {
+    return comp(x->element_summary.end,a);
+  }
+
+  bool all_end_before(impl_pointer x)const
+  {
+    return x==impl_pointer(0)||comp(x->summary.end,a);
+  }
+
+  /* first overlapping element of the subtree of x */
+
+  impl_pointer first(impl_pointer x)const
+  {
+    while(x!=impl_pointer(0)){
+      if(!all_end_before(x->left()))x=x->left();
+      else if(starts_after(x))break;
+      else if(!ends_before(x))return x;
+      else if(!all_end_before(x->right()))x=x->right();
+      else break;
+    }
+    return impl_pointer(0);
+  }
+
+  /* first overlapping element after x in the index */
+
+  impl_pointer next(impl_pointer x)const
+  {
+    impl_pointer h=header->impl();
+    if(!all_end_before(x->right())){
+      impl_pointer y=first(impl_pointer(x->right()));
+      if(y!=impl_pointer(0))return y;
+    }
+    for(;;){
+      impl_pointer y=x->parent();
+      while(y!=h&&x==y->right()){
+        x=y;
+        y=y->parent();
+      }
+      if(y==h||starts_after(y))return impl_pointer(0);
+      if(!ends_before(y))return y;
+      if(!all_end_before(y->right())){
+        impl_pointer z=first(impl_pointer(y->right()));
+        if(z!=impl_pointer(0))return z;
+      }
+      x=y;
+    }
+  }
+};
+
+template<typename Node,typename Query>
+class interval_overlap_iterator
+{
+public:
+  typedef typename Node::value_type        value_type;
+  typedef typename Node::difference_type   difference_type;
+  typedef const typename Node::value_type* pointer;
+  typedef const typename Node::value_type& reference;
+  typedef std::forward_iterator_tag        iterator_category;
+
+  interval_overlap_iterator(Node* node_,const Query& q_):node(node_),q(q_){}
+
+  reference operator*()const
+  {
+    return node->value();
+  }
+
+  pointer operator->()const
+  {
+    return &node->value();
+  }
+
+  interval_overlap_iterator& operator++()
+  {
+    node=q.next(node);
+    return *this;
+  }
+
+  interval_overlap_iterator operator++(int)
+  {
+    interval_overlap_iterator tmp(*this);
+    ++(*this);
+    return tmp;
+  }
+
+  Node* get_node()const{return node;}
+
+private:
+  Node* node;
+  Query q;
+};
+
+template<typename Node,typename Query>
+bool operator==(
+  const interval_overlap_iterator<Node,Query>& x,
+  const interval_overlap_iterator<Node,Query>& y)
+{
+  return x.get_node()==y.get_node();
+}
+
+template<typename Node,typename Query>
+bool operator!=(
+  const interval_overlap_iterator<Node,Query>& x,
+  const interval_overlap_iterator<Node,Query>& y)
+{
+  return !(x==y);
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,208 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_BTREE_INDEX_NODE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_BTREE_INDEX_NODE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Elements of B+tree ordered indices are not linked to one another: they
+ * are pointed to from the slots of leaf pages, and each node records the
+ * leaf page and slot holding it, much as random access index nodes point
+ * back to their position in the pointer array. Leaf pages are doubly
+ * linked in a circular list closed by a sentinel page whose only slot
+ * holds the header, so that traversal amounts to stepping through the
+ * slots of a page and then moving on to the next one.
+ *
+ * Besides the slots, every page records the number of slots in use and
+ * its parent inner page. Slot i of an inner page points to the first
+ * element of the subtree rooted at children[i].
+ */
+
+template<typename Allocator>
+struct ordered_btree_index_node_impl;
+
+template<typename Allocator>
+struct ordered_btree_inner_base;
+
+template<typename Allocator>
+struct ordered_btree_page_base
+{
+  typedef ordered_btree_index_node_impl<Allocator> node_impl_type;
+  typedef typename node_impl_type::pointer         node_impl_pointer;
+  typedef ordered_btree_inner_base<Allocator>      inner_base;
+
+  BOOST_STATIC_CONSTANT(std::size_t,capacity=32);
+
+  std::size_t       size;
+  inner_base*       parent;
+  node_impl_pointer nodes[capacity];
+};
+
+template<typename Allocator>
+struct ordered_btree_leaf_base:ordered_btree_page_base<Allocator>
+{
+  ordered_btree_leaf_base* prev;
+  ordered_btree_leaf_base* next;
+};
+
+template<typename Allocator>
+struct ordered_btree_inner_base:ordered_btree_page_base<Allocator>
+{
+  typedef ordered_btree_page_base<Allocator> page_base;
+
+  page_base* children[page_base::capacity];
+};
+
+template<typename Allocator>
+struct ordered_btree_index_node_impl
+{
+  typedef typename rebind_alloc_for<
+    Allocator,ordered_btree_index_node_impl
+  >::type                                             node_allocator;
+  typedef allocator_traits<node_allocator>            node_alloc_traits;
+  typedef typename node_alloc_traits::pointer         pointer;
+  typedef typename node_alloc_traits::const_pointer   const_pointer;
+  typedef typename node_alloc_traits::difference_type difference_type;
+  typedef ordered_btree_leaf_base<Allocator>          leaf_base;
+
+  leaf_base*&  leaf(){return leaf_;}
+  leaf_base*   leaf()const{return leaf_;}
+  std::size_t& pos(){return pos_;}
+  std::size_t  pos()const{return pos_;}
+
+  /* interoperability with bidir_node_iterator */
+
+  static void increment(pointer& x)
+  {
+    leaf_base*  l=x->leaf();
+    std::size_t n=x->pos()+1;
+    if(n==l->size){
+      l=l->next;
+      n=0;
+    }
+    x=l->nodes[n];
+  }
+
+  static void decrement(pointer& x)
+  {
+    leaf_base*  l=x->leaf();
+    std::size_t n=x->pos();
+    if(n==0){
+      l=l->prev;
+      n=l->size;
+    }
+    x=l->nodes[n-1];
+  }
+
+private:
+  leaf_base*  leaf_;
+  std::size_t pos_;
+};
+
+template<typename Super>
+struct ordered_btree_index_node_trampoline:
+  ordered_btree_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  >
+{
+  typedef ordered_btree_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  > impl_type;
+};
+
+template<typename Super>
+struct ordered_btree_index_node:
+  Super,ordered_btree_index_node_trampoline<Super>
+{
+private:
+  typedef ordered_btree_index_node_trampoline<Super> trampoline;
+
+public:
+  typedef typename trampoline::impl_type       impl_type;
+  typedef typename trampoline::pointer         impl_pointer;
+  typedef typename trampoline::const_pointer   const_impl_pointer;
+  typedef typename trampoline::difference_type difference_type;
+  typedef typename trampoline::leaf_base       impl_leaf_base;
+
+  impl_leaf_base*& leaf(){return trampoline::leaf();}
+  impl_leaf_base*  leaf()const{return trampoline::leaf();}
+  std::size_t&     pos(){return trampoline::pos();}
+  std::size_t      pos()const{return trampoline::pos();}
+
+  impl_pointer impl()
+  {
+    return static_cast<impl_pointer>(
+      static_cast<impl_type*>(static_cast<trampoline*>(this)));
+  }
+
+  const_impl_pointer impl()const
+  {
+    return static_cast<const_impl_pointer>(
+      static_cast<const impl_type*>(static_cast<const trampoline*>(this)));
+  }
+
+  static ordered_btree_index_node* from_impl(impl_pointer x)
+  {
+    return
+      static_cast<ordered_btree_index_node*>(
+        static_cast<trampoline*>(
+          raw_ptr<impl_type*>(x)));
+  }
+
+  static const ordered_btree_index_node* from_impl(const_impl_pointer x)
+  {
+    return
+      static_cast<const ordered_btree_index_node*>(
+        static_cast<const trampoline*>(
+          raw_ptr<const impl_type*>(x)));
+  }
+
+  /* interoperability with bidir_node_iterator */
+
+  static void increment(ordered_btree_index_node*& x)
+  {
+    impl_pointer xi=x->impl();
+    trampoline::increment(xi);
+    x=from_impl(xi);
+  }
+
+  static void decrement(ordered_btree_index_node*& x)
+  {
+    impl_pointer xi=x->impl();
+    trampoline::decrement(xi);
+    x=from_impl(xi);
+  }
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
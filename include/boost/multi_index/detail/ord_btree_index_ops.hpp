@@ -0,0 +1,269 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_BTREE_INDEX_OPS_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_BTREE_INDEX_OPS_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/mpl/and.hpp>
+#include <boost/multi_index/detail/promotes_arg.hpp>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Lookup in B+tree ordered indices is expressed in terms of
+ * ordered_btree_index_tree::partition_point, with predicates telling
+ * whether a key goes before the position sought. As in ord_index_ops.hpp,
+ * CompatibleKey is promoted to KeyFromValue::result_type in advance when
+ * the comparison would do it anyway.
+ */
+
+template<typename CompatibleKey,typename CompatibleCompare>
+struct ordered_btree_less_than
+{
+  ordered_btree_less_than(
+    const CompatibleKey& x_,const CompatibleCompare& comp_):
+    x(x_),comp(comp_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return comp(k,x);}
+
+private:
+  const CompatibleKey&     x;
+  const CompatibleCompare& comp;
+};
+
+template<typename CompatibleKey,typename CompatibleCompare>
+struct ordered_btree_not_greater_than
+{
+  ordered_btree_not_greater_than(
+    const CompatibleKey& x_,const CompatibleCompare& comp_):
+    x(x_),comp(comp_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return !comp(x,k);}
+
+private:
+  const CompatibleKey&     x;
+  const CompatibleCompare& comp;
+};
+
+template<typename LowerBounder>
+struct ordered_btree_below_lower
+{
+  ordered_btree_below_lower(const LowerBounder& lower_):lower(lower_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return !lower(k);}
+
+private:
+  const LowerBounder& lower;
+};
+
+template<typename UpperBounder>
+struct ordered_btree_within_upper
+{
+  ordered_btree_within_upper(const UpperBounder& upper_):upper(upper_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return upper(k);}
+
+private:
+  const UpperBounder& upper;
+};
+
+template<typename Tree,typename Pred>
+inline typename Tree::index_node_type* ordered_btree_index_partition_point(
+  const Tree& tree,const Pred& pred)
+{
+  return Tree::index_node_type::from_impl(
+    Tree::at(tree.partition_point(pred)));
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::index_node_type* ordered_btree_index_find(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_btree_index_find(
+    tree,key,x,comp,
+    mpl::and_<
+      promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>,
+      promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey> >());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline typename Tree::index_node_type* ordered_btree_index_find(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_btree_index_find(tree,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::index_node_type* ordered_btree_index_find(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  typedef typename Tree::index_node_type node_type;
+
+  node_type* y0=node_type::from_impl(Tree::at(tree.end(),0));
+  node_type* y=ordered_btree_index_partition_point(
+    tree,ordered_btree_less_than<CompatibleKey,CompatibleCompare>(x,comp));
+  return (y==y0||comp(x,key(y->value())))?y0:y;
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::index_node_type* ordered_btree_index_lower_bound(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_btree_index_lower_bound(
+    tree,key,x,comp,
+    promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey>());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline typename Tree::index_node_type* ordered_btree_index_lower_bound(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_btree_index_lower_bound(tree,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::index_node_type* ordered_btree_index_lower_bound(
+  const Tree& tree,const KeyFromValue&,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  return ordered_btree_index_partition_point(
+    tree,ordered_btree_less_than<CompatibleKey,CompatibleCompare>(x,comp));
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::index_node_type* ordered_btree_index_upper_bound(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_btree_index_upper_bound(
+    tree,key,x,comp,
+    promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline typename Tree::index_node_type* ordered_btree_index_upper_bound(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_btree_index_upper_bound(tree,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::index_node_type* ordered_btree_index_upper_bound(
+  const Tree& tree,const KeyFromValue&,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  return ordered_btree_index_partition_point(
+    tree,
+    ordered_btree_not_greater_than<CompatibleKey,CompatibleCompare>(x,comp));
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline std::pair<
+  typename Tree::index_node_type*,typename Tree::index_node_type*>
+ordered_btree_index_equal_range(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_btree_index_equal_range(
+    tree,key,x,comp,
+    mpl::and_<
+      promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>,
+      promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey> >());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline std::pair<
+  typename Tree::index_node_type*,typename Tree::index_node_type*>
+ordered_btree_index_equal_range(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_btree_index_equal_range(tree,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline std::pair<
+  typename Tree::index_node_type*,typename Tree::index_node_type*>
+ordered_btree_index_equal_range(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  typedef typename Tree::index_node_type node_type;
+
+  node_type* y0=node_type::from_impl(Tree::at(tree.end(),0));
+  node_type* y=ordered_btree_index_lower_bound(
+    tree,key,x,comp,mpl::false_());
+  if(y==y0||comp(x,key(y->value()))){
+    return std::pair<node_type*,node_type*>(y,y);
+  }
+  return std::pair<node_type*,node_type*>(
+    y,ordered_btree_index_upper_bound(tree,key,x,comp,mpl::false_()));
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,750 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_BTREE_INDEX_TREE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_BTREE_INDEX_TREE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/detail/adl_swap.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/ord_btree_index_node.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_pod.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <cstddef>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Keys are copied into the pages when they are PODs no bigger than two
+ * pointers, so that a lookup only touches one page per level of the tree.
+ * Otherwise, keys are obtained from the elements pointed to by the slots.
+ */
+
+template<typename Key>
+struct ordered_btree_caches_key:mpl::bool_<
+  is_pod<Key>::value&&(sizeof(Key)<=2*sizeof(void*))
+>{};
+
+template<typename Key,std::size_t N,bool CacheKeys>
+struct ordered_btree_page_keys
+{
+  Key keys[N];
+};
+
+template<typename Key,std::size_t N>
+struct ordered_btree_page_keys<Key,N,false>{};
+
+template<typename Allocator,typename Key,bool CacheKeys>
+struct ordered_btree_leaf:
+  ordered_btree_leaf_base<Allocator>,
+  ordered_btree_page_keys<
+    Key,ordered_btree_page_base<Allocator>::capacity,CacheKeys>
+{};
+
+template<typename Allocator,typename Key,bool CacheKeys>
+struct ordered_btree_inner:
+  ordered_btree_inner_base<Allocator>,
+  ordered_btree_page_keys<
+    Key,ordered_btree_page_base<Allocator>::capacity,CacheKeys>
+{};
+
+/* ordered_btree_index_tree manages the pages of a B+tree ordered index.
+ * All leaves are at the same depth and hold the elements in order; inner
+ * pages other than the root have at least capacity/2 children, and leaves
+ * other than the root are never empty. Leaves have at least capacity/2
+ * slots too except for the last one, which is split unevenly when
+ * elements are appended so that ascending insertion fills pages up.
+ *
+ * Searches are driven by a predicate telling whether a key goes before
+ * the position sought: the result is the first slot whose key does not
+ * satisfy it, returned as a leaf and slot number which may be one past
+ * the last slot of the leaf.
+ *
+ * Insertion never throws provided reserve() has been called in advance,
+ * which leaves enough spare pages to split one page per level and grow
+ * a new root. Erasure does not allocate.
+ */
+
+template<typename Node,typename KeyFromValue,typename Allocator>
+class ordered_btree_index_tree:private noncopyable
+{
+  typedef typename rebind_alloc_for<
+    Allocator,char
+  >::type                                            char_allocator;
+  typedef typename Node::impl_type                   node_impl_type;
+  typedef typename node_impl_type::pointer           node_impl_pointer;
+
+public:
+  typedef Node                                       index_node_type;
+  typedef typename remove_cv<
+    typename KeyFromValue::result_type>::type        key_type;
+  typedef ordered_btree_caches_key<key_type>         cache_keys;
+  typedef ordered_btree_page_base<char_allocator>    page_base;
+  typedef ordered_btree_leaf_base<char_allocator>    leaf_base;
+  typedef ordered_btree_inner_base<char_allocator>   inner_base;
+  typedef ordered_btree_leaf<
+    char_allocator,key_type,cache_keys::value>       leaf_page;
+  typedef ordered_btree_inner<
+    char_allocator,key_type,cache_keys::value>       inner_page;
+
+  BOOST_STATIC_CONSTANT(std::size_t,capacity=page_base::capacity);
+
+private:
+  typedef typename rebind_alloc_for<
+    Allocator,leaf_page
+  >::type                                            leaf_allocator;
+  typedef allocator_traits<leaf_allocator>           leaf_alloc_traits;
+  typedef typename leaf_alloc_traits::pointer        leaf_pointer;
+  typedef typename rebind_alloc_for<
+    Allocator,inner_page
+  >::type                                            inner_allocator;
+  typedef allocator_traits<inner_allocator>          inner_alloc_traits;
+  typedef typename inner_alloc_traits::pointer       inner_pointer;
+
+public:
+  ordered_btree_index_tree(
+    const Allocator& al,node_impl_pointer end_node,const KeyFromValue& k):
+    lal(al),ial(al),kfv(&k),end_(allocate_leaf()),root_(0),height_(0),
+    spare_leaf(0),spare_inners(0),num_spare_inners(0)
+  {
+    end_->size=1;
+    end_->parent=0;
+    end_->nodes[0]=end_node;
+    end_->prev=end_->next=end_;
+    end_node->leaf()=end_;
+    end_node->pos()=0;
+  }
+
+  ~ordered_btree_index_tree()
+  {
+    clear();
+    if(spare_leaf)deallocate(spare_leaf);
+    while(spare_inners){
+      inner_base* q=spare_inners;
+      spare_inners=q->parent;
+      deallocate(q);
+    }
+    deallocate(end_);
+  }
+
+  /* slot pos of leaf, possibly one past its last slot */
+
+  typedef std::pair<leaf_base*,std::size_t>         position;
+
+  leaf_base*  end()const{return end_;}
+  page_base*  root()const{return root_;}
+  std::size_t height()const{return height_;}
+
+  node_impl_pointer first()const{return end_->next->nodes[0];}
+
+  node_impl_pointer last()const
+  {
+    return end_->prev->nodes[end_->prev->size-1];
+  }
+
+  static node_impl_pointer at(const leaf_base* l,std::size_t pos)
+  {
+    return pos<l->size?l->nodes[pos]:l->next->nodes[0];
+  }
+
+  static node_impl_pointer at(const position& p)
+  {
+    return at(p.first,p.second);
+  }
+
+  template<typename Pred>
+  position partition_point(const Pred& pred)const
+  {
+    if(!root_)return position(end_,0);
+
+    page_base* p=root_;
+    for(std::size_t h=height_;h;--h){
+      inner_base* q=static_cast<inner_base*>(p);
+      std::size_t n=partition(q,pred,cache_keys());
+      p=q->children[n?n-1:0];
+    }
+    leaf_base* l=static_cast<leaf_base*>(p);
+    return position(l,partition(l,pred,cache_keys()));
+  }
+
+  void reserve()
+  {
+    if(!spare_leaf)spare_leaf=allocate_leaf();
+    while(num_spare_inners<height_+1){
+      inner_base* q=allocate_inner();
+      q->parent=spare_inners;
+      spare_inners=q;
+      ++num_spare_inners;
+    }
+  }
+
+  /* Preconditions: reserve() called, x goes right before slot pos of l
+   * (end() stands for the position past the last element).
+   */
+
+  void insert(leaf_base* l,std::size_t pos,node_impl_pointer x)
+  {
+    if(l==end_){
+      l=end_->prev;
+      pos=l->size;
+    }
+    if(!root_){
+      l=take_leaf();
+      l->size=0;
+      l->parent=0;
+      link_after(l,end_);
+      root_=l;
+      height_=0;
+      pos=0;
+    }
+    else if(l->size==capacity){
+      leaf_base*  r=take_leaf();
+      std::size_t h=capacity/2;
+      if(pos==capacity&&l->next==end_)h=pos; /* appending at the end */
+      r->size=0;
+      for(std::size_t i=h;i<capacity;++i)copy_slot(r,r->size++,l,i);
+      l->size=h;
+      link_after(r,l);
+      if(pos>h||pos==capacity){
+        put(r,pos-h,x);
+        insert_child(l,r);
+        return;
+      }
+      put(l,pos,x);
+      insert_child(l,r);
+      if(pos==0)update_min(l);
+      return;
+    }
+    put(l,pos,x);
+    if(pos==0)update_min(l);
+  }
+
+  void insert(const position& p,node_impl_pointer x)
+  {
+    insert(p.first,p.second,x);
+  }
+
+  void insert_before(node_impl_pointer y,node_impl_pointer x)
+  {
+    insert(y->leaf(),y->pos(),x);
+  }
+
+  void push_back(node_impl_pointer x)
+  {
+    reserve();
+    insert(end_,0,x);
+  }
+
+  void erase(node_impl_pointer x)
+  {
+    leaf_base*  l=x->leaf();
+    std::size_t pos=x->pos();
+    for(std::size_t i=pos+1;i<l->size;++i)copy_slot(l,i-1,l,i);
+    --l->size;
+    if(l==root_){
+      if(!l->size){
+        unlink(l);
+        recycle(l);
+        root_=0;
+      }
+      return;
+    }
+    if(pos==0&&l->size)update_min(l);
+    if(l->size<capacity/2)rebalance(l);
+  }
+
+  /* the key of x has changed without x moving */
+
+  void refresh(node_impl_pointer x)
+  {
+    refresh(x,cache_keys());
+  }
+
+  /* Elements erased and put back in their former position get their
+   * keys restored from a backup, as they may have been changed meanwhile.
+   */
+
+  typedef ordered_btree_page_keys<
+    key_type,1,cache_keys::value>                    key_backup;
+
+  void backup(node_impl_pointer x,key_backup& b)const
+  {
+    backup(x,b,cache_keys());
+  }
+
+  void insert_before(
+    node_impl_pointer y,node_impl_pointer x,const key_backup& b)
+  {
+    insert_before(y,x);
+    restore(x,b,cache_keys());
+  }
+
+  void clear()
+  {
+    if(root_){
+      free_subtree(root_,height_);
+      root_=0;
+      height_=0;
+    }
+    end_->prev=end_->next=end_;
+  }
+
+  void swap(ordered_btree_index_tree& x)
+  {
+    std::swap(end_,x.end_);
+    std::swap(root_,x.root_);
+    std::swap(height_,x.height_);
+    std::swap(spare_leaf,x.spare_leaf);
+    std::swap(spare_inners,x.spare_inners);
+    std::swap(num_spare_inners,x.num_spare_inners);
+  }
+
+  void swap(ordered_btree_index_tree& x,boost::true_type /* swap_allocators */)
+  {
+    adl_swap(lal,x.lal);
+    adl_swap(ial,x.ial);
+    swap(x);
+  }
+
+  void swap(ordered_btree_index_tree& x,boost::false_type /* swap_allocators */)
+  {
+    swap(x);
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  /* invariant stuff: the order of elements is checked by the index */
+
+  template<typename Compare>
+  bool invariant(const Compare& comp)const
+  {
+    if(end_->size!=1||end_->nodes[0]->leaf()!=end_||
+       end_->nodes[0]->pos()!=0)return false;
+    if(!root_){
+      return height_==0&&end_->next==end_&&end_->prev==end_;
+    }
+    if(root_->parent)return false;
+
+    leaf_base* l=end_;
+    if(!invariant(root_,height_,comp,l))return false;
+    return l->next==end_&&end_->prev==l;
+  }
+#endif
+
+private:
+  leaf_base* allocate_leaf()
+  {
+    return &*leaf_alloc_traits::allocate(lal,1);
+  }
+
+  inner_base* allocate_inner()
+  {
+    return &*inner_alloc_traits::allocate(ial,1);
+  }
+
+  void deallocate(leaf_base* l)
+  {
+    leaf_alloc_traits::deallocate(
+      lal,static_cast<leaf_pointer>(static_cast<leaf_page*>(l)),1);
+  }
+
+  void deallocate(inner_base* q)
+  {
+    inner_alloc_traits::deallocate(
+      ial,static_cast<inner_pointer>(static_cast<inner_page*>(q)),1);
+  }
+
+  leaf_base* take_leaf()
+  {
+    leaf_base* l=spare_leaf;
+    spare_leaf=0;
+    return l;
+  }
+
+  inner_base* take_inner()
+  {
+    inner_base* q=spare_inners;
+    spare_inners=q->parent;
+    --num_spare_inners;
+    return q;
+  }
+
+  void recycle(leaf_base* l)
+  {
+    if(!spare_leaf)spare_leaf=l;
+    else deallocate(l);
+  }
+
+  void recycle(inner_base* q)
+  {
+    if(num_spare_inners<height_+1){
+      q->parent=spare_inners;
+      spare_inners=q;
+      ++num_spare_inners;
+    }
+    else deallocate(q);
+  }
+
+  void free_subtree(page_base* p,std::size_t h)
+  {
+    if(!h){
+      recycle(static_cast<leaf_base*>(p));
+      return;
+    }
+    inner_base* q=static_cast<inner_base*>(p);
+    for(std::size_t i=0;i<q->size;++i)free_subtree(q->children[i],h-1);
+    recycle(q);
+  }
+
+  static void link_after(leaf_base* l,leaf_base* prev)
+  {
+    l->prev=prev;
+    l->next=prev->next;
+    prev->next->prev=l;
+    prev->next=l;
+  }
+
+  static void unlink(leaf_base* l)
+  {
+    l->prev->next=l->next;
+    l->next->prev=l->prev;
+  }
+
+  static std::size_t index_of(const inner_base* q,const page_base* p)
+  {
+    std::size_t i=0;
+    while(q->children[i]!=p)++i;
+    return i;
+  }
+
+  /* slot handling */
+
+  void copy_slot(leaf_base* l,std::size_t i,leaf_base* src,std::size_t j)
+  {
+    node_impl_pointer x=src->nodes[j];
+    l->nodes[i]=x;
+    x->leaf()=l;
+    x->pos()=i;
+    copy_key(page(l),i,page(src),j,cache_keys());
+  }
+
+  void copy_slot(inner_base* q,std::size_t i,inner_base* src,std::size_t j)
+  {
+    page_base* c=src->children[j];
+    q->children[i]=c;
+    q->nodes[i]=src->nodes[j];
+    c->parent=q;
+    copy_key(page(q),i,page(src),j,cache_keys());
+  }
+
+  static leaf_page*  page(leaf_base* l){return static_cast<leaf_page*>(l);}
+  static inner_page* page(inner_base* q){return static_cast<inner_page*>(q);}
+
+  template<typename Page1,typename Page2>
+  static void copy_key(
+    Page1* p,std::size_t i,const Page2* src,std::size_t j,mpl::true_)
+  {
+    p->keys[i]=src->keys[j];
+  }
+
+  template<typename Page1,typename Page2>
+  static void copy_key(Page1*,std::size_t,const Page2*,std::size_t,mpl::false_)
+  {
+  }
+
+  /* keys of inner pages are copied from the pages below, never obtained
+   * from the elements
+   */
+
+  void set_key(leaf_base* l,std::size_t i,mpl::true_)
+  {
+    page(l)->keys[i]=(*kfv)(Node::from_impl(l->nodes[i])->value());
+  }
+
+  void set_key(leaf_base*,std::size_t,mpl::false_){}
+
+  void put(leaf_base* l,std::size_t pos,node_impl_pointer x)
+  {
+    for(std::size_t i=l->size;i>pos;--i)copy_slot(l,i,l,i-1);
+    l->nodes[pos]=x;
+    x->leaf()=l;
+    x->pos()=pos;
+    set_key(l,pos,cache_keys());
+    ++l->size;
+  }
+
+  template<typename Page>
+  void put(inner_base* q,std::size_t pos,Page* c)
+  {
+    for(std::size_t i=q->size;i>pos;--i)copy_slot(q,i,q,i-1);
+    q->children[pos]=c;
+    q->nodes[pos]=c->nodes[0];
+    c->parent=q;
+    copy_key(page(q),pos,page(c),0,cache_keys());
+    ++q->size;
+  }
+
+  void refresh(node_impl_pointer x,mpl::true_)
+  {
+    leaf_base* l=x->leaf();
+    set_key(l,x->pos(),mpl::true_());
+    if(x->pos()==0)update_min(l);
+  }
+
+  void refresh(node_impl_pointer,mpl::false_){}
+
+  static void backup(node_impl_pointer x,key_backup& b,mpl::true_)
+  {
+    b.keys[0]=page(x->leaf())->keys[x->pos()];
+  }
+
+  static void backup(node_impl_pointer,key_backup&,mpl::false_){}
+
+  void restore(node_impl_pointer x,const key_backup& b,mpl::true_)
+  {
+    leaf_base* l=x->leaf();
+    page(l)->keys[x->pos()]=b.keys[0];
+    if(x->pos()==0)update_min(l);
+  }
+
+  void restore(node_impl_pointer,const key_backup&,mpl::false_){}
+
+  /* the first slot of p has changed */
+
+  template<typename Page>
+  void update_min(Page* p)
+  {
+    inner_base* q=p->parent;
+    if(!q)return;
+    std::size_t i=index_of(q,p);
+    q->nodes[i]=p->nodes[0];
+    copy_key(page(q),i,page(p),0,cache_keys());
+    if(!i)update_min(q);
+  }
+
+  /* c is inserted right after p, which might be the root */
+
+  template<typename Page>
+  void insert_child(Page* p,Page* c)
+  {
+    inner_base* q=p->parent;
+    if(!q){
+      q=take_inner();
+      q->size=0;
+      q->parent=0;
+      put(q,0,p);
+      put(q,1,c);
+      root_=q;
+      ++height_;
+      return;
+    }
+
+    std::size_t pos=index_of(q,p)+1;
+    if(q->size==capacity){
+      inner_base* r=take_inner();
+      std::size_t h=capacity/2;
+      r->size=0;
+      for(std::size_t i=h;i<capacity;++i)copy_slot(r,r->size++,q,i);
+      q->size=h;
+      if(pos>h)put(r,pos-h,c);
+      else put(q,pos,c);
+      insert_child(q,r);
+    }
+    else put(q,pos,c);
+  }
+
+  /* Slot pos of q is dropped. Pages merged together lose the one on the
+   * right, so pos is never 0 and the first slot of q is unaffected.
+   */
+
+  void remove_child(inner_base* q,std::size_t pos)
+  {
+    for(std::size_t i=pos+1;i<q->size;++i)copy_slot(q,i-1,q,i);
+    --q->size;
+    if(q==root_){
+      if(q->size==1){
+        root_=q->children[0];
+        root_->parent=0;
+        --height_;
+        recycle(q);
+      }
+    }
+    else if(q->size<capacity/2)rebalance(q);
+  }
+
+  /* p has too few slots: borrow one from a sibling or merge with it */
+
+  template<typename Page>
+  void rebalance(Page* p)
+  {
+    inner_base* q=p->parent;
+    std::size_t i=index_of(q,p);
+    if(i){
+      Page* s=static_cast<Page*>(q->children[i-1]);
+      if(s->size>capacity/2){
+        for(std::size_t j=p->size;j>0;--j)copy_slot(p,j,p,j-1);
+        copy_slot(p,0,s,--s->size);
+        ++p->size;
+        update_min(p);
+      }
+      else{
+        for(std::size_t j=0;j<p->size;++j)copy_slot(s,s->size++,p,j);
+        discard(p);
+        remove_child(q,i);
+      }
+    }
+    else{
+      Page* s=static_cast<Page*>(q->children[1]);
+      bool  was_empty=p->size==0;
+      if(s->size>capacity/2){
+        copy_slot(p,p->size++,s,0);
+        for(std::size_t j=1;j<s->size;++j)copy_slot(s,j-1,s,j);
+        --s->size;
+        update_min(s);
+        if(was_empty)update_min(p);
+      }
+      else{
+        for(std::size_t j=0;j<s->size;++j)copy_slot(p,p->size++,s,j);
+        if(was_empty)update_min(p);
+        discard(s);
+        remove_child(q,1);
+      }
+    }
+  }
+
+  void discard(leaf_base* l)
+  {
+    unlink(l);
+    recycle(l);
+  }
+
+  void discard(inner_base* q)
+  {
+    recycle(q);
+  }
+
+  /* number of leading slots whose keys satisfy pred */
+
+  static const key_type* keys(const leaf_base* l)
+  {
+    return static_cast<const leaf_page*>(l)->keys;
+  }
+
+  static const key_type* keys(const inner_base* q)
+  {
+    return static_cast<const inner_page*>(q)->keys;
+  }
+
+  template<typename Page,typename Pred>
+  static std::size_t partition(const Page* p,const Pred& pred,mpl::true_)
+  {
+    const key_type* k=keys(p);
+    std::size_t     first=0,
+                    n=p->size;
+    while(n){
+      std::size_t half=n/2;
+      if(pred(k[first+half])){
+        first+=half+1;
+        n-=half+1;
+      }
+      else n=half;
+    }
+    return first;
+  }
+
+  template<typename Page,typename Pred>
+  std::size_t partition(const Page* p,const Pred& pred,mpl::false_)const
+  {
+    std::size_t first=0,
+                n=p->size;
+    while(n){
+      std::size_t half=n/2;
+      if(pred((*kfv)(Node::from_impl(p->nodes[first+half])->value()))){
+        first+=half+1;
+        n-=half+1;
+      }
+      else n=half;
+    }
+    return first;
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  template<typename Compare>
+  bool invariant(
+    const page_base* p,std::size_t h,const Compare& comp,leaf_base*& l)const
+  {
+    if(p->size==0||p->size>capacity)return false;
+    if(!h){
+      const leaf_base* pl=static_cast<const leaf_base*>(p);
+      if(pl->prev!=l||l->next!=pl)return false;
+      l=const_cast<leaf_base*>(pl);
+      for(std::size_t i=0;i<p->size;++i){
+        if(p->nodes[i]->leaf()!=pl||p->nodes[i]->pos()!=i)return false;
+        if(!key_invariant(
+          static_cast<const leaf_page*>(pl),i,comp,cache_keys()))return false;
+      }
+    }
+    else{
+      const inner_base* q=static_cast<const inner_base*>(p);
+      if(q==root_?q->size<2:q->size<capacity/2)return false;
+      for(std::size_t i=0;i<q->size;++i){
+        const page_base* c=q->children[i];
+        if(c->parent!=q||q->nodes[i]!=c->nodes[0])return false;
+        if(!key_invariant(
+          static_cast<const inner_page*>(q),i,comp,cache_keys()))return false;
+        if(!invariant(c,h-1,comp,l))return false;
+      }
+    }
+    return true;
+  }
+
+  template<typename Page,typename Compare>
+  bool key_invariant(
+    const Page* p,std::size_t i,const Compare& comp,mpl::true_)const
+  {
+    const key_type& k=p->keys[i];
+    return
+      !comp(k,(*kfv)(Node::from_impl(p->nodes[i])->value()))&&
+      !comp((*kfv)(Node::from_impl(p->nodes[i])->value()),k);
+  }
+
+  template<typename Page,typename Compare>
+  bool key_invariant(const Page*,std::size_t,const Compare&,mpl::false_)const
+  {
+    return true;
+  }
+#endif
+
+  leaf_allocator      lal;
+  inner_allocator     ial;
+  const KeyFromValue* kfv;
+  leaf_base*          end_;
+  page_base*          root_;
+  std::size_t         height_;
+  leaf_base*          spare_leaf;
+  inner_base*         spare_inners;
+  std::size_t         num_spare_inners;
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
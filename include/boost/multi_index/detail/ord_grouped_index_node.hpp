@@ -0,0 +1,228 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_GROUPED_INDEX_NODE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_GROUPED_INDEX_NODE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/ord_index_node.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Elements of grouped ordered indices are doubly linked in a circular
+ * list closed by the header, as in sequenced indices, where equivalent
+ * elements lie next to one another. Every such run of equivalent elements
+ * (a group) is a node of a red-black tree of groups recording the first
+ * and last elements of the run and its length, and elements point back to
+ * their group. The key of a group is that of its first element.
+ */
+
+template<typename Allocator>
+struct ordered_grouped_index_node_impl; /* fwd decl. */
+
+template<typename Allocator>
+struct ordered_grouped_index_node_pointer
+{
+  typedef typename allocator_traits<
+    typename rebind_alloc_for<
+      Allocator,ordered_grouped_index_node_impl<Allocator>
+    >::type
+  >::pointer                                          type;
+};
+
+template<typename OrderedIndexNodeImpl,typename NodeImplPointer>
+struct ordered_grouped_index_group_node:OrderedIndexNodeImpl
+{
+  NodeImplPointer& first(){return first_;}
+  NodeImplPointer  first()const{return first_;}
+  NodeImplPointer& last(){return last_;}
+  NodeImplPointer  last()const{return last_;}
+  std::size_t&     size(){return size_;}
+  std::size_t      size()const{return size_;}
+
+private:
+  NodeImplPointer first_;
+  NodeImplPointer last_;
+  std::size_t     size_;
+};
+
+/* Group nodes are plain red-black tree nodes extended by means of an
+ * augment policy whose hooks do nothing.
+ */
+
+template<typename Allocator>
+struct ordered_grouped_index_group_policy
+{
+  template<typename OrderedIndexNodeImpl>
+  struct augmented_node
+  {
+    typedef ordered_grouped_index_group_node<
+      OrderedIndexNodeImpl,
+      typename ordered_grouped_index_node_pointer<Allocator>::type
+    > type;
+  };
+
+  template<typename Pointer> static void add(Pointer,Pointer){}
+  template<typename Pointer> static void remove(Pointer,Pointer){}
+  template<typename Pointer> static void copy(Pointer,Pointer){}
+  template<typename Pointer> static void rotate_left(Pointer,Pointer){}
+  template<typename Pointer> static void rotate_right(Pointer,Pointer){}
+  template<typename Pointer> static void build(Pointer){}
+  template<typename Pointer> static void update(Pointer,Pointer){}
+};
+
+template<typename Allocator>
+struct ordered_grouped_index_node_impl
+{
+  typedef typename rebind_alloc_for<
+    Allocator,ordered_grouped_index_node_impl
+  >::type                                        node_allocator;
+  typedef allocator_traits<node_allocator>       alloc_traits;
+  typedef typename alloc_traits::pointer         pointer;
+  typedef typename alloc_traits::const_pointer   const_pointer;
+  typedef typename alloc_traits::difference_type difference_type;
+  typedef ordered_index_node_impl<
+    ordered_grouped_index_group_policy<Allocator>,
+    Allocator
+  >                                              group_type;
+  typedef typename group_type::pointer           group_pointer;
+
+  pointer&       prior(){return prior_;}
+  pointer        prior()const{return prior_;}
+  pointer&       next(){return next_;}
+  pointer        next()const{return next_;}
+  group_pointer& group(){return group_;}
+  group_pointer  group()const{return group_;}
+
+  /* interoperability with bidir_node_iterator */
+
+  static void increment(pointer& x){x=x->next();}
+  static void decrement(pointer& x){x=x->prior();}
+
+  /* algorithmic stuff */
+
+  static void link(pointer x,pointer position)
+  {
+    x->prior()=position->prior();
+    x->next()=position;
+    x->prior()->next()=x->next()->prior()=x;
+  }
+
+  static void unlink(pointer x)
+  {
+    x->prior()->next()=x->next();
+    x->next()->prior()=x->prior();
+  }
+
+private:
+  pointer       prior_;
+  pointer       next_;
+  group_pointer group_;
+};
+
+template<typename Super>
+struct ordered_grouped_index_node_trampoline:
+  ordered_grouped_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  >
+{
+  typedef ordered_grouped_index_node_impl<
+    typename rebind_alloc_for<
+      typename Super::allocator_type,
+      char
+    >::type
+  > impl_type;
+};
+
+template<typename Super>
+struct ordered_grouped_index_node:
+  Super,ordered_grouped_index_node_trampoline<Super>
+{
+private:
+  typedef ordered_grouped_index_node_trampoline<Super> trampoline;
+
+public:
+  typedef typename trampoline::impl_type       impl_type;
+  typedef typename trampoline::pointer         impl_pointer;
+  typedef typename trampoline::const_pointer   const_impl_pointer;
+  typedef typename trampoline::difference_type difference_type;
+  typedef typename trampoline::group_pointer   group_pointer;
+
+  impl_pointer&  prior(){return trampoline::prior();}
+  impl_pointer   prior()const{return trampoline::prior();}
+  impl_pointer&  next(){return trampoline::next();}
+  impl_pointer   next()const{return trampoline::next();}
+  group_pointer& group(){return trampoline::group();}
+  group_pointer  group()const{return trampoline::group();}
+
+  impl_pointer impl()
+  {
+    return static_cast<impl_pointer>(
+      static_cast<impl_type*>(static_cast<trampoline*>(this)));
+  }
+
+  const_impl_pointer impl()const
+  {
+    return static_cast<const_impl_pointer>(
+      static_cast<const impl_type*>(static_cast<const trampoline*>(this)));
+  }
+
+  static ordered_grouped_index_node* from_impl(impl_pointer x)
+  {
+    return
+      static_cast<ordered_grouped_index_node*>(
+        static_cast<trampoline*>(
+          raw_ptr<impl_type*>(x)));
+  }
+
+  static const ordered_grouped_index_node* from_impl(const_impl_pointer x)
+  {
+    return
+      static_cast<const ordered_grouped_index_node*>(
+        static_cast<const trampoline*>(
+          raw_ptr<const impl_type*>(x)));
+  }
+
+  /* interoperability with bidir_node_iterator */
+
+  static void increment(ordered_grouped_index_node*& x)
+  {
+    impl_pointer xi=x->impl();
+    trampoline::increment(xi);
+    x=from_impl(xi);
+  }
+
+  static void decrement(ordered_grouped_index_node*& x)
+  {
+    impl_pointer xi=x->impl();
+    trampoline::decrement(xi);
+    x=from_impl(xi);
+  }
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
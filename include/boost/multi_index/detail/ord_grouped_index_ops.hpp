@@ -0,0 +1,287 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_GROUPED_INDEX_OPS_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_GROUPED_INDEX_OPS_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/mpl/and.hpp>
+#include <boost/multi_index/detail/promotes_arg.hpp>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Lookup in grouped ordered indices walks down the tree of groups, one
+ * comparison per level, and results are given as groups (the header of
+ * the tree standing for the end). As in ord_index_ops.hpp, CompatibleKey
+ * is promoted to KeyFromValue::result_type in advance when the comparison
+ * would do it anyway.
+ */
+
+template<typename CompatibleKey,typename CompatibleCompare>
+struct ordered_grouped_less_than
+{
+  ordered_grouped_less_than(
+    const CompatibleKey& x_,const CompatibleCompare& comp_):
+    x(x_),comp(comp_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return comp(k,x);}
+
+private:
+  const CompatibleKey&     x;
+  const CompatibleCompare& comp;
+};
+
+template<typename CompatibleKey,typename CompatibleCompare>
+struct ordered_grouped_not_greater_than
+{
+  ordered_grouped_not_greater_than(
+    const CompatibleKey& x_,const CompatibleCompare& comp_):
+    x(x_),comp(comp_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return !comp(x,k);}
+
+private:
+  const CompatibleKey&     x;
+  const CompatibleCompare& comp;
+};
+
+template<typename LowerBounder>
+struct ordered_grouped_below_lower
+{
+  ordered_grouped_below_lower(const LowerBounder& lower_):lower(lower_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return !lower(k);}
+
+private:
+  const LowerBounder& lower;
+};
+
+template<typename UpperBounder>
+struct ordered_grouped_within_upper
+{
+  ordered_grouped_within_upper(const UpperBounder& upper_):upper(upper_){}
+
+  template<typename Key>
+  bool operator()(const Key& k)const{return upper(k);}
+
+private:
+  const UpperBounder& upper;
+};
+
+/* first group whose key does not satisfy pred */
+
+template<typename Tree,typename KeyFromValue,typename Pred>
+inline typename Tree::group_pointer ordered_grouped_index_partition_point(
+  const Tree& tree,const KeyFromValue& key,const Pred& pred)
+{
+  typedef typename Tree::group_pointer group_pointer;
+
+  group_pointer y=tree.header(),top=tree.root();
+  while(top!=group_pointer(0)){
+    if(!pred(key(Tree::first(top)->value()))){
+      y=top;
+      top=top->left();
+    }
+    else top=top->right();
+  }
+  return y;
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::group_pointer ordered_grouped_index_find(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_grouped_index_find(
+    tree,key,x,comp,
+    mpl::and_<
+      promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>,
+      promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey> >());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline typename Tree::group_pointer ordered_grouped_index_find(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_grouped_index_find(tree,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::group_pointer ordered_grouped_index_find(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  typename Tree::group_pointer y=ordered_grouped_index_partition_point(
+    tree,key,ordered_grouped_less_than<CompatibleKey,CompatibleCompare>(
+      x,comp));
+  return (y==tree.header()||comp(x,key(Tree::first(y)->value())))?
+    tree.header():y;
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::group_pointer ordered_grouped_index_lower_bound(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_grouped_index_lower_bound(
+    tree,key,x,comp,
+    promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey>());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline typename Tree::group_pointer ordered_grouped_index_lower_bound(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_grouped_index_lower_bound(tree,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::group_pointer ordered_grouped_index_lower_bound(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  return ordered_grouped_index_partition_point(
+    tree,key,ordered_grouped_less_than<CompatibleKey,CompatibleCompare>(
+      x,comp));
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::group_pointer ordered_grouped_index_upper_bound(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_grouped_index_upper_bound(
+    tree,key,x,comp,
+    promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline typename Tree::group_pointer ordered_grouped_index_upper_bound(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_grouped_index_upper_bound(tree,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Tree::group_pointer ordered_grouped_index_upper_bound(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  return ordered_grouped_index_partition_point(
+    tree,key,
+    ordered_grouped_not_greater_than<CompatibleKey,CompatibleCompare>(
+      x,comp));
+}
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline std::pair<typename Tree::group_pointer,typename Tree::group_pointer>
+ordered_grouped_index_equal_range(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_grouped_index_equal_range(
+    tree,key,x,comp,
+    mpl::and_<
+      promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>,
+      promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey> >());
+}
+
+template<typename Tree,typename KeyFromValue,typename CompatibleCompare>
+inline std::pair<typename Tree::group_pointer,typename Tree::group_pointer>
+ordered_grouped_index_equal_range(
+  const Tree& tree,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_grouped_index_equal_range(tree,key,x,comp,mpl::false_());
+}
+
+/* With the comparison of the index, the range spans one group at most:
+ * the group following the lower bound is checked before looking for the
+ * upper bound from the root.
+ */
+
+template<
+  typename Tree,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline std::pair<typename Tree::group_pointer,typename Tree::group_pointer>
+ordered_grouped_index_equal_range(
+  const Tree& tree,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  typedef typename Tree::group_pointer group_pointer;
+  typedef typename Tree::group_type    group_type;
+
+  group_pointer y=ordered_grouped_index_lower_bound(
+    tree,key,x,comp,mpl::false_());
+  if(y==tree.header()||comp(x,key(Tree::first(y)->value()))){
+    return std::pair<group_pointer,group_pointer>(y,y);
+  }
+  group_pointer z=y;
+  group_type::increment(z);
+  if(z!=tree.header()&&!comp(x,key(Tree::first(z)->value()))){
+    z=ordered_grouped_index_upper_bound(tree,key,x,comp,mpl::false_());
+  }
+  return std::pair<group_pointer,group_pointer>(y,z);
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,333 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_GROUPED_INDEX_TREE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_GROUPED_INDEX_TREE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/detail/adl_swap.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/ord_grouped_index_node.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <cstddef>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* ordered_grouped_index_tree manages the groups of a grouped ordered index
+ * as described in ord_grouped_index_node.hpp, and links and unlinks
+ * elements accordingly. Keys are not looked at here: the index finds out
+ * where elements go and the tree keeps the list of elements and the tree
+ * of groups consistent.
+ *
+ * Creating a group never throws provided reserve() has been called in
+ * advance, which leaves a spare group node. Groups emptied by erasure
+ * are kept as the spare node when there is none.
+ */
+
+template<typename Node,typename Allocator>
+class ordered_grouped_index_tree:private noncopyable
+{
+  typedef typename Node::impl_type                   node_impl_type;
+  typedef typename node_impl_type::pointer           node_impl_pointer;
+
+public:
+  typedef Node                                       index_node_type;
+  typedef typename node_impl_type::group_type        group_type;
+  typedef typename group_type::pointer               group_pointer;
+
+private:
+  typedef typename rebind_alloc_for<
+    Allocator,group_type
+  >::type                                            group_allocator;
+  typedef allocator_traits<group_allocator>          group_alloc_traits;
+
+public:
+  ordered_grouped_index_tree(const Allocator& al):
+    gal(al),header_(allocate()),spare(0)
+  {
+    empty_initialize();
+  }
+
+  ~ordered_grouped_index_tree()
+  {
+    clear();
+    if(spare!=group_pointer(0))deallocate(spare);
+    deallocate(header_);
+  }
+
+  group_pointer header()const{return header_;}
+  group_pointer root()const{return header_->parent();}
+  group_pointer leftmost()const{return header_->left();}
+
+  static Node* first(group_pointer g){return Node::from_impl(g->first());}
+
+  /* information needed to put back an element where it was */
+
+  struct backup
+  {
+    node_impl_pointer next;
+    group_pointer     group;
+    bool              first;
+    bool              last;
+  };
+
+  void reserve()
+  {
+    if(spare==group_pointer(0))spare=allocate();
+  }
+
+  /* x goes right before position, which is either an element of group g
+   * or the one following its last element
+   */
+
+  static void link(
+    node_impl_pointer x,group_pointer g,node_impl_pointer position)
+  {
+    node_impl_type::link(x,position);
+    x->group()=g;
+    if(position==g->first())g->first()=x;
+    else if(x->prior()==g->last())g->last()=x;
+    ++g->size();
+  }
+
+  /* Precondition: reserve() called. x forms a new group linked to the
+   * side of parent given, as in ordered_index_node_impl::link.
+   */
+
+  void link(
+    node_impl_pointer x,ordered_index_side side,group_pointer parent,
+    node_impl_pointer end)
+  {
+    group_pointer g=spare;
+    spare=group_pointer(0);
+    g->first()=g->last()=x;
+    g->size()=1;
+    x->group()=g;
+    group_type::link(g,side,parent,header_);
+    group_pointer next=g;
+    group_type::increment(next);
+    node_impl_type::link(x,next==header_?end:next->first());
+  }
+
+  void unlink(node_impl_pointer x)
+  {
+    group_pointer g=extract(x);
+    if(g!=group_pointer(0))recycle(g);
+  }
+
+  /* Unlinks x and records where it was. If x was alone, its group is kept
+   * out of the tree until either restore() or release() is called.
+   */
+
+  void unlink(node_impl_pointer x,backup& b)
+  {
+    b.next=x->next();
+    b.group=x->group();
+    b.first=b.group->first()==x;
+    b.last=b.group->last()==x;
+    extract(x);
+  }
+
+  void restore(node_impl_pointer x,const backup& b,node_impl_pointer end)
+  {
+    group_pointer g=b.group;
+    if(g->size()==0){
+      group_type::restore(g,b.next==end?header_:b.next->group(),header_);
+    }
+    node_impl_type::link(x,b.next);
+    x->group()=g;
+    if(b.first)g->first()=x;
+    if(b.last)g->last()=x;
+    ++g->size();
+  }
+
+  void release(const backup& b)
+  {
+    if(b.group->size()==0)recycle(b.group);
+  }
+
+  /* x moves right before position within its group */
+
+  void relink(node_impl_pointer x,node_impl_pointer position)
+  {
+    if(position==x||position==x->next())return;
+    group_pointer g=x->group();
+    if(g->first()==x)g->first()=x->next();
+    else if(g->last()==x)g->last()=x->prior();
+    --g->size();
+    node_impl_type::unlink(x);
+    link(x,g,position);
+  }
+
+  /* Copying appends groups in order and then balances the tree. Should
+   * push_back throw, the groups are freed by the destructor, as the
+   * container under construction is not completed.
+   */
+
+  group_pointer push_back(
+    node_impl_pointer first,node_impl_pointer last,std::size_t size)
+  {
+    group_pointer g=allocate();
+    g->first()=first;
+    g->last()=last;
+    g->size()=size;
+    group_type::append(g,header_);
+    return g;
+  }
+
+  void build(std::size_t n)
+  {
+    group_type::build(header_,n);
+  }
+
+  void clear()
+  {
+    /* rotations turn the tree into a list along right links */
+
+    group_pointer x=root();
+    while(x!=group_pointer(0)){
+      group_pointer y=x->left();
+      if(y!=group_pointer(0)){
+        x->left()=y->right();
+        y->right()=x;
+        x=y;
+      }
+      else{
+        y=x->right();
+        deallocate(x);
+        x=y;
+      }
+    }
+    empty_initialize();
+  }
+
+  void swap(ordered_grouped_index_tree& x)
+  {
+    std::swap(header_,x.header_);
+    std::swap(spare,x.spare);
+  }
+
+  void swap(
+    ordered_grouped_index_tree& x,boost::true_type /* swap_allocators */)
+  {
+    adl_swap(gal,x.gal);
+    swap(x);
+  }
+
+  void swap(
+    ordered_grouped_index_tree& x,boost::false_type /* swap_allocators */)
+  {
+    swap(x);
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  /* invariant stuff: the order of elements is checked by the index */
+
+  bool invariant(node_impl_pointer end,std::size_t n)const
+  {
+    if(root()==group_pointer(0)){
+      return leftmost()==header_&&header_->right()==header_&&
+             end->next()==end&&end->prior()==end&&n==0;
+    }
+
+    std::size_t len=group_type::black_count(leftmost(),root());
+    node_impl_pointer y=end;
+    std::size_t       m=0;
+    for(group_pointer g=leftmost();g!=header_;group_type::increment(g)){
+      group_pointer l=g->left(),r=g->right();
+      if(g->color()==red){
+        if((l!=group_pointer(0)&&l->color()==red)||
+           (r!=group_pointer(0)&&r->color()==red))return false;
+      }
+      if(l==group_pointer(0)&&r==group_pointer(0)&&
+         group_type::black_count(g,root())!=len)return false;
+
+      if(g->size()==0||g->first()->prior()!=y)return false;
+      std::size_t s=0;
+      for(node_impl_pointer x=g->first();;x=x->next()){
+        if(x->group()!=g||x->next()->prior()!=x)return false;
+        ++s;
+        if(x==g->last())break;
+        if(x->next()==end)return false;
+      }
+      if(s!=g->size())return false;
+      y=g->last();
+      m+=s;
+    }
+    if(y->next()!=end||end->prior()!=y||m!=n)return false;
+
+    return leftmost()==group_type::minimum(root())&&
+           header_->right()==group_type::maximum(root());
+  }
+#endif
+
+private:
+  group_pointer allocate()
+  {
+    return group_alloc_traits::allocate(gal,1);
+  }
+
+  void deallocate(group_pointer g)
+  {
+    group_alloc_traits::deallocate(gal,g,1);
+  }
+
+  void recycle(group_pointer g)
+  {
+    if(spare==group_pointer(0))spare=g;
+    else deallocate(g);
+  }
+
+  void empty_initialize()
+  {
+    header_->color()=red;
+    header_->parent()=group_pointer(0);
+    header_->left()=header_;
+    header_->right()=header_;
+  }
+
+  /* Unlinks x and, if its group becomes empty, takes the group out of
+   * the tree and returns it.
+   */
+
+  group_pointer extract(node_impl_pointer x)
+  {
+    group_pointer g=x->group();
+    node_impl_type::unlink(x);
+    if(--g->size()==0){
+      group_type::rebalance_for_extract(
+        g,header_->parent(),header_->left(),header_->right());
+      return g;
+    }
+    if(g->first()==x)g->first()=x->next();
+    else if(g->last()==x)g->last()=x->prior();
+    return group_pointer(0);
+  }
+
+  group_allocator gal;
+  group_pointer   header_;
+  group_pointer   spare;
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -63,6 +63,8 @@
 #include <boost/multi_index/detail/node_handle.hpp>
 #include <boost/multi_index/detail/ord_index_node.hpp>
 #include <boost/multi_index/detail/ord_index_ops.hpp>
+#include <boost/multi_index/detail/ord_index_snapshot.hpp>
+#include <boost/multi_index/detail/ord_prefix_index_ops.hpp>
 #include <boost/multi_index/detail/safe_mode.hpp>
 #include <boost/multi_index/detail/scope_guard.hpp>
 #include <boost/multi_index/detail/unbounded.hpp>
@@ -70,8 +72,10 @@
 #include <boost/multi_index/detail/vartempl_support.hpp>
 #include <boost/multi_index/detail/ord_index_impl_fwd.hpp>
 #include <boost/ref.hpp>
+#include <boost/static_assert.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_const.hpp>
 #include <utility>
 
 #if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
@@ -237,6 +241,23 @@ protected:
 
   typedef std::pair<iterator,bool>                   emplace_return_type;
 
+  typedef ordered_index_snapshot<
+    typename remove_const<key_type>::type,
+    node_impl_pointer,allocator_type>                snapshot_type;
+
+  /* descents to a link point compare the key with those of the nodes
+   * through a probe, which can resolve most comparisons on the key
+   * prefixes kept by prefixed indices
+   */
+
+  typedef typename mpl::if_<
+    ordered_index_prefixed<AugmentPolicy>,
+    ordered_index_prefix_probe<
+      index_node_type,key_from_value,key_compare,key_type>,
+    ordered_index_key_probe<
+      index_node_type,key_from_value,key_compare,key_type>
+  >::type                                            key_probe;
+
 public:
 
   /* construct/copy/destroy
@@ -341,12 +362,21 @@ public:
   void insert(InputIterator first,InputIterator last)
   {
     BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT;
-    index_node_type* hint=header(); /* end() */
-    for(;first!=last;++first){
-      hint=this->final_insert_ref_(
-        *first,static_cast<final_node_type*>(hint)).first;
-      index_node_type::increment(hint);
+    this->final_bulk_insert_begin_();
+    BOOST_TRY{
+      index_node_type* hint=header(); /* end() */
+      for(;first!=last;++first){
+        hint=this->final_insert_ref_(
+          *first,static_cast<final_node_type*>(hint)).first;
+        index_node_type::increment(hint);
+      }
     }
+    BOOST_CATCH(...){
+      this->final_bulk_insert_end_();
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    this->final_bulk_insert_end_();
   }
 
 #if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
@@ -544,13 +574,17 @@ public:
   template<typename CompatibleKey>
   iterator find(const CompatibleKey& x)const
   {
-    return make_iterator(ordered_index_find(root(),header(),key,x,comp_));
+    return find(x,comp_);
   }
 
   template<typename CompatibleKey,typename CompatibleCompare>
   iterator find(
     const CompatibleKey& x,const CompatibleCompare& comp)const
   {
+    if(frozen()){
+      return make_iterator(index_node_type::from_impl(
+        ordered_index_snapshot_find(snapshot,key,x,comp)));
+    }
     return make_iterator(ordered_index_find(root(),header(),key,x,comp));
   }
 
@@ -571,14 +605,17 @@ public:
   template<typename CompatibleKey>
   iterator lower_bound(const CompatibleKey& x)const
   {
-    return make_iterator(
-      ordered_index_lower_bound(root(),header(),key,x,comp_));
+    return lower_bound(x,comp_);
   }
 
   template<typename CompatibleKey,typename CompatibleCompare>
   iterator lower_bound(
     const CompatibleKey& x,const CompatibleCompare& comp)const
   {
+    if(frozen()){
+      return make_iterator(index_node_type::from_impl(
+        ordered_index_snapshot_lower_bound(snapshot,key,x,comp)));
+    }
     return make_iterator(
       ordered_index_lower_bound(root(),header(),key,x,comp));
   }
@@ -586,14 +623,17 @@ public:
   template<typename CompatibleKey>
   iterator upper_bound(const CompatibleKey& x)const
   {
-    return make_iterator(
-      ordered_index_upper_bound(root(),header(),key,x,comp_));
+    return upper_bound(x,comp_);
   }
 
   template<typename CompatibleKey,typename CompatibleCompare>
   iterator upper_bound(
     const CompatibleKey& x,const CompatibleCompare& comp)const
   {
+    if(frozen()){
+      return make_iterator(index_node_type::from_impl(
+        ordered_index_snapshot_upper_bound(snapshot,key,x,comp)));
+    }
     return make_iterator(
       ordered_index_upper_bound(root(),header(),key,x,comp));
   }
@@ -602,22 +642,98 @@ public:
   std::pair<iterator,iterator> equal_range(
     const CompatibleKey& x)const
   {
-    std::pair<index_node_type*,index_node_type*> p=
-      ordered_index_equal_range(root(),header(),key,x,comp_);
-    return std::pair<iterator,iterator>(
-      make_iterator(p.first),make_iterator(p.second));
+    return equal_range(x,comp_);
   }
 
   template<typename CompatibleKey,typename CompatibleCompare>
   std::pair<iterator,iterator> equal_range(
     const CompatibleKey& x,const CompatibleCompare& comp)const
   {
+    if(frozen()){
+      std::pair<node_impl_pointer,node_impl_pointer> p=
+        ordered_index_snapshot_equal_range(snapshot,key,x,comp);
+      return std::pair<iterator,iterator>(
+        make_iterator(index_node_type::from_impl(p.first)),
+        make_iterator(index_node_type::from_impl(p.second)));
+    }
+
     std::pair<index_node_type*,index_node_type*> p=
       ordered_index_equal_range(root(),header(),key,x,comp);
     return std::pair<iterator,iterator>(
       make_iterator(p.first),make_iterator(p.second));
   }
 
+  /* Batched lookup of unrelated keys: searches for a block of keys descend
+   * the tree together, one level at a time, with the nodes to be visited
+   * next prefetched, so that their cache misses overlap. Frozen indices
+   * look up each key in their snapshot.
+   */
+
+  template<typename ForwardIterator,typename OutputIterator>
+  OutputIterator find_batch(
+    ForwardIterator first,ForwardIterator last,OutputIterator res)const
+  {
+    return find_batch(first,last,res,comp_);
+  }
+
+  template<
+    typename ForwardIterator,typename OutputIterator,
+    typename CompatibleCompare
+  >
+  OutputIterator find_batch(
+    ForwardIterator first,ForwardIterator last,OutputIterator res,
+    const CompatibleCompare& comp)const
+  {
+    if(frozen()){
+      for(;first!=last;++first)*res++=find(*first,comp);
+      return res;
+    }
+
+    index_node_type* ys[lookup_batch_size];
+    while(first!=last){
+      ForwardIterator it=first;
+      for(std::size_t i=0,n=ordered_index_lower_bound_batch(
+            root(),header(),key,first,last,comp,ys);
+          i!=n;++i,++it){
+        index_node_type* y=ys[i];
+        if(y!=header()&&comp(*it,key(y->value())))y=header();
+        *res++=make_iterator(y);
+      }
+    }
+    return res;
+  }
+
+  template<typename ForwardIterator,typename OutputIterator>
+  OutputIterator lower_bound_batch(
+    ForwardIterator first,ForwardIterator last,OutputIterator res)const
+  {
+    return lower_bound_batch(first,last,res,comp_);
+  }
+
+  template<
+    typename ForwardIterator,typename OutputIterator,
+    typename CompatibleCompare
+  >
+  OutputIterator lower_bound_batch(
+    ForwardIterator first,ForwardIterator last,OutputIterator res,
+    const CompatibleCompare& comp)const
+  {
+    if(frozen()){
+      for(;first!=last;++first)*res++=lower_bound(*first,comp);
+      return res;
+    }
+
+    index_node_type* ys[lookup_batch_size];
+    while(first!=last){
+      for(std::size_t i=0,n=ordered_index_lower_bound_batch(
+            root(),header(),key,first,last,comp,ys);
+          i!=n;++i){
+        *res++=make_iterator(ys[i]);
+      }
+    }
+    return res;
+  }
+
   /* range */
 
   template<typename LowerBounder,typename UpperBounder>
@@ -641,11 +757,126 @@ public:
     return range(lower,upper,dispatch());
   }
 
+  /* finger search */
+
+  class cursor
+  {
+  public:
+    iterator get()const{return it;}
+
+    template<typename CompatibleKey>
+    iterator seek(const CompatibleKey& x)
+    {
+      return seek(x,idx->comp_);
+    }
+
+    template<typename CompatibleKey,typename CompatibleCompare>
+    iterator seek(const CompatibleKey& x,const CompatibleCompare& comp)
+    {
+      BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(it);
+      it=idx->make_iterator(
+        ordered_index_finger_lower_bound(
+          it.get_node(),idx->header(),idx->key,x,comp));
+      return it;
+    }
+
+  private:
+    friend class ordered_index_impl;
+
+    cursor(const ordered_index_impl* idx_,const_iterator it_):
+      idx(idx_),it(it_){}
+
+    const ordered_index_impl* idx;
+    iterator                  it;
+  };
+
+  cursor make_cursor()const{return cursor(this,begin());}
+
+  cursor make_cursor(const_iterator position)const
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    return cursor(this,position);
+  }
+
+  template<typename InputIterator,typename OutputIterator>
+  OutputIterator lower_bound_many(
+    InputIterator first,InputIterator last,OutputIterator res)const
+  {
+    cursor c=make_cursor(end());
+    for(;first!=last;++first)*res++=c.seek(*first);
+    return res;
+  }
+
+  /* join-based set operations, for containers with this index alone */
+
+  void set_union(
+    ordered_index<
+      KeyFromValue,Compare,SuperMeta,TagList,Category,AugmentPolicy>& x)
+  {
+    BOOST_STATIC_ASSERT((is_same<index_node_type,final_node_type>::value));
+    BOOST_MULTI_INDEX_CHECK_EQUAL_ALLOCATORS(*this,x);
+    BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT;
+    BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT_OF(x);
+    if(x.empty()||&x==this)return;
+    set_union_(x);
+  }
+
+  void set_intersection(
+    const ordered_index<
+      KeyFromValue,Compare,SuperMeta,TagList,Category,AugmentPolicy>& x)
+  {
+    BOOST_STATIC_ASSERT((is_same<index_node_type,final_node_type>::value));
+    BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT;
+    if(&x==this)return;
+    set_intersection_(x,true);
+  }
+
+  void set_difference(
+    const ordered_index<
+      KeyFromValue,Compare,SuperMeta,TagList,Category,AugmentPolicy>& x)
+  {
+    BOOST_STATIC_ASSERT((is_same<index_node_type,final_node_type>::value));
+    BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT;
+    if(&x==this){
+      clear();
+      return;
+    }
+    set_intersection_(x,false);
+  }
+
+  void split(
+    key_param_type k,
+    ordered_index<
+      KeyFromValue,Compare,SuperMeta,TagList,Category,AugmentPolicy>& x)
+  {
+    BOOST_STATIC_ASSERT((is_same<index_node_type,final_node_type>::value));
+    BOOST_MULTI_INDEX_CHECK_EQUAL_ALLOCATORS(*this,x);
+    BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT;
+    BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT_OF(x);
+    if(&x==this)return;
+    split_(k,x);
+  }
+
+  /* freezing */
+
+  void freeze()
+  {
+    BOOST_MULTI_INDEX_ORD_INDEX_CHECK_INVARIANT;
+    if(frozen())return;
+    snapshot.build(
+      get_allocator(),leftmost(),size(),key,header()->impl());
+  }
+
+  void unfreeze()BOOST_NOEXCEPT{if(frozen())snapshot.clear();}
+  bool frozen()const BOOST_NOEXCEPT{return !snapshot.empty();}
+
 BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   ordered_index_impl(const ctor_args_list& args_list,const allocator_type& al):
     super(args_list.get_tail(),al),
     key(tuples::get<0>(args_list.get_head())),
-    comp_(tuples::get<1>(args_list.get_head()))
+    comp_(tuples::get<1>(args_list.get_head())),
+    appending(false)
   {
     empty_initialize();
   }
@@ -660,7 +891,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 #endif
 
     key(x.key),
-    comp_(x.comp_)
+    comp_(x.comp_),
+    appending(false)
   {
     /* Copy ctor just takes the key and compare objects from x. The rest is
      * done in a subsequent call to copy_().
@@ -678,7 +910,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 #endif
 
     key(x.key),
-    comp_(x.comp_)
+    comp_(x.comp_),
+    appending(false)
   {
     empty_initialize();
   }
@@ -730,6 +963,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
         cpy->color()=org->color();
         AugmentPolicy::copy(org->impl(),cpy->impl());
+        AugmentPolicy::assign(cpy->impl(),cpy->value(),key);
 
         node_impl_pointer parent_org=org->parent();
         if(parent_org==node_impl_pointer(0))cpy->parent()=node_impl_pointer(0);
@@ -752,6 +986,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
         if(org->right()==node_impl_pointer(0))
           cpy->right()=node_impl_pointer(0);
       }
+      node_impl_type::rethread(header()->impl());
     }
     
     super::copy_(x,map);
@@ -762,17 +997,15 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     value_param_type v,final_node_type*& x,Variant variant)
   {
     link_info inf;
-    if(!link_point(key(v),inf,Category())){
+    if(!(appending?
+         append_link_point(key(v),inf,Category()):
+         link_point(key(v),inf,Category()))){
       return static_cast<final_node_type*>(
         index_node_type::from_impl(inf.pos));
     }
 
     final_node_type* res=super::insert_(v,x,variant);
-    if(res==x){
-      node_impl_type::link(
-        static_cast<index_node_type*>(x)->impl(),
-        inf.side,inf.pos,header()->impl());
-    }
+    if(res==x)link(static_cast<index_node_type*>(x),inf);
     return res;
   }
 
@@ -782,22 +1015,21 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     final_node_type*& x,Variant variant)
   {
     link_info inf;
-    if(!hinted_link_point(key(v),position,inf,Category())){
+    if(!(appending?
+         append_link_point(key(v),inf,Category()):
+         hinted_link_point(key(v),position,inf,Category()))){
       return static_cast<final_node_type*>(
         index_node_type::from_impl(inf.pos));
     }
 
     final_node_type* res=super::insert_(v,position,x,variant);
-    if(res==x){
-      node_impl_type::link(
-        static_cast<index_node_type*>(x)->impl(),
-        inf.side,inf.pos,header()->impl());
-    }
+    if(res==x)link(static_cast<index_node_type*>(x),inf);
     return res;
   }
 
   void extract_(index_node_type* x)
   {
+    unfreeze();
     node_impl_type::rebalance_for_extract(
       x->impl(),header()->parent(),header()->left(),header()->right());
     super::extract_(x);
@@ -816,6 +1048,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   {
     super::clear_();
     empty_initialize();
+    unfreeze();
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super::detach_dereferenceable_iterators();
@@ -830,6 +1063,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   {
     adl_swap(key,x.key);
     adl_swap(comp_,x.comp_);
+    snapshot.swap(x.snapshot);
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super::swap(x);
@@ -842,6 +1076,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     ordered_index_impl<
       KeyFromValue,Compare,SuperMeta,TagList,Category,AugmentPolicy>& x)
   {
+    snapshot.swap(x.snapshot);
+
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super::swap(x);
 #endif
@@ -852,8 +1088,11 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   template<typename Variant>
   bool replace_(value_param_type v,index_node_type* x,Variant variant)
   {
+    unfreeze();
     if(in_place(v,x,Category())){
-      return super::replace_(v,x,variant);
+      if(!super::replace_(v,x,variant))return false;
+      reaugment(x);
+      return true;
     }
 
     index_node_type* next=x;
@@ -865,6 +1104,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     BOOST_TRY{
       link_info inf;
       if(link_point(key(v),inf,Category())&&super::replace_(v,x,variant)){
+        AugmentPolicy::assign(x->impl(),x->value(),key);
         node_impl_type::link(x->impl(),inf.side,inf.pos,header()->impl());
         return true;
       }
@@ -880,6 +1120,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
   bool modify_(index_node_type* x)
   {
+    unfreeze();
+
     bool b;
     BOOST_TRY{
       b=in_place(x->value(),x,Category());
@@ -889,7 +1131,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
       BOOST_RETHROW;
     }
     BOOST_CATCH_END
-    if(!b){
+    if(b)reaugment(x);
+    else{
       node_impl_type::rebalance_for_extract(
         x->impl(),header()->parent(),header()->left(),header()->right());
       BOOST_TRY{
@@ -902,6 +1145,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 #endif
           return false;
         }
+        AugmentPolicy::assign(x->impl(),x->value(),key);
         node_impl_type::link(x->impl(),inf.side,inf.pos,header()->impl());
       }
       BOOST_CATCH(...){
@@ -944,7 +1188,9 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
   bool modify_rollback_(index_node_type* x)
   {
+    unfreeze();
     if(in_place(x->value(),x,Category())){
+      reaugment(x);
       return super::modify_rollback_(x);
     }
 
@@ -958,6 +1204,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
       link_info inf;
       if(link_point(key(x->value()),inf,Category())&&
          super::modify_rollback_(x)){
+        AugmentPolicy::assign(x->impl(),x->value(),key);
         node_impl_type::link(x->impl(),inf.side,inf.pos,header()->impl());
         return true;
       }
@@ -976,6 +1223,24 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     return in_place(x->value(),x,Category())&&super::check_rollback_(x);
   }
 
+  /* When the index is empty at the start of a bulk insertion, elements
+   * are appended without rebalancing as long as they come in order, and
+   * the tree is built in one go at the end or as soon as an element does
+   * not go last.
+   */
+
+  void bulk_insert_begin_()
+  {
+    appending=(root()==0);
+    super::bulk_insert_begin_();
+  }
+
+  void bulk_insert_end_()
+  {
+    if(appending)end_appending();
+    super::bulk_insert_end_();
+  }
+
 #if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
   /* serialization */
 
@@ -998,6 +1263,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
   bool invariant_()const
   {
+    if(!node_impl_type::threads_invariant(header()->impl()))return false;
+
     if(size()==0||begin()==end()){
       if(size()!=0||begin()!=end()||
          header()->left()!=header()->impl()||
@@ -1031,6 +1298,19 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
         return false;
     }
 
+    if(frozen()){
+      if(snapshot.size()!=size()||snapshot.end()!=header()->impl())
+        return false;
+
+      std::size_t k=snapshot_type::first_position(size());
+      for(const_iterator it=begin(),it_end=end();it!=it_end;
+          ++it,k=snapshot_type::next_position(k,size())){
+        if(snapshot.pointer_at(k)!=it.get_node()->impl())return false;
+        if(comp_(snapshot.key_at(k),key(*it))||
+           comp_(key(*it),snapshot.key_at(k)))return false;
+      }
+    }
+
     return super::invariant_();
   }
 
@@ -1054,6 +1334,10 @@ protected: /* for the benefit of AugmentPolicy::augmented_interface */
     {return index_node_type::from_impl(header()->right());}
 
 private:
+  /* searches in flight at a time in find_batch and lower_bound_batch */
+
+  BOOST_STATIC_CONSTANT(std::size_t,lookup_batch_size=16);
+
   void empty_initialize()
   {
     header()->color()=red;
@@ -1062,6 +1346,7 @@ private:
     header()->parent()=node_impl_pointer(0);
     header()->left()=header()->impl();
     header()->right()=header()->impl();
+    node_impl_type::rethread(header()->impl());
   }
 
   struct link_info
@@ -1075,12 +1360,13 @@ private:
 
   bool link_point(key_param_type k,link_info& inf,ordered_unique_tag)
   {
+    key_probe        probe(key,comp_,k);
     index_node_type* y=header();
     index_node_type* x=root();
     bool c=true;
     while(x){
       y=x;
-      c=comp_(k,key(x->value()));
+      c=probe.goes_before(x);
       x=index_node_type::from_impl(c?x->left():x->right());
     }
     index_node_type* yy=y;
@@ -1093,7 +1379,7 @@ private:
       else index_node_type::decrement(yy);
     }
 
-    if(comp_(key(yy->value()),k)){
+    if(probe.goes_after(yy)){
       inf.side=c?to_left:to_right;
       inf.pos=y->impl();
       return true;
@@ -1106,12 +1392,13 @@ private:
 
   bool link_point(key_param_type k,link_info& inf,ordered_non_unique_tag)
   {
+    key_probe        probe(key,comp_,k);
     index_node_type* y=header();
     index_node_type* x=root();
     bool c=true;
     while (x){
      y=x;
-     c=comp_(k,key(x->value()));
+     c=probe.goes_before(x);
      x=index_node_type::from_impl(c?x->left():x->right());
     }
     inf.side=c?to_left:to_right;
@@ -1119,14 +1406,71 @@ private:
     return true;
   }
 
+  bool append_link_point(key_param_type k,link_info& inf,ordered_unique_tag)
+  {
+    index_node_type* y=rightmost();
+    if(y==header()||comp_(key(y->value()),k)){
+      inf.pos=y->impl();
+      return true;
+    }
+    else if(!comp_(k,key(y->value()))){
+      inf.pos=y->impl();
+      return false;
+    }
+    end_appending();
+    return link_point(k,inf,ordered_unique_tag());
+  }
+
+  bool append_link_point(
+    key_param_type k,link_info& inf,ordered_non_unique_tag)
+  {
+    index_node_type* y=rightmost();
+    if(y==header()||!comp_(k,key(y->value()))){
+      inf.pos=y->impl();
+      return true;
+    }
+    end_appending();
+    return link_point(k,inf,ordered_non_unique_tag());
+  }
+
+  void end_appending()
+  {
+    appending=false;
+    node_impl_type::build(header()->impl(),size());
+  }
+
+  /* insertions link nodes here, and other modifications go through
+   * extract_, clear_, replace_, modify_, modify_rollback_ or the join-based
+   * set operations, all of which drop the snapshot of a frozen index
+   */
+
+  void link(index_node_type* x,const link_info& inf)
+  {
+    unfreeze();
+    AugmentPolicy::assign(x->impl(),x->value(),key);
+    if(appending)node_impl_type::append(x->impl(),header()->impl());
+    else node_impl_type::link(x->impl(),inf.side,inf.pos,header()->impl());
+  }
+
+  /* augmented data depending on the value of x are recomputed when it
+   * changes with x staying in place
+   */
+
+  void reaugment(index_node_type* x)
+  {
+    AugmentPolicy::assign(x->impl(),x->value(),key);
+    AugmentPolicy::update(x->impl(),node_impl_pointer(header()->parent()));
+  }
+
   bool lower_link_point(key_param_type k,link_info& inf,ordered_non_unique_tag)
   {
+    key_probe        probe(key,comp_,k);
     index_node_type* y=header();
     index_node_type* x=root();
     bool c=false;
     while (x){
      y=x;
-     c=comp_(key(x->value()),k);
+     c=probe.goes_after(x);
      x=index_node_type::from_impl(c?x->right():x->left());
     }
     inf.side=c?to_right:to_left;
@@ -1224,6 +1568,498 @@ private:
     this->final_delete_node_(static_cast<final_node_type*>(x));
   }
 
+  /* Set operations recursively split the subtree of *this being processed
+   * by the key of the root of the corresponding subtree of x, apply
+   * themselves to both halves and join the results back. If a comparison
+   * throws, every function destroys the detached subtrees it has been given
+   * or holds, and the containers involved are left empty.
+   */
+
+  void set_union_(ordered_index_impl& x)
+  {
+    unfreeze();
+    x.unfreeze();
+
+    node_impl_pointer s=x.header()->parent();
+    size_type         n=size()+x.size(),m=0;
+    bool              linking=x.size()*8<size();
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    x.safe_super::detach_dereferenceable_iterators();
+#endif
+
+    x.empty_initialize();
+    BOOST_TRY{
+      if(linking)link_all_(s,x.header()->impl(),m);
+      else{
+        node_impl_pointer t=header()->parent();
+        std::size_t       ht=node_impl_type::black_height(t),
+                          hs=node_impl_type::black_height(s);
+        empty_initialize();
+        union_(t,ht,s,hs,x.header()->impl(),m,Category());
+        set_root(t);
+      }
+    }
+    BOOST_CATCH(...){
+      for(node_impl_pointer y=x.header()->left();y!=x.header()->impl();){
+        node_impl_pointer z=y->parent();
+        delete_node(y);
+        y=z;
+      }
+      if(linking)delete_all_nodes(root());
+      empty_initialize();
+      x.empty_initialize();
+      this->final_set_size_(0);
+      x.final_set_size_(0);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+      safe_super::detach_dereferenceable_iterators();
+#endif
+
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    node_impl_type::build(x.header()->impl(),m);
+    node_impl_type::rethread(x.header()->impl());
+    this->final_set_size_(n-m);
+    x.final_set_size_(m);
+  }
+
+  void set_intersection_(const ordered_index_impl& x,bool keep)
+  {
+    unfreeze();
+    if(!keep&&x.size()*2<size()){
+      /* same as in link_all_, with the crossover at m=n/2 */
+
+      for(const_iterator it=x.begin(),it_end=x.end();it!=it_end;++it){
+        erase(key(*it));
+      }
+      return;
+    }
+
+    node_impl_pointer t=header()->parent();
+    std::size_t       ht=node_impl_type::black_height(t);
+    size_type         n=size(),m=0;
+
+    empty_initialize();
+    BOOST_TRY{
+      intersection_(t,ht,x.header()->parent(),keep,m);
+    }
+    BOOST_CATCH(...){
+      empty_initialize();
+      this->final_set_size_(0);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+      safe_super::detach_dereferenceable_iterators();
+#endif
+
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    set_root(t);
+    this->final_set_size_(n-m);
+  }
+
+  void split_(key_param_type k,ordered_index_impl& x)
+  {
+    unfreeze();
+    x.unfreeze();
+
+    node_impl_pointer t=header()->parent(),l,r;
+    std::size_t       ht=node_impl_type::black_height(t),hl,hr;
+    size_type         n=size();
+
+    empty_initialize();
+    BOOST_TRY{
+      split_(t,ht,k,false,l,hl,r,hr);
+    }
+    BOOST_CATCH(...){
+      empty_initialize();
+      this->final_set_size_(0);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+      safe_super::detach_dereferenceable_iterators();
+#endif
+
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    set_root(l);
+    x.set_root(r);
+
+    /* sizes are found by counting the smaller part only */
+
+    size_type        m=0;
+    index_node_type* y=leftmost();
+    index_node_type* z=x.leftmost();
+    for(;y!=header()&&z!=x.header();++m){
+      index_node_type::increment(y);
+      index_node_type::increment(z);
+    }
+    if(y==header())m=n-m;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    for(z=x.leftmost();z!=x.header();index_node_type::increment(z)){
+      detach_iterators(z);
+    }
+#endif
+
+    this->final_set_size_(n-m);
+    x.final_set_size_(m);
+  }
+
+  /* splits t into l, with the elements whose key is less than (or not
+   * greater than, if upper) k, and r, with the rest
+   */
+
+  void split_(
+    node_impl_pointer t,std::size_t ht,const key_type& k,bool upper,
+    node_impl_pointer& l,std::size_t& hl,node_impl_pointer& r,std::size_t& hr)
+  {
+    if(t==node_impl_pointer(0)){
+      l=r=t;
+      hl=hr=0;
+      return;
+    }
+
+    bool to_left;
+    BOOST_TRY{
+      to_left=upper?
+        !comp_(k,key(index_node_type::from_impl(t)->value())):
+        comp_(key(index_node_type::from_impl(t)->value()),k);
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(t);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+
+    node_impl_pointer a=t->left(),b=t->right();
+    std::size_t       ha=ht,hb=ht;
+    node_impl_type::as_root(a,ha);
+    node_impl_type::as_root(b,hb);
+    if(to_left){
+      BOOST_TRY{
+        split_(b,hb,k,upper,l,hl,r,hr);
+      }
+      BOOST_CATCH(...){
+        delete_all_nodes(a);
+        delete_node(t);
+        BOOST_RETHROW;
+      }
+      BOOST_CATCH_END
+      node_impl_type::join(a,ha,t,l,hl,header()->impl());
+      l=a;
+      hl=ha;
+    }
+    else{
+      BOOST_TRY{
+        split_(a,ha,k,upper,l,hl,r,hr);
+      }
+      BOOST_CATCH(...){
+        delete_all_nodes(b);
+        delete_node(t);
+        BOOST_RETHROW;
+      }
+      BOOST_CATCH_END
+      node_impl_type::join(r,hr,t,b,hb,header()->impl());
+    }
+  }
+
+  /* splits t into the elements with key less than, equivalent to and
+   * greater than k
+   */
+
+  void split_(
+    node_impl_pointer t,std::size_t ht,const key_type& k,
+    node_impl_pointer& l,std::size_t& hl,node_impl_pointer& e,std::size_t& he,
+    node_impl_pointer& r,std::size_t& hr,ordered_unique_tag)
+  {
+    split_(t,ht,k,false,l,hl,r,hr);
+    e=node_impl_pointer(0);
+    he=0;
+    if(r==node_impl_pointer(0))return;
+
+    bool found;
+    BOOST_TRY{
+      found=!comp_(
+        k,key(index_node_type::from_impl(
+          node_impl_type::minimum(r))->value()));
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(l);
+      delete_all_nodes(r);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    if(found){
+      e=node_impl_type::split_first(r,hr,header()->impl());
+      e->color()=black;
+      e->left()=e->right()=node_impl_pointer(0);
+      AugmentPolicy::build(e);
+      he=1;
+    }
+  }
+
+  void split_(
+    node_impl_pointer t,std::size_t ht,const key_type& k,
+    node_impl_pointer& l,std::size_t& hl,node_impl_pointer& e,std::size_t& he,
+    node_impl_pointer& r,std::size_t& hr,ordered_non_unique_tag)
+  {
+    split_(t,ht,k,false,l,hl,r,hr);
+    BOOST_TRY{
+      split_(r,hr,k,true,e,he,r,hr);
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(l);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+  }
+
+  /* When x is much smaller than *this, linking its nodes one by one is
+   * faster than splitting *this by every one of them, in spite of the
+   * O(m*log(n)) complexity: join-based union is only faster beyond
+   * m=n/8 or so.
+   */
+
+  void link_all_(node_impl_pointer s,node_impl_pointer xheader,size_type& m)
+  {
+    if(s==node_impl_pointer(0))return;
+
+    node_impl_pointer r=s->right();
+    BOOST_TRY{
+      link_all_(s->left(),xheader,m);
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(r);
+      delete_node(s);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+
+    link_info inf;
+    bool      linkable;
+    BOOST_TRY{
+      linkable=link_point(
+        key(index_node_type::from_impl(s)->value()),inf,Category());
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(r);
+      delete_node(s);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    if(linkable){
+      node_impl_type::link(s,inf.side,inf.pos,header()->impl());
+    }
+    else{
+      node_impl_type::append(s,xheader);
+      ++m;
+    }
+    link_all_(r,xheader,m);
+  }
+
+  /* moves into t the elements of the subtree s of x, leaving in x those
+   * (counted in m) equivalent to some element of t
+   */
+
+  void union_(
+    node_impl_pointer& t,std::size_t& ht,node_impl_pointer s,std::size_t hs,
+    node_impl_pointer xheader,size_type& m,ordered_unique_tag)
+  {
+    if(s==node_impl_pointer(0))return;
+    if(t==node_impl_pointer(0)){
+      t=s;
+      ht=hs;
+      return;
+    }
+
+    node_impl_pointer a=s->left(),b=s->right(),l,e,r;
+    std::size_t       ha=hs,hb=hs,hl,he,hr;
+    node_impl_type::as_root(a,ha);
+    node_impl_type::as_root(b,hb);
+    BOOST_TRY{
+      split_(
+        t,ht,key(index_node_type::from_impl(s)->value()),l,hl,e,he,r,hr,
+        ordered_unique_tag());
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(s);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    BOOST_TRY{
+      union_(l,hl,a,ha,xheader,m,ordered_unique_tag());
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(r);
+      delete_all_nodes(b);
+      delete_node(s);
+      if(e!=node_impl_pointer(0))delete_node(e);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    if(e!=node_impl_pointer(0)){
+      node_impl_type::append(s,xheader);
+      ++m;
+      s=e;
+    }
+    BOOST_TRY{
+      union_(r,hr,b,hb,xheader,m,ordered_unique_tag());
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(l);
+      delete_node(s);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    node_impl_type::join(l,hl,s,r,hr,header()->impl());
+    t=l;
+    ht=hl;
+  }
+
+  void union_(
+    node_impl_pointer& t,std::size_t& ht,node_impl_pointer s,std::size_t hs,
+    node_impl_pointer xheader,size_type& m,ordered_non_unique_tag)
+  {
+    if(s==node_impl_pointer(0))return;
+    if(t==node_impl_pointer(0)){
+      t=s;
+      ht=hs;
+      return;
+    }
+
+    /* elements of *this go before their equivalents in x */
+
+    node_impl_pointer a=s->left(),b=s->right(),l,r;
+    std::size_t       ha=hs,hb=hs,hl,hr;
+    node_impl_type::as_root(a,ha);
+    node_impl_type::as_root(b,hb);
+    BOOST_TRY{
+      split_(t,ht,key(index_node_type::from_impl(s)->value()),true,l,hl,r,hr);
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(s);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    BOOST_TRY{
+      union_(l,hl,a,ha,xheader,m,ordered_non_unique_tag());
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(r);
+      delete_all_nodes(b);
+      delete_node(s);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    BOOST_TRY{
+      union_(r,hr,b,hb,xheader,m,ordered_non_unique_tag());
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(l);
+      delete_node(s);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    node_impl_type::join(l,hl,s,r,hr,header()->impl());
+    t=l;
+    ht=hl;
+  }
+
+  /* keeps in t the elements with (if keep) or without (if !keep) an
+   * equivalent in the subtree s of x, erasing the rest and counting them
+   * in m
+   */
+
+  void intersection_(
+    node_impl_pointer& t,std::size_t& ht,node_impl_pointer s,bool keep,
+    size_type& m)
+  {
+    if(t==node_impl_pointer(0))return;
+    if(s==node_impl_pointer(0)){
+      if(keep){
+        erase_all_nodes(t,m);
+        t=node_impl_pointer(0);
+        ht=0;
+      }
+      return;
+    }
+
+    node_impl_pointer l,e,r;
+    std::size_t       hl,he,hr;
+    split_(
+      t,ht,key(index_node_type::from_impl(s)->value()),l,hl,e,he,r,hr,
+      Category());
+    if(!keep){
+      erase_all_nodes(e,m);
+      e=node_impl_pointer(0);
+      he=0;
+    }
+    BOOST_TRY{
+      intersection_(l,hl,s->left(),keep,m);
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(e);
+      delete_all_nodes(r);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    BOOST_TRY{
+      intersection_(r,hr,s->right(),keep,m);
+    }
+    BOOST_CATCH(...){
+      delete_all_nodes(l);
+      delete_all_nodes(e);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    node_impl_type::join(l,hl,e,he,header()->impl());
+    node_impl_type::join(l,hl,r,hr,header()->impl());
+    t=l;
+    ht=hl;
+  }
+
+  void set_root(node_impl_pointer x)
+  {
+    if(x==node_impl_pointer(0)){
+      empty_initialize();
+      return;
+    }
+    header()->parent()=x;
+    x->parent()=header()->impl();
+    header()->left()=node_impl_type::minimum(x);
+    header()->right()=node_impl_type::maximum(x);
+    node_impl_type::rethread(header()->impl());
+  }
+
+  void delete_all_nodes(node_impl_pointer x)
+  {
+    delete_all_nodes(index_node_type::from_impl(x));
+  }
+
+  void delete_node(node_impl_pointer x)
+  {
+    this->final_delete_node_(
+      static_cast<final_node_type*>(index_node_type::from_impl(x)));
+  }
+
+  void erase_all_nodes(node_impl_pointer x,size_type& m)
+  {
+    if(x==node_impl_pointer(0))return;
+
+    erase_all_nodes(x->left(),m);
+    erase_all_nodes(x->right(),m);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    detach_iterators(index_node_type::from_impl(x));
+#endif
+
+    delete_node(x);
+    ++m;
+  }
+
   bool in_place(value_param_type v,index_node_type* x,ordered_unique_tag)const
   {
     index_node_type* y;
@@ -1436,6 +2272,10 @@ protected: /* for the benefit of AugmentPolicy::augmented_interface */
   key_from_value key;
   key_compare    comp_;
 
+private:
+  bool           appending;
+  snapshot_type  snapshot;
+
 #if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)&&\
     BOOST_WORKAROUND(__MWERKS__,<=0x3003)
 #pragma parse_mfunc_templ reset
@@ -42,6 +42,7 @@
 
 #include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
 #include <cstddef>
+#include <boost/mpl/bool.hpp>
 #include <boost/multi_index/detail/allocator_traits.hpp>
 #include <boost/multi_index/detail/raw_ptr.hpp>
 
@@ -64,6 +65,14 @@ namespace detail{
 enum ordered_index_color{red=false,black=true};
 enum ordered_index_side{to_left=false,to_right=true};
 
+/* Nodes are threaded, i.e. they keep pointers next() and prev() to their
+ * in-order neighbors, with the header closing the ring, when the augment
+ * policy specializes this to mpl::true_.
+ */
+
+template<typename AugmentPolicy>
+struct ordered_index_threaded:mpl::false_{};
+
 template<typename AugmentPolicy,typename Allocator>
 struct ordered_index_node_impl; /* fwd decl. */
 
@@ -254,6 +263,7 @@ struct ordered_index_node_impl:
 {
 private:
   typedef ordered_index_node_impl_base<AugmentPolicy,Allocator> super;
+  typedef typename ordered_index_threaded<AugmentPolicy>::type  threaded;
 
 public:
   typedef typename super::color_ref                             color_ref;
@@ -263,7 +273,16 @@ public:
 
   /* interoperability with bidir_node_iterator */
 
-  static void increment(pointer& x)
+  static void increment(pointer& x){increment(x,threaded());}
+  static void decrement(pointer& x){decrement(x,threaded());}
+
+  /* threads upkeep, no-ops for unthreaded nodes */
+
+  static void thread(pointer x,pointer header){thread(x,header,threaded());}
+  static void unthread(pointer x){unthread(x,threaded());}
+  static void rethread(pointer header){rethread(header,threaded());}
+
+  static void increment(pointer& x,mpl::false_)
   {
     if(x->right()!=pointer(0)){
       x=x->right();
@@ -279,7 +298,7 @@ public:
     }
   }
 
-  static void decrement(pointer& x)
+  static void decrement(pointer& x,mpl::false_)
   {
     if(x->color()==red&&x->parent()->parent()==x){
       x=x->right();
@@ -298,6 +317,58 @@ public:
     }
   }
 
+  static void increment(pointer& x,mpl::true_){x=x->next();}
+  static void decrement(pointer& x,mpl::true_){x=x->prev();}
+
+  static void thread(pointer,pointer,mpl::false_){}
+
+  static void thread(pointer x,pointer header,mpl::true_)
+  {
+    /* x, already in the tree, goes after its predecessor */
+
+    pointer y;
+    if(x->left()!=pointer(0)){
+      y=x->left();
+      while(y->right()!=pointer(0))y=y->right();
+    }
+    else{
+      pointer z=x;
+      y=x->parent();
+      while(y!=header&&z==y->left()){
+        z=y;
+        y=y->parent();
+      }
+    }
+    x->prev()=y;
+    x->next()=y->next();
+    y->next()->prev()=x;
+    y->next()=x;
+  }
+
+  static void unthread(pointer,mpl::false_){}
+
+  static void unthread(pointer x,mpl::true_)
+  {
+    x->prev()->next()=x->next();
+    x->next()->prev()=x->prev();
+  }
+
+  static void rethread(pointer,mpl::false_){}
+
+  static void rethread(pointer header,mpl::true_)
+  {
+    pointer y=header;
+    if(header->parent()!=pointer(0)){
+      for(pointer x=header->left();x!=header;increment(x,mpl::false_())){
+        y->next()=x;
+        x->prev()=y;
+        y=x;
+      }
+    }
+    y->next()=header;
+    header->prev()=y;
+  }
+
   /* algorithmic stuff */
 
   static void rotate_left(pointer x,parent_ref root)
@@ -345,6 +416,16 @@ public:
   static void rebalance(pointer x,parent_ref root)
   {
     x->color()=red;
+    rebalance_red(x,root);
+    root->color()=black;
+  }
+
+  /* restores the red-black invariant broken by red node x having a red
+   * parent, leaving the root red when the black height is to grow
+   */
+
+  static void rebalance_red(pointer x,parent_ref root)
+  {
     while(x!=root&&x->parent()->color()==red){
       if(x->parent()==x->parent()->parent()->left()){
         pointer y=x->parent()->parent()->right();
@@ -383,7 +464,6 @@ public:
         }
       }
     }
-    root->color()=black;
   }
 
   static void link(
@@ -408,6 +488,7 @@ public:
     x->parent()=position;
     x->left()=pointer(0);
     x->right()=pointer(0);
+    thread(x,header);
     AugmentPolicy::add(x,pointer(header->parent()));
     ordered_index_node_impl::rebalance(x,header->parent());
   }
@@ -418,6 +499,7 @@ public:
     pointer y=z;
     pointer x=pointer(0);
     pointer x_parent=pointer(0);
+    unthread(z);
     if(y->left()==pointer(0)){    /* z has at most one non-null child. y==z. */
       x=y->right();               /* x might be null */
     }
@@ -454,6 +536,7 @@ public:
       ordered_index_color c=y->color();
       y->color()=z->color();
       z->color()=c;
+      AugmentPolicy::update(x_parent,pointer(root));
       y=z;                    /* y now points to node to be actually deleted */
     }
     else{                     /* y==z */
@@ -465,6 +548,7 @@ public:
       else{
         if(z->parent()->left()==z)z->parent()->left()=x;
         else                      z->parent()->right()=x;
+        AugmentPolicy::update(x_parent,pointer(root));
       }
       if(leftmost==z){
         if(z->right()==pointer(0)){ /* z->left() must be null also */
@@ -559,9 +643,170 @@ public:
     }
   }
 
+  /* Sorted input is appended by making x the new root, with the previous
+   * tree as its left subtree: the result is a valid but unbalanced search
+   * tree where each node is the parent of its predecessor, so that
+   * iteration stays constant time. build() then turns the n nodes of such
+   * a tree into a red-black tree of minimum height in linear time, coloring
+   * red the nodes of the last level when it is not complete.
+   */
+
+  static void append(pointer x,pointer header)
+  {
+    pointer y=header->parent();
+    if(y==pointer(0))header->left()=x;
+    else y->parent()=x;
+    x->color()=black;
+    x->parent()=header;
+    x->left()=y;
+    x->right()=pointer(0);
+    header->parent()=x;
+    header->right()=x;
+    thread(x,header);
+  }
+
+  static void build(pointer header,std::size_t n)
+  {
+    if(n==0)return;
+
+    std::size_t red_depth=0;
+    for(std::size_t m=n+1;m>1;m>>=1)++red_depth;
+    pointer x=header->left();
+    pointer root=build(x,n,0,red_depth);
+    header->parent()=root;
+    root->parent()=header;
+  }
+
+  /* Join-based set operations deal with detached subtrees with a black
+   * root, along with their black height, i.e. the number of black nodes in
+   * any path from the root down to a leaf (0 for the empty subtree).
+   * header only serves as a temporary parent of the subtree roots so that
+   * rotations can be reused, its left and right links are not touched.
+   */
+
+  static std::size_t black_height(pointer x)
+  {
+    std::size_t h=0;
+    for(;x!=pointer(0);x=x->left())if(x->color()==black)++h;
+    return h;
+  }
+
+  /* in: x is a child of a root of black height h */
+
+  static void as_root(pointer x,std::size_t& h)
+  {
+    if(x!=pointer(0)&&x->color()==red)x->color()=black;
+    else --h;
+  }
+
+  /* joins l, x and r, with every key in l before x and x before every key
+   * in r, into l, in O(|hl-hr|+1) time
+   */
+
+  static void join(
+    pointer& l,std::size_t& hl,pointer x,pointer r,std::size_t hr,
+    pointer header)
+  {
+    pointer     p=header,c;
+    std::size_t h;
+    if(hl>=hr){
+      for(c=l,h=hl;c!=pointer(0)&&(c->color()==red||h>hr);c=c->right()){
+        if(c->color()==black)--h;
+        p=c;
+      }
+      x->left()=c;
+      x->right()=r;
+      if(p!=header){
+        p->right()=x;
+        l->parent()=header;
+        header->parent()=l;
+      }
+    }
+    else{
+      for(c=r,h=hr;c!=pointer(0)&&(c->color()==red||h>hl);c=c->left()){
+        if(c->color()==black)--h;
+        p=c;
+      }
+      x->left()=l;
+      x->right()=c;
+      if(p!=header){
+        p->left()=x;
+        r->parent()=header;
+        header->parent()=r;
+      }
+      hl=hr;
+    }
+    if(p==header)header->parent()=x;
+    x->parent()=p;
+    if(x->left()!=pointer(0))x->left()->parent()=x;
+    if(x->right()!=pointer(0))x->right()->parent()=x;
+    for(pointer y=x;y!=header;y=y->parent())AugmentPolicy::build(y);
+    x->color()=red;
+    rebalance_red(x,header->parent());
+    l=header->parent();
+    if(l->color()==red){
+      l->color()=black;
+      ++hl;
+    }
+  }
+
+  /* same with no middle node */
+
+  static void join(
+    pointer& l,std::size_t& hl,pointer r,std::size_t hr,pointer header)
+  {
+    if(r==pointer(0))return;
+    if(l==pointer(0)){
+      l=r;
+      hl=hr;
+      return;
+    }
+    pointer x=split_first(r,hr,header);
+    join(l,hl,x,r,hr,header);
+  }
+
+  /* removes the minimum node from non-empty r and returns it */
+
+  static pointer split_first(pointer& r,std::size_t& hr,pointer header)
+  {
+    pointer     x=r,a=x->left(),b=x->right();
+    std::size_t ha=hr,hb=hr;
+    as_root(b,hb);
+    if(a==pointer(0)){
+      r=b;
+      hr=hb;
+      return x;
+    }
+    as_root(a,ha);
+    pointer y=split_first(a,ha,header);
+    join(a,ha,x,b,hb,header);
+    r=a;
+    hr=ha;
+    return y;
+  }
+
 #if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
   /* invariant stuff */
 
+  static bool threads_invariant(pointer header)
+  {
+    return threads_invariant(header,threaded());
+  }
+
+  static bool threads_invariant(pointer,mpl::false_){return true;}
+
+  static bool threads_invariant(pointer header,mpl::true_)
+  {
+    pointer y=header;
+    if(header->parent()!=pointer(0)){
+      for(pointer x=header->left();x!=header;increment(x,mpl::false_())){
+        if(y->next()!=x||x->prev()!=y)return false;
+        y=x;
+      }
+    }
+    return y->next()==header&&header->prev()==y;
+  }
+
   static std::size_t black_count(pointer node,pointer root)
   {
     if(node==pointer(0))return 0;
@@ -574,6 +819,29 @@ public:
     return sum;
   }
 #endif
+
+private:
+  /* builds a subtree with the n nodes starting at x, which is left
+   * pointing to the node after them
+   */
+
+  static pointer build(
+    pointer& x,std::size_t n,std::size_t depth,std::size_t red_depth)
+  {
+    if(n==0)return pointer(0);
+
+    pointer l=build(x,(n-1)/2,depth+1,red_depth);
+    pointer y=x;
+    x=y->parent();
+    pointer r=build(x,n-1-(n-1)/2,depth+1,red_depth);
+    y->left()=l;
+    if(l!=pointer(0))l->parent()=y;
+    y->right()=r;
+    if(r!=pointer(0))r->parent()=y;
+    y->color()=depth==red_depth?red:black;
+    AugmentPolicy::build(y);
+    return y;
+  }
 };
 
 template<typename AugmentPolicy,typename Super>
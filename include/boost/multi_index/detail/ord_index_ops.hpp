@@ -42,7 +42,9 @@
 
 #include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
 #include <boost/mpl/and.hpp>
+#include <boost/multi_index/detail/prefetch.hpp>
 #include <boost/multi_index/detail/promotes_arg.hpp>
+#include <cstddef>
 #include <utility>
 
 namespace boost{
@@ -257,6 +259,139 @@ inline std::pair<Node*,Node*> ordered_index_equal_range(
   return std::pair<Node*,Node*>(y,y);
 }
 
+/* Finger search: lower_bound starting from node x (possibly the header)
+ * rather than from the root. The search climbs from x keeping the
+ * subtree known to hold the elements between the closest ancestors found
+ * at either side of the key, and descends into it once an ancestor at the
+ * far side is reached.
+ */
+
+template<
+  typename Node,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline Node* ordered_index_finger_lower_bound(
+  Node* x,Node* header,const KeyFromValue& key,const CompatibleKey& k,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_index_finger_lower_bound(
+    x,header,key,k,comp,
+    promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey>());
+}
+
+template<
+  typename Node,typename KeyFromValue,
+  typename CompatibleCompare
+>
+inline Node* ordered_index_finger_lower_bound(
+  Node* x,Node* header,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& k,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_index_finger_lower_bound(
+    x,header,key,k,comp,mpl::false_());
+}
+
+template<
+  typename Node,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline Node* ordered_index_finger_lower_bound(
+  Node* x,Node* header,const KeyFromValue& key,const CompatibleKey& k,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  if(!Node::from_impl(header->parent()))return header;
+  if(x==header){
+    x=Node::from_impl(header->right());
+    if(comp(key(x->value()),k))return header;
+  }
+
+  Node* y;
+  Node* top;
+  if(comp(key(x->value()),k)){
+    y=header;
+    top=Node::from_impl(x->right());
+    for(Node* p=Node::from_impl(x->parent());p!=header;
+        x=p,p=Node::from_impl(p->parent())){
+      if(x->impl()==p->left()){
+        if(!comp(key(p->value()),k)){
+          y=p;
+          break;
+        }
+        top=Node::from_impl(p->right());
+      }
+    }
+  }
+  else{
+    y=x;
+    top=Node::from_impl(x->left());
+    for(Node* p=Node::from_impl(x->parent());p!=header;
+        x=p,p=Node::from_impl(p->parent())){
+      if(x->impl()==p->right()){
+        if(comp(key(p->value()),k))break;
+        y=p;
+        top=Node::from_impl(p->left());
+      }
+    }
+  }
+
+  return ordered_index_lower_bound(top,y,key,k,comp,mpl::false_());
+}
+
+/* Interleaved lower_bound of up to N unrelated keys starting at first,
+ * which is advanced past them; ys[i] is set to the lower bound of the i-th
+ * key and the number of keys taken is returned. Rather than running each
+ * search to completion before starting the next one, the searches take
+ * turns at descending one level, and the node each of them is to visit
+ * next is prefetched in the meantime, so that the cache misses of
+ * different searches overlap instead of adding up.
+ */
+
+template<
+  std::size_t N,typename Node,typename KeyFromValue,
+  typename ForwardIterator,typename CompatibleCompare
+>
+inline std::size_t ordered_index_lower_bound_batch(
+  Node* top,Node* y,const KeyFromValue& key,
+  ForwardIterator& first,ForwardIterator last,
+  const CompatibleCompare& comp,Node* (&ys)[N])
+{
+  ForwardIterator its[N];
+  Node*           tops[N];
+  std::size_t     pending[N];
+  std::size_t     n=0;
+  for(;n!=N&&first!=last;++n,++first){
+    its[n]=first;
+    tops[n]=top;
+    ys[n]=y;
+    pending[n]=n;
+  }
+
+  /* pending[0,m) holds the searches not yet finished */
+
+  for(std::size_t m=top?n:0;m!=0;){
+    for(std::size_t j=0;j<m;){
+      std::size_t i=pending[j];
+      Node*       x=tops[i];
+      if(!comp(key(x->value()),*its[i])){
+        ys[i]=x;
+        x=Node::from_impl(x->left());
+      }
+      else x=Node::from_impl(x->right());
+      if(x){
+        prefetch(x);
+        prefetch(&*x->impl());
+        tops[i]=x;
+        ++j;
+      }
+      else pending[j]=pending[--m];
+    }
+  }
+  return n;
+}
+
 } /* namespace multi_index::detail */
 
 } /* namespace multi_index */
@@ -0,0 +1,427 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_INDEX_SNAPSHOT_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_INDEX_SNAPSHOT_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/mpl/and.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/auto_space.hpp>
+#include <boost/multi_index/detail/prefetch.hpp>
+#include <boost/multi_index/detail/promotes_arg.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Read-only copy of an ordered index laid out in Eytzinger order: the
+ * n keys are stored in an implicit complete binary tree with the root at
+ * position 1 and the children of k at 2k and 2k+1, along with the node
+ * pointer of each element, which position 0 holds for end(). Searching
+ * goes down the array with no branch other than the loop condition,
+ * prefetching the cache line where the search will be some levels below,
+ * and the position sought is recovered at the bottom from the sequence
+ * of turns taken, which the final value of k encodes in binary:
+ *
+ *   k=1; while(k<=n)k=2k+(key[k] goes before x); k>>=(trailing ones of k)+1
+ *
+ * (Khuong and Morin, "Array layouts for comparison-based searching", 2017).
+ * Keys are copies of those of the elements, so lookups do not touch the
+ * nodes until the one found.
+ */
+
+template<typename Key,typename Pointer,typename Allocator>
+class ordered_index_snapshot:private noncopyable
+{
+  /* the arrays live in a block allocated by build, so that an ordered
+   * index never frozen pays only for a pointer
+   */
+
+  struct snapshot_impl:private noncopyable
+  {
+    snapshot_impl(const Allocator& al,std::size_t n_):
+      n(0),keys(al,n_+1),ptrs(al,n_+1)
+    {}
+
+    /* keys are constructed in order, and their positions depend on the
+     * capacity keys.size()-1
+     */
+
+    ~snapshot_impl()
+    {
+      Key*        ks=raw_ptr<Key*>(keys.data());
+      std::size_t c=keys.size()-1;
+      for(std::size_t k=first_position(c),m=n;m--;k=next_position(k,c)){
+        ks[k].~Key();
+      }
+    }
+
+    std::size_t                   n;
+    auto_space<Key,Allocator>     keys;
+    auto_space<Pointer,Allocator> ptrs;
+  };
+
+  typedef typename rebind_alloc_for<
+    Allocator,snapshot_impl
+  >::type                                      impl_allocator;
+  typedef allocator_traits<impl_allocator>     impl_alloc_traits;
+  typedef typename impl_alloc_traits::pointer  impl_pointer;
+
+public:
+  typedef Key     key_type;
+  typedef Pointer pointer;
+
+  ordered_index_snapshot():impl(0){}
+
+  ~ordered_index_snapshot(){clear();}
+
+  /* builds from the n_ nodes of an ordered index from x onwards */
+
+  template<typename Node,typename KeyFromValue>
+  void build(
+    const Allocator& al,Node* x,std::size_t n_,const KeyFromValue& key,
+    Pointer end_)
+  {
+    impl_allocator ial(al);
+    impl_pointer   p=impl_alloc_traits::allocate(ial,1);
+    BOOST_TRY{
+      impl_alloc_traits::construct(ial,raw_ptr<snapshot_impl*>(p),al,n_);
+    }
+    BOOST_CATCH(...){
+      impl_alloc_traits::deallocate(ial,p,1);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+
+    snapshot_impl* s=raw_ptr<snapshot_impl*>(p);
+    BOOST_TRY{
+      Key*     ks=raw_ptr<Key*>(s->keys.data());
+      Pointer* ps=raw_ptr<Pointer*>(s->ptrs.data());
+      ps[0]=end_;
+      for(std::size_t k=first_position(n_);s->n!=n_;
+          k=next_position(k,n_)){
+        ::new (static_cast<void*>(ks+k)) Key(key(x->value()));
+        ps[k]=x->impl();
+        Node::increment(x);
+        ++s->n;
+      }
+    }
+    BOOST_CATCH(...){
+      impl_alloc_traits::destroy(ial,s);
+      impl_alloc_traits::deallocate(ial,p,1);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    clear();
+    impl=p;
+  }
+
+  bool        empty()const{return impl==impl_pointer(0);}
+  std::size_t size()const{return empty()?0:get()->n;}
+  Pointer     end()const{return get()->ptrs.data()[0];}
+
+  std::size_t memory_size()const
+  {
+    if(empty())return 0;
+    const snapshot_impl* s=get();
+    return
+      sizeof(snapshot_impl)+
+      static_cast<std::size_t>(s->keys.size())*sizeof(Key)+
+      static_cast<std::size_t>(s->ptrs.size())*sizeof(Pointer);
+  }
+
+  /* first position with a key not going before x */
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  Pointer lower_bound(
+    const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    const snapshot_impl* s=get();
+    const Key*           ks=raw_ptr<Key*>(s->keys.data());
+    std::size_t          n=s->n,k=1;
+    while(k<=n){
+      prefetch(ks+(std::min)(k<<prefetch_levels,n));
+      k=2*k+(comp(ks[k],x)?1:0);
+    }
+    return s->ptrs.data()[pop_right_turns(k)];
+  }
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  Pointer upper_bound(
+    const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    const snapshot_impl* s=get();
+    const Key*           ks=raw_ptr<Key*>(s->keys.data());
+    std::size_t          n=s->n,k=1;
+    while(k<=n){
+      prefetch(ks+(std::min)(k<<prefetch_levels,n));
+      k=2*k+(comp(x,ks[k])?0:1);
+    }
+    return s->ptrs.data()[pop_right_turns(k)];
+  }
+
+  /* same as lower_bound, also telling the position found */
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  std::pair<Pointer,const Key*> lower_bound_key(
+    const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    const snapshot_impl* s=get();
+    const Key*           ks=raw_ptr<Key*>(s->keys.data());
+    std::size_t          n=s->n,k=1;
+    while(k<=n){
+      prefetch(ks+(std::min)(k<<prefetch_levels,n));
+      k=2*k+(comp(ks[k],x)?1:0);
+    }
+    k=pop_right_turns(k);
+    return std::pair<Pointer,const Key*>(s->ptrs.data()[k],k?ks+k:0);
+  }
+
+  /* key and pointer at position k, for invariant checking */
+
+  const Key& key_at(std::size_t k)const{return get()->keys.data()[k];}
+  Pointer    pointer_at(std::size_t k)const{return get()->ptrs.data()[k];}
+
+  static std::size_t first_position(std::size_t n_)
+  {
+    std::size_t k=1;
+    if(n_)while(2*k<=n_)k*=2;
+    return k;
+  }
+
+  static std::size_t next_position(std::size_t k,std::size_t n_)
+  {
+    if(2*k+1<=n_){
+      k=2*k+1;
+      while(2*k<=n_)k*=2;
+      return k;
+    }
+    return pop_right_turns(k);
+  }
+
+  void clear()
+  {
+    if(empty())return;
+    impl_allocator ial(get()->keys.get_allocator());
+    impl_alloc_traits::destroy(ial,get());
+    impl_alloc_traits::deallocate(ial,impl,1);
+    impl=impl_pointer(0);
+  }
+
+  void swap(ordered_index_snapshot& x)
+  {
+    std::swap(impl,x.impl);
+  }
+
+private:
+  /* 2^prefetch_levels keys fill about a cache line */
+
+  BOOST_STATIC_CONSTANT(
+    std::size_t,prefetch_levels=
+      sizeof(Key)<=4?4:sizeof(Key)<=8?3:sizeof(Key)<=16?2:1);
+
+  /* drops the trailing right turns and the last left one */
+
+  static std::size_t pop_right_turns(std::size_t k)
+  {
+#if defined(BOOST_GCC)||defined(BOOST_CLANG)
+    return k>>(__builtin_ctzll(~static_cast<unsigned long long>(k))+1);
+#else
+    while(k&1)k>>=1;
+    return k>>1;
+#endif
+  }
+
+  snapshot_impl* get()const{return raw_ptr<snapshot_impl*>(impl);}
+
+  impl_pointer impl;
+};
+
+/* Lookup through a snapshot, with CompatibleKey promoted in advance as in
+ * ord_index_ops.hpp.
+ */
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Snapshot::pointer ordered_index_snapshot_find(
+  const Snapshot& s,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_index_snapshot_find(
+    s,key,x,comp,
+    mpl::and_<
+      promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>,
+      promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey> >());
+}
+
+template<typename Snapshot,typename KeyFromValue,typename CompatibleCompare>
+inline typename Snapshot::pointer ordered_index_snapshot_find(
+  const Snapshot& s,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_index_snapshot_find(s,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Snapshot::pointer ordered_index_snapshot_find(
+  const Snapshot& s,const KeyFromValue&,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  typedef typename Snapshot::key_type key_type;
+  typedef typename Snapshot::pointer  pointer;
+
+  std::pair<pointer,const key_type*> p=s.lower_bound_key(x,comp);
+  return (!p.second||comp(x,*p.second))?s.end():p.first;
+}
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Snapshot::pointer ordered_index_snapshot_lower_bound(
+  const Snapshot& s,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_index_snapshot_lower_bound(
+    s,key,x,comp,
+    promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey>());
+}
+
+template<typename Snapshot,typename KeyFromValue,typename CompatibleCompare>
+inline typename Snapshot::pointer ordered_index_snapshot_lower_bound(
+  const Snapshot& s,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_index_snapshot_lower_bound(s,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Snapshot::pointer ordered_index_snapshot_lower_bound(
+  const Snapshot& s,const KeyFromValue&,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  return s.lower_bound(x,comp);
+}
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Snapshot::pointer ordered_index_snapshot_upper_bound(
+  const Snapshot& s,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_index_snapshot_upper_bound(
+    s,key,x,comp,
+    promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>());
+}
+
+template<typename Snapshot,typename KeyFromValue,typename CompatibleCompare>
+inline typename Snapshot::pointer ordered_index_snapshot_upper_bound(
+  const Snapshot& s,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_index_snapshot_upper_bound(s,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline typename Snapshot::pointer ordered_index_snapshot_upper_bound(
+  const Snapshot& s,const KeyFromValue&,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  return s.upper_bound(x,comp);
+}
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline std::pair<typename Snapshot::pointer,typename Snapshot::pointer>
+ordered_index_snapshot_equal_range(
+  const Snapshot& s,const KeyFromValue& key,const CompatibleKey& x,
+  const CompatibleCompare& comp)
+{
+  typedef typename KeyFromValue::result_type key_type;
+
+  return ordered_index_snapshot_equal_range(
+    s,key,x,comp,
+    mpl::and_<
+      promotes_1st_arg<CompatibleCompare,CompatibleKey,key_type>,
+      promotes_2nd_arg<CompatibleCompare,key_type,CompatibleKey> >());
+}
+
+template<typename Snapshot,typename KeyFromValue,typename CompatibleCompare>
+inline std::pair<typename Snapshot::pointer,typename Snapshot::pointer>
+ordered_index_snapshot_equal_range(
+  const Snapshot& s,const KeyFromValue& key,
+  const BOOST_DEDUCED_TYPENAME KeyFromValue::result_type& x,
+  const CompatibleCompare& comp,mpl::true_)
+{
+  return ordered_index_snapshot_equal_range(s,key,x,comp,mpl::false_());
+}
+
+template<
+  typename Snapshot,typename KeyFromValue,
+  typename CompatibleKey,typename CompatibleCompare
+>
+inline std::pair<typename Snapshot::pointer,typename Snapshot::pointer>
+ordered_index_snapshot_equal_range(
+  const Snapshot& s,const KeyFromValue&,const CompatibleKey& x,
+  const CompatibleCompare& comp,mpl::false_)
+{
+  typedef typename Snapshot::key_type key_type;
+  typedef typename Snapshot::pointer  pointer;
+
+  std::pair<pointer,const key_type*> p=s.lower_bound_key(x,comp);
+  if(!p.second||comp(x,*p.second)){
+    return std::pair<pointer,pointer>(p.first,p.first);
+  }
+  return std::pair<pointer,pointer>(p.first,s.upper_bound(x,comp));
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
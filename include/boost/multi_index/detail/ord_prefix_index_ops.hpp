@@ -0,0 +1,209 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_ORD_PREFIX_INDEX_OPS_HPP
+#define BOOST_MULTI_INDEX_DETAIL_ORD_PREFIX_INDEX_OPS_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/cstdint.hpp>
+#include <boost/mpl/bool.hpp>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Prefixed ordered indices keep in every node the first 8 bytes of its
+ * string key, big-endian and zero-padded, along with the key length.
+ * Keys whose prefixes differ compare as their prefixes do, as
+ * std::char_traits<char> compares characters as unsigned char. When the
+ * prefixes are the same and one of the keys is 8 bytes long or less, this
+ * key is a prefix of the other (which is padded with zeros or has zeros
+ * beyond its length) and lengths decide. Only the remaining ties look
+ * into the elements.
+ */
+
+struct ordered_index_key_prefix
+{
+  boost::uint64_t bytes;
+  std::size_t     size;
+};
+
+template<typename Traits,typename Alloc>
+inline ordered_index_key_prefix make_ordered_index_key_prefix(
+  const std::basic_string<char,Traits,Alloc>& s)
+{
+  ordered_index_key_prefix res;
+  res.bytes=0;
+  res.size=s.size();
+  const char* p=s.data();
+  std::size_t n=res.size<8?res.size:8;
+  for(std::size_t i=0;i<n;++i){
+    res.bytes|=boost::uint64_t(static_cast<unsigned char>(p[i]))<<(56-8*i);
+  }
+  return res;
+}
+
+enum ordered_index_prefix_order
+{
+  prefix_less=-1,prefix_equal=0,prefix_greater=1,prefix_undecided=2
+};
+
+inline ordered_index_prefix_order compare_ordered_index_key_prefixes(
+  const ordered_index_key_prefix& x,const ordered_index_key_prefix& y)
+{
+  if(x.bytes!=y.bytes)return x.bytes<y.bytes?prefix_less:prefix_greater;
+  if(x.size<=8||y.size<=8){
+    return x.size<y.size?prefix_less:
+           y.size<x.size?prefix_greater:prefix_equal;
+  }
+  return prefix_undecided;
+}
+
+/* The augment policy of prefixed indices specializes this to mpl::true_,
+ * so that insertions locate their link point with the prefix as well.
+ */
+
+template<typename AugmentPolicy>
+struct ordered_index_prefixed:mpl::false_{};
+
+/* Key probes compare a given key k against the key of node x:
+ * goes_before(x) is k<key(x) and goes_after(x) is key(x)<k.
+ */
+
+template<
+  typename Node,typename KeyFromValue,typename Compare,typename Key
+>
+struct ordered_index_key_probe
+{
+  ordered_index_key_probe(
+    const KeyFromValue& key_,const Compare& comp_,const Key& k_):
+    key(key_),comp(comp_),k(k_)
+  {}
+
+  bool goes_before(Node* x)const{return comp(k,key(x->value()));}
+  bool goes_after(Node* x)const{return comp(key(x->value()),k);}
+
+  const KeyFromValue& key;
+  const Compare&      comp;
+  const Key&          k;
+};
+
+template<
+  typename Node,typename KeyFromValue,typename Compare,typename Key
+>
+struct ordered_index_prefix_probe
+{
+  ordered_index_prefix_probe(
+    const KeyFromValue& key_,const Compare& comp_,const Key& k_):
+    key(key_),comp(comp_),k(k_),kp(make_ordered_index_key_prefix(k_))
+  {}
+
+  bool goes_before(Node* x)const
+  {
+    switch(compare_ordered_index_key_prefixes(kp,x->impl()->prefix)){
+      case prefix_less:      return true;
+      case prefix_undecided: return comp(k,key(x->value()));
+      default:               return false;
+    }
+  }
+
+  bool goes_after(Node* x)const
+  {
+    switch(compare_ordered_index_key_prefixes(kp,x->impl()->prefix)){
+      case prefix_greater:   return true;
+      case prefix_undecided: return comp(key(x->value()),k);
+      default:               return false;
+    }
+  }
+
+  const KeyFromValue&      key;
+  const Compare&           comp;
+  const Key&               k;
+  ordered_index_key_prefix kp;
+};
+
+/* lookups through a probe, as in ord_index_ops.hpp */
+
+template<typename Node,typename Probe>
+inline Node* ordered_index_probe_lower_bound(
+  Node* top,Node* y,const Probe& probe)
+{
+  while(top){
+    if(!probe.goes_after(top)){
+      y=top;
+      top=Node::from_impl(top->left());
+    }
+    else top=Node::from_impl(top->right());
+  }
+
+  return y;
+}
+
+template<typename Node,typename Probe>
+inline Node* ordered_index_probe_upper_bound(
+  Node* top,Node* y,const Probe& probe)
+{
+  while(top){
+    if(probe.goes_before(top)){
+      y=top;
+      top=Node::from_impl(top->left());
+    }
+    else top=Node::from_impl(top->right());
+  }
+
+  return y;
+}
+
+template<typename Node,typename Probe>
+inline Node* ordered_index_probe_find(Node* top,Node* y,const Probe& probe)
+{
+  Node* y0=y;
+  y=ordered_index_probe_lower_bound(top,y,probe);
+  return (y==y0||probe.goes_before(y))?y0:y;
+}
+
+template<typename Node,typename Probe>
+inline std::pair<Node*,Node*> ordered_index_probe_equal_range(
+  Node* top,Node* y,const Probe& probe)
+{
+  while(top){
+    if(probe.goes_after(top)){
+      top=Node::from_impl(top->right());
+    }
+    else if(probe.goes_before(top)){
+      y=top;
+      top=Node::from_impl(top->left());
+    }
+    else{
+      return std::pair<Node*,Node*>(
+        ordered_index_probe_lower_bound(
+          Node::from_impl(top->left()),top,probe),
+        ordered_index_probe_upper_bound(
+          Node::from_impl(top->right()),y,probe));
+    }
+  }
+
+  return std::pair<Node*,Node*>(y,y);
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
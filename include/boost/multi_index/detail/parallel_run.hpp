@@ -0,0 +1,119 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_PARALLEL_RUN_HPP
+#define BOOST_MULTI_INDEX_DETAIL_PARALLEL_RUN_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/core/no_exceptions_support.hpp>
+#include <cstddef>
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_THREADS)&&\
+    !defined(BOOST_NO_CXX11_HDR_THREAD)&&\
+    !defined(BOOST_NO_CXX11_HDR_EXCEPTION)&&\
+    !defined(BOOST_NO_EXCEPTIONS)
+#define BOOST_MULTI_INDEX_PARALLEL_RUN_USES_THREADS
+#include <exception>
+#include <thread>
+#include <vector>
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* parallel_run(n,f) invokes f(0),...,f(n-1) concurrently, f(0) on the
+ * calling thread and each of the rest on a thread of its own. Should a
+ * thread fail to launch, the calls not yet launched are made on the calling
+ * thread instead. If some calls throw, the exception from the one with the
+ * lowest index is rethrown once all of them have finished. Without C++11
+ * threads (or with BOOST_MULTI_INDEX_DISABLE_THREADS defined) the calls are
+ * made sequentially.
+ */
+
+#if defined(BOOST_MULTI_INDEX_PARALLEL_RUN_USES_THREADS)
+template<typename F>
+struct parallel_run_task
+{
+  parallel_run_task(const F& f_,std::size_t i_,std::exception_ptr& e_):
+    f(&f_),i(i_),e(&e_){}
+
+  void operator()()const
+  {
+    BOOST_TRY{
+      (*f)(i);
+    }
+    BOOST_CATCH(...){
+      *e=std::current_exception();
+    }
+    BOOST_CATCH_END
+  }
+
+private:
+  const F*            f;
+  std::size_t         i;
+  std::exception_ptr* e;
+};
+
+template<typename F>
+void parallel_run(std::size_t n,const F& f)
+{
+  std::vector<std::exception_ptr> errors(n);
+  std::vector<std::thread>        threads;
+  threads.reserve(n);
+
+  std::size_t i=1;
+  BOOST_TRY{
+    for(;i<n;++i){
+      threads.push_back(std::thread(parallel_run_task<F>(f,i,errors[i])));
+    }
+  }
+  BOOST_CATCH(...){
+    /* out of threads: fall through and do the rest here */
+  }
+  BOOST_CATCH_END
+
+  parallel_run_task<F>(f,0,errors[0])();
+  for(std::size_t j=i;j<n;++j)parallel_run_task<F>(f,j,errors[j])();
+  for(std::size_t j=0;j<threads.size();++j)threads[j].join();
+  for(std::size_t j=0;j<n;++j){
+    if(errors[j])std::rethrow_exception(errors[j]);
+  }
+}
+
+inline std::size_t parallel_run_concurrency()
+{
+  std::size_t n=std::thread::hardware_concurrency();
+  return n!=0?n:1;
+}
+#else
+template<typename F>
+void parallel_run(std::size_t n,const F& f)
+{
+  for(std::size_t i=0;i<n;++i)f(i);
+}
+
+inline std::size_t parallel_run_concurrency()
+{
+  return 1;
+}
+#endif
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,334 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_PERFECT_HASH_TABLE_HPP
+#define BOOST_MULTI_INDEX_DETAIL_PERFECT_HASH_TABLE_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/auto_space.hpp>
+#include <boost/multi_index/detail/prefetch.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Perfect hash table mapping a fixed set of m distinct hash values to
+ * about 1.01*m slots, after PTHash (Pibiri and Trani, 2021): hash values
+ * are scrambled and distributed among m/average_bucket_size buckets, and
+ * each bucket is assigned a 16-bit pilot value such that
+ *
+ *   slot(h) = reduce(rotate(scramble(h)) XOR mix(pilot[bucket(h)]))
+ *
+ * is collision-free over the set, reduce mapping its argument to
+ * [0,number of slots). Buckets are processed by decreasing size, searching
+ * for pilots with no collision against the slots already taken; the 1%
+ * of slots in excess keeps this search short for the last buckets, and
+ * the pilot array small enough to stay in cache. Construction fails if two
+ * elements of the set are equal, or if the search exhausts the range of
+ * pilots with every seed tried (which takes adversarial hash values).
+ *
+ * Lookup of a value not in the set yields an arbitrary slot, possibly an
+ * empty one, so the caller must always check the element found.
+ */
+
+template<typename Allocator,typename Pointer>
+class perfect_hash_table:private noncopyable
+{
+  typedef unsigned short pilot_type;
+
+  /* seed, pilots and slots live in a block allocated by build, so that
+   * an empty table takes no more than a pointer
+   */
+
+  struct table_impl
+  {
+    explicit table_impl(const Allocator& al):
+      seed(0),num_buckets(0),pilots(al,0),slots(al,0)
+    {}
+
+    std::size_t                      seed;
+    std::size_t                      num_buckets;
+    auto_space<pilot_type,Allocator> pilots;
+    auto_space<Pointer,Allocator>    slots;
+  };
+
+  typedef typename rebind_alloc_for<
+    Allocator,table_impl
+  >::type                                      impl_allocator;
+  typedef allocator_traits<impl_allocator>     impl_alloc_traits;
+  typedef typename impl_alloc_traits::pointer  impl_pointer;
+
+public:
+  perfect_hash_table():impl(0){}
+
+  ~perfect_hash_table(){clear();}
+
+  template<typename HashIterator,typename PointerIterator>
+  bool build(
+    const Allocator& al,HashIterator first,HashIterator last,
+    PointerIterator xs)
+  {
+    std::vector<std::size_t> hs(first,last);
+    std::size_t              m=hs.size(),
+                             n=m+m/slack+1,
+                             r=m/average_bucket_size+1;
+
+    bool duplicate=false;
+    for(std::size_t attempt=0;attempt!=max_attempts&&!duplicate;++attempt){
+      std::size_t s=scramble(attempt+1);
+      auto_space<pilot_type,Allocator> new_pilots(al,r);
+      pilot_type* ps=raw_ptr<pilot_type*>(new_pilots.data());
+      if(!search_pilots(hs,s,r,n,ps,duplicate))continue;
+
+      auto_space<Pointer,Allocator> new_slots(al,n);
+      Pointer* ss=raw_ptr<Pointer*>(new_slots.data());
+      std::fill(ss,ss+n,Pointer(0));
+      for(std::size_t i=0;i!=m;++i,++xs){
+        ss[position(hs[i],s,r,n,ps)]=*xs;
+      }
+
+      impl_allocator ial(al);
+      impl_pointer   p=impl_alloc_traits::allocate(ial,1);
+      BOOST_TRY{
+        impl_alloc_traits::construct(ial,raw_ptr<table_impl*>(p),al);
+      }
+      BOOST_CATCH(...){
+        impl_alloc_traits::deallocate(ial,p,1);
+        BOOST_RETHROW;
+      }
+      BOOST_CATCH_END
+      table_impl* t=raw_ptr<table_impl*>(p);
+      t->seed=s;
+      t->num_buckets=r;
+      t->pilots.swap(new_pilots);
+      t->slots.swap(new_slots);
+      clear();
+      impl=p;
+      return true;
+    }
+    return false;
+  }
+
+  bool empty()const{return impl==impl_pointer(0);}
+
+  std::size_t memory_size()const
+  {
+    if(empty())return 0;
+    const table_impl* t=get();
+    return
+      sizeof(table_impl)+
+      static_cast<std::size_t>(t->pilots.size())*sizeof(pilot_type)+
+      static_cast<std::size_t>(t->slots.size())*sizeof(Pointer);
+  }
+
+  const Pointer* find(std::size_t h)const
+  {
+    const table_impl* t=get();
+    return raw_ptr<Pointer*>(t->slots.data())+position(
+      h,t->seed,t->num_buckets,t->slots.size(),
+      raw_ptr<pilot_type*>(t->pilots.data()));
+  }
+
+  void prefetch_pilot(std::size_t h)const
+  {
+    const table_impl* t=get();
+    prefetch(
+      raw_ptr<pilot_type*>(t->pilots.data())+
+      reduce(scramble(h^t->seed),t->num_buckets));
+  }
+
+  void clear()
+  {
+    if(empty())return;
+    impl_allocator ial(get()->pilots.get_allocator());
+    impl_alloc_traits::destroy(ial,get());
+    impl_alloc_traits::deallocate(ial,impl,1);
+    impl=impl_pointer(0);
+  }
+
+  void swap(perfect_hash_table& x)
+  {
+    std::swap(impl,x.impl);
+  }
+
+private:
+  BOOST_STATIC_CONSTANT(std::size_t,average_bucket_size=3);
+  BOOST_STATIC_CONSTANT(std::size_t,slack=100);
+  BOOST_STATIC_CONSTANT(std::size_t,max_attempts=8);
+  BOOST_STATIC_CONSTANT(
+    std::size_t,max_pilot=(std::size_t)(pilot_type)(-1));
+  BOOST_STATIC_CONSTANT(
+    std::size_t,size_t_bits=sizeof(std::size_t)*CHAR_BIT);
+
+#if ((((ULONG_MAX>>16)>>16)>>16)>>15)==0 /* unsigned long less than 64 bits */
+  BOOST_STATIC_CONSTANT(std::size_t,pilot_multiplier=2654435769ul);
+
+  /* MurmurHash3 finalizer */
+
+  static std::size_t scramble(std::size_t x)
+  {
+    x^=x>>16;
+    x*=0x85ebca6bul;
+    x^=x>>13;
+    x*=0xc2b2ae35ul;
+    x^=x>>16;
+    return x;
+  }
+#else
+  BOOST_STATIC_CONSTANT(
+    std::size_t,pilot_multiplier=11400714819323198485ul);
+
+  static std::size_t scramble(std::size_t x)
+  {
+    x^=x>>33;
+    x*=0xff51afd7ed558ccdul;
+    x^=x>>33;
+    x*=0xc4ceb9fe1a85ec53ul;
+    x^=x>>33;
+    return x;
+  }
+#endif
+
+  /* maps x to [0,n) with a multiplication rather than a division where
+   * possible (Lemire's fastrange), which uses the high bits of x
+   */
+
+  static std::size_t reduce(std::size_t x,std::size_t n)
+  {
+#if defined(BOOST_HAS_INT128)&&\
+    ((((ULONG_MAX>>16)>>16)>>16)>>15)!=0 /* 64-bit unsigned long */
+    return static_cast<std::size_t>(
+      (static_cast<boost::uint128_type>(x)*n)>>64);
+#else
+    return x%n;
+#endif
+  }
+
+  static std::size_t rotate(std::size_t x)
+  {
+    return (x<<(size_t_bits/2))|(x>>(size_t_bits/2));
+  }
+
+  static std::size_t position(
+    std::size_t h,std::size_t s,std::size_t r,std::size_t n,
+    const pilot_type* ps)
+  {
+    std::size_t x=scramble(h^s);
+    return reduce(rotate(x)^(ps[reduce(x,r)]*pilot_multiplier),n);
+  }
+
+  static bool search_pilots(
+    const std::vector<std::size_t>& hs,std::size_t s,
+    std::size_t r,std::size_t n,pilot_type* ps,bool& duplicate)
+  {
+    std::size_t              m=hs.size();
+    std::vector<std::size_t> xs(m),bucket_start(r+1,0),order(m);
+
+    /* sort scrambled hash values by bucket */
+
+    for(std::size_t i=0;i!=m;++i){
+      xs[i]=scramble(hs[i]^s);
+      ++bucket_start[reduce(xs[i],r)+1];
+    }
+    for(std::size_t b=0;b!=r;++b)bucket_start[b+1]+=bucket_start[b];
+    {
+      std::vector<std::size_t> next(bucket_start.begin(),bucket_start.end()-1);
+      for(std::size_t i=0;i!=m;++i){
+        order[next[reduce(xs[i],r)]++]=rotate(xs[i]);
+      }
+    }
+
+    /* sort buckets by decreasing size */
+
+    std::size_t max_size=0;
+    for(std::size_t b=0;b!=r;++b){
+      std::size_t size=bucket_start[b+1]-bucket_start[b];
+      if(size>max_size)max_size=size;
+    }
+    std::vector<std::size_t> size_start(max_size+2,0),buckets(r);
+    for(std::size_t b=0;b!=r;++b){
+      ++size_start[max_size-(bucket_start[b+1]-bucket_start[b])+1];
+    }
+    for(std::size_t i=0;i!=max_size;++i)size_start[i+1]+=size_start[i];
+    for(std::size_t b=0;b!=r;++b){
+      buckets[size_start[max_size-(bucket_start[b+1]-bucket_start[b])]++]=b;
+    }
+
+    /* search pilots */
+
+    std::vector<bool>        taken(n,false);
+    std::vector<std::size_t> pos(max_size);
+    for(std::size_t i=0;i!=r;++i){
+      std::size_t b=buckets[i],
+                  first=bucket_start[b],
+                  size=bucket_start[b+1]-first;
+      if(size==0){
+        ps[b]=0;
+        continue;
+      }
+
+      /* scramble is a bijection, so equal values within a bucket come from
+       * equal hash values, which no pilot can tell apart
+       */
+
+      for(std::size_t j=first+1;j!=first+size;++j){
+        for(std::size_t l=first;l!=j;++l){
+          if(order[l]==order[j]){
+            duplicate=true;
+            return false;
+          }
+        }
+      }
+
+      for(std::size_t p=0;;++p){
+        if(p>max_pilot)return false;
+        std::size_t mp=p*pilot_multiplier,j=0;
+        for(;j!=size;++j){
+          std::size_t k=reduce(order[first+j]^mp,n),l=0;
+          if(taken[k])break;
+          while(l!=j&&pos[l]!=k)++l;
+          if(l!=j)break;
+          pos[j]=k;
+        }
+        if(j==size){
+          for(j=0;j!=size;++j)taken[pos[j]]=true;
+          ps[b]=static_cast<pilot_type>(p);
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  table_impl* get()const{return raw_ptr<table_impl*>(impl);}
+
+  impl_pointer impl;
+};
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,50 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_DETAIL_PREFETCH_HPP
+#define BOOST_MULTI_INDEX_DETAIL_PREFETCH_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+
+#if defined(_MSC_VER)&&!defined(__clang__)&&\
+    (defined(_M_X64)||defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* hints the processor to bring the cache line at p into the cache ahead of
+ * a read; p needs not point to valid memory, as prefetching never faults
+ */
+
+inline void prefetch(const void* p)
+{
+#if defined(BOOST_GCC)||defined(BOOST_CLANG)
+  __builtin_prefetch(p);
+#elif defined(_MSC_VER)&&(defined(_M_X64)||defined(_M_IX86))
+  _mm_prefetch(static_cast<const char*>(p),_MM_HINT_T0);
+#else
+  (void)p;
+#endif
+}
+
+} /* namespace multi_index::detail */
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -110,6 +110,11 @@
     safe_mode::check_equal_allocators(cont0,cont1),                           \
     safe_mode::unequal_allocators);
 
+#define BOOST_MULTI_INDEX_CHECK_VALID_HASH(h,hash,k)                         \
+  BOOST_MULTI_INDEX_SAFE_MODE_ASSERT(                                        \
+    (hash)(k)==(h),                                                          \
+    safe_mode::invalid_hash);
+
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
 #include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
 #include <algorithm>
@@ -0,0 +1,113 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_FAST_HASH_HPP
+#define BOOST_MULTI_INDEX_FAST_HASH_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/functional/hash.hpp>
+#include <boost/multi_index/detail/fast_hash_algo.hpp>
+#include <boost/type_traits/is_enum.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <cstddef>
+#include <string>
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Integral and enum values are mixed directly; any other type is hashed
+ * with boost::hash and the result mixed, so that hashed indices with
+ * power-of-two bucket arrays or badly distributed keys get full avalanche.
+ */
+
+template<
+  typename T,
+  bool Integral=(is_integral<T>::value||is_enum<T>::value)
+>
+struct fast_hash_base
+{
+  std::size_t operator()(const T& x)const
+  {
+    return fast_hash_algo::mix(boost::hash<T>()(x));
+  }
+};
+
+template<typename T>
+struct fast_hash_base<T,true>
+{
+  std::size_t operator()(T x)const
+  {
+    return fast_hash_algo::mix(static_cast<fast_hash_algo::uint64>(x));
+  }
+};
+
+template<typename CharT>
+struct fast_hash_chars
+{
+  std::size_t operator()(const CharT* p,std::size_t n)const
+  {
+    return fast_hash_algo::hash_bytes(p,n*sizeof(CharT));
+  }
+};
+
+} /* namespace multi_index::detail */
+
+/* fast_hash is a drop-in replacement for boost::hash as the Hash parameter
+ * of hashed indices: strings are hashed several bytes at a time rather
+ * than byte by byte, and all results have good bit dispersion.
+ */
+
+template<typename T>
+struct fast_hash:detail::fast_hash_base<T>
+{
+  typedef T           argument_type;
+  typedef std::size_t result_type;
+};
+
+template<typename CharT,typename Traits,typename Allocator>
+struct fast_hash<std::basic_string<CharT,Traits,Allocator> >
+{
+  typedef std::basic_string<CharT,Traits,Allocator> argument_type;
+  typedef std::size_t                               result_type;
+
+  std::size_t operator()(const argument_type& x)const
+  {
+    return detail::fast_hash_chars<CharT>()(x.data(),x.size());
+  }
+};
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+template<typename CharT,typename Traits>
+struct fast_hash<std::basic_string_view<CharT,Traits> >
+{
+  typedef std::basic_string_view<CharT,Traits> argument_type;
+  typedef std::size_t                          result_type;
+
+  std::size_t operator()(const argument_type& x)const
+  {
+    return detail::fast_hash_chars<CharT>()(x.data(),x.size());
+  }
+};
+#endif
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,68 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_HASHED_FLAT_INDEX_FWD_HPP
+#define BOOST_MULTI_INDEX_HASHED_FLAT_INDEX_FWD_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/multi_index/detail/hash_index_args.hpp>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+class hashed_flat_index;
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+bool operator==(
+  const hashed_flat_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+  const hashed_flat_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& y);
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+bool operator!=(
+  const hashed_flat_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+  const hashed_flat_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& y);
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+void swap(
+  hashed_flat_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+  hashed_flat_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& y);
+
+} /* namespace multi_index::detail */
+
+/* hashed_flat_index specifiers */
+
+template<
+  typename Arg1,typename Arg2=mpl::na,
+  typename Arg3=mpl::na,typename Arg4=mpl::na
+>
+struct hashed_flat_unique;
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,1228 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_HPP
+#define BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/call_traits.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/detail/workaround.hpp>
+#include <boost/foreach_fwd.hpp>
+#include <boost/move/core.hpp>
+#include <boost/move/utility_core.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/aux_/na.hpp>
+#include <boost/mpl/push_front.hpp>
+#include <boost/multi_index/detail/access_specifier.hpp>
+#include <boost/multi_index/detail/adl_swap.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/do_not_copy_elements_tag.hpp>
+#include <boost/multi_index/detail/auto_space.hpp>
+#include <boost/multi_index/detail/hash_flat_index_iterator.hpp>
+#include <boost/multi_index/detail/hash_forward_index_bucket_array.hpp>
+#include <boost/multi_index/detail/hash_forward_index_node.hpp>
+#include <boost/multi_index/detail/index_node_base.hpp>
+#include <boost/multi_index/detail/modify_key_adaptor.hpp>
+#include <boost/multi_index/detail/node_handle.hpp>
+#include <boost/multi_index/detail/promotes_arg.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/multi_index/detail/safe_mode.hpp>
+#include <boost/multi_index/detail/scope_guard.hpp>
+#include <boost/multi_index/detail/vartempl_support.hpp>
+#include <boost/multi_index/hashed_forward_index_fwd.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+#define BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT_OF(x)            \
+  detail::scope_guard BOOST_JOIN(check_invariant_,__LINE__)=                 \
+    detail::make_obj_guard(x,&hashed_forward_index::check_invariant_);          \
+  BOOST_JOIN(check_invariant_,__LINE__).touch();
+#define BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT                  \
+  BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT_OF(*this)
+#else
+#define BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT_OF(x)
+#define BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* hashed_forward_index adds a layer of hashed indexing to a given Super
+ * with nodes singly linked as described in hash_forward_index_node.hpp.
+ * Only unique keys and forward traversal are supported.
+ */
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+class hashed_forward_index:
+  BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS SuperMeta::type
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  ,public safe_mode::safe_container<
+    hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList> >
+#endif
+
+{
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)&&\
+    BOOST_WORKAROUND(__MWERKS__,<=0x3003)
+/* The "ISO C++ Template Parser" option in CW8.3 has a problem with the
+ * lifetime of const references bound to temporaries --precisely what
+ * scopeguards are.
+ */
+
+#pragma parse_mfunc_templ off
+#endif
+
+  typedef typename SuperMeta::type               super;
+
+protected:
+  typedef hashed_forward_index_node<
+    typename super::index_node_type>             index_node_type;
+
+private:
+  typedef typename index_node_type::impl_type    node_impl_type;
+  typedef typename node_impl_type::pointer       node_impl_pointer;
+  typedef node_impl_type                         node_alg;
+  typedef hashed_forward_index_bucket_array<
+    typename super::final_allocator_type>        bucket_array_type;
+
+public:
+  /* types */
+
+  typedef typename KeyFromValue::result_type     key_type;
+  typedef typename index_node_type::value_type   value_type;
+  typedef KeyFromValue                           key_from_value;
+  typedef Hash                                   hasher;
+  typedef Pred                                   key_equal;
+  typedef typename super::final_allocator_type   allocator_type;
+
+private:
+  typedef allocator_traits<allocator_type>       alloc_traits;
+
+public:
+  typedef typename alloc_traits::pointer         pointer;
+  typedef typename alloc_traits::const_pointer   const_pointer;
+  typedef value_type&                            reference;
+  typedef const value_type&                      const_reference;
+  typedef typename alloc_traits::size_type       size_type;
+  typedef typename alloc_traits::difference_type difference_type;
+  typedef tuple<size_type,
+    key_from_value,hasher,key_equal>             ctor_args;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  typedef safe_mode::safe_iterator<
+    hashed_flat_index_iterator<index_node_type>,
+    hashed_forward_index>                           iterator;
+#else
+  typedef hashed_flat_index_iterator<
+    index_node_type>                             iterator;
+#endif
+
+  typedef iterator                               const_iterator;
+
+  typedef typename super::final_node_handle_type node_type;
+  typedef detail::insert_return_type<
+    iterator,node_type>                          insert_return_type;
+  typedef TagList                                tag_list;
+
+protected:
+  typedef typename super::final_node_type     final_node_type;
+  typedef tuples::cons<
+    ctor_args,
+    typename super::ctor_args_list>           ctor_args_list;
+  typedef typename mpl::push_front<
+    typename super::index_type_list,
+    hashed_forward_index>::type                  index_type_list;
+  typedef typename mpl::push_front<
+    typename super::iterator_type_list,
+    iterator>::type                           iterator_type_list;
+  typedef typename mpl::push_front<
+    typename super::const_iterator_type_list,
+    const_iterator>::type                     const_iterator_type_list;
+  typedef typename super::copy_map_type       copy_map_type;
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
+  typedef typename super::index_saver_type    index_saver_type;
+  typedef typename super::index_loader_type   index_loader_type;
+#endif
+
+private:
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  typedef safe_mode::safe_container<
+    hashed_forward_index>                        safe_super;
+#endif
+
+  typedef typename call_traits<value_type>::param_type value_param_type;
+  typedef typename call_traits<
+    key_type>::param_type                              key_param_type;
+
+  /* Needed to avoid commas in BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL
+   * expansion.
+   */
+
+  typedef std::pair<iterator,bool>                     emplace_return_type;
+
+public:
+
+  /* construct/destroy/copy
+   * Default and copy ctors are in the protected section as indices are
+   * not supposed to be created on their own. No range ctor either.
+   */
+
+  hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& operator=(
+    const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x)
+  {
+    this->final()=x.final();
+    return *this;
+  }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+  hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& operator=(
+    std::initializer_list<value_type> list)
+  {
+    this->final()=list;
+    return *this;
+  }
+#endif
+
+  allocator_type get_allocator()const BOOST_NOEXCEPT
+  {
+    return this->final().get_allocator();
+  }
+
+  /* size and capacity */
+
+  bool      empty()const BOOST_NOEXCEPT{return this->final_empty_();}
+  size_type size()const BOOST_NOEXCEPT{return this->final_size_();}
+  size_type max_size()const BOOST_NOEXCEPT{return this->final_max_size_();}
+
+  /* iterators */
+
+  iterator begin()BOOST_NOEXCEPT
+  {
+    return make_iterator(
+      index_node_type::from_impl(node_impl_type::first(buckets.begin())));
+  }
+
+  const_iterator begin()const BOOST_NOEXCEPT
+  {
+    return make_iterator(
+      index_node_type::from_impl(node_impl_type::first(buckets.begin())));
+  }
+
+  iterator       end()BOOST_NOEXCEPT{return make_iterator(header());}
+  const_iterator end()const BOOST_NOEXCEPT{return make_iterator(header());}
+  const_iterator cbegin()const BOOST_NOEXCEPT{return begin();}
+  const_iterator cend()const BOOST_NOEXCEPT{return end();}
+
+  iterator iterator_to(const value_type& x)
+  {
+    return make_iterator(
+      node_from_value<index_node_type>(boost::addressof(x)));
+  }
+
+  const_iterator iterator_to(const value_type& x)const
+  {
+    return make_iterator(
+      node_from_value<index_node_type>(boost::addressof(x)));
+  }
+
+  /* modifiers */
+
+  BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL(
+    emplace_return_type,emplace,emplace_impl)
+
+  BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL_EXTRA_ARG(
+    iterator,emplace_hint,emplace_hint_impl,iterator,position)
+
+  std::pair<iterator,bool> insert(const value_type& x)
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_(x);
+    return std::pair<iterator,bool>(make_iterator(p.first),p.second);
+  }
+
+  std::pair<iterator,bool> insert(BOOST_RV_REF(value_type) x)
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_rv_(x);
+    return std::pair<iterator,bool>(make_iterator(p.first),p.second);
+  }
+
+  iterator insert(iterator position,const value_type& x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_(
+      x,static_cast<final_node_type*>(position.get_node()));
+    return make_iterator(p.first);
+  }
+
+  iterator insert(iterator position,BOOST_RV_REF(value_type) x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_rv_(
+      x,static_cast<final_node_type*>(position.get_node()));
+    return make_iterator(p.first);
+  }
+
+  template<typename InputIterator>
+  void insert(InputIterator first,InputIterator last)
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    for(;first!=last;++first)this->final_insert_ref_(*first);
+  }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+  void insert(std::initializer_list<value_type> list)
+  {
+    insert(list.begin(),list.end());
+  }
+#endif
+
+  insert_return_type insert(BOOST_RV_REF(node_type) nh)
+  {
+    if(nh)BOOST_MULTI_INDEX_CHECK_EQUAL_ALLOCATORS(*this,nh);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_nh_(nh);
+    return insert_return_type(make_iterator(p.first),p.second,boost::move(nh));
+  }
+
+  iterator insert(const_iterator position,BOOST_RV_REF(node_type) nh)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    if(nh)BOOST_MULTI_INDEX_CHECK_EQUAL_ALLOCATORS(*this,nh);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_nh_(
+      nh,static_cast<final_node_type*>(position.get_node()));
+    return make_iterator(p.first);
+  }
+
+  node_type extract(const_iterator position)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    return this->final_extract_(
+      static_cast<final_node_type*>(position.get_node()));
+  }
+
+  node_type extract(key_param_type x)
+  {
+    iterator position=find(x);
+    if(position==end())return node_type();
+    else return extract(position);
+  }
+
+  iterator erase(iterator position)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    this->final_erase_(static_cast<final_node_type*>(position++.get_node()));
+    return position;
+  }
+
+  size_type erase(key_param_type k)
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+
+    node_impl_pointer x=find_in_bucket(k,bucket_of(hash_(k)));
+    if(x==node_impl_pointer(0))return 0;
+    this->final_erase_(
+      static_cast<final_node_type*>(index_node_type::from_impl(x)));
+    return 1;
+  }
+
+  iterator erase(iterator first,iterator last)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(first);
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(last);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(first,*this);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(last,*this);
+    BOOST_MULTI_INDEX_CHECK_VALID_RANGE(first,last);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    while(first!=last){
+      first=erase(first);
+    }
+    return first;
+  }
+
+  bool replace(iterator position,const value_type& x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    return this->final_replace_(
+      x,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  bool replace(iterator position,BOOST_RV_REF(value_type) x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    return this->final_replace_rv_(
+      x,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  template<typename Modifier>
+  bool modify(iterator position,Modifier mod)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    /* MSVC++ 6.0 optimizer on safe mode code chokes if this
+     * this is not added. Left it for all compilers as it does no
+     * harm.
+     */
+
+    position.detach();
+#endif
+
+    return this->final_modify_(
+      mod,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  template<typename Modifier,typename Rollback>
+  bool modify(iterator position,Modifier mod,Rollback back_)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    /* MSVC++ 6.0 optimizer on safe mode code chokes if this
+     * this is not added. Left it for all compilers as it does no
+     * harm.
+     */
+
+    position.detach();
+#endif
+
+    return this->final_modify_(
+      mod,back_,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  template<typename Modifier>
+  bool modify_key(iterator position,Modifier mod)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    return modify(
+      position,modify_key_adaptor<Modifier,value_type,KeyFromValue>(mod,key));
+  }
+
+  template<typename Modifier,typename Rollback>
+  bool modify_key(iterator position,Modifier mod,Rollback back_)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    return modify(
+      position,
+      modify_key_adaptor<Modifier,value_type,KeyFromValue>(mod,key),
+      modify_key_adaptor<Rollback,value_type,KeyFromValue>(back_,key));
+  }
+
+  void clear()BOOST_NOEXCEPT
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    this->final_clear_();
+  }
+
+  void swap(hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x)
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT_OF(x);
+    this->final_swap_(x.final());
+  }
+
+  /* observers */
+
+  key_from_value key_extractor()const{return key;}
+  hasher         hash_function()const{return hash_;}
+  key_equal      key_eq()const{return eq_;}
+
+  /* lookup */
+
+  /* Internally, these ops rely on const_iterator being the same
+   * type as iterator.
+   */
+
+  template<typename CompatibleKey>
+  iterator find(const CompatibleKey& k)const
+  {
+    return find(k,hash_,eq_);
+  }
+
+  template<
+    typename CompatibleKey,typename CompatibleHash,typename CompatiblePred
+  >
+  iterator find(
+    const CompatibleKey& k,
+    const CompatibleHash& hash,const CompatiblePred& eq)const
+  {
+    return find(
+      k,hash,eq,promotes_1st_arg<CompatiblePred,CompatibleKey,key_type>());
+  }
+
+  template<typename CompatibleKey>
+  size_type count(const CompatibleKey& k)const
+  {
+    return count(k,hash_,eq_);
+  }
+
+  template<
+    typename CompatibleKey,typename CompatibleHash,typename CompatiblePred
+  >
+  size_type count(
+    const CompatibleKey& k,
+    const CompatibleHash& hash,const CompatiblePred& eq)const
+  {
+    return find(k,hash,eq)!=end()?1:0;
+  }
+
+  template<typename CompatibleKey>
+  std::pair<iterator,iterator> equal_range(const CompatibleKey& k)const
+  {
+    return equal_range(k,hash_,eq_);
+  }
+
+  template<
+    typename CompatibleKey,typename CompatibleHash,typename CompatiblePred
+  >
+  std::pair<iterator,iterator> equal_range(
+    const CompatibleKey& k,
+    const CompatibleHash& hash,const CompatiblePred& eq)const
+  {
+    iterator it=find(k,hash,eq),it_last=it;
+    if(it!=end())++it_last;
+    return std::pair<iterator,iterator>(it,it_last);
+  }
+
+  /* bucket interface */
+
+  size_type bucket_count()const BOOST_NOEXCEPT
+  {
+    return static_cast<size_type>(buckets.size());
+  }
+
+  size_type max_bucket_count()const BOOST_NOEXCEPT{return static_cast<size_type>(-1);}
+
+  size_type bucket_size(size_type n)const
+  {
+    size_type res=0;
+    for(node_impl_pointer x=buckets.at(n);!x->last();x=x->next())++res;
+    return res;
+  }
+
+  size_type bucket(key_param_type k)const
+  {
+    return static_cast<size_type>(buckets.position(hash_(k)));
+  }
+
+  /* hash policy */
+
+  float load_factor()const BOOST_NOEXCEPT
+    {return static_cast<float>(size())/bucket_count();}
+  float max_load_factor()const BOOST_NOEXCEPT{return mlf;}
+  void  max_load_factor(float z){mlf=z;calculate_max_load();}
+
+  void rehash(size_type n)
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    if(size()<=max_load&&n<=bucket_count())return;
+
+    size_type bc=bucket_count_for(size());
+    unchecked_rehash(bc<n?n:bc);
+  }
+
+  void reserve(size_type n)
+  {
+    rehash(static_cast<size_type>(std::ceil(static_cast<float>(n)/mlf)));
+  }
+
+BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
+  hashed_forward_index(const ctor_args_list& args_list,const allocator_type& al):
+    super(args_list.get_tail(),al),
+    key(tuples::get<1>(args_list.get_head())),
+    hash_(tuples::get<2>(args_list.get_head())),
+    eq_(tuples::get<3>(args_list.get_head())),
+    buckets(al,header()->impl(),tuples::get<0>(args_list.get_head())),
+    mlf(1.0f)
+  {
+    calculate_max_load();
+  }
+
+  hashed_forward_index(
+    const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x):
+    super(x),
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super(),
+#endif
+
+    key(x.key),
+    hash_(x.hash_),
+    eq_(x.eq_),
+    buckets(x.get_allocator(),header()->impl(),x.buckets.size()),
+    mlf(x.mlf),
+    max_load(x.max_load)
+  {
+    /* Copy ctor just takes the internal configuration objects from x. The rest
+     * is done in subsequent call to copy_().
+     */
+  }
+
+  hashed_forward_index(
+    const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+    do_not_copy_elements_tag):
+    super(x,do_not_copy_elements_tag()),
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super(),
+#endif
+
+    key(x.key),
+    hash_(x.hash_),
+    eq_(x.eq_),
+    buckets(x.get_allocator(),header()->impl(),0),
+    mlf(x.mlf)
+  {
+    calculate_max_load();
+  }
+
+  ~hashed_forward_index()
+  {
+    /* the container is guaranteed to be empty by now */
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  iterator make_iterator(index_node_type* node)
+  {
+    return iterator(node,this);
+  }
+
+  const_iterator make_iterator(index_node_type* node)const
+  {
+    return const_iterator(node,const_cast<hashed_forward_index*>(this));
+  }
+#else
+  iterator make_iterator(index_node_type* node)
+  {
+    return iterator(node);
+  }
+
+  const_iterator make_iterator(index_node_type* node)const
+  {
+    return const_iterator(node);
+  }
+#endif
+
+  void copy_(
+    const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+    const copy_map_type& map)
+  {
+    node_impl_pointer end_=header()->impl();
+    for(std::size_t n=0,s=buckets.size();n!=s;++n){
+      node_impl_pointer org=x.buckets.at(n),
+                        cpy=buckets.at(n);
+      while(!org->last()){
+        org=org->next();
+        node_impl_pointer next_cpy=static_cast<index_node_type*>(
+          map.find(static_cast<final_node_type*>(
+            index_node_type::from_impl(org))))->impl();
+        cpy->set_next(next_cpy,false);
+        cpy=next_cpy;
+      }
+      cpy->set_next(buckets.next_of(n,end_),true);
+    }
+
+    super::copy_(x,map);
+  }
+
+  template<typename Variant>
+  final_node_type* insert_(
+    value_param_type v,final_node_type*& x,Variant variant)
+  {
+    reserve_for_insert(size()+1);
+
+    node_impl_pointer buc=bucket_of(hash_(key(v))),
+                      pos=find_in_bucket(key(v),buc);
+    if(pos!=node_impl_pointer(0)){
+      return static_cast<final_node_type*>(index_node_type::from_impl(pos));
+    }
+
+    final_node_type* res=super::insert_(v,x,variant);
+    if(res==x)node_alg::link(static_cast<index_node_type*>(x)->impl(),buc);
+    return res;
+  }
+
+  template<typename Variant>
+  final_node_type* insert_(
+    value_param_type v,index_node_type* position,
+    final_node_type*& x,Variant variant)
+  {
+    reserve_for_insert(size()+1);
+
+    node_impl_pointer buc=bucket_of(hash_(key(v))),
+                      pos=find_in_bucket(key(v),buc);
+    if(pos!=node_impl_pointer(0)){
+      return static_cast<final_node_type*>(index_node_type::from_impl(pos));
+    }
+
+    final_node_type* res=super::insert_(v,position,x,variant);
+    if(res==x)node_alg::link(static_cast<index_node_type*>(x)->impl(),buc);
+    return res;
+  }
+
+  void extract_(index_node_type* x)
+  {
+    unlink(x);
+    super::extract_(x);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    detach_iterators(x);
+#endif
+  }
+
+  void delete_all_nodes_()
+  {
+    node_impl_pointer end_=header()->impl(),
+                      x=node_impl_type::first(buckets.begin());
+    while(x!=end_){
+      node_impl_pointer y=x;
+      node_alg::increment(x);
+      this->final_delete_node_(
+        static_cast<final_node_type*>(index_node_type::from_impl(y)));
+    }
+  }
+
+  void clear_()
+  {
+    super::clear_();
+    buckets.clear(header()->impl());
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super::detach_dereferenceable_iterators();
+#endif
+  }
+
+  template<typename BoolConstant>
+  void swap_(
+    hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+    BoolConstant swap_allocators)
+  {
+    adl_swap(key,x.key);
+    adl_swap(hash_,x.hash_);
+    adl_swap(eq_,x.eq_);
+    buckets.swap(x.buckets,swap_allocators);
+    std::swap(mlf,x.mlf);
+    std::swap(max_load,x.max_load);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super::swap(x);
+#endif
+
+    super::swap_(x,swap_allocators);
+  }
+
+  void swap_elements_(
+    hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x)
+  {
+    buckets.swap(x.buckets);
+    std::swap(mlf,x.mlf);
+    std::swap(max_load,x.max_load);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super::swap(x);
+#endif
+
+    super::swap_elements_(x);
+  }
+
+  template<typename Variant>
+  bool replace_(value_param_type v,index_node_type* x,Variant variant)
+  {
+    if(eq_(key(v),key(x->value()))){
+      return super::replace_(v,x,variant);
+    }
+
+    node_impl_pointer prev=unlink(x);
+
+    BOOST_TRY{
+      node_impl_pointer buc=bucket_of(hash_(key(v)));
+      if(find_in_bucket(key(v),buc)==node_impl_pointer(0)&&
+         super::replace_(v,x,variant)){
+        node_alg::link(x->impl(),buc);
+        return true;
+      }
+      node_alg::relink(x->impl(),prev);
+      return false;
+    }
+    BOOST_CATCH(...){
+      node_alg::relink(x->impl(),prev);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+  }
+
+  bool modify_(index_node_type* x)
+  {
+    node_impl_pointer buc;
+    bool              b;
+    BOOST_TRY{
+      buc=bucket_of(hash_(key(x->value())));
+      b=in_place(x->impl(),key(x->value()),buc);
+    }
+    BOOST_CATCH(...){
+      extract_(x);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    if(!b){
+      unlink(x);
+      BOOST_TRY{
+        if(find_in_bucket(key(x->value()),buc)!=node_impl_pointer(0)){
+          super::extract_(x);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+          detach_iterators(x);
+#endif
+          return false;
+        }
+        node_alg::link(x->impl(),buc);
+      }
+      BOOST_CATCH(...){
+        super::extract_(x);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+        detach_iterators(x);
+#endif
+
+        BOOST_RETHROW;
+      }
+      BOOST_CATCH_END
+    }
+
+    BOOST_TRY{
+      if(!super::modify_(x)){
+        unlink(x);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+        detach_iterators(x);
+#endif
+        return false;
+      }
+      else return true;
+    }
+    BOOST_CATCH(...){
+      unlink(x);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+      detach_iterators(x);
+#endif
+
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+  }
+
+  bool modify_rollback_(index_node_type* x)
+  {
+    node_impl_pointer buc=bucket_of(hash_(key(x->value())));
+    if(in_place(x->impl(),key(x->value()),buc)){
+      return super::modify_rollback_(x);
+    }
+
+    node_impl_pointer prev=unlink(x);
+
+    BOOST_TRY{
+      if(find_in_bucket(key(x->value()),buc)==node_impl_pointer(0)&&
+         super::modify_rollback_(x)){
+        node_alg::link(x->impl(),buc);
+        return true;
+      }
+      node_alg::relink(x->impl(),prev);
+      return false;
+    }
+    BOOST_CATCH(...){
+      node_alg::relink(x->impl(),prev);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+  }
+
+  bool check_rollback_(index_node_type* x)const
+  {
+    node_impl_pointer buc=bucket_of(hash_(key(x->value())));
+    return in_place(x->impl(),key(x->value()),buc)&&
+           super::check_rollback_(x);
+  }
+
+  /* comparison */
+
+#if !defined(BOOST_NO_MEMBER_TEMPLATE_FRIENDS)
+  /* defect macro refers to class, not function, templates, but anyway */
+
+  template<typename K,typename H,typename P,typename S,typename T>
+  friend bool operator==(
+    const hashed_forward_index<K,H,P,S,T>&,const hashed_forward_index<K,H,P,S,T>& y);
+#endif
+
+  bool equals(const hashed_forward_index& x)const
+  {
+    if(size()!=x.size())return false;
+    for(const_iterator it=begin(),it_end=end(),it2_end=x.end();
+        it!=it_end;++it){
+      const_iterator it2=x.find(key(*it));
+      if(it2==it2_end||!(*it==*it2))return false;
+    }
+    return true;
+  }
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
+  /* serialization: the layout of the buckets is recomputed on loading */
+
+  template<typename Archive>
+  void save_(
+    Archive& ar,const unsigned int version,const index_saver_type& sm)const
+  {
+    super::save_(ar,version,sm);
+  }
+
+  template<typename Archive>
+  void load_(Archive& ar,const unsigned int version,const index_loader_type& lm)
+  {
+    super::load_(ar,version,lm);
+  }
+#endif
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  /* invariant stuff */
+
+  bool invariant_()const
+  {
+    if(size()==0||begin()==end()){
+      if(size()!=0||begin()!=end())return false;
+    }
+    else{
+      size_type s=0;
+      for(const_iterator it=begin(),it_end=end();it!=it_end;++it,++s){
+        if(!in_place(
+          it.get_node()->impl(),key(*it),bucket_of(hash_(key(*it)))))
+          return false;
+      }
+      if(s!=size())return false;
+    }
+
+    return super::invariant_();
+  }
+
+  /* This forwarding function eases things for the boost::mem_fn construct
+   * in BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT. Actually,
+   * final_check_invariant is already an inherited member function of index.
+   */
+  void check_invariant_()const{this->final_check_invariant_();}
+#endif
+
+private:
+  index_node_type* header()const{return this->final_header();}
+
+  node_impl_pointer bucket_of(std::size_t h)const
+  {
+    return buckets.at(buckets.position(h));
+  }
+
+  node_impl_pointer unlink(index_node_type* x)
+  {
+    node_impl_pointer xi=x->impl();
+    return node_alg::unlink(xi,buckets.bucket_of(xi,header()->impl()));
+  }
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  node_impl_pointer find_in_bucket(
+    const CompatibleKey& k,node_impl_pointer buc,
+    const CompatiblePred& eq)const
+  {
+    for(node_impl_pointer x=buc;!x->last();){
+      x=x->next();
+      if(eq(k,key(index_node_type::from_impl(x)->value())))return x;
+    }
+    return node_impl_pointer(0);
+  }
+
+  node_impl_pointer find_in_bucket(
+    key_param_type k,node_impl_pointer buc)const
+  {
+    return find_in_bucket(k,buc,eq_);
+  }
+
+  /* x belongs to buc and no other element in buc is equivalent to k */
+
+  bool in_place(
+    node_impl_pointer x,key_param_type k,node_impl_pointer buc)const
+  {
+    bool found=false;
+    for(node_impl_pointer y=buc;!y->last();){
+      y=y->next();
+      if(y==x)found=true;
+      else if(eq_(k,key(index_node_type::from_impl(y)->value()))){
+        return false;
+      }
+    }
+    return found;
+  }
+
+  void calculate_max_load()
+  {
+    float fml=mlf*static_cast<float>(buckets.size());
+    max_load=(std::numeric_limits<size_type>::max)();
+    if(max_load>fml)max_load=static_cast<size_type>(fml);
+  }
+
+  size_type bucket_count_for(size_type n)const
+  {
+    size_type bc =(std::numeric_limits<size_type>::max)();
+    float     fbc=1.0f+static_cast<float>(n)/mlf;
+    if(bc>fbc)bc =static_cast<size_type>(fbc);
+    return bc;
+  }
+
+  void reserve_for_insert(size_type n)
+  {
+    if(n>max_load)unchecked_rehash(bucket_count_for(n));
+  }
+
+  /* Hash values are all computed before any node is relinked, so that
+   * an exception thrown by hash_ leaves the index untouched.
+   */
+
+  void unchecked_rehash(size_type n)
+  {
+    node_impl_pointer end_=header()->impl();
+    bucket_array_type buckets_cpy(get_allocator(),end_,n);
+
+    if(size()!=0){
+      auto_space<std::size_t,allocator_type> hashes(get_allocator(),size());
+      std::size_t*                           h=raw_ptr<std::size_t*>(
+                                                 hashes.data());
+      for(node_impl_pointer x=node_impl_type::first(buckets.begin());
+          x!=end_;node_alg::increment(x)){
+        *h++=hash_(key(index_node_type::from_impl(x)->value()));
+      }
+
+      h=raw_ptr<std::size_t*>(hashes.data());
+      for(node_impl_pointer x=node_impl_type::first(buckets.begin());
+          x!=end_;){
+        node_impl_pointer y=x;
+        node_alg::increment(x);
+        node_alg::link(y,buckets_cpy.at(buckets_cpy.position(*h++)));
+      }
+    }
+
+    buckets.swap(buckets_cpy);
+    calculate_max_load();
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  void detach_iterators(index_node_type* x)
+  {
+    iterator it=make_iterator(x);
+    safe_mode::detach_equivalent_iterators(it);
+  }
+#endif
+
+  template<BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
+  std::pair<iterator,bool> emplace_impl(BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
+  {
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool>p=
+      this->final_emplace_(BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
+    return std::pair<iterator,bool>(make_iterator(p.first),p.second);
+  }
+
+  template<BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
+  iterator emplace_hint_impl(
+    iterator position,BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool>p=
+      this->final_emplace_hint_(
+        static_cast<final_node_type*>(position.get_node()),
+        BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
+    return make_iterator(p.first);
+  }
+
+  template<
+    typename CompatibleHash,typename CompatiblePred
+  >
+  iterator find(
+    const key_type& k,
+    const CompatibleHash& hash,const CompatiblePred& eq,mpl::true_)const
+  {
+    return find(k,hash,eq,mpl::false_());
+  }
+
+  template<
+    typename CompatibleKey,typename CompatibleHash,typename CompatiblePred
+  >
+  iterator find(
+    const CompatibleKey& k,
+    const CompatibleHash& hash,const CompatiblePred& eq,mpl::false_)const
+  {
+    node_impl_pointer x=find_in_bucket(k,bucket_of(hash(k)),eq);
+    if(x==node_impl_pointer(0))return end();
+    return make_iterator(index_node_type::from_impl(x));
+  }
+
+  key_from_value    key;
+  hasher            hash_;
+  key_equal         eq_;
+  bucket_array_type buckets;
+  float             mlf;
+  size_type         max_load;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)&&\
+    BOOST_WORKAROUND(__MWERKS__,<=0x3003)
+#pragma parse_mfunc_templ reset
+#endif
+};
+
+/* comparison */
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+bool operator==(
+  const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+  const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& y)
+{
+  return x.equals(y);
+}
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+bool operator!=(
+  const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+  const hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& y)
+{
+  return !(x==y);
+}
+
+/*  specialized algorithms */
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+void swap(
+  hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& x,
+  hashed_forward_index<KeyFromValue,Hash,Pred,SuperMeta,TagList>& y)
+{
+  x.swap(y);
+}
+
+} /* namespace multi_index::detail */
+
+/* hashed_forward_index specifier: argument handling is shared with hashed
+ * indices, but hashed index options are not accepted.
+ */
+
+template<typename Arg1,typename Arg2,typename Arg3,typename Arg4>
+struct hashed_forward_unique
+{
+  typedef typename detail::hashed_index_args<
+    Arg1,Arg2,Arg3,Arg4,mpl::na>                   index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::hash_type           hash_type;
+  typedef typename index_args::pred_type           pred_type;
+
+  BOOST_STATIC_ASSERT(
+    mpl::is_na<typename index_args::supplied_options_type>::value);
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::hashed_forward_index_node<Super> type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::hashed_forward_index<
+      key_from_value_type,hash_type,pred_type,
+      SuperMeta,tag_list_type> type;
+  };
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+/* Boost.Foreach compatibility */
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList
+>
+inline boost::mpl::true_* boost_foreach_is_noncopyable(
+  boost::multi_index::detail::hashed_forward_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList>*&,
+  boost_foreach_argument_dependent_lookup_hack)
+{
+  return 0;
+}
+
+#undef BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT
+#undef BOOST_MULTI_INDEX_HASHED_FORWARD_INDEX_CHECK_INVARIANT_OF
+
+#endif
@@ -1,4 +1,4 @@
-/* Copyright 2003-2020 Joaquin M Lopez Munoz.
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
  * Distributed under the Boost Software License, Version 1.0.
  * (See accompanying file LICENSE_1_0.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt)
@@ -33,14 +33,21 @@
 #include <boost/multi_index/detail/bucket_array.hpp>
 #include <boost/multi_index/detail/do_not_copy_elements_tag.hpp>
 #include <boost/multi_index/detail/hash_index_iterator.hpp>
+#include <boost/multi_index/detail/hash_index_rehash_state.hpp>
+#include <boost/multi_index/detail/hash_index_stats.hpp>
+#include <boost/multi_index/detail/index_base.hpp>
 #include <boost/multi_index/detail/index_node_base.hpp>
 #include <boost/multi_index/detail/modify_key_adaptor.hpp>
 #include <boost/multi_index/detail/node_handle.hpp>
+#include <boost/multi_index/detail/perfect_hash_table.hpp>
+#include <boost/multi_index/detail/prefetch.hpp>
 #include <boost/multi_index/detail/promotes_arg.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
 #include <boost/multi_index/detail/safe_mode.hpp>
 #include <boost/multi_index/detail/scope_guard.hpp>
 #include <boost/multi_index/detail/vartempl_support.hpp>
 #include <boost/multi_index/hashed_index_fwd.hpp>
+#include <boost/static_assert.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <boost/type_traits/is_same.hpp>
 #include <cmath>
@@ -48,6 +55,7 @@
 #include <functional>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
 #include <initializer_list>
@@ -75,6 +83,20 @@ namespace multi_index{
 
 namespace detail{
 
+class hashed_index_parallel_rehash_access;
+
+/* Insertion variant for emplace_hashed: carries the hash of the value for
+ * Index alone, and behaves as emplaced_tag for the rest of indices.
+ */
+
+template<typename Index>
+struct hashed_emplaced_tag:emplaced_tag
+{
+  explicit hashed_emplaced_tag(std::size_t h_):h(h_){}
+
+  std::size_t h;
+};
+
 /* hashed_index adds a layer of hashed indexing to a given Super */
 
 /* Most of the implementation of unique and non-unique indices is
@@ -84,14 +106,17 @@ namespace detail{
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 class hashed_index:
-  BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS SuperMeta::type
+  BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS SuperMeta::type,
+  private hashed_index_rehash_state<
+    hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>,
+    typename SuperMeta::type::final_allocator_type,Options>
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
   ,public safe_mode::safe_container<
-    hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category> >
+    hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options> >
 #endif
 
 { 
@@ -109,7 +134,7 @@ class hashed_index:
 
 protected:
   typedef hashed_index_node<
-    typename super::index_node_type>             index_node_type;
+    typename super::index_node_type,Options>     index_node_type;
 
 private:
   typedef typename index_node_type::
@@ -117,8 +142,29 @@ private:
   typedef typename index_node_type::impl_type    node_impl_type;
   typedef typename node_impl_type::pointer       node_impl_pointer;
   typedef typename node_impl_type::base_pointer  node_impl_base_pointer;
-  typedef bucket_array<
-    typename super::final_allocator_type>        bucket_array_type;
+  typedef hashed_index_rehash_state<
+    hashed_index,
+    typename super::final_allocator_type,Options> rehash_state_type;
+  typedef typename rehash_state_type::
+    bucket_array_type                            bucket_array_type;
+  typedef perfect_hash_table<
+    typename super::final_allocator_type,
+    node_impl_pointer>                           perfect_hash_table_type;
+  typedef mpl::bool_<Options::stores_hash>       stores_hash;
+  typedef mpl::bool_<
+    Options::rehashes_incrementally>             rehashes_incrementally;
+  typedef mpl::bool_<Options::stores_group_size> stores_group_size;
+
+  /* incremental rehashing moves elements by their stored hash values */
+
+  BOOST_STATIC_ASSERT(
+    !Options::rehashes_incrementally||Options::stores_hash);
+
+  /* only non-unique indices have groups of more than one element */
+
+  BOOST_STATIC_ASSERT((
+    !Options::stores_group_size||
+    is_same<Category,hashed_non_unique_tag>::value));
 
 public:
   /* types */
@@ -162,6 +208,7 @@ public:
     index_node_type,bucket_array_type,
     Category,hashed_index_local_iterator_tag>    local_iterator;
   typedef local_iterator                         const_local_iterator;
+  typedef hashed_index_stats                     stats_type;
 
   typedef typename super::final_node_handle_type node_type;
   typedef detail::insert_return_type<
@@ -212,15 +259,18 @@ public:
    * not supposed to be created on their own. No range ctor either.
    */
 
-  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& operator=(
-    const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x)
+  hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& operator=(
+    const hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x)
   {
     this->final()=x.final();
     return *this;
   }
 
 #if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
-  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& operator=(
+  hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& operator=(
     std::initializer_list<value_type> list)
   {
     this->final()=list;
@@ -278,6 +328,11 @@ public:
   BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL_EXTRA_ARG(
     iterator,emplace_hint,emplace_hint_impl,iterator,position)
 
+  /* h must be the hash value of the key of the element constructed */
+
+  BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL_EXTRA_ARG(
+    emplace_return_type,emplace_hashed,emplace_hashed_impl,std::size_t,h)
+
   std::pair<iterator,bool> insert(const value_type& x)
   {
     BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
@@ -375,24 +430,14 @@ public:
   size_type erase(key_param_type k)
   {
     BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
+    return erase_hashed(k,hash_(k));
+  }
 
-    std::size_t buc=buckets.position(hash_(k));
-    for(node_impl_pointer x=buckets.at(buc)->prior();
-        x!=node_impl_pointer(0);x=node_alg::next_to_inspect(x)){
-      if(eq_(k,key(index_node_type::from_impl(x)->value()))){
-        node_impl_pointer y=end_of_range(x);
-        size_type         s=0;
-        do{
-          node_impl_pointer z=node_alg::after(x);
-          this->final_erase_(
-            static_cast<final_node_type*>(index_node_type::from_impl(x)));
-          x=z;
-          ++s;
-        }while(x!=y);
-        return s;
-      }
-    }
-    return 0;
+  size_type erase(key_param_type k,std::size_t h)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_HASH(h,hash_,k);
+    BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
+    return erase_hashed(k,h);
   }
 
   iterator erase(iterator first,iterator last)
@@ -501,7 +546,8 @@ public:
     this->final_clear_();
   }
 
-  void swap(hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x)
+  void swap(hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x)
   {
     BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
     BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT_OF(x);
@@ -542,6 +588,17 @@ public:
       k,hash,eq,promotes_1st_arg<CompatiblePred,CompatibleKey,key_type>());
   }
 
+  /* Overloads taking the hash value h of k skip the computation of
+   * hash_(k), which is only checked in safe mode.
+   */
+
+  template<typename CompatibleKey>
+  iterator find(const CompatibleKey& k,std::size_t h)const
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_HASH(h,hash_,k);
+    return find_hashed(k,h,eq_);
+  }
+
   template<typename CompatibleKey>
   size_type count(const CompatibleKey& k)const
   {
@@ -559,12 +616,27 @@ public:
       k,hash,eq,promotes_1st_arg<CompatiblePred,CompatibleKey,key_type>());
   }
 
+  template<typename CompatibleKey>
+  size_type count(const CompatibleKey& k,std::size_t h)const
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_HASH(h,hash_,k);
+    return count_hashed(k,h,eq_);
+  }
+
   template<typename CompatibleKey>
   std::pair<iterator,iterator> equal_range(const CompatibleKey& k)const
   {
     return equal_range(k,hash_,eq_);
   }
 
+  template<typename CompatibleKey>
+  std::pair<iterator,iterator> equal_range(
+    const CompatibleKey& k,std::size_t h)const
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_HASH(h,hash_,k);
+    return equal_range_hashed(k,h,eq_);
+  }
+
   template<
     typename CompatibleKey,typename CompatibleHash,typename CompatiblePred
   >
@@ -576,11 +648,89 @@ public:
       k,hash,eq,promotes_1st_arg<CompatiblePred,CompatibleKey,key_type>());
   }
 
+  /* Batched lookup: keys are processed in blocks, hashing all the keys of a
+   * block and prefetching their buckets and first elements before resolving
+   * any of them, so that cache misses of different keys overlap.
+   */
+
+  template<typename ForwardIterator,typename OutputIterator>
+  OutputIterator find_many(
+    ForwardIterator first,ForwardIterator last,OutputIterator res)const
+  {
+    return find_many(first,last,res,hash_,eq_);
+  }
+
+  template<
+    typename ForwardIterator,typename OutputIterator,
+    typename CompatibleHash,typename CompatiblePred
+  >
+  OutputIterator find_many(
+    ForwardIterator first,ForwardIterator last,OutputIterator res,
+    const CompatibleHash& hash,const CompatiblePred& eq)const
+  {
+    std::size_t       hs[lookup_batch_size];
+    node_impl_pointer xs[lookup_batch_size];
+    while(first!=last){
+      ForwardIterator it=first;
+      for(std::size_t i=0,n=prefetch_batch(first,last,hash,hs,xs);
+          i!=n;++i,++it){
+        node_impl_pointer x=find_from(xs[i],hs[i],*it,eq);
+        *res++=x!=node_impl_pointer(0)?
+          make_iterator(index_node_type::from_impl(x)):end();
+      }
+    }
+    return res;
+  }
+
+  template<typename ForwardIterator,typename OutputIterator>
+  OutputIterator count_many(
+    ForwardIterator first,ForwardIterator last,OutputIterator res)const
+  {
+    return count_many(first,last,res,hash_,eq_);
+  }
+
+  template<
+    typename ForwardIterator,typename OutputIterator,
+    typename CompatibleHash,typename CompatiblePred
+  >
+  OutputIterator count_many(
+    ForwardIterator first,ForwardIterator last,OutputIterator res,
+    const CompatibleHash& hash,const CompatiblePred& eq)const
+  {
+    std::size_t       hs[lookup_batch_size];
+    node_impl_pointer xs[lookup_batch_size];
+    while(first!=last){
+      ForwardIterator it=first;
+      for(std::size_t i=0,n=prefetch_batch(first,last,hash,hs,xs);
+          i!=n;++i,++it){
+        *res++=count_range(find_from(xs[i],hs[i],*it,eq));
+      }
+    }
+    return res;
+  }
+
+  /* Calls f(first,last,n) for each group of n equivalent elements, jumping
+   * from one group to the next in constant time.
+   */
+
+  template<typename F>
+  F for_each_group(F f)const
+  {
+    for(const_iterator it=begin(),it_end=end();it!=it_end;){
+      node_impl_pointer x=it.get_node()->impl();
+      const_iterator    it_last=make_iterator(
+        index_node_type::from_impl(end_of_range(x)));
+      f(it,it_last,count_range(x));
+      it=it_last;
+    }
+    return f;
+  }
+
   /* bucket interface */
 
   size_type bucket_count()const BOOST_NOEXCEPT
   {
-    return static_cast<size_type>(buckets.size());
+    return static_cast<size_type>(buckets.size()+pending_bucket_count());
   }
 
   size_type max_bucket_count()const BOOST_NOEXCEPT{return static_cast<size_type>(-1);}
@@ -588,7 +738,7 @@ public:
   size_type bucket_size(size_type n)const
   {
     size_type res=0;
-    for(node_impl_pointer x=buckets.at(n)->prior();
+    for(node_impl_pointer x=bucket_at(n)->prior();
         x!=node_impl_pointer(0);x=node_alg::after_local(x)){
       ++res;
     }
@@ -597,7 +747,7 @@ public:
 
   size_type bucket(key_param_type k)const
   {
-    return static_cast<size_type>(buckets.position(hash_(k)));
+    return static_cast<size_type>(bucket_index(hash_(k)));
   }
 
   local_iterator begin(size_type n)
@@ -607,7 +757,7 @@ public:
 
   const_local_iterator begin(size_type n)const
   {
-    node_impl_pointer x=buckets.at(n)->prior();
+    node_impl_pointer x=bucket_at(n)->prior();
     if(x==node_impl_pointer(0))return end(n);
     return make_local_iterator(index_node_type::from_impl(x));
   }
@@ -643,19 +793,14 @@ public:
     {return static_cast<float>(size())/bucket_count();}
   float max_load_factor()const BOOST_NOEXCEPT{return mlf;}
   void  max_load_factor(float z){mlf=z;calculate_max_load();}
+  float min_load_factor()const BOOST_NOEXCEPT{return minlf;}
+  void  min_load_factor(float z){minlf=z;}
 
   void rehash(size_type n)
   {
     BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
-    if(size()<=max_load&&n<=bucket_count())return;
-
-    size_type bc =(std::numeric_limits<size_type>::max)();
-    float     fbc=1.0f+static_cast<float>(size())/mlf;
-    if(bc>fbc){
-      bc=static_cast<size_type>(fbc);
-      if(bc<n)bc=n;
-    }
-    unchecked_rehash(bc);
+    if(!rehash_in_progress()&&size()<=max_load&&n<=bucket_count())return;
+    unchecked_rehash(rehash_bucket_count(n));
   }
 
   void reserve(size_type n)
@@ -663,21 +808,86 @@ public:
     rehash(static_cast<size_type>(std::ceil(static_cast<float>(n)/mlf)));
   }
 
+  void shrink_to_fit()
+  {
+    BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
+    size_type bc=bucket_count_for(size());
+    if(rehash_in_progress()||
+       bucket_array_type::size_for(bc)<buckets.size())unchecked_rehash(bc);
+    else end_incremental_rehash(); /* drops spare buckets, if any */
+  }
+
+  /* statistics */
+
+  stats_type stats()const
+  {
+    stats_type res;
+    res.bucket_count=bucket_count();
+    for(size_type buc=0;buc!=res.bucket_count;++buc){
+      std::size_t len=0;
+      for(node_impl_pointer x=bucket_at(buc)->prior();
+          x!=node_impl_pointer(0);){
+        std::size_t n=count_range(x);
+        len+=n;
+        ++res.group_count;
+        if(n>res.max_group_size)res.max_group_size=n;
+        while(n--)x=node_alg::after_local(x);
+      }
+      if(len==0)++res.empty_bucket_count;
+      if(len>res.max_chain_length)res.max_chain_length=len;
+      ++res.chain_length_histogram[
+        len<stats_type::chain_length_histogram_size?
+          len:stats_type::chain_length_histogram_size-1];
+    }
+    res.bucket_bytes=buckets.memory_size()+pending_buckets_memory_size();
+    res.node_bytes=size()*sizeof(final_node_type);
+    return res;
+  }
+
+  /* freezing */
+
+  bool freeze()
+  {
+    BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
+    if(frozen())return true;
+
+    std::vector<std::size_t>       hs;
+    std::vector<node_impl_pointer> xs;
+    hs.reserve(size());
+    xs.reserve(size());
+    for(size_type buc=0,buc_end=bucket_count();buc!=buc_end;++buc){
+      for(node_impl_pointer x=bucket_at(buc)->prior();
+          x!=node_impl_pointer(0);){
+        hs.push_back(hash_of(x));
+        xs.push_back(x);
+        for(size_type n=count_range(x);n--;)x=node_alg::after_local(x);
+      }
+    }
+    return mph.build(get_allocator(),hs.begin(),hs.end(),xs.begin());
+  }
+
+  void unfreeze()BOOST_NOEXCEPT{if(frozen())mph.clear();}
+  bool frozen()const BOOST_NOEXCEPT{return !mph.empty();}
+
 BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   hashed_index(const ctor_args_list& args_list,const allocator_type& al):
     super(args_list.get_tail(),al),
+    rehash_state_type(al),
     key(tuples::get<1>(args_list.get_head())),
     hash_(tuples::get<2>(args_list.get_head())),
     eq_(tuples::get<3>(args_list.get_head())),
     buckets(al,header()->impl(),tuples::get<0>(args_list.get_head())),
-    mlf(1.0f)
+    mlf(1.0f),
+    minlf(0.0f)
   {
     calculate_max_load();
   }
 
   hashed_index(
-    const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x):
+    const hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x):
     super(x),
+    rehash_state_type(x.get_allocator()),
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super(),
@@ -688,17 +898,22 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     eq_(x.eq_),
     buckets(x.get_allocator(),header()->impl(),x.buckets.size()),
     mlf(x.mlf),
+    minlf(x.minlf),
     max_load(x.max_load)
   {
     /* Copy ctor just takes the internal configuration objects from x. The rest
      * is done in subsequent call to copy_().
      */
+
+    copy_rehash_state(x);
   }
 
   hashed_index(
-    const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
+    const hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
     do_not_copy_elements_tag):
     super(x,do_not_copy_elements_tag()),
+    rehash_state_type(x.get_allocator()),
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super(),
@@ -708,7 +923,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     hash_(x.hash_),
     eq_(x.eq_),
     buckets(x.get_allocator(),header()->impl(),0),
-    mlf(1.0f)
+    mlf(1.0f),
+    minlf(0.0f)
   {
      calculate_max_load();
   }
@@ -751,14 +967,16 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   }
 
   void copy_(
-    const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
+    const hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
     const copy_map_type& map)
   {
     copy_(x,map,Category());
   }
 
   void copy_(
-    const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
+    const hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
     const copy_map_type& map,hashed_unique_tag)
   {
     if(x.size()!=0){
@@ -770,11 +988,11 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
                           prev_cpy=
           static_cast<index_node_type*>(map.find(static_cast<final_node_type*>(
             index_node_type::from_impl(prev_org))))->impl();
+        if(prev_org!=end_org)copy_stored_hash(prev_org,prev_cpy);
         cpy->prior()=prev_cpy;
         if(node_alg::is_first_of_bucket(org)){
           node_impl_base_pointer buc_org=prev_org->next(),
-                                 buc_cpy=
-            buckets.begin()+(buc_org-x.buckets.begin());
+                                 buc_cpy=copy_bucket(x,buc_org,org);
           prev_cpy->next()=buc_cpy;
           buc_cpy->prior()=cpy;
         }
@@ -790,7 +1008,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   }
   
   void copy_(
-    const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
+    const hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
     const copy_map_type& map,hashed_non_unique_tag)
   {
     if(x.size()!=0){
@@ -802,10 +1021,13 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
                           next_cpy=
           static_cast<index_node_type*>(map.find(static_cast<final_node_type*>(
             index_node_type::from_impl(next_org))))->impl();
+        if(next_org!=end_org){
+          copy_stored_hash(next_org,next_cpy);
+          copy_group_size(next_org,next_cpy);
+        }
         if(node_alg::is_first_of_bucket(next_org)){
           node_impl_base_pointer buc_org=org->next(),
-                                 buc_cpy=
-            buckets.begin()+(buc_org-x.buckets.begin());
+                                 buc_cpy=copy_bucket(x,buc_org,next_org);
           cpy->next()=buc_cpy;
           buc_cpy->prior()=next_cpy;
           next_cpy->prior()=cpy;
@@ -847,15 +1069,15 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   {
     reserve_for_insert(size()+1);
 
-    std::size_t buc=find_bucket(v);
-    link_info   pos(buckets.at(buc));
-    if(!link_point(v,pos)){
+    std::size_t h=insertion_hash(v,variant);
+    link_info   pos(bucket_of(h));
+    if(!link_point(v,h,pos)){
       return static_cast<final_node_type*>(
         index_node_type::from_impl(node_impl_type::pointer_from(pos)));
     }
 
     final_node_type* res=super::insert_(v,x,variant);
-    if(res==x)link(static_cast<index_node_type*>(x),pos);
+    if(res==x)link(static_cast<index_node_type*>(x),h,pos);
     return res;
   }
 
@@ -866,18 +1088,31 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   {
     reserve_for_insert(size()+1);
 
-    std::size_t buc=find_bucket(v);
-    link_info   pos(buckets.at(buc));
-    if(!link_point(v,pos)){
+    std::size_t h=insertion_hash(v,variant);
+    link_info   pos(bucket_of(h));
+    if(!link_point(v,h,pos)){
       return static_cast<final_node_type*>(
         index_node_type::from_impl(node_impl_type::pointer_from(pos)));
     }
 
     final_node_type* res=super::insert_(v,position,x,variant);
-    if(res==x)link(static_cast<index_node_type*>(x),pos);
+    if(res==x)link(static_cast<index_node_type*>(x),h,pos);
     return res;
   }
 
+  template<typename Variant>
+  std::size_t insertion_hash(value_param_type v,Variant)const
+  {
+    return hash_(key(v));
+  }
+
+  std::size_t insertion_hash(
+    value_param_type v,hashed_emplaced_tag<hashed_index> variant)const
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_HASH(variant.h,hash_,key(v));
+    return variant.h;
+  }
+
   void extract_(index_node_type* x)
   {
     unlink(x);
@@ -888,6 +1123,25 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 #endif
   }
 
+  void clear_buckets()
+  {
+    /* with shrinking enabled, a big array is replaced rather than reset */
+
+    if(minlf>0&&bucket_array_type::size_for(0)<buckets.size()){
+      BOOST_TRY{
+        bucket_array_type buckets_cpy(get_allocator(),header()->impl(),0);
+        buckets.swap(buckets_cpy);
+        end_incremental_rehash();
+        calculate_max_load();
+        return;
+      }
+      BOOST_CATCH(...){}
+      BOOST_CATCH_END
+    }
+    buckets.clear(header()->impl());
+    end_incremental_rehash();
+  }
+
   void delete_all_nodes_()
   {
     delete_all_nodes_(Category());
@@ -925,7 +1179,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   void clear_()
   {
     super::clear_();
-    buckets.clear(header()->impl());
+    clear_buckets();
+    mph.clear();
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super::detach_dereferenceable_iterators();
@@ -934,7 +1189,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
   template<typename BoolConstant>
   void swap_(
-    hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
+    hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
     BoolConstant swap_allocators)
   {
     adl_swap(key,x.key);
@@ -942,7 +1197,10 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     adl_swap(eq_,x.eq_);
     buckets.swap(x.buckets,swap_allocators);
     std::swap(mlf,x.mlf);
+    std::swap(minlf,x.minlf);
     std::swap(max_load,x.max_load);
+    migration().swap(x.migration(),swap_allocators);
+    mph.swap(x.mph);
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super::swap(x);
@@ -952,11 +1210,14 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   }
 
   void swap_elements_(
-    hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x)
+    hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x)
   {
     buckets.swap(x.buckets);
     std::swap(mlf,x.mlf);
+    std::swap(minlf,x.minlf);
     std::swap(max_load,x.max_load);
+    migration().swap(x.migration());
+    mph.swap(x.mph);
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
     safe_super::swap(x);
@@ -976,10 +1237,10 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     unlink(x,undo);
 
     BOOST_TRY{
-      std::size_t  buc=find_bucket(v);
-      link_info    pos(buckets.at(buc));
-      if(link_point(v,pos)&&super::replace_(v,x,variant)){
-        link(x,pos);
+      std::size_t  h=hash_(key(v));
+      link_info    pos(bucket_of(h));
+      if(link_point(v,h,pos)&&super::replace_(v,x,variant)){
+        link(x,h,pos);
         return true;
       }
       undo();
@@ -994,11 +1255,13 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
   bool modify_(index_node_type* x)
   {
-    std::size_t buc;
-    bool        b; 
+    std::size_t            h;
+    node_impl_base_pointer buc;
+    bool                   b; 
     BOOST_TRY{
-      buc=find_bucket(x->value());
-      b=in_place(x->impl(),key(x->value()),buc);
+      h=hash_(key(x->value()));
+      buc=bucket_of(h);
+      b=in_place(x->impl(),key(x->value()),h,buc)&&keeps_group_size(x);
     }
     BOOST_CATCH(...){
       extract_(x);
@@ -1008,8 +1271,8 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     if(!b){
       unlink(x);
       BOOST_TRY{
-        link_info pos(buckets.at(buc));
-        if(!link_point(x->value(),pos)){
+        link_info pos(buc);
+        if(!link_point(x->value(),h,pos)){
           super::extract_(x);
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
@@ -1017,7 +1280,7 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 #endif
           return false;
         }
-        link(x,pos);
+        link(x,h,pos);
       }
       BOOST_CATCH(...){
         super::extract_(x);
@@ -1030,6 +1293,12 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
       }
       BOOST_CATCH_END
     }
+    else{
+      /* key may have changed all the same, and with it its hash value */
+
+      unfreeze();
+      set_stored_hash(x,h);
+    }
 
     BOOST_TRY{
       if(!super::modify_(x)){
@@ -1056,18 +1325,26 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
   bool modify_rollback_(index_node_type* x)
   {
-    std::size_t buc=find_bucket(x->value());
-    if(in_place(x->impl(),key(x->value()),buc)){
-      return super::modify_rollback_(x);
+    std::size_t            h=hash_(key(x->value()));
+    node_impl_base_pointer buc=bucket_of(h);
+    if(in_place(x->impl(),key(x->value()),h,buc)&&keeps_group_size(x)){
+      /* stored hash updated only on success, as the element is to be
+       * restored to its original value otherwise
+       */
+
+      if(!super::modify_rollback_(x))return false;
+      unfreeze();
+      set_stored_hash(x,h);
+      return true;
     }
 
     unlink_undo undo;
     unlink(x,undo);
 
     BOOST_TRY{
-      link_info pos(buckets.at(buc));
-      if(link_point(x->value(),pos)&&super::modify_rollback_(x)){
-        link(x,pos);
+      link_info pos(buc);
+      if(link_point(x->value(),h,pos)&&super::modify_rollback_(x)){
+        link(x,h,pos);
         return true;
       }
       undo();
@@ -1082,8 +1359,9 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
   bool check_rollback_(index_node_type* x)const
   {
-    std::size_t buc=find_bucket(x->value());
-    return in_place(x->impl(),key(x->value()),buc)&&super::check_rollback_(x);
+    std::size_t h=hash_(key(x->value()));
+    return in_place(x->impl(),key(x->value()),h,bucket_of(h))&&
+           super::check_rollback_(x);
   }
 
   /* comparison */
@@ -1091,9 +1369,12 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 #if !defined(BOOST_NO_MEMBER_TEMPLATE_FRIENDS)
   /* defect macro refers to class, not function, templates, but anyway */
 
-  template<typename K,typename H,typename P,typename S,typename T,typename C>
+  template<
+    typename K,typename H,typename P,typename S,typename T,typename C,
+    typename O
+  >
   friend bool operator==(
-    const hashed_index<K,H,P,S,T,C>&,const hashed_index<K,H,P,S,T,C>& y);
+    const hashed_index<K,H,P,S,T,C,O>&,const hashed_index<K,H,P,S,T,C,O>& y);
 #endif
 
   bool equals(const hashed_index& x)const{return equals(x,Category());}
@@ -1177,17 +1458,47 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
         size_type ss1=0;
         for(const_local_iterator it=begin(buc),it_end=end(buc);
             it!=it_end;++it,++ss1){
-          if(find_bucket(*it)!=buc)return false;
+          std::size_t h=hash_(key(*it));
+          if(bucket_index(h)!=buc)return false;
+          if(!check_stored_hash(it.get_node(),h))return false;
         }
         if(ss1!=bucket_size(buc))return false;
         s1+=ss1;
       }
       if(s1!=size())return false;
+
+      if(!check_group_sizes(stores_group_size()))return false;
+
+      if(frozen()){
+        for(const_iterator it=begin(),it_end=end();it!=it_end;++it){
+          std::size_t h=hash_(key(*it));
+          if(*mph.find(h)!=
+             find_in_bucket(bucket_of(h)->prior(),h,key(*it),eq_)){
+            return false;
+          }
+        }
+      }
     }
 
     return super::invariant_();
   }
 
+  bool check_group_sizes(mpl::true_)const
+  {
+    for(const_iterator it=begin(),it_end=end();it!=it_end;){
+      const_iterator it_last=make_iterator(
+        index_node_type::from_impl(end_of_range(it.get_node()->impl())));
+      if(group_size(it.get_node()->impl())!=
+         static_cast<std::size_t>(std::distance(it,it_last)))return false;
+      while(++it!=it_last){
+        if(group_size(it.get_node()->impl())!=0)return false;
+      }
+    }
+    return true;
+  }
+
+  bool check_group_sizes(mpl::false_)const{return true;}
+
   /* This forwarding function eases things for the boost::mem_fn construct
    * in BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT. Actually,
    * final_check_invariant is already an inherited member function of index.
@@ -1219,17 +1530,19 @@ private:
     link_info_non_unique
   >::type                                link_info;
 
-  bool link_point(value_param_type v,link_info& pos)
+  bool link_point(value_param_type v,std::size_t h,link_info& pos)
   {
-    return link_point(v,pos,Category());
+    return link_point(v,h,pos,Category());
   }
 
   bool link_point(
-    value_param_type v,node_impl_base_pointer& pos,hashed_unique_tag)
+    value_param_type v,std::size_t h,node_impl_base_pointer& pos,
+    hashed_unique_tag)
   {
     for(node_impl_pointer x=pos->prior();x!=node_impl_pointer(0);
         x=node_alg::after_local(x)){
-      if(eq_(key(v),key(index_node_type::from_impl(x)->value()))){
+      if(hash_match(x,h)&&
+         eq_(key(v),key(index_node_type::from_impl(x)->value()))){
         pos=node_impl_type::base_pointer_from(x);
         return false;
       }
@@ -1238,11 +1551,13 @@ private:
   }
 
   bool link_point(
-    value_param_type v,link_info_non_unique& pos,hashed_non_unique_tag)
+    value_param_type v,std::size_t h,link_info_non_unique& pos,
+    hashed_non_unique_tag)
   {
     for(node_impl_pointer x=pos.first->prior();x!=node_impl_pointer(0);
         x=node_alg::next_to_inspect(x)){
-      if(eq_(key(v),key(index_node_type::from_impl(x)->value()))){
+      if(hash_match(x,h)&&
+         eq_(key(v),key(index_node_type::from_impl(x)->value()))){
         pos.first=node_impl_type::base_pointer_from(x);
         pos.last=node_impl_type::base_pointer_from(last_of_range(x));
         return true;
@@ -1269,6 +1584,7 @@ private:
     if(z==x){                      /* range of size 1 or 2 */
       node_impl_pointer yy=node_impl_type::pointer_from(y);
       return
+        same_hash(x,yy)&&
         eq_(
           key(index_node_type::from_impl(x)->value()),
           key(index_node_type::from_impl(yy)->value()))?yy:x;
@@ -1296,7 +1612,8 @@ private:
     node_impl_pointer      z=y->prior();
     if(z==x){                      /* range of size 1 or 2 */
       node_impl_pointer yy=node_impl_type::pointer_from(y);
-      if(!eq_(
+      if(!same_hash(x,yy)||
+         !eq_(
            key(index_node_type::from_impl(x)->value()),
            key(index_node_type::from_impl(yy)->value())))yy=x;
       return yy->next()->prior()==yy?
@@ -1311,8 +1628,15 @@ private:
                z->next()->prior();
   }
 
-  void link(index_node_type* x,const link_info& pos)
+  /* all modifications of the index go through link and unlink, which
+   * thus take care of dropping the perfect hash table of a frozen index
+   * (in-place modify_ and modify_rollback_ do it on their own)
+   */
+
+  void link(index_node_type* x,std::size_t h,const link_info& pos)
   {
+    unfreeze();
+    set_stored_hash(x,h);
     link(x,pos,Category());
   }
 
@@ -1326,47 +1650,156 @@ private:
   {
     if(pos.last==node_impl_base_pointer(0)){
       node_alg::link(x->impl(),pos.first,header()->impl());
+      set_group_size(x->impl(),1);
     }
     else{
-      node_alg::link(
-        x->impl(),
-        node_impl_type::pointer_from(pos.first),
-        node_impl_type::pointer_from(pos.last));
+      node_impl_pointer first=node_impl_type::pointer_from(pos.first);
+      node_alg::link(x->impl(),first,node_impl_type::pointer_from(pos.last));
+      set_group_size(x->impl(),group_size(first)+1);
+      set_group_size(first,0);
     }
   }
 
   void unlink(index_node_type* x)
   {
+    unfreeze();
+    group_size_update u=group_size_on_unlink(x->impl());
     node_alg::unlink(x->impl());
+    set_group_size(u.first,u.second);
   }
 
-  typedef typename node_alg::unlink_undo unlink_undo;
+  typedef typename node_alg::unlink_undo        node_alg_unlink_undo;
+
+  /* unlink_undo also restores the group size modified by unlink */
+
+  struct group_size_unlink_undo
+  {
+    group_size_unlink_undo():x(0),size(0){}
+
+    void operator()()
+    {
+      undo();
+      if(x!=node_impl_pointer(0))set_group_size(x,size);
+    }
+
+    node_alg_unlink_undo undo;
+    node_impl_pointer    x;
+    std::size_t          size;
+  };
+
+  typedef typename mpl::if_<
+    stores_group_size,
+    group_size_unlink_undo,
+    node_alg_unlink_undo
+  >::type                                       unlink_undo;
 
   void unlink(index_node_type* x,unlink_undo& undo)
+  {
+    unfreeze();
+    unlink(x,undo,stores_group_size());
+  }
+
+  void unlink(index_node_type* x,node_alg_unlink_undo& undo,mpl::false_)
   {
     node_alg::unlink(x->impl(),undo);
   }
 
+  void unlink(index_node_type* x,group_size_unlink_undo& undo,mpl::true_)
+  {
+    group_size_update u=group_size_on_unlink(x->impl());
+    node_alg::unlink(x->impl(),undo.undo);
+    if(u.first!=node_impl_pointer(0)){ /* x was not alone in its group */
+      undo.x=u.first;
+      undo.size=group_size(u.first);
+      set_group_size(u.first,u.second);
+    }
+  }
+
   void calculate_max_load()
   {
-    float fml=mlf*static_cast<float>(bucket_count());
+    float fml=mlf*static_cast<float>(buckets.size());
     max_load=(std::numeric_limits<size_type>::max)();
     if(max_load>fml)max_load=static_cast<size_type>(fml);
   }
 
+  /* Shrinking is triggered by an insertion finding the load below min_load()
+   * (erasure does not rehash, so that erasing while traversing the index
+   * stays safe) and aims at a load factor midway between the shrinking
+   * threshold and mlf. As the threshold is capped at mlf/4 and consecutive
+   * bucket counts are about a factor of two apart, the resulting load
+   * factor lies well within both limits, so that the size must change by
+   * a constant fraction before the index grows or shrinks again, whatever
+   * the sequence of insertions and erasures.
+   */
+
+  float shrink_load_factor()const
+  {
+    return minlf<mlf/4?minlf:mlf/4;
+  }
+
+  /* computed on the fly rather than stored, as it is only needed with a
+   * nonzero minimum load factor
+   */
+
+  size_type min_load()const
+  {
+    return static_cast<size_type>(
+      shrink_load_factor()*static_cast<float>(buckets.size()));
+  }
+
   void reserve_for_insert(size_type n)
+  {
+    if(minlf>0&&n<min_load())shrink_for_insert(n);
+    reserve_for_insert(n,rehashes_incrementally());
+  }
+
+  void shrink_for_insert(size_type n)
+  {
+    float     target=(shrink_load_factor()+mlf)/2;
+    size_type bc=static_cast<size_type>(
+      1.0f+static_cast<float>(n)/target);
+    if(bucket_array_type::size_for(bc)<buckets.size())unchecked_rehash(bc);
+  }
+
+  void reserve_for_insert(size_type n,mpl::false_)
+  {
+    if(n>max_load)unchecked_rehash(bucket_count_for(n));
+  }
+
+  void reserve_for_insert(size_type n,mpl::true_)
   {
     if(n>max_load){
-      size_type bc =(std::numeric_limits<size_type>::max)();
-      float     fbc=1.0f+static_cast<float>(n)/mlf;
-      if(bc>fbc)bc =static_cast<size_type>(fbc);
-      unchecked_rehash(bc);
+      /* a migration still pending here can only be due to a change in the
+       * maximum load factor: rehash everything then
+       */
+
+      if(rehash_in_progress())unchecked_rehash(bucket_count_for(n));
+      else start_incremental_rehash(n);
     }
+    else if(rehash_in_progress())migrate_buckets(migration().step);
+    else prepare_buckets(n);
+  }
+
+  size_type bucket_count_for(size_type n)const
+  {
+    size_type bc =(std::numeric_limits<size_type>::max)();
+    float     fbc=1.0f+static_cast<float>(n)/mlf;
+    if(bc>fbc)bc =static_cast<size_type>(fbc);
+    return bc;
+  }
+
+  size_type rehash_bucket_count(size_type n)const
+  {
+    size_type bc=bucket_count_for(size());
+    return bc<n?n:bc;
   }
 
-  void unchecked_rehash(size_type n){unchecked_rehash(n,Category());}
+  void unchecked_rehash(size_type n)
+  {
+    unchecked_rehash(n,Category(),stores_hash());
+  }
 
-  void unchecked_rehash(size_type n,hashed_unique_tag)
+  void unchecked_rehash(size_type n,hashed_unique_tag,mpl::false_)
   {
     node_impl_type    cpy_end_node;
     node_impl_pointer cpy_end=node_impl_pointer(&cpy_end_node),
@@ -1411,14 +1844,10 @@ private:
       BOOST_CATCH_END
     }
 
-    end_->prior()=cpy_end->prior()!=cpy_end?cpy_end->prior():end_;
-    end_->next()=cpy_end->next();
-    end_->prior()->next()->prior()=end_->next()->prior()->prior()=end_;
-    buckets.swap(buckets_cpy);
-    calculate_max_load();
+    commit_rehash(cpy_end,buckets_cpy);
   }
 
-  void unchecked_rehash(size_type n,hashed_non_unique_tag)
+  void unchecked_rehash(size_type n,hashed_non_unique_tag,mpl::false_)
   {
     node_impl_type    cpy_end_node;
     node_impl_pointer cpy_end=node_impl_pointer(&cpy_end_node),
@@ -1472,51 +1901,741 @@ private:
       BOOST_CATCH_END
     }
 
+    commit_rehash(cpy_end,buckets_cpy);
+  }
+
+  /* With stored hashes, a rehash does not invoke hash_ and thus can't
+   * throw: neither the rollback machinery above nor the extra memory
+   * it needs are required.
+   */
+
+  void unchecked_rehash(size_type n,hashed_unique_tag,mpl::true_)
+  {
+    node_impl_type    cpy_end_node;
+    node_impl_pointer cpy_end=node_impl_pointer(&cpy_end_node),
+                      end_=header()->impl();
+    bucket_array_type buckets_cpy(get_allocator(),cpy_end,n);
+
+    for(std::size_t i=0,size_=size();i!=size_;++i){
+      node_impl_pointer x=end_->prior();
+      std::size_t       h=index_node_type::from_impl(x)->stored_hash();
+      node_alg::unlink_last(end_);
+      node_alg::link(x,buckets_cpy.at(buckets_cpy.position(h)),cpy_end);
+    }
+
+    commit_rehash(cpy_end,buckets_cpy);
+  }
+
+  void unchecked_rehash(size_type n,hashed_non_unique_tag,mpl::true_)
+  {
+    node_impl_type    cpy_end_node;
+    node_impl_pointer cpy_end=node_impl_pointer(&cpy_end_node),
+                      end_=header()->impl();
+    bucket_array_type buckets_cpy(get_allocator(),cpy_end,n);
+
+    for(;;){
+      node_impl_pointer x=end_->prior();
+      if(x==end_)break;
+
+      std::size_t h=index_node_type::from_impl(x)->stored_hash();
+      std::pair<node_impl_pointer,bool> p=node_alg::unlink_last_group(end_);
+      node_alg::link_range(
+        p.first,x,buckets_cpy.at(buckets_cpy.position(h)),cpy_end);
+    }
+
+    commit_rehash(cpy_end,buckets_cpy);
+  }
+
+  void commit_rehash(node_impl_pointer cpy_end,bucket_array_type& buckets_cpy)
+  {
+    node_impl_pointer end_=header()->impl();
     end_->prior()=cpy_end->prior()!=cpy_end?cpy_end->prior():end_;
     end_->next()=cpy_end->next();
     end_->prior()->next()->prior()=end_->next()->prior()->prior()=end_;
     buckets.swap(buckets_cpy);
+    end_incremental_rehash();
     calculate_max_load();
   }
 
-  bool in_place(node_impl_pointer x,key_param_type k,std::size_t buc)const
-  {
-    return in_place(x,k,buc,Category());
-  }
+  /* Parallel rehashing is done in two passes, each split among a number of
+   * threads:
+   *   - Thread t takes the t-th slice of the buckets (those of a pending
+   *     incremental migration included), computes the new position of their
+   *     elements (or groups thereof, for non-unique indices) and files them
+   *     by the slice of the new array they belong to. Nothing is modified,
+   *     so if hash_ throws the container is left untouched.
+   *   - Thread t links the elements filed for the t-th slice of the new
+   *     array into a list of its own, ended by a private sentinel.
+   * The resulting lists are then stitched together and committed as a
+   * regular rehash would.
+   */
 
-  bool in_place(
-    node_impl_pointer x,key_param_type k,std::size_t buc,
-    hashed_unique_tag)const
+  BOOST_STATIC_CONSTANT(std::size_t,parallel_rehash_grain=1024);
+
+  struct rehash_unit
   {
-    bool found=false;
-    for(node_impl_pointer y=buckets.at(buc)->prior();
-        y!=node_impl_pointer(0);y=node_alg::after_local(y)){
-      if(y==x)found=true;
-      else if(eq_(k,key(index_node_type::from_impl(y)->value())))return false;
+    rehash_unit(
+      node_impl_pointer first_,node_impl_pointer last_,std::size_t pos_):
+      first(first_),last(last_),pos(pos_){}
+
+    node_impl_pointer first,last;
+    std::size_t       pos;
+  };
+
+  /* these grow from several threads at once, so they do not go through
+   * allocator_type, which needs not be thread safe
+   */
+
+  typedef std::vector<rehash_unit>        rehash_unit_vector;
+  typedef std::vector<rehash_unit_vector> rehash_unit_table;
+
+  struct rehash_filer
+  {
+    rehash_filer(
+      const hashed_index& x_,const bucket_array_type& buckets_cpy_,
+      std::size_t num_threads_,rehash_unit_table& units_):
+      x(&x_),buckets_cpy(&buckets_cpy_),num_threads(num_threads_),
+      units(&units_){}
+
+    void operator()(std::size_t t)const
+    {
+      std::size_t bc=x->bucket_count(),
+                  slice=bc/num_threads+1,
+                  first=t*slice<bc?t*slice:bc,
+                  last=bc-first>slice?first+slice:bc,
+                  cpy_slice=buckets_cpy->size()/num_threads+1;
+      rehash_unit_vector* row=&(*units)[t*num_threads];
+
+      for(std::size_t buc=first;buc!=last;++buc){
+        for(node_impl_pointer y=x->bucket_at(buc)->prior();
+            y!=node_impl_pointer(0);){
+          node_impl_pointer z=last_of_unit(y,Category());
+          std::size_t       pos=buckets_cpy->position(x->hash_of(y));
+          row[pos/cpy_slice].push_back(rehash_unit(y,z,pos));
+          y=node_alg::after_local(z);
+        }
+      }
     }
-    return found;
-  }
 
-  bool in_place(
-    node_impl_pointer x,key_param_type k,std::size_t buc,
-    hashed_non_unique_tag)const
+  private:
+    static node_impl_pointer last_of_unit(node_impl_pointer y,hashed_unique_tag)
+    {
+      return y;
+    }
+
+    static node_impl_pointer last_of_unit(
+      node_impl_pointer y,hashed_non_unique_tag)
+    {
+      /* groups of 2 are filed as two units, which end up together anyway */
+
+      return node_alg::is_first_of_group(y)?y->next()->prior():y;
+    }
+
+    const hashed_index*      x;
+    const bucket_array_type* buckets_cpy;
+    std::size_t              num_threads;
+    rehash_unit_table*       units;
+  };
+
+  struct rehash_linker
   {
-    bool found=false;
-    int  range_size=0;
-    for(node_impl_pointer y=buckets.at(buc)->prior();y!=node_impl_pointer(0);){
-      if(node_alg::is_first_of_group(y)){ /* group of 3 or more */
-        if(y==x){
-          /* in place <-> equal to some other member of the group */
-          return eq_(
-            k,
-            key(index_node_type::from_impl(
-              node_impl_type::pointer_from(y->next()))->value()));
+    rehash_linker(
+      const bucket_array_type& buckets_cpy_,std::size_t num_threads_,
+      const rehash_unit_table& units_,node_impl_pointer ends_):
+      buckets_cpy(&buckets_cpy_),num_threads(num_threads_),
+      units(&units_),ends(ends_){}
+
+    void operator()(std::size_t t)const
+    {
+      node_impl_pointer end_=ends+t;
+      end_->prior()=end_;
+      end_->next()=buckets_cpy->end();
+
+      /* units are linked at the front of their bucket, so going backwards
+       * keeps elements (equivalent ones in particular) in their order
+       */
+
+      for(std::size_t i=num_threads;i--;){
+        const rehash_unit_vector& v=(*units)[i*num_threads+t];
+        for(std::size_t j=v.size();j--;){
+          link_unit(v[j],buckets_cpy->at(v[j].pos),end_,Category());
         }
-        else{
-          node_impl_pointer z=
-            node_alg::after_local(y->next()->prior()); /* end of range */
-          if(eq_(k,key(index_node_type::from_impl(y)->value()))){
-            if(found)return false; /* x lies outside */
+      }
+    }
+
+  private:
+    static void link_unit(
+      const rehash_unit& u,node_impl_base_pointer buc,node_impl_pointer end_,
+      hashed_unique_tag)
+    {
+      node_alg::link(u.first,buc,end_);
+    }
+
+    static void link_unit(
+      const rehash_unit& u,node_impl_base_pointer buc,node_impl_pointer end_,
+      hashed_non_unique_tag)
+    {
+      node_alg::link_range(u.first,u.last,buc,end_);
+    }
+
+    const bucket_array_type* buckets_cpy;
+    std::size_t              num_threads;
+    const rehash_unit_table* units;
+    node_impl_pointer        ends;
+  };
+
+  /* parallel_rehash(x,n,num_threads) and unchecked_parallel_rehash are
+   * defined in hashed_index_parallel_rehash.hpp, so that only their users
+   * pay for the inclusion of <thread>
+   */
+
+  friend class hashed_index_parallel_rehash_access;
+
+  void parallel_rehash_(size_type n,std::size_t num_threads)
+  {
+    BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
+    if(!rehash_in_progress()&&size()<=max_load&&n<=bucket_count())return;
+    unchecked_parallel_rehash(rehash_bucket_count(n),num_threads);
+  }
+
+  void unchecked_parallel_rehash(size_type n,std::size_t num_threads);
+
+  std::size_t hash_of(node_impl_pointer x)const
+  {
+    return hash_of(x,stores_hash());
+  }
+
+  std::size_t hash_of(node_impl_pointer x,mpl::true_)const
+  {
+    return index_node_type::from_impl(x)->stored_hash();
+  }
+
+  std::size_t hash_of(node_impl_pointer x,mpl::false_)const
+  {
+    return hash_(key(index_node_type::from_impl(x)->value()));
+  }
+
+  /* Incremental rehashing: the new bucket array replaces the old one
+   * right away, but the old array is kept in migration.old_buckets until
+   * all of its elements have been moved. Buckets of the old array are
+   * migrated in increasing order, migration.next being the first one not
+   * yet processed, so the bucket for a hash value h is found in the old
+   * array iff old_buckets.position(h)>=migration.next. Runs of both arrays
+   * coexist in the same doubly linked list, which is what keeps iteration
+   * oblivious to the whole process.
+   *
+   * Buckets are migrated only on insertion (rehashing is allowed to change
+   * the traversal order there) in batches sized so that the migration is
+   * complete before the new array is itself exhausted. Likewise, the new
+   * array is allocated in advance as migration.spare_buckets and its
+   * buckets initialized by the insertions taking the load beyond 3/4 of
+   * max_load, so that no insertion does work proportional to the size of
+   * the container.
+   *
+   * The state of the migration is kept in a base class, empty for indices
+   * not rehashing incrementally.
+   */
+
+  rehash_state_type&       migration(){return *this;}
+  const rehash_state_type& migration()const{return *this;}
+
+  bool rehash_in_progress()const
+  {
+    return rehash_in_progress(rehashes_incrementally());
+  }
+
+  bool rehash_in_progress(mpl::true_)const{return migration().step!=0;}
+  bool rehash_in_progress(mpl::false_)const{return false;}
+
+  std::size_t pending_bucket_count()const
+  {
+    return pending_bucket_count(rehashes_incrementally());
+  }
+
+  std::size_t pending_bucket_count(mpl::true_)const
+  {
+    return rehash_in_progress()?migration().old_buckets.size():0;
+  }
+
+  std::size_t pending_bucket_count(mpl::false_)const{return 0;}
+
+  std::size_t pending_buckets_memory_size()const
+  {
+    return pending_buckets_memory_size(rehashes_incrementally());
+  }
+
+  std::size_t pending_buckets_memory_size(mpl::true_)const
+  {
+    return
+      migration().old_buckets.memory_size()+
+      migration().spare_buckets.memory_size();
+  }
+
+  std::size_t pending_buckets_memory_size(mpl::false_)const{return 0;}
+
+  node_impl_base_pointer bucket_of(std::size_t h)const
+  {
+    return bucket_of(h,rehashes_incrementally());
+  }
+
+  node_impl_base_pointer bucket_of(std::size_t h,mpl::true_)const
+  {
+    if(rehash_in_progress()){
+      std::size_t buc=migration().old_buckets.position(h);
+      if(buc>=migration().next)return migration().old_buckets.at(buc);
+    }
+    return buckets.at(buckets.position(h));
+  }
+
+  node_impl_base_pointer bucket_of(std::size_t h,mpl::false_)const
+  {
+    return buckets.at(buckets.position(h));
+  }
+
+  /* While a rehash is in progress, bucket numbers past those of the new
+   * array refer to the buckets of the old one.
+   */
+
+  std::size_t bucket_index(std::size_t h)const
+  {
+    return bucket_index(h,rehashes_incrementally());
+  }
+
+  std::size_t bucket_index(std::size_t h,mpl::true_)const
+  {
+    if(rehash_in_progress()){
+      std::size_t buc=migration().old_buckets.position(h);
+      if(buc>=migration().next)return buckets.size()+buc;
+    }
+    return buckets.position(h);
+  }
+
+  std::size_t bucket_index(std::size_t h,mpl::false_)const
+  {
+    return buckets.position(h);
+  }
+
+  node_impl_base_pointer bucket_at(std::size_t n)const
+  {
+    return bucket_at(n,rehashes_incrementally());
+  }
+
+  node_impl_base_pointer bucket_at(std::size_t n,mpl::true_)const
+  {
+    if(n<buckets.size())return buckets.at(n);
+    return migration().old_buckets.at(n-buckets.size());
+  }
+
+  node_impl_base_pointer bucket_at(std::size_t n,mpl::false_)const
+  {
+    return buckets.at(n);
+  }
+
+  void prepare_buckets(size_type n)
+  {
+    if(migration().chunk==0){
+      if(max_load==(std::numeric_limits<size_type>::max)()||
+         n<=max_load-max_load/4)return;
+
+      bucket_array_type spare_buckets(
+        get_allocator(),bucket_count_for(max_load+1));
+      migration().spare_buckets.swap(spare_buckets);
+      migration().initialized=0;
+      migration().chunk=migration().spare_buckets.size()/(max_load-n+1)+1;
+    }
+
+    std::size_t last=migration().spare_buckets.size();
+    if(last-migration().initialized>migration().chunk){
+      last=migration().initialized+migration().chunk;
+    }
+    migration().spare_buckets.initialize(migration().initialized,last);
+    migration().initialized=last;
+  }
+
+  void release_old_buckets()
+  {
+    if(rehash_in_progress()){
+      bucket_array_type null_buckets(get_allocator());
+      migration().old_buckets.swap(null_buckets);
+      migration().next=migration().step=0;
+    }
+  }
+
+  void release_spare_buckets()
+  {
+    if(migration().chunk!=0){
+      bucket_array_type null_buckets(get_allocator());
+      migration().spare_buckets.swap(null_buckets);
+      migration().initialized=migration().chunk=0;
+    }
+  }
+
+  void start_incremental_rehash(size_type n)
+  {
+    size_type bc=bucket_count_for(n);
+    if(migration().chunk!=0&&migration().spare_buckets.size()<bc){
+      release_spare_buckets(); /* maximum load factor has changed */
+    }
+    if(migration().chunk==0){
+      bucket_array_type spare_buckets(get_allocator(),bc);
+      migration().spare_buckets.swap(spare_buckets);
+      migration().initialized=0;
+    }
+    migration().spare_buckets.initialize(
+      migration().initialized,migration().spare_buckets.size());
+
+    /* the end bucket of the new array takes over as the list sentinel */
+
+    node_impl_pointer end_=header()->impl();
+    end_->prior()->next()=migration().spare_buckets.end();
+    migration().spare_buckets.end()->prior()=end_;
+    buckets.swap(migration().spare_buckets);
+    migration().old_buckets.swap(migration().spare_buckets);
+    migration().initialized=migration().chunk=0;
+    calculate_max_load();
+
+    /* migration is done within half the insertions allowed before the new
+     * array reaches its maximum load, so as not to overlap with the
+     * initialization of the next spare array
+     */
+
+    size_type room=(max_load>n?max_load-n:0)/2+1;
+    migration().next=0;
+    migration().step=migration().old_buckets.size()/room+1;
+    migrate_buckets(migration().step);
+  }
+
+  void migrate_buckets(std::size_t n)
+  {
+    std::size_t last=migration().old_buckets.size();
+    if(last-migration().next>n)last=migration().next+n;
+    for(;migration().next!=last;++migration().next){
+      migrate_bucket(migration().old_buckets.at(migration().next),Category());
+    }
+    if(migration().next==migration().old_buckets.size())release_old_buckets();
+  }
+
+  void migrate_bucket(node_impl_base_pointer buc,hashed_unique_tag)
+  {
+    node_impl_pointer end_=header()->impl();
+    for(node_impl_pointer x;(x=buc->prior())!=node_impl_pointer(0);){
+      std::size_t h=index_node_type::from_impl(x)->stored_hash();
+      node_alg::unlink(x);
+      node_alg::link(x,buckets.at(buckets.position(h)),end_);
+    }
+  }
+
+  void migrate_bucket(node_impl_base_pointer buc,hashed_non_unique_tag)
+  {
+    /* Groups are moved as a whole; those of size 2 are indistinguishable
+     * from two single elements. Units are linked at the front of their new
+     * bucket, so they are taken from the back of the old one for
+     * equivalent elements to keep their relative order.
+     */
+
+    node_impl_pointer end_=header()->impl();
+    for(node_impl_pointer x;(x=buc->prior())!=node_impl_pointer(0);){
+      node_impl_pointer y;
+      for(;;){
+        y=node_alg::is_first_of_group(x)?x->next()->prior():x;
+        if(node_alg::is_last_of_bucket(y))break;
+        x=node_impl_type::pointer_from(y->next());
+      }
+      std::size_t h=index_node_type::from_impl(x)->stored_hash();
+      node_alg::unlink_range(x,y);
+      node_alg::link_range(x,y,buckets.at(buckets.position(h)),end_);
+    }
+  }
+
+  void end_incremental_rehash()
+  {
+    end_incremental_rehash(rehashes_incrementally());
+  }
+
+  void end_incremental_rehash(mpl::true_)
+  {
+    release_old_buckets();
+    release_spare_buckets();
+  }
+
+  void end_incremental_rehash(mpl::false_){}
+
+  /* A copy replicates the rehash state of x along with its layout, so that
+   * copy_ can map buckets by the stored hash of their first element.
+   */
+
+  void copy_rehash_state(const hashed_index& x)
+  {
+    copy_rehash_state(x,rehashes_incrementally());
+  }
+
+  void copy_rehash_state(const hashed_index& x,mpl::true_)
+  {
+    if(x.rehash_in_progress()){
+      node_impl_type    cpy_end_node;
+      bucket_array_type old_buckets_cpy(
+        get_allocator(),node_impl_pointer(&cpy_end_node),
+        x.migration().old_buckets.size());
+      migration().old_buckets.swap(old_buckets_cpy);
+      migration().next=x.migration().next;
+      migration().step=x.migration().step;
+    }
+  }
+
+  void copy_rehash_state(const hashed_index&,mpl::false_){}
+
+  node_impl_base_pointer copy_bucket(
+    const hashed_index& x,node_impl_base_pointer buc_org,
+    node_impl_pointer first_org)const
+  {
+    return copy_bucket(x,buc_org,first_org,rehashes_incrementally());
+  }
+
+  node_impl_base_pointer copy_bucket(
+    const hashed_index& x,node_impl_base_pointer buc_org,
+    node_impl_pointer first_org,mpl::true_)const
+  {
+    if(buc_org==x.buckets.end())return buckets.end();
+    return bucket_of(index_node_type::from_impl(first_org)->stored_hash());
+  }
+
+  node_impl_base_pointer copy_bucket(
+    const hashed_index& x,node_impl_base_pointer buc_org,
+    node_impl_pointer,mpl::false_)const
+  {
+    return buckets.begin()+(buc_org-x.buckets.begin());
+  }
+
+  /* stored hash handling: when the hash is not stored, all checks based
+   * on it trivially succeed.
+   */
+
+  static bool hash_match(node_impl_pointer x,std::size_t h)
+  {
+    return hash_match(x,h,stores_hash());
+  }
+
+  static bool hash_match(node_impl_pointer x,std::size_t h,mpl::true_)
+  {
+    return index_node_type::from_impl(x)->stored_hash()==h;
+  }
+
+  static bool hash_match(node_impl_pointer,std::size_t,mpl::false_)
+  {
+    return true;
+  }
+
+  static bool same_hash(node_impl_pointer x,node_impl_pointer y)
+  {
+    return same_hash(x,y,stores_hash());
+  }
+
+  static bool same_hash(node_impl_pointer x,node_impl_pointer y,mpl::true_)
+  {
+    return
+      index_node_type::from_impl(x)->stored_hash()==
+      index_node_type::from_impl(y)->stored_hash();
+  }
+
+  static bool same_hash(node_impl_pointer,node_impl_pointer,mpl::false_)
+  {
+    return true;
+  }
+
+  static void set_stored_hash(index_node_type* x,std::size_t h)
+  {
+    set_stored_hash(x,h,stores_hash());
+  }
+
+  static void set_stored_hash(index_node_type* x,std::size_t h,mpl::true_)
+  {
+    x->stored_hash()=h;
+  }
+
+  static void set_stored_hash(index_node_type*,std::size_t,mpl::false_){}
+
+  static void copy_stored_hash(node_impl_pointer org,node_impl_pointer cpy)
+  {
+    copy_stored_hash(org,cpy,stores_hash());
+  }
+
+  static void copy_stored_hash(
+    node_impl_pointer org,node_impl_pointer cpy,mpl::true_)
+  {
+    index_node_type::from_impl(cpy)->stored_hash()=
+      index_node_type::from_impl(org)->stored_hash();
+  }
+
+  static void copy_stored_hash(node_impl_pointer,node_impl_pointer,mpl::false_)
+  {}
+
+  /* group size bookkeeping, a no-op unless stores_group_size: only first
+   * elements of groups keep their sizes, the rest being set to zero
+   */
+
+  static std::size_t group_size(node_impl_pointer x)
+  {
+    return group_size(x,stores_group_size());
+  }
+
+  static std::size_t group_size(node_impl_pointer x,mpl::true_)
+  {
+    return index_node_type::from_impl(x)->group_size();
+  }
+
+  static std::size_t group_size(node_impl_pointer,mpl::false_){return 0;}
+
+  static void set_group_size(node_impl_pointer x,std::size_t n)
+  {
+    set_group_size(x,n,stores_group_size());
+  }
+
+  static void set_group_size(node_impl_pointer x,std::size_t n,mpl::true_)
+  {
+    if(x!=node_impl_pointer(0))index_node_type::from_impl(x)->group_size()=n;
+  }
+
+  static void set_group_size(node_impl_pointer,std::size_t,mpl::false_){}
+
+  static void copy_group_size(node_impl_pointer org,node_impl_pointer cpy)
+  {
+    set_group_size(cpy,group_size(org));
+  }
+
+  /* element whose group size changes when x is unlinked, and its new value */
+
+  typedef std::pair<node_impl_pointer,std::size_t> group_size_update;
+
+  static group_size_update group_size_on_unlink(node_impl_pointer x)
+  {
+    return group_size_on_unlink(x,stores_group_size());
+  }
+
+  static group_size_update group_size_on_unlink(
+    node_impl_pointer x,mpl::true_)
+  {
+    std::size_t n=group_size(x);
+    if(n==1)return group_size_update(node_impl_pointer(0),0);
+    else if(n!=0){                              /* first of group, size>1 */
+      return group_size_update(node_impl_type::pointer_from(x->next()),n-1);
+    }
+    else{
+      node_impl_pointer first=first_of_group(x);
+      return group_size_update(first,group_size(first)-1);
+    }
+  }
+
+  static group_size_update group_size_on_unlink(node_impl_pointer,mpl::false_)
+  {
+    return group_size_update(node_impl_pointer(0),0);
+  }
+
+  /* First element of the group of x, x not being the first one. Cases
+   * follow those of node_alg::unlink; middle elements of groups of size>3
+   * take a walk to the last but one, which links back to the first.
+   */
+
+  static node_impl_pointer first_of_group(node_impl_pointer x)
+  {
+    if(x->prior()->next()==node_impl_type::base_pointer_from(x)){
+      if(group_size(x->prior())!=0)return x->prior();  /* last of size 2 */
+      while(node_impl_type::pointer_from(x->next())->prior()==x){
+        x=node_impl_type::pointer_from(x->next());
+      }
+      return node_impl_type::pointer_from(x->next());   /* x is n-1 */
+    }
+    else if(x->next()->prior()->prior()==x){  /* last of group and bucket */
+      return node_impl_type::pointer_from(x->prior()->next());
+    }
+    else{
+      node_impl_pointer first=
+        node_impl_type::pointer_from(x->prior()->prior()->next());
+      if(first->next()==node_impl_type::base_pointer_from(x)){
+        return first;                                  /* second of group */
+      }
+      return node_impl_type::pointer_from(x->prior()->next());      /* last */
+    }
+  }
+
+  /* In-place modification can split or merge groups of size<=2, which are
+   * linked as ungrouped elements: with stores_group_size, elements of those
+   * are relinked instead.
+   */
+
+  bool keeps_group_size(index_node_type* x)const
+  {
+    return keeps_group_size(x->impl(),stores_group_size());
+  }
+
+  bool keeps_group_size(node_impl_pointer x,mpl::true_)const
+  {
+    std::size_t n=group_size(x);
+    if(n==0)n=group_size(first_of_group(x));
+    return n>2;
+  }
+
+  bool keeps_group_size(node_impl_pointer,mpl::false_)const{return true;}
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  static bool check_stored_hash(const index_node_type* x,std::size_t h)
+  {
+    return check_stored_hash(x,h,stores_hash());
+  }
+
+  static bool check_stored_hash(
+    const index_node_type* x,std::size_t h,mpl::true_)
+  {
+    return x->stored_hash()==h;
+  }
+
+  static bool check_stored_hash(const index_node_type*,std::size_t,mpl::false_)
+  {
+    return true;
+  }
+#endif
+
+  bool in_place(
+    node_impl_pointer x,key_param_type k,std::size_t h,
+    node_impl_base_pointer buc)const
+  {
+    return in_place(x,k,h,buc,Category());
+  }
+
+  bool in_place(
+    node_impl_pointer x,key_param_type k,std::size_t h,
+    node_impl_base_pointer buc,hashed_unique_tag)const
+  {
+    bool found=false;
+    for(node_impl_pointer y=buc->prior();
+        y!=node_impl_pointer(0);y=node_alg::after_local(y)){
+      if(y==x)found=true;
+      else if(hash_match(y,h)&&
+              eq_(k,key(index_node_type::from_impl(y)->value())))return false;
+    }
+    return found;
+  }
+
+  bool in_place(
+    node_impl_pointer x,key_param_type k,std::size_t h,
+    node_impl_base_pointer buc,hashed_non_unique_tag)const
+  {
+    bool found=false;
+    int  range_size=0;
+    for(node_impl_pointer y=buc->prior();y!=node_impl_pointer(0);){
+      if(node_alg::is_first_of_group(y)){ /* group of 3 or more */
+        if(y==x){
+          /* in place <-> equal to some other member of the group */
+          node_impl_pointer yy=node_impl_type::pointer_from(y->next());
+          return
+            hash_match(yy,h)&&
+            eq_(k,key(index_node_type::from_impl(yy)->value()));
+        }
+        else{
+          node_impl_pointer z=
+            node_alg::after_local(y->next()->prior()); /* end of range */
+          if(hash_match(y,h)&&
+             eq_(k,key(index_node_type::from_impl(y)->value()))){
+            if(found)return false; /* x lies outside */
             do{
               if(y==x)return true;
               y=node_alg::after_local(y);
@@ -1537,7 +2656,8 @@ private:
           range_size=1;
           found=true;
         }
-        else if(eq_(k,key(index_node_type::from_impl(y)->value()))){
+        else if(hash_match(y,h)&&
+                eq_(k,key(index_node_type::from_impl(y)->value()))){
           if(range_size==0&&found)return false;
           if(range_size==1&&!found)return false;
           if(range_size==2)return false;
@@ -1585,6 +2705,37 @@ private:
     return make_iterator(p.first);
   }
 
+  template<BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
+  std::pair<iterator,bool> emplace_hashed_impl(
+    std::size_t h,BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
+  {
+    BOOST_MULTI_INDEX_HASHED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_emplace_variant_(
+      hashed_emplaced_tag<hashed_index>(h),
+      BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
+    return std::pair<iterator,bool>(make_iterator(p.first),p.second);
+  }
+
+  size_type erase_hashed(key_param_type k,std::size_t h)
+  {
+    for(node_impl_pointer x=bucket_of(h)->prior();
+        x!=node_impl_pointer(0);x=node_alg::next_to_inspect(x)){
+      if(hash_match(x,h)&&eq_(k,key(index_node_type::from_impl(x)->value()))){
+        node_impl_pointer y=end_of_range(x);
+        size_type         s=0;
+        do{
+          node_impl_pointer z=node_alg::after(x);
+          this->final_erase_(
+            static_cast<final_node_type*>(index_node_type::from_impl(x)));
+          x=z;
+          ++s;
+        }while(x!=y);
+        return s;
+      }
+    }
+    return 0;
+  }
+
   template<
     typename CompatibleHash,typename CompatiblePred
   >
@@ -1602,14 +2753,16 @@ private:
     const CompatibleKey& k,
     const CompatibleHash& hash,const CompatiblePred& eq,mpl::false_)const
   {
-    std::size_t buc=buckets.position(hash(k));
-    for(node_impl_pointer x=buckets.at(buc)->prior();
-        x!=node_impl_pointer(0);x=node_alg::next_to_inspect(x)){
-      if(eq(k,key(index_node_type::from_impl(x)->value()))){
-        return make_iterator(index_node_type::from_impl(x));
-      }
-    }
-    return end();
+    return find_hashed(k,hash(k),eq);
+  }
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  iterator find_hashed(
+    const CompatibleKey& k,std::size_t h,const CompatiblePred& eq)const
+  {
+    node_impl_pointer x=find_node(h,k,eq);
+    return x!=node_impl_pointer(0)?
+      make_iterator(index_node_type::from_impl(x)):end();
   }
 
   template<
@@ -1629,20 +2782,14 @@ private:
     const CompatibleKey& k,
     const CompatibleHash& hash,const CompatiblePred& eq,mpl::false_)const
   {
-    std::size_t buc=buckets.position(hash(k));
-    for(node_impl_pointer x=buckets.at(buc)->prior();
-        x!=node_impl_pointer(0);x=node_alg::next_to_inspect(x)){
-      if(eq(k,key(index_node_type::from_impl(x)->value()))){
-        size_type         res=0;
-        node_impl_pointer y=end_of_range(x);
-        do{
-          ++res;
-          x=node_alg::after(x);
-        }while(x!=y);
-        return res;
-      }
-    }
-    return 0;
+    return count_hashed(k,hash(k),eq);
+  }
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  size_type count_hashed(
+    const CompatibleKey& k,std::size_t h,const CompatiblePred& eq)const
+  {
+    return count_range(find_node(h,k,eq));
   }
 
   template<
@@ -1662,16 +2809,155 @@ private:
     const CompatibleKey& k,
     const CompatibleHash& hash,const CompatiblePred& eq,mpl::false_)const
   {
-    std::size_t buc=buckets.position(hash(k));
-    for(node_impl_pointer x=buckets.at(buc)->prior();
-        x!=node_impl_pointer(0);x=node_alg::next_to_inspect(x)){
-      if(eq(k,key(index_node_type::from_impl(x)->value()))){
-        return std::pair<iterator,iterator>(
-          make_iterator(index_node_type::from_impl(x)),
-          make_iterator(index_node_type::from_impl(end_of_range(x))));
+    return equal_range_hashed(k,hash(k),eq);
+  }
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  std::pair<iterator,iterator> equal_range_hashed(
+    const CompatibleKey& k,std::size_t h,const CompatiblePred& eq)const
+  {
+    node_impl_pointer x=find_node(h,k,eq);
+    if(x==node_impl_pointer(0)){
+      return std::pair<iterator,iterator>(end(),end());
+    }
+    return std::pair<iterator,iterator>(
+      make_iterator(index_node_type::from_impl(x)),
+      make_iterator(index_node_type::from_impl(end_of_range(x))));
+  }
+
+  /* first element equivalent to k, or null */
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  node_impl_pointer find_node(
+    std::size_t h,const CompatibleKey& k,const CompatiblePred& eq)const
+  {
+    if(frozen())return find_in_slot(*mph.find(h),h,k,eq);
+    return find_in_bucket(bucket_of(h)->prior(),h,k,eq);
+  }
+
+  /* same, given the first element of the bucket of k (the element in the
+   * slot for k if frozen)
+   */
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  node_impl_pointer find_from(
+    node_impl_pointer x,std::size_t h,
+    const CompatibleKey& k,const CompatiblePred& eq)const
+  {
+    if(frozen())return find_in_slot(x,h,k,eq);
+    return find_in_bucket(x,h,k,eq);
+  }
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  node_impl_pointer find_in_slot(
+    node_impl_pointer x,std::size_t h,
+    const CompatibleKey& k,const CompatiblePred& eq)const
+  {
+    if(x!=node_impl_pointer(0)&&hash_match(x,h)&&
+       eq(k,key(index_node_type::from_impl(x)->value()))){
+      return x;
+    }
+    return node_impl_pointer(0);
+  }
+
+  /* first element equivalent to k in the bucket whose first element is x,
+   * or null
+   */
+
+  template<typename CompatibleKey,typename CompatiblePred>
+  node_impl_pointer find_in_bucket(
+    node_impl_pointer x,std::size_t h,
+    const CompatibleKey& k,const CompatiblePred& eq)const
+  {
+    for(;x!=node_impl_pointer(0);x=node_alg::next_to_inspect(x)){
+      if(hash_match(x,h)&&eq(k,key(index_node_type::from_impl(x)->value()))){
+        break;
+      }
+    }
+    return x;
+  }
+
+  size_type count_range(node_impl_pointer x)const
+  {
+    if(x==node_impl_pointer(0))return 0;
+    return count_range(x,stores_group_size());
+  }
+
+  size_type count_range(node_impl_pointer x,mpl::true_)const
+  {
+    return static_cast<size_type>(index_node_type::from_impl(x)->group_size());
+  }
+
+  size_type count_range(node_impl_pointer x,mpl::false_)const
+  {
+    size_type         res=0;
+    node_impl_pointer y=end_of_range(x);
+    do{
+      ++res;
+      x=node_alg::after(x);
+    }while(x!=y);
+    return res;
+  }
+
+  BOOST_STATIC_CONSTANT(std::size_t,lookup_batch_size=16);
+
+  /* hashes up to lookup_batch_size keys starting at first, which is advanced
+   * past them, and stores the hashes and first elements of their buckets;
+   * buckets are prefetched in one pass and the elements in another, so that
+   * neither waits for the previous key's memory accesses
+   */
+
+  template<typename ForwardIterator,typename CompatibleHash>
+  std::size_t prefetch_batch(
+    ForwardIterator& first,ForwardIterator last,const CompatibleHash& hash,
+    std::size_t* hs,node_impl_pointer* xs)const
+  {
+    if(frozen())return prefetch_frozen_batch(first,last,hash,hs,xs);
+
+    node_impl_base_pointer bucs[lookup_batch_size];
+    std::size_t            n=0;
+    for(;n!=lookup_batch_size&&first!=last;++n,++first){
+      hs[n]=hash(*first);
+      bucs[n]=bucket_of(hs[n]);
+      prefetch(&*bucs[n]);
+    }
+    for(std::size_t i=0;i!=n;++i){
+      xs[i]=bucs[i]->prior();
+      if(xs[i]!=node_impl_pointer(0)){
+        prefetch(&*xs[i]);
+        prefetch(index_node_type::from_impl(xs[i]));
       }
     }
-    return std::pair<iterator,iterator>(end(),end());
+    return n;
+  }
+
+  /* same, going through the pilot and slot of each key in the perfect hash
+   * table
+   */
+
+  template<typename ForwardIterator,typename CompatibleHash>
+  std::size_t prefetch_frozen_batch(
+    ForwardIterator& first,ForwardIterator last,const CompatibleHash& hash,
+    std::size_t* hs,node_impl_pointer* xs)const
+  {
+    const node_impl_pointer* slots[lookup_batch_size];
+    std::size_t              n=0;
+    for(;n!=lookup_batch_size&&first!=last;++n,++first){
+      hs[n]=hash(*first);
+      mph.prefetch_pilot(hs[n]);
+    }
+    for(std::size_t i=0;i!=n;++i){
+      slots[i]=mph.find(hs[i]);
+      prefetch(slots[i]);
+    }
+    for(std::size_t i=0;i!=n;++i){
+      xs[i]=*slots[i];
+      if(xs[i]!=node_impl_pointer(0)){
+        prefetch(&*xs[i]);
+        prefetch(index_node_type::from_impl(xs[i]));
+      }
+    }
+    return n;
   }
 
   key_from_value               key;
@@ -1679,7 +2965,9 @@ private:
   key_equal                    eq_;
   bucket_array_type            buckets;
   float                        mlf;
+  float                        minlf; /* packed along with mlf */
   size_type                    max_load;
+  perfect_hash_table_type      mph;
       
 #if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)&&\
     BOOST_WORKAROUND(__MWERKS__,<=0x3003)
@@ -1691,22 +2979,26 @@ private:
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 bool operator==(
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& y)
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& y)
 {
   return x.equals(y);
 }
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 bool operator!=(
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& y)
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& y)
 {
   return !(x==y);
 }
@@ -1715,11 +3007,11 @@ bool operator!=(
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 void swap(
-  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
-  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& y)
+  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& y)
 {
   x.swap(y);
 }
@@ -1728,20 +3020,23 @@ void swap(
 
 /* hashed index specifiers */
 
-template<typename Arg1,typename Arg2,typename Arg3,typename Arg4>
+template<
+  typename Arg1,typename Arg2,typename Arg3,typename Arg4,typename Arg5
+>
 struct hashed_unique
 {
   typedef typename detail::hashed_index_args<
-    Arg1,Arg2,Arg3,Arg4>                           index_args;
+    Arg1,Arg2,Arg3,Arg4,Arg5>                      index_args;
   typedef typename index_args::tag_list_type::type tag_list_type;
   typedef typename index_args::key_from_value_type key_from_value_type;
   typedef typename index_args::hash_type           hash_type;
   typedef typename index_args::pred_type           pred_type;
+  typedef typename index_args::options_type        options_type;
 
   template<typename Super>
   struct node_class
   {
-    typedef detail::hashed_index_node<Super> type;
+    typedef detail::hashed_index_node<Super,options_type> type;
   };
 
   template<typename SuperMeta>
@@ -1749,24 +3044,27 @@ struct hashed_unique
   {
     typedef detail::hashed_index<
       key_from_value_type,hash_type,pred_type,
-      SuperMeta,tag_list_type,detail::hashed_unique_tag> type;
+      SuperMeta,tag_list_type,detail::hashed_unique_tag,options_type> type;
   };
 };
 
-template<typename Arg1,typename Arg2,typename Arg3,typename Arg4>
+template<
+  typename Arg1,typename Arg2,typename Arg3,typename Arg4,typename Arg5
+>
 struct hashed_non_unique
 {
   typedef typename detail::hashed_index_args<
-    Arg1,Arg2,Arg3,Arg4>                           index_args;
+    Arg1,Arg2,Arg3,Arg4,Arg5>                      index_args;
   typedef typename index_args::tag_list_type::type tag_list_type;
   typedef typename index_args::key_from_value_type key_from_value_type;
   typedef typename index_args::hash_type           hash_type;
   typedef typename index_args::pred_type           pred_type;
+  typedef typename index_args::options_type        options_type;
 
   template<typename Super>
   struct node_class
   {
-    typedef detail::hashed_index_node<Super> type;
+    typedef detail::hashed_index_node<Super,options_type> type;
   };
 
   template<typename SuperMeta>
@@ -1774,7 +3072,7 @@ struct hashed_non_unique
   {
     typedef detail::hashed_index<
       key_from_value_type,hash_type,pred_type,
-      SuperMeta,tag_list_type,detail::hashed_non_unique_tag> type;
+      SuperMeta,tag_list_type,detail::hashed_non_unique_tag,options_type> type;
   };
 };
 
@@ -1786,11 +3084,11 @@ struct hashed_non_unique
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 inline boost::mpl::true_* boost_foreach_is_noncopyable(
   boost::multi_index::detail::hashed_index<
-    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>*&,
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>*&,
   boost_foreach_argument_dependent_lookup_hack)
 {
   return 0;
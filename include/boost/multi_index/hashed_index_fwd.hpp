@@ -1,4 +1,4 @@
-/* Copyright 2003-2013 Joaquin M Lopez Munoz.
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
  * Distributed under the Boost Software License, Version 1.0.
  * (See accompanying file LICENSE_1_0.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt)
@@ -23,33 +23,39 @@ namespace detail{
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 class hashed_index;
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 bool operator==(
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& y);
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& y);
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 bool operator!=(
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
-  const hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& y);
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+  const hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& y);
 
 template<
   typename KeyFromValue,typename Hash,typename Pred,
-  typename SuperMeta,typename TagList,typename Category
+  typename SuperMeta,typename TagList,typename Category,typename Options
 >
 void swap(
-  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& x,
-  hashed_index<KeyFromValue,Hash,Pred,SuperMeta,TagList,Category>& y);
+  hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+  hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& y);
 
 } /* namespace multi_index::detail */
 
@@ -57,13 +63,13 @@ void swap(
 
 template<
   typename Arg1,typename Arg2=mpl::na,
-  typename Arg3=mpl::na,typename Arg4=mpl::na
+  typename Arg3=mpl::na,typename Arg4=mpl::na,typename Arg5=mpl::na
 >
 struct hashed_unique;
 
 template<
   typename Arg1,typename Arg2=mpl::na,
-  typename Arg3=mpl::na,typename Arg4=mpl::na
+  typename Arg3=mpl::na,typename Arg4=mpl::na,typename Arg5=mpl::na
 >
 struct hashed_non_unique;
 
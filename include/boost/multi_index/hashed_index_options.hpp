@@ -0,0 +1,194 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_HASHED_INDEX_OPTIONS_HPP
+#define BOOST_MULTI_INDEX_HASHED_INDEX_OPTIONS_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/mpl/aux_/na.hpp>
+#include <boost/mpl/fold.hpp>
+#include <boost/mpl/placeholders.hpp>
+#include <boost/mpl/vector.hpp>
+#include <boost/preprocessor/facilities/intercept.hpp>
+#include <boost/preprocessor/repetition/enum_binary_params.hpp>
+#include <boost/preprocessor/repetition/enum_params.hpp>
+#include <boost/type_traits/is_base_and_derived.hpp>
+
+/* Options modifying the internal layout and algorithms of hashed indices.
+ * An option is a class with a nested template pack<Base> whose ::type
+ * derives from Base and overrides some of the traits defined in
+ * detail::default_hashed_index_options. hashed_index_options<...>
+ * bundles several options into one, with later options taking precedence.
+ */
+
+/* This user_definable macro limits the number of options in a
+ * hashed_index_options bundle.
+ */
+
+#if !defined(BOOST_MULTI_INDEX_LIMIT_HASHED_INDEX_OPTIONS_SIZE)
+#define BOOST_MULTI_INDEX_LIMIT_HASHED_INDEX_OPTIONS_SIZE 5
+#endif
+
+#if BOOST_MULTI_INDEX_LIMIT_HASHED_INDEX_OPTIONS_SIZE<\
+    BOOST_MPL_LIMIT_VECTOR_SIZE
+#define BOOST_MULTI_INDEX_HASHED_INDEX_OPTIONS_SIZE \
+  BOOST_MULTI_INDEX_LIMIT_HASHED_INDEX_OPTIONS_SIZE
+#else
+#define BOOST_MULTI_INDEX_HASHED_INDEX_OPTIONS_SIZE BOOST_MPL_LIMIT_VECTOR_SIZE
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+struct hashed_index_option_marker{};
+
+template<typename T>
+struct is_hashed_index_option
+{
+  BOOST_STATIC_CONSTANT(
+    bool,value=(is_base_and_derived<hashed_index_option_marker,T>::value));
+};
+
+struct default_hashed_index_options
+{
+  typedef default_hashed_index_options type;
+
+  BOOST_STATIC_CONSTANT(bool,stores_hash=false);
+  BOOST_STATIC_CONSTANT(bool,pow2_buckets=false);
+  BOOST_STATIC_CONSTANT(bool,rehashes_incrementally=false);
+  BOOST_STATIC_CONSTANT(bool,stores_group_size=false);
+};
+
+template<typename Option,typename Base>
+struct pack_hashed_index_option
+{
+  typedef typename Option::template pack<Base>::type type;
+};
+
+/* Resolves the user-supplied option (possibly mpl::na) into the traits
+ * class actually consumed by hashed_index and hashed_index_node.
+ */
+
+template<typename Option>
+struct hashed_index_options_traits:
+  pack_hashed_index_option<Option,default_hashed_index_options>
+{};
+
+template<>
+struct hashed_index_options_traits<mpl::na>
+{
+  typedef default_hashed_index_options type;
+};
+
+} /* namespace multi_index::detail */
+
+/* store_hash: each node keeps the hash value of its key, so that rehashing
+ * does not invoke the hash function and lookups only call the equality
+ * predicate on elements whose stored hash matches that of the key.
+ */
+
+template<bool Enabled=true>
+struct store_hash:private detail::hashed_index_option_marker
+{
+  template<typename Base>
+  struct pack:Base
+  {
+    typedef pack type;
+
+    BOOST_STATIC_CONSTANT(bool,stores_hash=Enabled);
+  };
+};
+
+/* power_2_buckets: bucket counts are powers of two and hash values are
+ * mapped to buckets by multiplicative (Fibonacci) hashing instead of
+ * taking the modulo of a prime number.
+ */
+
+template<bool Enabled=true>
+struct power_2_buckets:private detail::hashed_index_option_marker
+{
+  template<typename Base>
+  struct pack:Base
+  {
+    typedef pack type;
+
+    BOOST_STATIC_CONSTANT(bool,pow2_buckets=Enabled);
+  };
+};
+
+/* incremental_rehash: when the maximum load is exceeded, elements are moved
+ * to the new bucket array a few buckets at a time by subsequent insertions
+ * rather than all at once. Migration relies on stored hash values, so this
+ * option implies store_hash.
+ */
+
+template<bool Enabled=true>
+struct incremental_rehash:private detail::hashed_index_option_marker
+{
+  template<typename Base>
+  struct pack:Base
+  {
+    typedef pack type;
+
+    BOOST_STATIC_CONSTANT(bool,stores_hash=(Enabled||Base::stores_hash));
+    BOOST_STATIC_CONSTANT(bool,rehashes_incrementally=Enabled);
+  };
+};
+
+/* store_group_size: the first node of each group of equivalent elements in
+ * a hashed_non_unique index keeps the size of the group, so that count is
+ * constant time.
+ */
+
+template<bool Enabled=true>
+struct store_group_size:private detail::hashed_index_option_marker
+{
+  template<typename Base>
+  struct pack:Base
+  {
+    typedef pack type;
+
+    BOOST_STATIC_CONSTANT(bool,stores_group_size=Enabled);
+  };
+};
+
+template<
+  BOOST_PP_ENUM_BINARY_PARAMS(
+    BOOST_MULTI_INDEX_HASHED_INDEX_OPTIONS_SIZE,
+    typename Option,
+    =mpl::na BOOST_PP_INTERCEPT)
+>
+struct hashed_index_options:private detail::hashed_index_option_marker
+{
+  template<typename Base>
+  struct pack
+  {
+    typedef typename mpl::fold<
+      mpl::vector<
+        BOOST_PP_ENUM_PARAMS(BOOST_MULTI_INDEX_HASHED_INDEX_OPTIONS_SIZE,Option)
+      >,
+      Base,
+      detail::pack_hashed_index_option<mpl::_2,mpl::_1>
+    >::type type;
+  };
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#undef BOOST_MULTI_INDEX_HASHED_INDEX_OPTIONS_SIZE
+
+#endif
@@ -0,0 +1,136 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_HASHED_INDEX_PARALLEL_REHASH_HPP
+#define BOOST_MULTI_INDEX_HASHED_INDEX_PARALLEL_REHASH_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/detail/auto_space.hpp>
+#include <boost/multi_index/detail/parallel_run.hpp>
+#include <boost/multi_index/detail/raw_ptr.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index_container_fwd.hpp>
+#include <cstddef>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* Threaded part of parallel_rehash, kept apart so that
+ * <thread> is only brought in by the translation units using it.
+ */
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList,typename Category,typename Options
+>
+void hashed_index<
+  KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>::
+unchecked_parallel_rehash(size_type n,std::size_t num_threads)
+{
+  if(num_threads==0)num_threads=parallel_run_concurrency();
+  if(num_threads>size()/parallel_rehash_grain){
+    num_threads=size()/parallel_rehash_grain;
+  }
+  if(num_threads<=1){
+    unchecked_rehash(n);
+    return;
+  }
+
+  node_impl_type    cpy_end_node;
+  node_impl_pointer cpy_end=node_impl_pointer(&cpy_end_node);
+  bucket_array_type buckets_cpy(get_allocator(),cpy_end,n);
+  auto_space<
+    node_impl_type,allocator_type> ends(get_allocator(),num_threads);
+  node_impl_pointer              ends_=
+    node_impl_pointer(raw_ptr<node_impl_type*>(ends.data()));
+  rehash_unit_table              units(num_threads*num_threads);
+  parallel_run(
+    num_threads,rehash_filer(*this,buckets_cpy,num_threads,units));
+
+  /* Linking does not throw: should parallel_run fail at all, it does so
+   * before invoking rehash_linker.
+   */
+
+  parallel_run(
+    num_threads,rehash_linker(buckets_cpy,num_threads,units,ends_));
+
+  node_impl_pointer last=cpy_end;
+  for(std::size_t t=0;t<num_threads;++t){
+    node_impl_pointer end_=ends_+t;
+    if(end_->prior()!=end_){
+      last->next()=end_->next();
+      end_->next()->prior()->prior()=last;
+      last=end_->prior();
+    }
+  }
+  last->next()=buckets_cpy.end();
+  cpy_end->prior()=last;
+  commit_rehash(cpy_end,buckets_cpy);
+}
+
+class hashed_index_parallel_rehash_access
+{
+public:
+  template<
+    typename KeyFromValue,typename Hash,typename Pred,
+    typename SuperMeta,typename TagList,typename Category,typename Options
+  >
+  static void parallel_rehash(
+    hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+    typename hashed_index<
+      KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>::size_type n,
+    std::size_t num_threads)
+  {
+    x.parallel_rehash_(n,num_threads);
+  }
+};
+
+} /* namespace multi_index::detail */
+
+/* parallel rehashing */
+
+template<
+  typename KeyFromValue,typename Hash,typename Pred,
+  typename SuperMeta,typename TagList,typename Category,typename Options
+>
+void parallel_rehash(
+  detail::hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>& x,
+  typename detail::hashed_index<
+    KeyFromValue,Hash,Pred,SuperMeta,TagList,Category,Options>::size_type n,
+  std::size_t num_threads=0)
+{
+  detail::hashed_index_parallel_rehash_access::parallel_rehash(
+    x,n,num_threads);
+}
+
+/* acts on index #0, as the hashed index members of the container do */
+
+template<typename Value,typename IndexSpecifierList,typename Allocator>
+void parallel_rehash(
+  multi_index_container<Value,IndexSpecifierList,Allocator>& m,
+  typename multi_index_container<
+    Value,IndexSpecifierList,Allocator>::size_type n,
+  std::size_t num_threads=0)
+{
+  parallel_rehash(m.template get<0>(),n,num_threads);
+}
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
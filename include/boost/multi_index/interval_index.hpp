@@ -0,0 +1,135 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_INTERVAL_INDEX_HPP
+#define BOOST_MULTI_INDEX_INTERVAL_INDEX_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/multi_index/augmented_index.hpp>
+#include <boost/multi_index/detail/itv_index_ops.hpp>
+#include <boost/multi_index/interval_index_fwd.hpp>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* interval_ordered_index sorts the elements by start point and keeps the
+ * maximum end point of every subtree, which allows for enumerating the
+ * elements overlapping a given interval while skipping the subtrees that
+ * cannot contain any.
+ */
+
+template<typename OrderedIndexImpl>
+class interval_ordered_index:public OrderedIndexImpl
+{
+  typedef          OrderedIndexImpl             super;
+
+protected:
+  typedef typename super::index_node_type       index_node_type;
+  typedef typename super::node_impl_pointer     node_impl_pointer;
+
+public:
+  typedef typename super::ctor_args_list        ctor_args_list;
+  typedef typename super::allocator_type        allocator_type;
+  typedef typename super::key_type              key_type;
+  typedef typename super::key_from_value        key_from_value;
+  typedef typename super::key_compare           key_compare;
+
+private:
+  typedef interval_overlap_query<
+    index_node_type,key_from_value,key_compare,key_type> query_type;
+
+public:
+  typedef interval_overlap_iterator<
+    index_node_type,query_type>                 overlap_iterator;
+
+  /* interval queries */
+
+  std::pair<overlap_iterator,overlap_iterator>
+  overlapping(const key_type& a,const key_type& b)const
+  {
+    query_type q(this->header(),this->key,this->comp_,a,b);
+    return std::pair<overlap_iterator,overlap_iterator>(
+      overlap_iterator(q.first(),q),overlap_iterator(this->header(),q));
+  }
+
+  std::pair<overlap_iterator,overlap_iterator>
+  stabbing(const key_type& x)const
+  {
+    return overlapping(x,x);
+  }
+
+protected:
+  interval_ordered_index(const interval_ordered_index& x):super(x){};
+
+  interval_ordered_index(
+    const interval_ordered_index& x,do_not_copy_elements_tag):
+    super(x,do_not_copy_elements_tag()){};
+
+  interval_ordered_index(
+    const ctor_args_list& args_list,const allocator_type& al):
+    super(args_list,al){}
+};
+
+/* augmenting policy for ordered_index */
+
+template<typename EndKeyFromValue,typename Compare>
+struct interval_policy:
+  summary_policy<interval_max_end<EndKeyFromValue,Compare> >
+{
+  template<typename OrderedIndexImpl>
+  struct augmented_interface
+  {
+    typedef interval_ordered_index<OrderedIndexImpl> type;
+  };
+};
+
+} /* namespace multi_index::detail */
+
+/* interval_index specifier */
+
+template<typename Arg1,typename Arg2,typename Arg3,typename Arg4>
+struct interval_index
+{
+  typedef typename detail::interval_index_args<
+    Arg1,Arg2,Arg3,Arg4>                               index_args;
+  typedef typename index_args::tag_list_type::type     tag_list_type;
+  typedef typename index_args::key_from_value_type     key_from_value_type;
+  typedef typename index_args::end_key_from_value_type end_key_from_value_type;
+  typedef typename index_args::compare_type            compare_type;
+  typedef detail::interval_policy<
+    end_key_from_value_type,compare_type>              augment_policy;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_index_node<augment_policy,Super> type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type,detail::ordered_non_unique_tag,
+      augment_policy>                                  type;
+  };
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
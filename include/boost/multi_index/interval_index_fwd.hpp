@@ -0,0 +1,34 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_INTERVAL_INDEX_FWD_HPP
+#define BOOST_MULTI_INDEX_INTERVAL_INDEX_FWD_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/multi_index/detail/itv_index_args.hpp>
+#include <boost/multi_index/detail/ord_index_impl_fwd.hpp>
+
+namespace boost{
+
+namespace multi_index{
+
+/* interval_index specifier */
+
+template<
+  typename Arg1,typename Arg2,typename Arg3=mpl::na,typename Arg4=mpl::na
+>
+struct interval_index;
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,1373 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_ORDERED_GROUPED_INDEX_HPP
+#define BOOST_MULTI_INDEX_ORDERED_GROUPED_INDEX_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/call_traits.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/core/no_exceptions_support.hpp>
+#include <boost/detail/workaround.hpp>
+#include <boost/foreach_fwd.hpp>
+#include <boost/iterator/reverse_iterator.hpp>
+#include <boost/move/core.hpp>
+#include <boost/move/utility_core.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/mpl/push_front.hpp>
+#include <boost/multi_index/detail/access_specifier.hpp>
+#include <boost/multi_index/detail/adl_swap.hpp>
+#include <boost/multi_index/detail/allocator_traits.hpp>
+#include <boost/multi_index/detail/bidir_node_iterator.hpp>
+#include <boost/multi_index/detail/do_not_copy_elements_tag.hpp>
+#include <boost/multi_index/detail/index_node_base.hpp>
+#include <boost/multi_index/detail/modify_key_adaptor.hpp>
+#include <boost/multi_index/detail/node_handle.hpp>
+#include <boost/multi_index/detail/ord_grouped_index_node.hpp>
+#include <boost/multi_index/detail/ord_grouped_index_ops.hpp>
+#include <boost/multi_index/detail/ord_grouped_index_tree.hpp>
+#include <boost/multi_index/detail/ord_index_args.hpp>
+#include <boost/multi_index/detail/safe_mode.hpp>
+#include <boost/multi_index/detail/scope_guard.hpp>
+#include <boost/multi_index/detail/unbounded.hpp>
+#include <boost/multi_index/detail/value_compare.hpp>
+#include <boost/multi_index/detail/vartempl_support.hpp>
+#include <boost/multi_index/ordered_grouped_index_fwd.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <cstddef>
+#include <utility>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
+#include <boost/archive/archive_exception.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/multi_index/detail/duplicates_iterator.hpp>
+#include <boost/throw_exception.hpp>
+#endif
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+#define BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT_OF(x)              \
+  detail::scope_guard BOOST_JOIN(check_invariant_,__LINE__)=                 \
+    detail::make_obj_guard(x,&ordered_grouped_index::check_invariant_);        \
+  BOOST_JOIN(check_invariant_,__LINE__).touch();
+#define BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT                    \
+  BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT_OF(*this)
+#else
+#define BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT_OF(x)
+#define BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT
+#endif
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* ordered_grouped_index adds a layer of non-unique ordered indexing to a
+ * given Super, with a red-black tree node per group of equivalent elements
+ * as described in ord_grouped_index_node.hpp, so that insertion, erasure
+ * and lookup depend on the number of distinct keys rather than on the
+ * number of elements. The interface is that of ordered_index.
+ */
+
+template<
+  typename KeyFromValue,typename Compare,
+  typename SuperMeta,typename TagList
+>
+class ordered_grouped_index:
+  BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS SuperMeta::type
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  ,public safe_mode::safe_container<
+    ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList> >
+#endif
+
+{
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)&&\
+    BOOST_WORKAROUND(__MWERKS__,<=0x3003)
+/* The "ISO C++ Template Parser" option in CW8.3 has a problem with the
+ * lifetime of const references bound to temporaries --precisely what
+ * scopeguards are.
+ */
+
+#pragma parse_mfunc_templ off
+#endif
+
+  typedef typename SuperMeta::type                   super;
+
+protected:
+  typedef ordered_grouped_index_node<
+    typename super::index_node_type>                 index_node_type;
+
+private:
+  typedef typename index_node_type::impl_type        node_impl_type;
+  typedef typename node_impl_type::pointer           node_impl_pointer;
+
+public:
+  /* types */
+
+  typedef typename KeyFromValue::result_type         key_type;
+  typedef typename index_node_type::value_type       value_type;
+  typedef KeyFromValue                               key_from_value;
+  typedef Compare                                    key_compare;
+  typedef value_comparison<
+    value_type,KeyFromValue,Compare>                 value_compare;
+  typedef tuple<key_from_value,key_compare>          ctor_args;
+  typedef typename super::final_allocator_type       allocator_type;
+  typedef value_type&                                reference;
+  typedef const value_type&                          const_reference;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  typedef safe_mode::safe_iterator<
+    bidir_node_iterator<index_node_type>,
+    ordered_grouped_index>                           iterator;
+#else
+  typedef bidir_node_iterator<index_node_type>       iterator;
+#endif
+
+  typedef iterator                                   const_iterator;
+
+private:
+  typedef allocator_traits<allocator_type>           alloc_traits;
+  typedef ordered_grouped_index_tree<
+    index_node_type,allocator_type>                  tree_type;
+  typedef typename tree_type::group_type             group_type;
+  typedef typename tree_type::group_pointer          group_pointer;
+
+public:
+  typedef typename alloc_traits::size_type           size_type;
+  typedef typename alloc_traits::difference_type     difference_type;
+  typedef typename alloc_traits::pointer             pointer;
+  typedef typename alloc_traits::const_pointer       const_pointer;
+  typedef typename
+    boost::reverse_iterator<iterator>                reverse_iterator;
+  typedef typename
+    boost::reverse_iterator<const_iterator>          const_reverse_iterator;
+  typedef typename super::final_node_handle_type     node_type;
+  typedef detail::insert_return_type<
+    iterator,node_type>                              insert_return_type;
+  typedef TagList                                    tag_list;
+
+protected:
+  typedef typename super::final_node_type            final_node_type;
+  typedef tuples::cons<
+    ctor_args,
+    typename super::ctor_args_list>                  ctor_args_list;
+  typedef typename mpl::push_front<
+    typename super::index_type_list,
+    ordered_grouped_index>::type                     index_type_list;
+  typedef typename mpl::push_front<
+    typename super::iterator_type_list,
+    iterator>::type                                  iterator_type_list;
+  typedef typename mpl::push_front<
+    typename super::const_iterator_type_list,
+    const_iterator>::type                            const_iterator_type_list;
+  typedef typename super::copy_map_type              copy_map_type;
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
+  typedef typename super::index_saver_type           index_saver_type;
+  typedef typename super::index_loader_type          index_loader_type;
+#endif
+
+private:
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  typedef safe_mode::safe_container<
+    ordered_grouped_index>                           safe_super;
+#endif
+
+  typedef typename call_traits<
+    value_type>::param_type                          value_param_type;
+  typedef typename call_traits<
+    key_type>::param_type                            key_param_type;
+
+  /* Needed to avoid commas in BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL
+   * expansion.
+   */
+
+  typedef std::pair<iterator,bool>                   emplace_return_type;
+
+public:
+
+  /* construct/copy/destroy
+   * Default and copy ctors are in the protected section as indices are
+   * not supposed to be created on their own. No range ctor either.
+   */
+
+  ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>&
+  operator=(
+    const ordered_grouped_index<
+      KeyFromValue,Compare,SuperMeta,TagList>& x)
+  {
+    this->final()=x.final();
+    return *this;
+  }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+  ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>&
+  operator=(std::initializer_list<value_type> list)
+  {
+    this->final()=list;
+    return *this;
+  }
+#endif
+
+  allocator_type get_allocator()const BOOST_NOEXCEPT
+  {
+    return this->final().get_allocator();
+  }
+
+  /* iterators */
+
+  iterator
+    begin()BOOST_NOEXCEPT{return make_iterator(leftmost());}
+  const_iterator
+    begin()const BOOST_NOEXCEPT{return make_iterator(leftmost());}
+  iterator
+    end()BOOST_NOEXCEPT{return make_iterator(header());}
+  const_iterator
+    end()const BOOST_NOEXCEPT{return make_iterator(header());}
+  reverse_iterator
+    rbegin()BOOST_NOEXCEPT{return boost::make_reverse_iterator(end());}
+  const_reverse_iterator
+    rbegin()const BOOST_NOEXCEPT{return boost::make_reverse_iterator(end());}
+  reverse_iterator
+    rend()BOOST_NOEXCEPT{return boost::make_reverse_iterator(begin());}
+  const_reverse_iterator
+    rend()const BOOST_NOEXCEPT{return boost::make_reverse_iterator(begin());}
+  const_iterator
+    cbegin()const BOOST_NOEXCEPT{return begin();}
+  const_iterator
+    cend()const BOOST_NOEXCEPT{return end();}
+  const_reverse_iterator
+    crbegin()const BOOST_NOEXCEPT{return rbegin();}
+  const_reverse_iterator
+    crend()const BOOST_NOEXCEPT{return rend();}
+
+  iterator iterator_to(const value_type& x)
+  {
+    return make_iterator(
+      node_from_value<index_node_type>(boost::addressof(x)));
+  }
+
+  const_iterator iterator_to(const value_type& x)const
+  {
+    return make_iterator(
+      node_from_value<index_node_type>(boost::addressof(x)));
+  }
+
+  /* capacity */
+
+  bool      empty()const BOOST_NOEXCEPT{return this->final_empty_();}
+  size_type size()const BOOST_NOEXCEPT{return this->final_size_();}
+  size_type max_size()const BOOST_NOEXCEPT{return this->final_max_size_();}
+
+  /* modifiers */
+
+  BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL(
+    emplace_return_type,emplace,emplace_impl)
+
+  BOOST_MULTI_INDEX_OVERLOADS_TO_VARTEMPL_EXTRA_ARG(
+    iterator,emplace_hint,emplace_hint_impl,iterator,position)
+
+  std::pair<iterator,bool> insert(const value_type& x)
+  {
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_(x);
+    return std::pair<iterator,bool>(make_iterator(p.first),p.second);
+  }
+
+  std::pair<iterator,bool> insert(BOOST_RV_REF(value_type) x)
+  {
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_rv_(x);
+    return std::pair<iterator,bool>(make_iterator(p.first),p.second);
+  }
+
+  iterator insert(iterator position,const value_type& x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_(
+      x,static_cast<final_node_type*>(position.get_node()));
+    return make_iterator(p.first);
+  }
+
+  iterator insert(iterator position,BOOST_RV_REF(value_type) x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_rv_(
+      x,static_cast<final_node_type*>(position.get_node()));
+    return make_iterator(p.first);
+  }
+
+  template<typename InputIterator>
+  void insert(InputIterator first,InputIterator last)
+  {
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    index_node_type* hint=header(); /* end() */
+    for(;first!=last;++first){
+      hint=this->final_insert_ref_(
+        *first,static_cast<final_node_type*>(hint)).first;
+      index_node_type::increment(hint);
+    }
+  }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+  void insert(std::initializer_list<value_type> list)
+  {
+    insert(list.begin(),list.end());
+  }
+#endif
+
+  insert_return_type insert(BOOST_RV_REF(node_type) nh)
+  {
+    if(nh)BOOST_MULTI_INDEX_CHECK_EQUAL_ALLOCATORS(*this,nh);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_nh_(nh);
+    return insert_return_type(make_iterator(p.first),p.second,boost::move(nh));
+  }
+
+  iterator insert(const_iterator position,BOOST_RV_REF(node_type) nh)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    if(nh)BOOST_MULTI_INDEX_CHECK_EQUAL_ALLOCATORS(*this,nh);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool> p=this->final_insert_nh_(
+      nh,static_cast<final_node_type*>(position.get_node()));
+    return make_iterator(p.first);
+  }
+
+  node_type extract(const_iterator position)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    return this->final_extract_(
+      static_cast<final_node_type*>(position.get_node()));
+  }
+
+  node_type extract(key_param_type x)
+  {
+    iterator position=lower_bound(x);
+    if(position==end()||comp_(x,key(*position)))return node_type();
+    else return extract(position);
+  }
+
+  iterator erase(iterator position)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    this->final_erase_(static_cast<final_node_type*>(position++.get_node()));
+    return position;
+  }
+
+  size_type erase(key_param_type x)
+  {
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<iterator,iterator> p=equal_range(x);
+    size_type s=0;
+    while(p.first!=p.second){
+      p.first=erase(p.first);
+      ++s;
+    }
+    return s;
+  }
+
+  iterator erase(iterator first,iterator last)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(first);
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(last);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(first,*this);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(last,*this);
+    BOOST_MULTI_INDEX_CHECK_VALID_RANGE(first,last);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    while(first!=last){
+      first=erase(first);
+    }
+    return first;
+  }
+
+  bool replace(iterator position,const value_type& x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    return this->final_replace_(
+      x,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  bool replace(iterator position,BOOST_RV_REF(value_type) x)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    return this->final_replace_rv_(
+      x,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  template<typename Modifier>
+  bool modify(iterator position,Modifier mod)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    /* MSVC++ 6.0 optimizer on safe mode code chokes if this
+     * this is not added. Left it for all compilers as it does no
+     * harm.
+     */
+
+    position.detach();
+#endif
+
+    return this->final_modify_(
+      mod,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  template<typename Modifier,typename Rollback>
+  bool modify(iterator position,Modifier mod,Rollback back_)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    /* MSVC++ 6.0 optimizer on safe mode code chokes if this
+     * this is not added. Left it for all compilers as it does no
+     * harm.
+     */
+
+    position.detach();
+#endif
+
+    return this->final_modify_(
+      mod,back_,static_cast<final_node_type*>(position.get_node()));
+  }
+
+  template<typename Modifier>
+  bool modify_key(iterator position,Modifier mod)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    return modify(
+      position,modify_key_adaptor<Modifier,value_type,KeyFromValue>(mod,key));
+  }
+
+  template<typename Modifier,typename Rollback>
+  bool modify_key(iterator position,Modifier mod,Rollback back_)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_DEREFERENCEABLE_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    return modify(
+      position,
+      modify_key_adaptor<Modifier,value_type,KeyFromValue>(mod,key),
+      modify_key_adaptor<Rollback,value_type,KeyFromValue>(back_,key));
+  }
+
+  void swap(
+    ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& x)
+  {
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT_OF(x);
+    this->final_swap_(x.final());
+  }
+
+  void clear()BOOST_NOEXCEPT
+  {
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    this->final_clear_();
+  }
+
+  /* observers */
+
+  key_from_value key_extractor()const{return key;}
+  key_compare    key_comp()const{return comp_;}
+  value_compare  value_comp()const{return value_compare(key,comp_);}
+
+  /* set operations */
+
+  /* Internally, these ops rely on const_iterator being the same
+   * type as iterator.
+   */
+
+  template<typename CompatibleKey>
+  iterator find(const CompatibleKey& x)const
+  {
+    return make_iterator(
+      first_of(ordered_grouped_index_find(tree,key,x,comp_)));
+  }
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  iterator find(
+    const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    return make_iterator(
+      first_of(ordered_grouped_index_find(tree,key,x,comp)));
+  }
+
+  template<typename CompatibleKey>
+  size_type count(const CompatibleKey& x)const
+  {
+    return count(x,comp_);
+  }
+
+  /* groups record their size, so count does not walk the elements and,
+   * for the comparison of the index, looks up a single group
+   */
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  size_type count(const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    std::pair<group_pointer,group_pointer> p=
+      ordered_grouped_index_equal_range(tree,key,x,comp);
+    size_type n=0;
+    for(;p.first!=p.second;group_type::increment(p.first)){
+      n+=static_cast<size_type>(p.first->size());
+    }
+    return n;
+  }
+
+  template<typename CompatibleKey>
+  iterator lower_bound(const CompatibleKey& x)const
+  {
+    return make_iterator(
+      first_of(ordered_grouped_index_lower_bound(tree,key,x,comp_)));
+  }
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  iterator lower_bound(
+    const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    return make_iterator(
+      first_of(ordered_grouped_index_lower_bound(tree,key,x,comp)));
+  }
+
+  template<typename CompatibleKey>
+  iterator upper_bound(const CompatibleKey& x)const
+  {
+    return make_iterator(
+      first_of(ordered_grouped_index_upper_bound(tree,key,x,comp_)));
+  }
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  iterator upper_bound(
+    const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    return make_iterator(
+      first_of(ordered_grouped_index_upper_bound(tree,key,x,comp)));
+  }
+
+  template<typename CompatibleKey>
+  std::pair<iterator,iterator> equal_range(
+    const CompatibleKey& x)const
+  {
+    return equal_range(x,comp_);
+  }
+
+  template<typename CompatibleKey,typename CompatibleCompare>
+  std::pair<iterator,iterator> equal_range(
+    const CompatibleKey& x,const CompatibleCompare& comp)const
+  {
+    std::pair<group_pointer,group_pointer> p=
+      ordered_grouped_index_equal_range(tree,key,x,comp);
+    return std::pair<iterator,iterator>(
+      make_iterator(first_of(p.first)),make_iterator(first_of(p.second)));
+  }
+
+  /* range */
+
+  template<typename LowerBounder,typename UpperBounder>
+  std::pair<iterator,iterator>
+  range(LowerBounder lower,UpperBounder upper)const
+  {
+    typedef typename mpl::if_<
+      is_same<LowerBounder,unbounded_type>,
+      BOOST_DEDUCED_TYPENAME mpl::if_<
+        is_same<UpperBounder,unbounded_type>,
+        both_unbounded_tag,
+        lower_unbounded_tag
+      >::type,
+      BOOST_DEDUCED_TYPENAME mpl::if_<
+        is_same<UpperBounder,unbounded_type>,
+        upper_unbounded_tag,
+        none_unbounded_tag
+      >::type
+    >::type dispatch;
+
+    return range(lower,upper,dispatch());
+  }
+
+BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
+  ordered_grouped_index(
+    const ctor_args_list& args_list,const allocator_type& al):
+    super(args_list.get_tail(),al),
+    key(tuples::get<0>(args_list.get_head())),
+    comp_(tuples::get<1>(args_list.get_head())),
+    tree(al)
+  {
+    empty_initialize();
+  }
+
+  ordered_grouped_index(
+    const ordered_grouped_index<
+      KeyFromValue,Compare,SuperMeta,TagList>& x):
+    super(x),
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super(),
+#endif
+
+    key(x.key),
+    comp_(x.comp_),
+    tree(x.get_allocator())
+  {
+    /* Copy ctor just takes the key and compare objects from x. The rest is
+     * done in a subsequent call to copy_().
+     */
+  }
+
+  ordered_grouped_index(
+     const ordered_grouped_index<
+       KeyFromValue,Compare,SuperMeta,TagList>& x,
+     do_not_copy_elements_tag):
+    super(x,do_not_copy_elements_tag()),
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super(),
+#endif
+
+    key(x.key),
+    comp_(x.comp_),
+    tree(x.get_allocator())
+  {
+    empty_initialize();
+  }
+
+  ~ordered_grouped_index()
+  {
+    /* the container is guaranteed to be empty by now */
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  iterator       make_iterator(index_node_type* node)
+    {return iterator(node,this);}
+  const_iterator make_iterator(index_node_type* node)const
+    {return const_iterator(node,const_cast<ordered_grouped_index*>(this));}
+#else
+  iterator       make_iterator(index_node_type* node){return iterator(node);}
+  const_iterator make_iterator(index_node_type* node)const
+                   {return const_iterator(node);}
+#endif
+
+  void copy_(
+    const ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& x,
+    const copy_map_type& map)
+  {
+    empty_initialize();
+
+    std::size_t n=0;
+    for(group_pointer org=x.tree.leftmost();org!=x.tree.header();
+        group_type::increment(org),++n){
+      group_pointer g=tree.push_back(
+        map_node(map,org->first()),map_node(map,org->last()),org->size());
+      for(node_impl_pointer y=org->first();;y=y->next()){
+        node_impl_pointer cpy=map_node(map,y);
+        node_impl_type::link(cpy,header()->impl());
+        cpy->group()=g;
+        if(y==org->last())break;
+      }
+    }
+    tree.build(n);
+
+    super::copy_(x,map);
+  }
+
+  template<typename Variant>
+  final_node_type* insert_(
+    value_param_type v,final_node_type*& x,Variant variant)
+  {
+    link_info inf;
+    link_point(key(v),inf);
+    if(inf.group==group_pointer(0))tree.reserve();
+    final_node_type* res=super::insert_(v,x,variant);
+    if(res==x)link(static_cast<index_node_type*>(x),inf);
+    return res;
+  }
+
+  template<typename Variant>
+  final_node_type* insert_(
+    value_param_type v,index_node_type* position,
+    final_node_type*& x,Variant variant)
+  {
+    link_info inf;
+    hinted_link_point(key(v),position,inf);
+    if(inf.group==group_pointer(0))tree.reserve();
+    final_node_type* res=super::insert_(v,position,x,variant);
+    if(res==x)link(static_cast<index_node_type*>(x),inf);
+    return res;
+  }
+
+  void extract_(index_node_type* x)
+  {
+    tree.unlink(x->impl());
+    super::extract_(x);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    detach_iterators(x);
+#endif
+  }
+
+  void delete_all_nodes_()
+  {
+    for(index_node_type* x=leftmost();x!=header();){
+      index_node_type* y=x;
+      index_node_type::increment(x);
+      this->final_delete_node_(static_cast<final_node_type*>(y));
+    }
+  }
+
+  void clear_()
+  {
+    super::clear_();
+    empty_initialize();
+    tree.clear();
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super::detach_dereferenceable_iterators();
+#endif
+  }
+
+  template<typename BoolConstant>
+  void swap_(
+    ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& x,
+    BoolConstant swap_allocators)
+  {
+    adl_swap(key,x.key);
+    adl_swap(comp_,x.comp_);
+    tree.swap(x.tree,swap_allocators);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super::swap(x);
+#endif
+
+    super::swap_(x,swap_allocators);
+  }
+
+  void swap_elements_(
+    ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& x)
+  {
+    tree.swap(x.tree);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+    safe_super::swap(x);
+#endif
+
+    super::swap_elements_(x);
+  }
+
+  template<typename Variant>
+  bool replace_(value_param_type v,index_node_type* x,Variant variant)
+  {
+    if(in_place(v,x))return super::replace_(v,x,variant);
+
+    typename tree_type::backup b;
+    tree.unlink(x->impl(),b);
+
+    BOOST_TRY{
+      link_info inf;
+      link_point(key(v),inf);
+      if(inf.group==group_pointer(0))tree.reserve();
+      if(super::replace_(v,x,variant)){
+        link(x,inf);
+        tree.release(b);
+        return true;
+      }
+      tree.restore(x->impl(),b,header()->impl());
+      return false;
+    }
+    BOOST_CATCH(...){
+      tree.restore(x->impl(),b,header()->impl());
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+  }
+
+  bool modify_(index_node_type* x)
+  {
+    bool b;
+    BOOST_TRY{
+      b=in_place(x->value(),x);
+    }
+    BOOST_CATCH(...){
+      extract_(x);
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    if(!b){
+      tree.unlink(x->impl());
+      BOOST_TRY{
+        link_info inf;
+        link_point(key(x->value()),inf);
+        if(inf.group==group_pointer(0))tree.reserve();
+        link(x,inf);
+      }
+      BOOST_CATCH(...){
+        super::extract_(x);
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+        detach_iterators(x);
+#endif
+
+        BOOST_RETHROW;
+      }
+      BOOST_CATCH_END
+    }
+
+    BOOST_TRY{
+      if(!super::modify_(x)){
+        tree.unlink(x->impl());
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+        detach_iterators(x);
+#endif
+
+        return false;
+      }
+      else return true;
+    }
+    BOOST_CATCH(...){
+      tree.unlink(x->impl());
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+      detach_iterators(x);
+#endif
+
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+  }
+
+  bool modify_rollback_(index_node_type* x)
+  {
+    if(in_place(x->value(),x))return super::modify_rollback_(x);
+
+    typename tree_type::backup b;
+    tree.unlink(x->impl(),b);
+
+    BOOST_TRY{
+      link_info inf;
+      link_point(key(x->value()),inf);
+      if(inf.group==group_pointer(0))tree.reserve();
+      if(super::modify_rollback_(x)){
+        link(x,inf);
+        tree.release(b);
+        return true;
+      }
+      tree.restore(x->impl(),b,header()->impl());
+      return false;
+    }
+    BOOST_CATCH(...){
+      tree.restore(x->impl(),b,header()->impl());
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+  }
+
+  bool check_rollback_(index_node_type* x)const
+  {
+    return in_place(x->value(),x)&&super::check_rollback_(x);
+  }
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
+  /* serialization */
+
+  template<typename Archive>
+  void save_(
+    Archive& ar,const unsigned int version,const index_saver_type& sm)const
+  {
+    typedef duplicates_iterator<index_node_type,value_compare> dup_iterator;
+
+    sm.save(
+      dup_iterator(begin().get_node(),end().get_node(),value_comp()),
+      dup_iterator(end().get_node(),value_comp()),
+      ar,version);
+    super::save_(ar,version,sm);
+  }
+
+  template<typename Archive>
+  void load_(Archive& ar,const unsigned int version,const index_loader_type& lm)
+  {
+    lm.load(
+      ::boost::bind(
+        &ordered_grouped_index::rearranger,this,
+        ::boost::arg<1>(),::boost::arg<2>()),
+      ar,version);
+    super::load_(ar,version,lm);
+  }
+#endif
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  /* invariant stuff */
+
+  bool invariant_()const
+  {
+    if(size()==0||begin()==end()){
+      if(size()!=0||begin()!=end())return false;
+    }
+    else{
+      if((size_type)std::distance(begin(),end())!=size())return false;
+
+      index_node_type* y=leftmost();
+      index_node_type* x=y;
+      for(index_node_type::increment(x);x!=header();){
+        if(x->group()==y->group()){
+          if(comp_(key(y->value()),key(x->value())))return false;
+        }
+        else if(!comp_(key(y->value()),key(x->value())))return false;
+        if(comp_(key(x->value()),key(y->value())))return false;
+        y=x;
+        index_node_type::increment(x);
+      }
+    }
+    if(!tree.invariant(header()->impl(),size()))return false;
+
+    return super::invariant_();
+  }
+
+  /* This forwarding function eases things for the boost::mem_fn construct
+   * in BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT. Actually,
+   * final_check_invariant is already an inherited member function of
+   * ordered_grouped_index.
+   */
+  void check_invariant_()const{this->final_check_invariant_();}
+#endif
+
+private:
+  /* x joins group (right before position) or, if group is null, forms a
+   * new group linked to the side of parent given
+   */
+
+  struct link_info
+  {
+    link_info():
+      group(0),position(0),side(to_left),parent(0){}
+
+    group_pointer      group;
+    node_impl_pointer  position;
+    ordered_index_side side;
+    group_pointer      parent;
+  };
+
+  index_node_type* header()const{return this->final_header();}
+
+  index_node_type* leftmost()const
+  {
+    return index_node_type::from_impl(header()->next());
+  }
+
+  index_node_type* first_of(group_pointer g)const
+  {
+    return g==tree.header()?header():index_node_type::from_impl(g->first());
+  }
+
+  static node_impl_pointer map_node(
+    const copy_map_type& map,node_impl_pointer x)
+  {
+    return static_cast<index_node_type*>(map.find(
+      static_cast<final_node_type*>(index_node_type::from_impl(x))))->impl();
+  }
+
+  void empty_initialize()
+  {
+    header()->prior()=header()->next()=header()->impl();
+    header()->group()=group_pointer(0);
+  }
+
+  bool equivalent(key_param_type k,const key_type& k2)const
+  {
+    return !comp_(k,k2)&&!comp_(k2,k);
+  }
+
+  /* Elements equivalent to k go to the end of their group. Otherwise, the
+   * new group is linked as in ordered_index: the walk down looks for the
+   * first group not less than k and checks for equivalence at the end,
+   * which takes one comparison per level plus one.
+   */
+
+  void link_point(key_param_type k,link_info& inf)const
+  {
+    group_pointer y=tree.header(),x=tree.root(),z=group_pointer(0);
+    bool          c=true;
+    while(x!=group_pointer(0)){
+      y=x;
+      c=!comp_(key(tree_type::first(x)->value()),k);
+      if(c){
+        z=x;
+        x=x->left();
+      }
+      else x=x->right();
+    }
+    if(z!=group_pointer(0)&&!comp_(k,key(tree_type::first(z)->value()))){
+      inf.group=z;
+      inf.position=z->last()->next();
+    }
+    else{
+      inf.group=group_pointer(0);
+      inf.side=c?to_left:to_right;
+      inf.parent=y;
+    }
+  }
+
+  /* Hinted insertion puts the element right before position if it belongs
+   * to the group of position or to that of the preceding element.
+   */
+
+  void hinted_link_point(
+    key_param_type k,index_node_type* position,link_info& inf)const
+  {
+    group_pointer g=group_pointer(0);
+    if(position!=header()&&
+       equivalent(k,key(tree_type::first(position->group())->value()))){
+      g=position->group();
+    }
+    else if(position!=leftmost()){
+      index_node_type* y=position;
+      index_node_type::decrement(y);
+      if(equivalent(k,key(tree_type::first(y->group())->value()))){
+        g=y->group();
+      }
+    }
+
+    if(g!=group_pointer(0)){
+      inf.group=g;
+      inf.position=position->impl();
+    }
+    else link_point(k,inf);
+  }
+
+  void link(index_node_type* x,const link_info& inf)
+  {
+    if(inf.group!=group_pointer(0)){
+      tree_type::link(x->impl(),inf.group,inf.position);
+    }
+    else tree.link(x->impl(),inf.side,inf.parent,header()->impl());
+  }
+
+  /* If the element is alone in its group, the group key is its own and
+   * neighbor elements belong to the adjacent groups.
+   */
+
+  bool in_place(value_param_type v,index_node_type* x)const
+  {
+    group_pointer g=x->group();
+    if(g->size()>1){
+      node_impl_pointer y=g->first()!=x->impl()?g->first():x->next();
+      return equivalent(key(v),key(index_node_type::from_impl(y)->value()));
+    }
+
+    index_node_type* y;
+    if(x!=leftmost()){
+      y=x;
+      index_node_type::decrement(y);
+      if(!comp_(key(y->value()),key(v)))return false;
+    }
+
+    y=x;
+    index_node_type::increment(y);
+    return y==header()||comp_(key(v),key(y->value()));
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  void detach_iterators(index_node_type* x)
+  {
+    iterator it=make_iterator(x);
+    safe_mode::detach_equivalent_iterators(it);
+  }
+#endif
+
+  template<BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
+  std::pair<iterator,bool> emplace_impl(BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
+  {
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool>p=
+      this->final_emplace_(BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
+    return std::pair<iterator,bool>(make_iterator(p.first),p.second);
+  }
+
+  template<BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
+  iterator emplace_hint_impl(
+    iterator position,BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
+  {
+    BOOST_MULTI_INDEX_CHECK_VALID_ITERATOR(position);
+    BOOST_MULTI_INDEX_CHECK_IS_OWNER(position,*this);
+    BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT;
+    std::pair<final_node_type*,bool>p=
+      this->final_emplace_hint_(
+        static_cast<final_node_type*>(position.get_node()),
+        BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
+    return make_iterator(p.first);
+  }
+
+  template<typename LowerBounder,typename UpperBounder>
+  std::pair<iterator,iterator>
+  range(LowerBounder lower,UpperBounder upper,none_unbounded_tag)const
+  {
+    index_node_type* y=lower_range(lower);
+    if(y==header()||!upper(key(y->value()))){
+      return std::pair<iterator,iterator>(make_iterator(y),make_iterator(y));
+    }
+    return std::pair<iterator,iterator>(
+      make_iterator(y),make_iterator(upper_range(upper)));
+  }
+
+  template<typename LowerBounder,typename UpperBounder>
+  std::pair<iterator,iterator>
+  range(LowerBounder,UpperBounder upper,lower_unbounded_tag)const
+  {
+    return std::pair<iterator,iterator>(
+      begin(),make_iterator(upper_range(upper)));
+  }
+
+  template<typename LowerBounder,typename UpperBounder>
+  std::pair<iterator,iterator>
+  range(LowerBounder lower,UpperBounder,upper_unbounded_tag)const
+  {
+    return std::pair<iterator,iterator>(
+      make_iterator(lower_range(lower)),end());
+  }
+
+  template<typename LowerBounder,typename UpperBounder>
+  std::pair<iterator,iterator>
+  range(LowerBounder,UpperBounder,both_unbounded_tag)const
+  {
+    return std::pair<iterator,iterator>(begin(),end());
+  }
+
+  template<typename LowerBounder>
+  index_node_type* lower_range(const LowerBounder& lower)const
+  {
+    return first_of(ordered_grouped_index_partition_point(
+      tree,key,ordered_grouped_below_lower<LowerBounder>(lower)));
+  }
+
+  template<typename UpperBounder>
+  index_node_type* upper_range(const UpperBounder& upper)const
+  {
+    return first_of(ordered_grouped_index_partition_point(
+      tree,key,ordered_grouped_within_upper<UpperBounder>(upper)));
+  }
+
+#if !defined(BOOST_MULTI_INDEX_DISABLE_SERIALIZATION)
+  void rearranger(index_node_type* position,index_node_type *x)
+  {
+    if(!position||comp_(key(position->value()),key(x->value()))){
+      position=lower_bound(key(x->value())).get_node();
+    }
+    else if(comp_(key(x->value()),key(position->value()))){
+      /* inconsistent rearrangement */
+      throw_exception(
+        archive::archive_exception(
+          archive::archive_exception::other_exception));
+    }
+    else index_node_type::increment(position);
+
+    tree.relink(x->impl(),position->impl());
+  }
+#endif /* serialization */
+
+  key_from_value key;
+  key_compare    comp_;
+  tree_type      tree;
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)&&\
+    BOOST_WORKAROUND(__MWERKS__,<=0x3003)
+#pragma parse_mfunc_templ reset
+#endif
+};
+
+/* comparison */
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator==(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y)
+{
+  return x.size()==y.size()&&std::equal(x.begin(),x.end(),y.begin());
+}
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator<(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y)
+{
+  return std::lexicographical_compare(x.begin(),x.end(),y.begin(),y.end());
+}
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator!=(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y)
+{
+  return !(x==y);
+}
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator>(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y)
+{
+  return y<x;
+}
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator>=(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y)
+{
+  return !(x<y);
+}
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator<=(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y)
+{
+  return !(x>y);
+}
+
+/*  specialized algorithms */
+
+template<
+  typename KeyFromValue,typename Compare,
+  typename SuperMeta,typename TagList
+>
+void swap(
+  ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& x,
+  ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& y)
+{
+  x.swap(y);
+}
+
+} /* namespace multi_index::detail */
+
+/* ordered_grouped_index specifiers */
+
+template<typename Arg1,typename Arg2,typename Arg3>
+struct ordered_grouped_non_unique
+{
+  typedef detail::ordered_index_args<
+    Arg1,Arg2,Arg3>                                index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::compare_type        compare_type;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_grouped_index_node<Super> type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_grouped_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type>                     type;
+  };
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+/* Boost.Foreach compatibility */
+
+template<
+  typename KeyFromValue,typename Compare,
+  typename SuperMeta,typename TagList
+>
+inline boost::mpl::true_* boost_foreach_is_noncopyable(
+  boost::multi_index::detail::ordered_grouped_index<
+    KeyFromValue,Compare,SuperMeta,TagList>*&,
+  boost_foreach_argument_dependent_lookup_hack)
+{
+  return 0;
+}
+
+#undef BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT
+#undef BOOST_MULTI_INDEX_ORD_GROUPED_INDEX_CHECK_INVARIANT_OF
+
+#endif
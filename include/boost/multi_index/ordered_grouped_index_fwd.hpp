@@ -0,0 +1,121 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_ORDERED_GROUPED_INDEX_FWD_HPP
+#define BOOST_MULTI_INDEX_ORDERED_GROUPED_INDEX_FWD_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/multi_index/detail/ord_index_args.hpp>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+template<
+  typename KeyFromValue,typename Compare,
+  typename SuperMeta,typename TagList
+>
+class ordered_grouped_index;
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator==(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y);
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator<(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y);
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator!=(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y);
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator>(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y);
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator>=(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y);
+
+template<
+  typename KeyFromValue1,typename Compare1,
+  typename SuperMeta1,typename TagList1,
+  typename KeyFromValue2,typename Compare2,
+  typename SuperMeta2,typename TagList2
+>
+bool operator<=(
+  const ordered_grouped_index<
+    KeyFromValue1,Compare1,SuperMeta1,TagList1>& x,
+  const ordered_grouped_index<
+    KeyFromValue2,Compare2,SuperMeta2,TagList2>& y);
+
+template<
+  typename KeyFromValue,typename Compare,
+  typename SuperMeta,typename TagList
+>
+void swap(
+  ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& x,
+  ordered_grouped_index<KeyFromValue,Compare,SuperMeta,TagList>& y);
+
+} /* namespace multi_index::detail */
+
+/* ordered_grouped_index specifiers */
+
+template<typename Arg1,typename Arg2=mpl::na,typename Arg3=mpl::na>
+struct ordered_grouped_non_unique;
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -44,6 +44,10 @@ struct null_augment_policy
   template<typename Pointer> static void copy(Pointer,Pointer){}
   template<typename Pointer> static void rotate_left(Pointer,Pointer){}
   template<typename Pointer> static void rotate_right(Pointer,Pointer){}
+  template<typename Pointer> static void build(Pointer){}
+  template<typename Pointer> static void update(Pointer,Pointer){}
+  template<typename Pointer,typename Value,typename KeyFromValue>
+  static void assign(Pointer,const Value&,const KeyFromValue&){}
 
 #if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
   /* invariant stuff */
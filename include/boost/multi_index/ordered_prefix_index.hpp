@@ -0,0 +1,265 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_ORDERED_PREFIX_INDEX_HPP
+#define BOOST_MULTI_INDEX_ORDERED_PREFIX_INDEX_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/mpl/bool.hpp>
+#include <boost/multi_index/detail/ord_index_impl.hpp>
+#include <boost/multi_index/detail/ord_prefix_index_ops.hpp>
+#include <boost/multi_index/ordered_prefix_index_fwd.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <utility>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* prefixed_ordered_index keeps in its nodes a prefix of their string keys
+ * that settles most comparisons without accessing the elements.
+ */
+
+template<typename OrderedIndexNodeImpl>
+struct prefixed_node:OrderedIndexNodeImpl
+{
+  ordered_index_key_prefix prefix;
+};
+
+template<typename OrderedIndexImpl>
+class prefixed_ordered_index:public OrderedIndexImpl
+{
+  typedef          OrderedIndexImpl         super;
+
+protected:
+  typedef typename super::index_node_type   index_node_type;
+  typedef typename super::key_probe         key_probe;
+
+public:
+  typedef typename super::ctor_args_list    ctor_args_list;
+  typedef typename super::allocator_type    allocator_type;
+  typedef typename super::iterator          iterator;
+  typedef typename super::size_type         size_type;
+  typedef typename super::key_type          key_type;
+
+  /* lookups with key_type arguments use the prefixes, others go through
+   * the regular comparison
+   */
+
+  using super::find;
+  using super::count;
+  using super::lower_bound;
+  using super::upper_bound;
+  using super::equal_range;
+
+  iterator find(const key_type& x)const
+  {
+    if(this->frozen())return super::find(x,this->comp_);
+    return this->make_iterator(ordered_index_probe_find(
+      this->root(),this->header(),key_probe(this->key,this->comp_,x)));
+  }
+
+  size_type count(const key_type& x)const
+  {
+    std::pair<iterator,iterator> p=equal_range(x);
+    return static_cast<size_type>(std::distance(p.first,p.second));
+  }
+
+  iterator lower_bound(const key_type& x)const
+  {
+    if(this->frozen())return super::lower_bound(x,this->comp_);
+    return this->make_iterator(ordered_index_probe_lower_bound(
+      this->root(),this->header(),key_probe(this->key,this->comp_,x)));
+  }
+
+  iterator upper_bound(const key_type& x)const
+  {
+    if(this->frozen())return super::upper_bound(x,this->comp_);
+    return this->make_iterator(ordered_index_probe_upper_bound(
+      this->root(),this->header(),key_probe(this->key,this->comp_,x)));
+  }
+
+  std::pair<iterator,iterator> equal_range(const key_type& x)const
+  {
+    if(this->frozen())return super::equal_range(x,this->comp_);
+    std::pair<index_node_type*,index_node_type*> p=
+      ordered_index_probe_equal_range(
+        this->root(),this->header(),key_probe(this->key,this->comp_,x));
+    return std::pair<iterator,iterator>(
+      this->make_iterator(p.first),this->make_iterator(p.second));
+  }
+
+protected:
+  prefixed_ordered_index(const prefixed_ordered_index& x):super(x){};
+
+  prefixed_ordered_index(
+    const prefixed_ordered_index& x,do_not_copy_elements_tag):
+    super(x,do_not_copy_elements_tag()){};
+
+  prefixed_ordered_index(
+    const ctor_args_list& args_list,const allocator_type& al):
+    super(args_list,al){}
+};
+
+/* augmenting policy for ordered_index: prefixes depend on the element
+ * alone, and are set on linking or when the element changes in place
+ */
+
+template<typename KeyFromValue>
+struct prefix_policy
+{
+  template<typename OrderedIndexNodeImpl>
+  struct augmented_node
+  {
+    typedef prefixed_node<OrderedIndexNodeImpl> type;
+  };
+
+  template<typename OrderedIndexImpl>
+  struct augmented_interface
+  {
+    typedef prefixed_ordered_index<OrderedIndexImpl> type;
+  };
+
+  /* algorithmic stuff */
+
+  template<typename Pointer>
+  static void add(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void remove(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void copy(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void rotate_left(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void rotate_right(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void build(Pointer){}
+
+  template<typename Pointer>
+  static void update(Pointer,Pointer){}
+
+  template<typename Pointer,typename Value>
+  static void assign(Pointer x,const Value& v,const KeyFromValue& key)
+  {
+    x->prefix=make_ordered_index_key_prefix(key(v));
+  }
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  /* invariant stuff */
+
+  template<typename Pointer>
+  static bool invariant(Pointer){return true;}
+#endif
+};
+
+template<typename KeyFromValue>
+struct ordered_index_prefixed<prefix_policy<KeyFromValue> >:mpl::true_{};
+
+/* Prefixes are only consistent with the lexicographical order of strings
+ * of char compared through std::char_traits<char>.
+ */
+
+template<typename Key,typename Compare>
+struct is_prefixable_key:mpl::false_{};
+
+template<typename Alloc>
+struct is_prefixable_key<
+  std::basic_string<char,std::char_traits<char>,Alloc>,
+  std::less<std::basic_string<char,std::char_traits<char>,Alloc> >
+>:mpl::true_{};
+
+template<typename IndexArgs>
+struct prefix_index_args:IndexArgs
+{
+  typedef typename remove_cv<
+    typename remove_reference<
+      typename IndexArgs::key_from_value_type::result_type
+    >::type
+  >::type                                          key_type;
+
+  BOOST_STATIC_ASSERT((
+    is_prefixable_key<key_type,typename IndexArgs::compare_type>::value));
+};
+
+} /* namespace multi_index::detail */
+
+/* ordered_prefix_index specifiers */
+
+template<typename Arg1,typename Arg2,typename Arg3>
+struct ordered_prefix_unique
+{
+  typedef detail::prefix_index_args<
+    detail::ordered_index_args<Arg1,Arg2,Arg3> >  index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::compare_type        compare_type;
+  typedef detail::prefix_policy<key_from_value_type> augment_policy;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_index_node<augment_policy,Super> type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type,detail::ordered_unique_tag,
+      augment_policy>                                  type;
+  };
+};
+
+template<typename Arg1,typename Arg2,typename Arg3>
+struct ordered_prefix_non_unique
+{
+  typedef detail::prefix_index_args<
+    detail::ordered_index_args<Arg1,Arg2,Arg3> >  index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::compare_type        compare_type;
+  typedef detail::prefix_policy<key_from_value_type> augment_policy;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_index_node<augment_policy,Super> type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type,detail::ordered_non_unique_tag,
+      augment_policy>                                  type;
+  };
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -0,0 +1,160 @@
+/* Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#ifndef BOOST_MULTI_INDEX_ORDERED_THREADED_INDEX_HPP
+#define BOOST_MULTI_INDEX_ORDERED_THREADED_INDEX_HPP
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/mpl/bool.hpp>
+#include <boost/multi_index/detail/ord_index_impl.hpp>
+#include <boost/multi_index/ordered_threaded_index_fwd.hpp>
+
+namespace boost{
+
+namespace multi_index{
+
+namespace detail{
+
+/* threaded nodes link to their in-order neighbors so that iterator
+ * increment and decrement are a single pointer load instead of a walk
+ * up or down the tree.
+ */
+
+template<typename OrderedIndexNodeImpl>
+struct threaded_node:OrderedIndexNodeImpl
+{
+  typedef typename OrderedIndexNodeImpl::pointer pointer;
+
+  pointer& next(){return next_;}
+  pointer  next()const{return next_;}
+  pointer& prev(){return prev_;}
+  pointer  prev()const{return prev_;}
+
+private:
+  pointer next_;
+  pointer prev_;
+};
+
+/* augmenting policy for ordered_index: threads are maintained by
+ * ordered_index_node_impl itself, so all the hooks are no-ops
+ */
+
+struct thread_policy
+{
+  template<typename OrderedIndexNodeImpl>
+  struct augmented_node
+  {
+    typedef threaded_node<OrderedIndexNodeImpl> type;
+  };
+
+  template<typename OrderedIndexImpl>
+  struct augmented_interface
+  {
+    typedef OrderedIndexImpl type;
+  };
+
+  /* algorithmic stuff */
+
+  template<typename Pointer>
+  static void add(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void remove(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void copy(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void rotate_left(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void rotate_right(Pointer,Pointer){}
+
+  template<typename Pointer>
+  static void build(Pointer){}
+
+  template<typename Pointer>
+  static void update(Pointer,Pointer){}
+
+  template<typename Pointer,typename Value,typename KeyFromValue>
+  static void assign(Pointer,const Value&,const KeyFromValue&){}
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
+  /* invariant stuff */
+
+  template<typename Pointer>
+  static bool invariant(Pointer){return true;}
+#endif
+};
+
+template<>
+struct ordered_index_threaded<thread_policy>:mpl::true_{};
+
+} /* namespace multi_index::detail */
+
+/* ordered_threaded_index specifiers */
+
+template<typename Arg1,typename Arg2,typename Arg3>
+struct ordered_threaded_unique
+{
+  typedef typename detail::ordered_index_args<
+    Arg1,Arg2,Arg3>                                index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::compare_type        compare_type;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_index_node<detail::thread_policy,Super> type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type,detail::ordered_unique_tag,
+      detail::thread_policy>                              type;
+  };
+};
+
+template<typename Arg1,typename Arg2,typename Arg3>
+struct ordered_threaded_non_unique
+{
+  typedef detail::ordered_index_args<
+    Arg1,Arg2,Arg3>                                index_args;
+  typedef typename index_args::tag_list_type::type tag_list_type;
+  typedef typename index_args::key_from_value_type key_from_value_type;
+  typedef typename index_args::compare_type        compare_type;
+
+  template<typename Super>
+  struct node_class
+  {
+    typedef detail::ordered_index_node<detail::thread_policy,Super> type;
+  };
+
+  template<typename SuperMeta>
+  struct index_class
+  {
+    typedef detail::ordered_index<
+      key_from_value_type,compare_type,
+      SuperMeta,tag_list_type,detail::ordered_non_unique_tag,
+      detail::thread_policy>                                  type;
+  };
+};
+
+} /* namespace multi_index */
+
+} /* namespace boost */
+
+#endif
@@ -315,6 +315,22 @@ struct rank_policy
     rotate_left(x,y);
   }
 
+  template<typename Pointer>
+  static void build(Pointer x) /* in: subtrees of x already built */
+  {
+    x->size=ranked_node_size(x->left())+ranked_node_size(x->right())+1;
+  }
+
+  /* sizes are kept up to date by add and remove, and do not depend on
+   * element values
+   */
+
+  template<typename Pointer>
+  static void update(Pointer,Pointer){}
+
+  template<typename Pointer,typename Value,typename KeyFromValue>
+  static void assign(Pointer,const Value&,const KeyFromValue&){}
+
 #if defined(BOOST_MULTI_INDEX_ENABLE_INVARIANT_CHECKING)
   /* invariant stuff */
 
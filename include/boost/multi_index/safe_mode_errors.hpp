@@ -37,7 +37,8 @@ enum error_code
   inside_range,
   out_of_bounds,
   same_container,
-  unequal_allocators
+  unequal_allocators,
+  invalid_hash
 };
 
 } /* namespace multi_index::safe_mode */
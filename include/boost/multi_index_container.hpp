@@ -233,6 +233,7 @@ public:
     node_count(0)
   {
     BOOST_MULTI_INDEX_CHECK_INVARIANT;
+    bulk_insert_begin_();
     BOOST_TRY{
       iterator hint=super::end();
       for(;first!=last;++first){
@@ -242,10 +243,12 @@ public:
       }
     }
     BOOST_CATCH(...){
+      bulk_insert_end_();
       clear_();
       BOOST_RETHROW;
     }
     BOOST_CATCH_END
+    bulk_insert_end_();
   }
 
 #if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
@@ -258,6 +261,7 @@ public:
     node_count(0)
   {
     BOOST_MULTI_INDEX_CHECK_INVARIANT;
+    bulk_insert_begin_();
     BOOST_TRY{
       typedef const Value* init_iterator;
 
@@ -269,10 +273,12 @@ public:
       }
     }
     BOOST_CATCH(...){
+      bulk_insert_end_();
       clear_();
       BOOST_RETHROW;
     }
     BOOST_CATCH_END
+    bulk_insert_end_();
   }
 #endif
 
@@ -770,13 +776,20 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
   template<BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
   std::pair<final_node_type*,bool> emplace_(
     BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
+  {
+    return emplace_variant_(
+      detail::emplaced_tag(),BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
+  }
+
+  template<typename Variant,BOOST_MULTI_INDEX_TEMPLATE_PARAM_PACK>
+  std::pair<final_node_type*,bool> emplace_variant_(
+    Variant variant,BOOST_MULTI_INDEX_FUNCTION_PARAM_PACK)
   {
     final_node_type* x=allocate_node();
     BOOST_TRY{
       construct_value(x,BOOST_MULTI_INDEX_FORWARD_PARAM_PACK);
       BOOST_TRY{
-        final_node_type* res=super::insert_(
-          x->value(),x,detail::emplaced_tag());
+        final_node_type* res=super::insert_(x->value(),x,variant);
         if(res==x){
           ++node_count;
           return std::pair<final_node_type*,bool>(res,true);
@@ -952,6 +965,21 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
     node_count=0;
   }
 
+  void bulk_insert_begin_()
+  {
+    super::bulk_insert_begin_();
+  }
+
+  void bulk_insert_end_()
+  {
+    super::bulk_insert_end_();
+  }
+
+  void set_size_(size_type n)
+  {
+    node_count=n;
+  }
+
   void swap_(multi_index_container<Value,IndexSpecifierList,Allocator>& x)
   {
     swap_(
@@ -1126,17 +1154,26 @@ BOOST_MULTI_INDEX_PROTECTED_IF_MEMBER_TEMPLATE_FRIENDS:
 
     index_loader_type lm(bfm_allocator::member,s);
 
-    for(std::size_t n=0;n<s;++n){
-      detail::archive_constructed<Value> value("item",ar,value_version);
-      std::pair<final_node_type*,bool> p=insert_rv_(
-        value.get(),super::end().get_node());
-      if(!p.second)throw_exception(
-        archive::archive_exception(
-          archive::archive_exception::other_exception));
-      ar.reset_object_address(
-        boost::addressof(p.first->value()),boost::addressof(value.get()));
-      lm.add(p.first,ar,version);
+    bulk_insert_begin_();
+    BOOST_TRY{
+      for(std::size_t n=0;n<s;++n){
+        detail::archive_constructed<Value> value("item",ar,value_version);
+        std::pair<final_node_type*,bool> p=insert_rv_(
+          value.get(),super::end().get_node());
+        if(!p.second)throw_exception(
+          archive::archive_exception(
+            archive::archive_exception::other_exception));
+        ar.reset_object_address(
+          boost::addressof(p.first->value()),boost::addressof(value.get()));
+        lm.add(p.first,ar,version);
+      }
     }
+    BOOST_CATCH(...){
+      bulk_insert_end_();
+      BOOST_RETHROW;
+    }
+    BOOST_CATCH_END
+    bulk_insert_end_();
     lm.add_track(header(),ar,version);
 
     super::load_(ar,version,lm);
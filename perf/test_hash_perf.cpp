@@ -0,0 +1,830 @@
+/* Boost.MultiIndex performance test for hashed indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+
+#include <algorithm>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/fast_hash.hpp>
+#include <boost/multi_index/hashed_flat_index.hpp>
+#include <boost/multi_index/hashed_forward_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/hashed_index_parallel_rehash.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <cstddef>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+#include <chrono>
+#endif
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)
+#include <thread>
+#endif
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)&&\
+    !defined(BOOST_NO_CXX11_HDR_MUTEX)&&\
+    !defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#define BOOST_MULTI_INDEX_PERF_CONCURRENT
+#include <boost/multi_index/concurrent_multi_index_container.hpp>
+#include <mutex>
+#endif
+
+using namespace std;
+using namespace boost::multi_index;
+
+/* Timing is done by taking the best of several runs of each routine, which
+ * filters out most of the noise from the system without requiring the
+ * elaborate harness of test_perf.cpp: measured routines here are
+ * long-running enough for clock() to be accurate.
+ */
+
+const int runs=5;
+
+template<typename F>
+double measure(F f)
+{
+  double best=0.0;
+  for(int i=0;i<runs;++i){
+    clock_t start=clock();
+    f();
+    double t=double(clock()-start)/CLOCKS_PER_SEC;
+    if(i==0||t<best)best=t;
+  }
+  return best;
+}
+
+/* key generators */
+
+struct sequential_int
+{
+  typedef int result_type;
+  int operator()(int n)const{return n;}
+};
+
+struct strided_int
+{
+  typedef int result_type;
+  int operator()(int n)const{return n*1024;}
+};
+
+struct random_string
+{
+  typedef string result_type;
+  string operator()(int n)const
+  {
+    ostringstream os;
+    os<<"user/"<<(unsigned)(n*2654435761u)<<"/session";
+    return os.str();
+  }
+};
+
+struct long_string
+{
+  typedef string result_type;
+  string operator()(int n)const
+  {
+    ostringstream os;
+    os<<"https://www.example.com/"<<string(160,'p')<<"/resource?id="
+      <<(unsigned)(n*2654435761u);
+    return os.str();
+  }
+};
+
+struct url_string
+{
+  typedef string result_type;
+  string operator()(int n)const
+  {
+    ostringstream os;
+    os<<"https://www.example.com/catalog/"<<(unsigned)(n*2654435761u);
+    return os.str();
+  }
+};
+
+struct ticker_string
+{
+  typedef string result_type;
+  string operator()(int n)const
+  {
+    /* bijective base 26, over a permutation of [1,26+...+26^5] */
+
+    unsigned int m=1+(unsigned int)((n*7919ull)%12356630ull);
+    string       res;
+    while(m>0){
+      --m;
+      res.insert(res.begin(),char('A'+m%26));
+      m/=26;
+    }
+    return res;
+  }
+};
+
+template<typename Container>
+struct lookup_all
+{
+  typedef typename Container::key_type key_type;
+
+  lookup_all(
+    const Container& c_,const vector<key_type>& keys_,std::size_t& res_):
+    c(c_),keys(keys_),res(res_){}
+
+  void operator()()const
+  {
+    std::size_t n=0;
+    for(typename vector<key_type>::const_iterator it=keys.begin(),
+        it_end=keys.end();it!=it_end;++it){
+      if(c.find(*it)!=c.end())++n;
+    }
+    res+=n;
+  }
+
+  const Container&        c;
+  const vector<key_type>& keys;
+  std::size_t&            res;
+};
+
+/* Lookup throughput for successful and unsuccessful lookups, in millions
+ * of lookups per second.
+ */
+
+template<typename Container,typename KeyGen>
+void lookup_throughput(const char* title,int n,KeyGen gen)
+{
+  typedef typename Container::key_type key_type;
+
+  Container        c;
+  vector<key_type> hits,misses;
+  for(int i=0;i<n;++i){
+    c.insert(gen(2*i));
+    hits.push_back(gen(2*i));
+    misses.push_back(gen(2*i+1));
+  }
+  random_shuffle(hits.begin(),hits.end());
+
+  std::size_t res=0;
+  double      thit=measure(lookup_all<Container>(c,hits,res)),
+              tmiss=measure(lookup_all<Container>(c,misses,res));
+  if(res!=runs*(std::size_t)n)cout<<"  (unexpected result)"<<endl;
+
+  cout<<"  "<<setw(28)<<left<<title<<right
+      <<setw(8)<<n/thit/1.E6<<" Mlookups/s (hit), "
+      <<setw(8)<<n/tmiss/1.E6<<" Mlookups/s (miss)"<<endl;
+}
+
+template<typename KeyGen>
+void compare_bucket_policies(const char* title,KeyGen gen)
+{
+  typedef typename KeyGen::result_type key_type;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type> > >
+  >                                                    prime_container;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type>,power_2_buckets<> > >
+  >                                                    pow2_container;
+
+  cout<<title<<endl;
+  for(int n=100000;n<=1000000;n*=10){
+    cout<<"  "<<n<<" elements"<<endl;
+    lookup_throughput<prime_container>("prime bucket counts",n,gen);
+    lookup_throughput<pow2_container>("power of two bucket counts",n,gen);
+  }
+}
+
+void test_bucket_policies()
+{
+  cout<<fixed<<setprecision(2);
+  compare_bucket_policies("bucket policies, sequential int keys",
+    sequential_int());
+  compare_bucket_policies("bucket policies, strided int keys",
+    strided_int());
+  compare_bucket_policies("bucket policies, string keys",
+    random_string());
+}
+
+template<typename KeyGen>
+void compare_flat_index(const char* title,KeyGen gen)
+{
+  typedef typename KeyGen::result_type key_type;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type> > >
+  >                                                    node_container;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_flat_unique<identity<key_type> > >
+  >                                                    flat_container;
+
+  cout<<title<<endl;
+  for(int n=100000;n<=1000000;n*=10){
+    cout<<"  "<<n<<" elements"<<endl;
+    lookup_throughput<node_container>("hashed_unique",n,gen);
+    lookup_throughput<flat_container>("hashed_flat_unique",n,gen);
+  }
+}
+
+void test_flat_index()
+{
+  cout<<fixed<<setprecision(2);
+  compare_flat_index("flat index, sequential int keys",sequential_int());
+  compare_flat_index("flat index, strided int keys",strided_int());
+  compare_flat_index("flat index, string keys",random_string());
+}
+
+/* Worst latency of a single insertion and total time taken to insert n
+ * elements, in milliseconds: incremental rehashing replaces the pauses
+ * of full rehashes with a small overhead on every insertion.
+ */
+
+template<typename Container>
+void insertion_latency(const char* title,int n)
+{
+  /* a first large allocation gets out of the way the housekeeping some
+   * allocators do after the destruction of a previous container
+   */
+
+  {
+    vector<char> v(1<<16);
+  }
+
+  Container c;
+  double    worst=0.0;
+  clock_t   start=clock();
+  for(int i=0;i<n;++i){
+    clock_t t0=clock();
+    c.insert(i);
+    double  t=double(clock()-t0)/CLOCKS_PER_SEC;
+    if(t>worst)worst=t;
+  }
+  double total=double(clock()-start)/CLOCKS_PER_SEC;
+
+  cout<<"  "<<setw(28)<<left<<title<<right
+      <<setw(10)<<worst*1.E3<<" ms (worst), "
+      <<setw(10)<<total*1.E3<<" ms (total)"<<endl;
+}
+
+void test_incremental_rehash()
+{
+  typedef multi_index_container<
+    int,
+    indexed_by<hashed_unique<identity<int>,store_hash<> > >
+  >                                                    full_container;
+  typedef multi_index_container<
+    int,
+    indexed_by<hashed_unique<identity<int>,incremental_rehash<> > >
+  >                                                    incremental_container;
+
+  cout<<fixed<<setprecision(2);
+  cout<<"insertion latency, sequential int keys"<<endl;
+  for(int n=100000;n<=4000000;n*=2){
+    cout<<"  "<<n<<" elements"<<endl;
+    insertion_latency<full_container>("full rehash",n);
+    insertion_latency<incremental_container>("incremental rehash",n);
+  }
+}
+
+template<typename Container>
+struct find_many_all
+{
+  typedef typename Container::key_type key_type;
+  typedef typename Container::iterator iterator;
+
+  find_many_all(
+    const Container& c_,const vector<key_type>& keys_,std::size_t& res_):
+    c(c_),keys(keys_),res(res_){}
+
+  void operator()()const
+  {
+    const std::size_t batch=256;
+    iterator          its[batch];
+    std::size_t       n=0;
+    for(typename vector<key_type>::const_iterator it=keys.begin(),
+        it_end=keys.end();it!=it_end;){
+      typename vector<key_type>::const_iterator
+        it_next=std::size_t(it_end-it)<batch?it_end:it+batch;
+      iterator* last=c.find_many(it,it_next,its);
+      for(iterator* p=its;p!=last;++p)if(*p!=c.end())++n;
+      it=it_next;
+    }
+    res+=n;
+  }
+
+  const Container&        c;
+  const vector<key_type>& keys;
+  std::size_t&            res;
+};
+
+/* Successful lookups with a loop of find and with find_many over batches
+ * of 256 keys, in millions of lookups per second: the difference grows as
+ * the index outgrows the cache.
+ */
+
+template<typename KeyGen>
+void compare_find_many(const char* title,KeyGen gen)
+{
+  typedef typename KeyGen::result_type key_type;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type> > >
+  >                                                    container;
+
+  cout<<title<<endl;
+  for(int n=10000;n<=10000000;n*=10){
+    container        c;
+    vector<key_type> keys;
+    for(int i=0;i<n;++i){
+      c.insert(gen(i));
+      keys.push_back(gen(i));
+    }
+    random_shuffle(keys.begin(),keys.end());
+
+    std::size_t res=0;
+    double      tfind=measure(lookup_all<container>(c,keys,res)),
+                tmany=measure(find_many_all<container>(c,keys,res));
+    if(res!=2*runs*(std::size_t)n)cout<<"  (unexpected result)"<<endl;
+
+    cout<<"  "<<setw(9)<<n<<" elements "
+        <<setw(8)<<n/tfind/1.E6<<" Mlookups/s (find), "
+        <<setw(8)<<n/tmany/1.E6<<" Mlookups/s (find_many)"<<endl;
+  }
+}
+
+void test_find_many()
+{
+  cout<<fixed<<setprecision(2);
+  compare_find_many("batched lookup, sequential int keys",sequential_int());
+  compare_find_many("batched lookup, string keys",random_string());
+}
+
+/* clock() adds up the time of all threads, so parallel rehashing is timed
+ * with a wall clock where available.
+ */
+
+double wall_clock()
+{
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+  return chrono::duration<double>(
+    chrono::steady_clock::now().time_since_epoch()).count();
+#else
+  return double(clock())/CLOCKS_PER_SEC;
+#endif
+}
+
+/* Time taken to rehash n elements to twice their bucket count with
+ * 1, 2, 4... threads, in milliseconds. Each measurement needs a freshly
+ * populated container, as rehashing never shrinks the bucket array.
+ */
+
+template<typename Container>
+void parallel_rehash_scaling(const char* title,int n,std::size_t max_threads)
+{
+  cout<<"  "<<title<<endl;
+  double t1=0.0;
+  for(std::size_t threads=1;;threads*=2){
+    if(threads>max_threads)threads=max_threads;
+
+    Container c;
+    for(int i=0;i<n;++i)c.insert(i);
+    double start=wall_clock();
+    parallel_rehash(c,2*c.bucket_count(),threads);
+    double t=wall_clock()-start;
+    if(threads==1)t1=t;
+
+    cout<<"    "<<setw(3)<<threads<<" threads "
+        <<setw(10)<<t*1.E3<<" ms, speedup "<<t1/t<<endl;
+    if(threads==max_threads)break;
+  }
+}
+
+void test_parallel_rehash()
+{
+  typedef multi_index_container<
+    int,
+    indexed_by<hashed_unique<identity<int> > >
+  >                                                    plain_container;
+  typedef multi_index_container<
+    int,
+    indexed_by<hashed_unique<identity<int>,store_hash<> > >
+  >                                                    stored_hash_container;
+
+  std::size_t max_threads=1;
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)
+  max_threads=thread::hardware_concurrency();
+  if(max_threads==0)max_threads=1;
+#endif
+
+  const int n=50000000;
+
+  cout<<fixed<<setprecision(2);
+  cout<<"parallel rehash, "<<n<<" sequential int keys"<<endl;
+  parallel_rehash_scaling<plain_container>("hashed_unique",n,max_threads);
+  parallel_rehash_scaling<stored_hash_container>(
+    "hashed_unique with store_hash",n,max_threads);
+}
+
+template<typename Container>
+struct refreeze
+{
+  refreeze(Container& c_):c(c_){}
+
+  void operator()()const
+  {
+    c.unfreeze();
+    c.freeze();
+  }
+
+  Container& c;
+};
+
+/* Lookup throughput of a hashed index before and after freeze(), in
+ * millions of lookups per second, along with the time taken to populate
+ * the index (with buckets reserved in advance) and to freeze it.
+ */
+
+template<typename KeyGen>
+void compare_frozen(const char* title,int n,KeyGen gen)
+{
+  typedef typename KeyGen::result_type key_type;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type> > >
+  >                                                    container;
+
+  vector<key_type> hits,misses;
+  for(int i=0;i<n;++i){
+    hits.push_back(gen(2*i));
+    misses.push_back(gen(2*i+1));
+  }
+
+  container c;
+  c.reserve(n);
+  double start=wall_clock();
+  c.insert(hits.begin(),hits.end());
+  double tinsert=wall_clock()-start,
+         tfreeze=measure(refreeze<container>(c));
+  if(!c.frozen())cout<<"  (freezing failed)"<<endl;
+  random_shuffle(hits.begin(),hits.end());
+
+  std::size_t res=0;
+  c.unfreeze();
+  double thit=measure(lookup_all<container>(c,hits,res)),
+         tmiss=measure(lookup_all<container>(c,misses,res));
+  c.freeze();
+  double thitf=measure(lookup_all<container>(c,hits,res)),
+         tmissf=measure(lookup_all<container>(c,misses,res));
+  if(res!=2*runs*(std::size_t)n)cout<<"  (unexpected result)"<<endl;
+
+  cout<<title<<endl
+      <<"  insertion "<<setw(8)<<tinsert*1.E3<<" ms, "
+      <<"freeze "<<setw(8)<<tfreeze*1.E3<<" ms"<<endl
+      <<"  "<<setw(10)<<left<<"regular"<<right
+      <<setw(8)<<n/thit/1.E6<<" Mlookups/s (hit), "
+      <<setw(8)<<n/tmiss/1.E6<<" Mlookups/s (miss)"<<endl
+      <<"  "<<setw(10)<<left<<"frozen"<<right
+      <<setw(8)<<n/thitf/1.E6<<" Mlookups/s (hit), "
+      <<setw(8)<<n/tmissf/1.E6<<" Mlookups/s (miss)"<<endl;
+}
+
+void test_freeze()
+{
+  const int n=10000000;
+
+  cout<<fixed<<setprecision(2);
+  compare_frozen("frozen index, 10M sequential int keys",n,sequential_int());
+  compare_frozen("frozen index, 10M string keys",n,random_string());
+}
+
+/* Allocator keeping track of the memory in use by all the containers
+ * instantiated with it.
+ */
+
+std::size_t allocated_bytes=0;
+
+template<typename T>
+struct counting_allocator:std::allocator<T>
+{
+  typedef std::allocator<T> super;
+  template<typename U>struct rebind{typedef counting_allocator<U> other;};
+
+  counting_allocator(){}
+  template<typename U>counting_allocator(const counting_allocator<U>&){}
+
+  T* allocate(std::size_t n)
+  {
+    allocated_bytes+=n*sizeof(T);
+    return super::allocate(n);
+  }
+
+  void deallocate(T* p,std::size_t n)
+  {
+    allocated_bytes-=n*sizeof(T);
+    super::deallocate(p,n);
+  }
+};
+
+/* Bytes taken per element by a container of n elements, buckets included. */
+
+template<typename Container,typename KeyGen>
+void memory_footprint(const char* title,int n,KeyGen gen)
+{
+  std::size_t bytes;
+  {
+    Container c;
+    for(int i=0;i<n;++i)c.insert(gen(i));
+    bytes=allocated_bytes;
+  }
+
+  cout<<"  "<<setw(28)<<left<<title<<right
+      <<setw(8)<<double(bytes)/n<<" bytes/element"<<endl;
+}
+
+template<typename KeyGen>
+void compare_forward_index(const char* title,KeyGen gen)
+{
+  typedef typename KeyGen::result_type key_type;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type> > >,
+    counting_allocator<key_type>
+  >                                                    node_container;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_forward_unique<identity<key_type> > >,
+    counting_allocator<key_type>
+  >                                                    forward_container;
+
+  cout<<title<<endl;
+  for(int n=100000;n<=1000000;n*=10){
+    cout<<"  "<<n<<" elements"<<endl;
+    memory_footprint<node_container>("hashed_unique",n,gen);
+    memory_footprint<forward_container>("hashed_forward_unique",n,gen);
+    lookup_throughput<node_container>("hashed_unique",n,gen);
+    lookup_throughput<forward_container>("hashed_forward_unique",n,gen);
+  }
+}
+
+void test_forward_index()
+{
+  cout<<fixed<<setprecision(2);
+  compare_forward_index("forward index, sequential int keys",sequential_int());
+  compare_forward_index("forward index, string keys",random_string());
+}
+
+/* Chain length statistics of a container of n elements: maximum chain
+ * length and percentage of empty buckets (an ideal hash function leaves
+ * a fraction exp(-load_factor) of buckets empty).
+ */
+
+template<typename Container,typename KeyGen>
+void chain_lengths(const char* title,int n,KeyGen gen)
+{
+  Container c;
+  for(int i=0;i<n;++i)c.insert(gen(i));
+  typename Container::stats_type st=c.stats();
+
+  cout<<"  "<<setw(28)<<left<<title<<right
+      <<setw(8)<<st.max_chain_length<<" max chain length, "
+      <<setw(8)<<100.0*st.empty_bucket_count/st.bucket_count
+      <<"% empty buckets"<<endl;
+}
+
+template<typename KeyGen>
+void compare_fast_hash(const char* title,KeyGen gen)
+{
+  typedef typename KeyGen::result_type key_type;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type> > >
+  >                                                    prime_container;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<
+      hashed_unique<identity<key_type>,fast_hash<key_type> >
+    >
+  >                                                    prime_fast_container;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type>,power_2_buckets<> > >
+  >                                                    pow2_container;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<
+      hashed_unique<
+        identity<key_type>,fast_hash<key_type>,
+        std::equal_to<key_type>,power_2_buckets<>
+      >
+    >
+  >                                                    pow2_fast_container;
+
+  cout<<title<<endl;
+  for(int n=100000;n<=1000000;n*=10){
+    cout<<"  "<<n<<" elements"<<endl;
+    chain_lengths<prime_container>("boost::hash, prime",n,gen);
+    chain_lengths<prime_fast_container>("fast_hash, prime",n,gen);
+    chain_lengths<pow2_container>("boost::hash, power of two",n,gen);
+    chain_lengths<pow2_fast_container>("fast_hash, power of two",n,gen);
+    lookup_throughput<prime_container>("boost::hash, prime",n,gen);
+    lookup_throughput<prime_fast_container>("fast_hash, prime",n,gen);
+    lookup_throughput<pow2_container>("boost::hash, power of two",n,gen);
+    lookup_throughput<pow2_fast_container>("fast_hash, power of two",n,gen);
+  }
+}
+
+void test_fast_hash()
+{
+  cout<<fixed<<setprecision(2);
+  compare_fast_hash("fast_hash, sequential int keys",sequential_int());
+  compare_fast_hash("fast_hash, strided int keys",strided_int());
+  compare_fast_hash("fast_hash, string keys",random_string());
+  compare_fast_hash("fast_hash, long string keys",long_string());
+}
+
+/* Stored hash values let chain traversals skip the elements whose hash
+ * differs without accessing their keys, which for strings lie in a
+ * separate heap block.
+ */
+
+template<typename KeyGen>
+void compare_stored_hash(const char* title,KeyGen gen)
+{
+  typedef typename KeyGen::result_type key_type;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type> > >
+  >                                                    plain_container;
+  typedef multi_index_container<
+    key_type,
+    indexed_by<hashed_unique<identity<key_type>,store_hash<> > >
+  >                                                    stored_container;
+
+  cout<<title<<endl;
+  for(int n=100000;n<=1000000;n*=10){
+    cout<<"  "<<n<<" elements"<<endl;
+    lookup_throughput<plain_container>("plain nodes",n,gen);
+    lookup_throughput<stored_container>("store_hash",n,gen);
+  }
+}
+
+void test_string_keys()
+{
+  cout<<fixed<<setprecision(2);
+  compare_stored_hash("stored hash, URL keys",url_string());
+  compare_stored_hash("stored hash, ticker keys",ticker_string());
+}
+
+#if defined(BOOST_MULTI_INDEX_PERF_CONCURRENT)
+/* A multi_index_container behind one mutex, the baseline for
+ * concurrent_multi_index_container.
+ */
+
+template<typename Container>
+struct locked_container
+{
+  bool insert(int x)
+  {
+    lock_guard<mutex> lck(m);
+    return c.insert(x).second;
+  }
+
+  std::size_t erase(int x)
+  {
+    lock_guard<mutex> lck(m);
+    return c.erase(x);
+  }
+
+  std::size_t count(int x)
+  {
+    lock_guard<mutex> lck(m);
+    return c.count(x);
+  }
+
+  mutex     m;
+  Container c;
+};
+
+template<typename Container>
+struct concurrent_adaptor
+{
+  bool        insert(int x){return c.insert(x);}
+  std::size_t erase(int x){return c.template erase<0>(x);}
+  std::size_t count(int x){return c.template count<0>(x);}
+
+  Container c;
+};
+
+/* Each thread runs ops operations on keys drawn from [0,2n), a fraction
+ * reads/100 of them lookups and the rest insertions and erasures in equal
+ * parts, so that a container prefilled with n elements keeps its size.
+ */
+
+template<typename Container>
+struct mixed_operations
+{
+  mixed_operations(Container& c_,int n_,int ops_,int reads_,unsigned seed_):
+    c(&c_),n(n_),ops(ops_),reads(reads_),seed(seed_){}
+
+  void operator()()const
+  {
+    unsigned    x=seed*2654435761u+1;
+    std::size_t res=0;
+    for(int i=0;i<ops;++i){
+      x^=x<<13;x^=x>>17;x^=x<<5;
+      int key=(int)(x%(2u*n)),op=(int)((x>>24)%100);
+      if(op<reads)res+=c->count(key);
+      else if(op%2)res+=c->insert(key);
+      else res+=c->erase(key);
+    }
+    if(res==(std::size_t)-1)cout<<"";
+  }
+
+  Container* c;
+  int        n,ops,reads;
+  unsigned   seed;
+};
+
+template<typename Container>
+double mixed_throughput(int n,std::size_t threads,int reads)
+{
+  const int ops=200000;
+
+  Container c;
+  for(int i=0;i<n;++i)c.insert(2*i);
+
+  vector<thread> ts;
+  double         start=wall_clock();
+  for(std::size_t t=1;t<threads;++t){
+    ts.push_back(thread(mixed_operations<Container>(c,n,ops,reads,t)));
+  }
+  mixed_operations<Container>(c,n,ops,reads,0)();
+  for(std::size_t t=0;t<ts.size();++t)ts[t].join();
+  return threads*ops/(wall_clock()-start)/1.E6;
+}
+
+void concurrent_scaling(const char* title,int n,int reads)
+{
+  typedef multi_index_container<
+    int,
+    indexed_by<hashed_unique<identity<int> > >
+  >                                                    plain_container;
+  typedef concurrent_multi_index_container<
+    int,
+    indexed_by<hashed_unique<identity<int> > >
+  >                                                    concurrent_container;
+
+  cout<<"  "<<title<<endl;
+  for(std::size_t threads=1;threads<=32;threads*=2){
+    cout<<"    "<<setw(3)<<threads<<" threads "
+        <<setw(8)<<mixed_throughput<
+          locked_container<plain_container> >(n,threads,reads)
+        <<" Mops/s (single mutex), "
+        <<setw(8)<<mixed_throughput<
+          concurrent_adaptor<concurrent_container> >(n,threads,reads)
+        <<" Mops/s (striped locks)"<<endl;
+  }
+}
+
+void test_concurrent()
+{
+  const int n=1000000;
+
+  cout<<fixed<<setprecision(2);
+  cout<<"concurrent access, "<<n<<" int keys, "
+      <<thread::hardware_concurrency()<<" hardware threads"<<endl;
+  concurrent_scaling("90% lookups",n,90);
+  concurrent_scaling("50% lookups",n,50);
+  concurrent_scaling("10% lookups",n,10);
+}
+#else
+void test_concurrent(){}
+#endif
+
+int main()
+{
+  test_bucket_policies();
+  test_flat_index();
+  test_incremental_rehash();
+  test_parallel_rehash();
+  test_find_many();
+  test_freeze();
+  test_forward_index();
+  test_fast_hash();
+  test_string_keys();
+  test_concurrent();
+
+  return 0;
+}
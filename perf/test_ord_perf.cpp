@@ -0,0 +1,1044 @@
+/* Boost.MultiIndex performance test for ordered indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+
+#include <algorithm>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/augmented_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/interval_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_btree_index.hpp>
+#include <boost/multi_index/ordered_grouped_index.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/ordered_prefix_index.hpp>
+#include <boost/multi_index/ordered_threaded_index.hpp>
+#include <boost/multi_index/ranked_index.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace boost::multi_index;
+
+/* Timing is done by taking the best of several runs of each routine, as in
+ * test_hash_perf.cpp.
+ */
+
+const int runs=3;
+
+template<typename F>
+double measure(F f)
+{
+  double best=0.0;
+  for(int i=0;i<runs;++i){
+    clock_t start=clock();
+    f();
+    double t=double(clock()-start)/CLOCKS_PER_SEC;
+    if(i==0||t<best)best=t;
+  }
+  return best;
+}
+
+/* Deterministic pseudorandom sequence, as random_shuffle over 100M
+ * elements is too slow with some standard libraries.
+ */
+
+struct lcg
+{
+  lcg():n(12345u){}
+
+  unsigned int operator()()
+  {
+    n=n*1103515245u+12345u;
+    return n;
+  }
+
+  unsigned int n;
+};
+
+template<typename Container>
+struct lookup_all
+{
+  lookup_all(const Container& c_,const vector<int>& keys_,std::size_t& res_):
+    c(c_),keys(keys_),res(res_){}
+
+  void operator()()const
+  {
+    std::size_t n=0;
+    for(vector<int>::const_iterator it=keys.begin(),it_end=keys.end();
+        it!=it_end;++it){
+      if(c.find(*it)!=c.end())++n;
+    }
+    res+=n;
+  }
+
+  const Container&   c;
+  const vector<int>& keys;
+  std::size_t&       res;
+};
+
+/* lower_bound followed by a scan of len elements */
+
+template<typename Container>
+struct scan_all
+{
+  scan_all(
+    const Container& c_,const vector<int>& keys_,int len_,long long& res_):
+    c(c_),keys(keys_),len(len_),res(res_){}
+
+  void operator()()const
+  {
+    long long s=0;
+    for(vector<int>::const_iterator it=keys.begin(),it_end=keys.end();
+        it!=it_end;++it){
+      typename Container::const_iterator first=c.lower_bound(*it),
+                                         last=c.end();
+      for(int i=0;i<len&&first!=last;++i,++first)s+=*first;
+    }
+    res+=s;
+  }
+
+  const Container&   c;
+  const vector<int>& keys;
+  int                len;
+  long long&         res;
+};
+
+/* Point lookup and range scan throughput for n elements inserted in random
+ * order, in millions of lookups/scans per second.
+ */
+
+template<typename Container>
+void lookup_and_scan(const char* title,int n)
+{
+  Container   c;
+  vector<int> keys;
+  lcg         rnd;
+  for(int i=0;i<n;++i){
+    int x=static_cast<int>(rnd()>>1);
+    c.insert(x);
+    keys.push_back(x);
+  }
+
+  const std::size_t m=1000000;
+  vector<int>       probes;
+  for(std::size_t i=0;i<m;++i)probes.push_back(keys[rnd()%keys.size()]);
+
+  std::size_t res=0;
+  long long   sum=0;
+  double      tfind=measure(lookup_all<Container>(c,probes,res)),
+              tscan10=measure(scan_all<Container>(c,probes,10,sum)),
+              tscan1000=measure(
+                scan_all<Container>(
+                  c,vector<int>(probes.begin(),probes.begin()+m/100),
+                  1000,sum));
+  if(res!=runs*m)cout<<"  (unexpected result)"<<endl;
+
+  cout<<"  "<<setw(22)<<left<<title<<right
+      <<setw(8)<<m/tfind/1.E6<<" Mfinds/s, "
+      <<setw(8)<<m/tscan10/1.E6<<" Mscans/s (10), "
+      <<setw(8)<<m/100/tscan1000/1.E3<<" Kscans/s (1000)"<<endl;
+}
+
+typedef multi_index_container<
+  int,
+  indexed_by<ordered_unique<identity<int> > >
+> rb_container;
+
+typedef multi_index_container<
+  int,
+  indexed_by<ordered_btree_unique<identity<int> > >
+> btree_container;
+
+void test_btree_index(int n)
+{
+  cout<<fixed<<setprecision(2);
+  cout<<"ordered_unique vs. ordered_btree_unique, "<<n<<" int keys"<<endl;
+  lookup_and_scan<rb_container>("ordered_unique",n);
+  lookup_and_scan<btree_container>("ordered_btree_unique",n);
+}
+
+/* Construction from a sorted range, which builds the tree in linear time,
+ * against the hinted insertion at the end it used to amount to, and
+ * against construction from the same elements in random order.
+ */
+
+template<typename Container>
+struct build_from_range
+{
+  build_from_range(const vector<int>& v_,std::size_t& res_):v(v_),res(res_){}
+
+  void operator()()const
+  {
+    Container c(v.begin(),v.end());
+    res+=c.size();
+  }
+
+  const vector<int>& v;
+  std::size_t&       res;
+};
+
+template<typename Container>
+struct build_by_hinted_insertion
+{
+  build_by_hinted_insertion(const vector<int>& v_,std::size_t& res_):
+    v(v_),res(res_){}
+
+  void operator()()const
+  {
+    Container c;
+    for(vector<int>::const_iterator it=v.begin(),it_end=v.end();
+        it!=it_end;++it){
+      c.insert(c.end(),*it);
+    }
+    res+=c.size();
+  }
+
+  const vector<int>& v;
+  std::size_t&       res;
+};
+
+template<typename Container>
+void build(const char* title,int n)
+{
+  vector<int> sorted,shuffled;
+  lcg         rnd;
+  for(int i=0;i<n;++i)sorted.push_back(i);
+  shuffled=sorted;
+  for(std::size_t i=shuffled.size();i>1;--i){
+    std::swap(shuffled[i-1],shuffled[rnd()%i]);
+  }
+
+  std::size_t res=0;
+  double      tsorted=measure(build_from_range<Container>(sorted,res)),
+              thinted=measure(build_by_hinted_insertion<Container>(sorted,res)),
+              tshuffled=measure(build_from_range<Container>(shuffled,res));
+  if(res!=3*runs*std::size_t(n))cout<<"  (unexpected result)"<<endl;
+
+  cout<<"  "<<setw(22)<<left<<title<<right
+      <<setw(8)<<tsorted<<" s sorted range, "
+      <<setw(8)<<thinted<<" s hinted insertion, "
+      <<setw(8)<<tshuffled<<" s shuffled range"<<endl;
+}
+
+typedef multi_index_container<
+  int,
+  indexed_by<ranked_unique<identity<int> > >
+> ranked_container;
+
+void test_sorted_build(int n)
+{
+  cout<<fixed<<setprecision(2);
+  cout<<"construction of "<<n<<" int keys"<<endl;
+  build<rb_container>("ordered_unique",n);
+  build<ranked_container>("ranked_unique",n);
+}
+
+/* Monotonic sequences of lookups d elements apart, from the root and
+ * with a cursor.
+ */
+
+template<typename Container>
+struct lower_bound_all
+{
+  lower_bound_all(const Container& c_,const vector<int>& keys_,long long& res_):
+    c(c_),keys(keys_),res(res_){}
+
+  void operator()()const
+  {
+    long long s=0;
+    for(vector<int>::const_iterator it=keys.begin(),it_end=keys.end();
+        it!=it_end;++it){
+      s+=*c.lower_bound(*it);
+    }
+    res+=s;
+  }
+
+  const Container&   c;
+  const vector<int>& keys;
+  long long&         res;
+};
+
+template<typename Container>
+struct seek_all
+{
+  seek_all(const Container& c_,const vector<int>& keys_,long long& res_):
+    c(c_),keys(keys_),res(res_){}
+
+  void operator()()const
+  {
+    long long                    s=0;
+    typename Container::cursor   cur=c.make_cursor();
+    for(vector<int>::const_iterator it=keys.begin(),it_end=keys.end();
+        it!=it_end;++it){
+      s+=*cur.seek(*it);
+    }
+    res+=s;
+  }
+
+  const Container&   c;
+  const vector<int>& keys;
+  long long&         res;
+};
+
+void test_finger_search(int n)
+{
+  rb_container c;
+  for(int i=0;i<n;++i)c.insert(2*i);
+
+  cout<<fixed<<setprecision(2);
+  cout<<"ascending lookups in ordered_unique, "<<n<<" int keys"<<endl;
+  for(int d=1;d<=1024;d*=4){
+    vector<int> keys;
+    for(int i=0;i<1000000;++i){
+      keys.push_back(2*static_cast<int>((static_cast<long long>(i)*d)%n)+1);
+    }
+
+    long long res1=0,res2=0;
+    double    t1=measure(lower_bound_all<rb_container>(c,keys,res1)),
+              t2=measure(seek_all<rb_container>(c,keys,res2));
+    if(res1!=res2)cout<<"  (unexpected result)"<<endl;
+
+    cout<<"  d="<<setw(8)<<left<<d<<right
+        <<setw(8)<<keys.size()/t1/1.E6<<" Mlookups/s lower_bound, "
+        <<setw(8)<<keys.size()/t2/1.E6<<" Mlookups/s cursor"<<endl;
+  }
+}
+
+/* Set operations between a container with n elements and another with m,
+ * through join/split against element by element insertion or lookup.
+ * Each operation works on fresh copies of the containers, whose
+ * construction is not timed.
+ */
+
+struct join_union
+{
+  template<typename Container>
+  void operator()(Container& c0,Container& c1)const{c0.set_union(c1);}
+};
+
+struct insert_union
+{
+  template<typename Container>
+  void operator()(Container& c0,Container& c1)const
+  {
+    c0.insert(c1.begin(),c1.end());
+  }
+};
+
+struct join_intersection
+{
+  template<typename Container>
+  void operator()(Container& c0,Container& c1)const{c0.set_intersection(c1);}
+};
+
+struct std_intersection
+{
+  template<typename Container>
+  void operator()(Container& c0,Container& c1)const
+  {
+    Container res;
+    std::set_intersection(
+      c0.begin(),c0.end(),c1.begin(),c1.end(),inserter(res,res.end()));
+    c0.swap(res);
+  }
+};
+
+struct join_split
+{
+  template<typename Container>
+  void operator()(Container& c0,Container& c1)const
+  {
+    c0.split(*c0.begin()+static_cast<int>(c0.size())/2,c1);
+  }
+};
+
+struct erase_split
+{
+  template<typename Container>
+  void operator()(Container& c0,Container& c1)const
+  {
+    typename Container::iterator it=
+      c0.lower_bound(*c0.begin()+static_cast<int>(c0.size())/2);
+    c1.insert(it,c0.end());
+    c0.erase(it,c0.end());
+  }
+};
+
+template<typename Container,typename Op>
+double measure_on_copies(const Container& c0,const Container& c1,Op op)
+{
+  double best=0.0;
+  for(int i=0;i<runs;++i){
+    Container x0(c0),x1(c1);
+    clock_t   start=clock();
+    op(x0,x1);
+    double    t=double(clock()-start)/CLOCKS_PER_SEC;
+    if(i==0||t<best)best=t;
+  }
+  return best;
+}
+
+void test_join_ops(int n)
+{
+  cout<<fixed<<setprecision(4);
+  cout<<"set operations in ordered_unique, "<<n<<" int keys"<<endl;
+  for(int m=1;m<=n;m*=100){
+    rb_container c0,c1;
+    for(int i=0;i<n;++i)c0.insert(2*i);
+    for(int i=0;i<m;++i)c1.insert(2*static_cast<int>(
+      (static_cast<long long>(i)*n)/m)+i%2); /* half of them in c0 */
+
+    cout<<"  m="<<setw(10)<<left<<m<<right
+        <<setw(9)<<measure_on_copies(c0,c1,join_union())<<" s union, "
+        <<setw(9)<<measure_on_copies(c0,c1,insert_union())<<" s insert, "
+        <<setw(9)<<measure_on_copies(c0,c1,join_intersection())
+        <<" s intersection, "
+        <<setw(9)<<measure_on_copies(c0,c1,std_intersection())
+        <<" s std::set_intersection"<<endl;
+  }
+  rb_container c0,c1;
+  for(int i=0;i<n;++i)c0.insert(i);
+  cout<<"  split in half "
+      <<setw(9)<<measure_on_copies(c0,c1,join_split())<<" s split, "
+      <<setw(9)<<measure_on_copies(c0,c1,erase_split())<<" s insert+erase"
+      <<endl;
+}
+
+/* Sizes can be given in the command line, as the largest default size
+ * takes several GB of memory.
+ */
+
+/* Random lookups before and after freezing, along with the time taken by
+ * freeze() compared to that of inserting the elements.
+ */
+
+struct freeze_index
+{
+  freeze_index(rb_container& c_):c(c_){}
+
+  void operator()()const
+  {
+    c.unfreeze();
+    c.freeze();
+  }
+
+  rb_container& c;
+};
+
+void test_freeze(int n)
+{
+  rb_container c;
+  vector<int>  keys;
+  lcg          rnd;
+  for(int i=0;i<n;++i)keys.push_back(static_cast<int>(rnd()>>1));
+  clock_t      start=clock();
+  for(int i=0;i<n;++i)c.insert(keys[i]);
+  double       tinsert=double(clock()-start)/CLOCKS_PER_SEC,
+               tfreeze=measure(freeze_index(c));
+
+  /* half hits, half misses */
+
+  const std::size_t m=1000000;
+  vector<int>       probes;
+  for(std::size_t i=0;i<m;++i){
+    probes.push_back(keys[rnd()%keys.size()]-static_cast<int>(i%2));
+  }
+
+  std::size_t res1=0,res2=0;
+  long long   sum1=0,sum2=0;
+  c.unfreeze();
+  double      tfind=measure(lookup_all<rb_container>(c,probes,res1)),
+              tlower=measure(lower_bound_all<rb_container>(c,probes,sum1));
+  c.freeze();
+  double      tffind=measure(lookup_all<rb_container>(c,probes,res2)),
+              tflower=measure(lower_bound_all<rb_container>(c,probes,sum2));
+  if(res1!=res2||sum1!=sum2)cout<<"  (unexpected result)"<<endl;
+
+  cout<<fixed<<setprecision(2);
+  cout<<"frozen ordered_unique, "<<n<<" int keys: freeze "
+      <<setprecision(3)<<tfreeze<<" s, insert "<<tinsert<<" s"<<endl
+      <<setprecision(2)
+      <<"  unfrozen "<<setw(8)<<m/tfind/1.E6<<" Mfinds/s, "
+      <<setw(8)<<m/tlower/1.E6<<" Mlower_bounds/s"<<endl
+      <<"  frozen   "<<setw(8)<<m/tffind/1.E6<<" Mfinds/s, "
+      <<setw(8)<<m/tflower/1.E6<<" Mlower_bounds/s"<<endl;
+}
+
+/* Range sums with aggregate() against walking the range, along with the
+ * insertion overhead of keeping the summaries.
+ */
+
+struct int_sum
+{
+  typedef long long result_type;
+
+  long long operator()()const{return 0;}
+  long long operator()(int x)const{return x;}
+  long long operator()(long long x,long long y)const{return x+y;}
+};
+
+typedef multi_index_container<
+  int,
+  indexed_by<augmented_unique<int_sum,identity<int> > >
+> aug_container;
+
+template<typename Container>
+struct insert_all
+{
+  insert_all(const vector<int>& keys_):keys(keys_){}
+
+  void operator()()const
+  {
+    Container c;
+    for(std::size_t i=0;i<keys.size();++i)c.insert(keys[i]);
+  }
+
+  const vector<int>& keys;
+};
+
+struct aggregate_all
+{
+  aggregate_all(
+    const aug_container& c_,const vector<int>& probes_,long long& res_):
+    c(c_),probes(probes_),res(res_){}
+
+  void operator()()const
+  {
+    long long s=0;
+    for(std::size_t i=0;i+1<probes.size();i+=2){
+      s+=c.aggregate(c.lower_bound(probes[i]),c.lower_bound(probes[i+1]));
+    }
+    res=s;
+  }
+
+  const aug_container& c;
+  const vector<int>&   probes;
+  long long&           res;
+};
+
+struct walk_all
+{
+  walk_all(
+    const aug_container& c_,const vector<int>& probes_,long long& res_):
+    c(c_),probes(probes_),res(res_){}
+
+  void operator()()const
+  {
+    long long s=0;
+    for(std::size_t i=0;i+1<probes.size();i+=2){
+      aug_container::iterator first=c.lower_bound(probes[i]),
+                              last=c.lower_bound(probes[i+1]);
+      for(;first!=last;++first)s+=*first;
+    }
+    res=s;
+  }
+
+  const aug_container& c;
+  const vector<int>&   probes;
+  long long&           res;
+};
+
+void test_aggregate(int n)
+{
+  vector<int> keys;
+  lcg         rnd;
+  for(int i=0;i<n;++i)keys.push_back(static_cast<int>(rnd()>>1));
+  double      tinsert=measure(insert_all<rb_container>(keys)),
+              tainsert=measure(insert_all<aug_container>(keys));
+
+  /* ranges spanning 1% of the elements on average */
+
+  aug_container     c(keys.begin(),keys.end());
+  const std::size_t m=2000;
+  vector<int>       probes;
+  for(std::size_t i=0;i<m;++i){
+    int       a=keys[rnd()%keys.size()];
+    long long b=a+static_cast<long long>(rnd()%(2u*(0x7FFFFFFFu/100u)));
+    probes.push_back(a);
+    probes.push_back(static_cast<int>(
+      (std::min)(b,(long long)(std::numeric_limits<int>::max)())));
+  }
+
+  long long res1=0,res2=0;
+  double    taggregate=measure(aggregate_all(c,probes,res1)),
+            twalk=measure(walk_all(c,probes,res2));
+  if(res1!=res2)cout<<"  (unexpected result)"<<endl;
+
+  cout<<fixed<<setprecision(3);
+  cout<<"augmented_unique sum, "<<n<<" int keys: insert "<<tainsert
+      <<" s (ordered_unique "<<tinsert<<" s)"<<endl
+      <<"  "<<m/2<<" range sums: aggregate "<<setprecision(5)<<taggregate
+      <<" s, walk "<<twalk<<" s"<<endl;
+}
+
+/* Stabbing queries with an interval index against scanning the elements
+ * with start point not after the query point in an ordered index.
+ */
+
+struct span
+{
+  span(int lo_,int hi_):lo(lo_),hi(hi_){}
+
+  int lo,hi;
+};
+
+typedef multi_index_container<
+  span,
+  indexed_by<
+    interval_index<member<span,int,&span::lo>,member<span,int,&span::hi> >
+  >
+> itv_container;
+
+typedef multi_index_container<
+  span,
+  indexed_by<ordered_non_unique<member<span,int,&span::lo> > >
+> start_container;
+
+struct stab_all
+{
+  stab_all(const itv_container& c_,const vector<int>& probes_,long long& res_):
+    c(c_),probes(probes_),res(res_){}
+
+  void operator()()const
+  {
+    long long s=0;
+    for(std::size_t i=0;i<probes.size();++i){
+      std::pair<
+        itv_container::overlap_iterator,
+        itv_container::overlap_iterator> p=c.stabbing(probes[i]);
+      for(;p.first!=p.second;++p.first)s+=p.first->hi;
+    }
+    res=s;
+  }
+
+  const itv_container& c;
+  const vector<int>&   probes;
+  long long&           res;
+};
+
+struct scan_starts
+{
+  scan_starts(
+    const start_container& c_,const vector<int>& probes_,long long& res_):
+    c(c_),probes(probes_),res(res_){}
+
+  void operator()()const
+  {
+    long long s=0;
+    for(std::size_t i=0;i<probes.size();++i){
+      start_container::iterator it=c.begin(),
+                                last=c.upper_bound(probes[i]);
+      for(;it!=last;++it)if(it->hi>=probes[i])s+=it->hi;
+    }
+    res=s;
+  }
+
+  const start_container& c;
+  const vector<int>&     probes;
+  long long&             res;
+};
+
+void test_interval_index(int n)
+{
+  /* mostly short spans, with some long ones */
+
+  itv_container   c;
+  start_container c2;
+  lcg             rnd;
+  for(int i=0;i<n;++i){
+    int lo=static_cast<int>(rnd()>>2),
+        len=static_cast<int>(rnd()%(i%100?1000u:10000000u));
+    c.insert(span(lo,lo+len));
+    c2.insert(span(lo,lo+len));
+  }
+
+  const std::size_t m=100;
+  vector<int>       probes;
+  for(std::size_t i=0;i<m;++i)probes.push_back(static_cast<int>(rnd()>>2));
+
+  long long res1=0,res2=0;
+  double    tstab=measure(stab_all(c,probes,res1)),
+            tscan=measure(scan_starts(c2,probes,res2));
+  if(res1!=res2)cout<<"  (unexpected result)"<<endl;
+
+  cout<<fixed<<setprecision(3);
+  cout<<"interval_index, "<<n<<" spans: "<<m<<" stabbing queries "
+      <<setprecision(5)<<tstab<<" s, ordered_non_unique scan "
+      <<tscan<<" s"<<endl;
+}
+
+/* Iteration over threaded nodes against the tree walk of plain ordered
+ * indices: full traversals both ways, then range scans.
+ */
+
+template<typename Container>
+struct traverse
+{
+  traverse(const Container& c_,long long& res_):c(c_),res(res_){}
+
+  void operator()()const
+  {
+    long long s=0;
+    for(typename Container::const_iterator it=c.begin(),it_end=c.end();
+        it!=it_end;++it)s+=*it;
+    for(typename Container::const_reverse_iterator it=c.rbegin(),
+        it_end=c.rend();it!=it_end;++it)s-=*it;
+    res+=s+static_cast<long long>(c.size());
+  }
+
+  const Container& c;
+  long long&       res;
+};
+
+typedef multi_index_container<
+  int,
+  indexed_by<ordered_threaded_unique<identity<int> > >
+> threaded_container;
+
+template<typename Container>
+void traverse_and_scan(const char* title,int n)
+{
+  Container c;
+  lcg       rnd;
+  for(int i=0;i<n;++i)c.insert(static_cast<int>(rnd()>>1));
+
+  long long res=0;
+  double    t=measure(traverse<Container>(c,res));
+  if(res!=runs*static_cast<long long>(c.size()))
+    cout<<"  (unexpected result)"<<endl;
+
+  cout<<"  "<<setw(22)<<left<<title<<right
+      <<setw(8)<<2*c.size()/t/1.E6<<" Melements/s traversed"<<endl;
+  lookup_and_scan<Container>(title,n);
+}
+
+void test_threaded_index(int n)
+{
+  cout<<fixed<<setprecision(2);
+  cout<<"ordered_unique vs. ordered_threaded_unique, "<<n<<" int keys"<<endl;
+  traverse_and_scan<rb_container>("ordered_unique",n);
+  traverse_and_scan<threaded_container>("ordered_threaded_unique",n);
+}
+
+/* Prefixed against plain nodes for string keys: URLs, which all share
+ * their first bytes, and ticker symbols, which fit entirely in the prefix.
+ */
+
+struct url_key
+{
+  string operator()(int n)const
+  {
+    ostringstream os;
+    os<<"https://www.example.com/catalog/"<<(unsigned)(n*2654435761u);
+    return os.str();
+  }
+};
+
+struct ticker_key
+{
+  /* bijective base 26, over a permutation of [1,26+...+26^5] */
+
+  string operator()(int n)const
+  {
+    unsigned int m=1+(unsigned int)((n*7919ull)%12356630ull);
+    string       res;
+    while(m>0){
+      --m;
+      res.insert(res.begin(),char('A'+m%26));
+      m/=26;
+    }
+    return res;
+  }
+};
+
+template<typename Container>
+struct insert_keys
+{
+  insert_keys(const vector<string>& keys_,std::size_t& res_):
+    keys(keys_),res(res_){}
+
+  void operator()()const
+  {
+    Container c;
+    for(std::size_t i=0;i<keys.size();++i)c.insert(keys[i]);
+    res+=c.size();
+  }
+
+  const vector<string>& keys;
+  std::size_t&          res;
+};
+
+template<typename Container>
+struct find_keys
+{
+  find_keys(
+    const Container& c_,const vector<string>& keys_,std::size_t& res_):
+    c(c_),keys(keys_),res(res_){}
+
+  void operator()()const
+  {
+    std::size_t n=0;
+    for(std::size_t i=0;i<keys.size();++i){
+      if(c.find(keys[i])!=c.end())++n;
+    }
+    res+=n;
+  }
+
+  const Container&      c;
+  const vector<string>& keys;
+  std::size_t&          res;
+};
+
+template<typename Container,typename KeyGen>
+void insert_and_find(const char* title,int n,KeyGen gen)
+{
+  vector<string> keys,probes;
+  lcg            rnd;
+  for(int i=0;i<n;++i)keys.push_back(gen(i));
+  for(int i=0;i<n;++i)probes.push_back(keys[rnd()%keys.size()]);
+
+  Container   c(keys.begin(),keys.end());
+  std::size_t res=0;
+  double      tinsert=measure(insert_keys<Container>(keys,res)),
+              tfind=measure(find_keys<Container>(c,probes,res));
+  if(res!=2*runs*std::size_t(n))cout<<"  (unexpected result)"<<endl;
+
+  cout<<"  "<<setw(22)<<left<<title<<right
+      <<setw(8)<<tinsert<<" s insertion, "
+      <<setw(8)<<n/tfind/1.E6<<" Mfinds/s"<<endl;
+}
+
+typedef multi_index_container<
+  string,
+  indexed_by<ordered_unique<identity<string> > >
+> string_container;
+
+typedef multi_index_container<
+  string,
+  indexed_by<ordered_prefix_unique<identity<string> > >
+> prefix_container;
+
+void test_prefix_index(int n)
+{
+  cout<<fixed<<setprecision(3);
+  cout<<"ordered_unique vs. ordered_prefix_unique, "<<n<<" URLs"<<endl;
+  insert_and_find<string_container>("ordered_unique",n,url_key());
+  insert_and_find<prefix_container>("ordered_prefix_unique",n,url_key());
+  cout<<"ordered_unique vs. ordered_prefix_unique, "<<n
+      <<" ticker symbols"<<endl;
+  insert_and_find<string_container>("ordered_unique",n,ticker_key());
+  insert_and_find<prefix_container>("ordered_prefix_unique",n,ticker_key());
+}
+
+/* Grouped against plain non-unique nodes with few distinct keys:
+ * insertion, count() of random keys and erasure in random order.
+ */
+
+typedef multi_index_container<
+  int,
+  indexed_by<ordered_non_unique<identity<int> > >
+> multi_container;
+
+typedef multi_index_container<
+  int,
+  indexed_by<ordered_grouped_non_unique<identity<int> > >
+> grouped_container;
+
+template<typename Container>
+struct count_all
+{
+  count_all(
+    const Container& c_,const vector<int>& probes_,std::size_t& res_):
+    c(c_),probes(probes_),res(res_){}
+
+  void operator()()const
+  {
+    std::size_t s=0;
+    for(std::size_t i=0;i<probes.size();++i)s+=c.count(probes[i]);
+    res+=s;
+  }
+
+  const Container&   c;
+  const vector<int>& probes;
+  std::size_t&       res;
+};
+
+template<typename Container>
+double erase_all(const vector<int>& keys,const vector<std::size_t>& order)
+{
+  double best=0.0;
+  for(int i=0;i<runs;++i){
+    Container                            c;
+    vector<typename Container::iterator> its;
+    for(std::size_t j=0;j<keys.size();++j){
+      its.push_back(c.insert(keys[j]).first);
+    }
+    clock_t start=clock();
+    for(std::size_t j=0;j<order.size();++j)c.erase(its[order[j]]);
+    double t=double(clock()-start)/CLOCKS_PER_SEC;
+    if(i==0||t<best)best=t;
+  }
+  return best;
+}
+
+template<typename Container>
+std::size_t insert_count_and_erase(
+  const char* title,const vector<int>& keys,const vector<int>& probes,
+  const vector<std::size_t>& order)
+{
+  Container   c(keys.begin(),keys.end());
+  std::size_t res=0;
+  double      tinsert=measure(insert_all<Container>(keys)),
+              tcount=measure(count_all<Container>(c,probes,res)),
+              terase=erase_all<Container>(keys,order);
+
+  cout<<"  "<<setw(27)<<left<<title<<right
+      <<setw(8)<<tinsert<<" s insertion, "
+      <<setw(9)<<tcount/probes.size()*1.E6<<" us/count, "
+      <<setw(8)<<terase<<" s erasure"<<endl;
+  return res;
+}
+
+void test_grouped_index(int n)
+{
+  const int           m=32;
+  vector<int>         keys,probes;
+  vector<std::size_t> order;
+  lcg                 rnd;
+  for(int i=0;i<n;++i)keys.push_back(static_cast<int>(rnd()>>8)%m);
+  for(int i=0;i<1000;++i)probes.push_back(static_cast<int>(rnd()>>8)%m);
+  for(int i=0;i<n;++i)order.push_back(i);
+  for(int i=n;i>1;--i)std::swap(order[i-1],order[rnd()%i]);
+
+  cout<<fixed<<setprecision(3);
+  cout<<"ordered_non_unique vs. ordered_grouped_non_unique, "<<n
+      <<" int keys, "<<m<<" distinct"<<endl;
+  std::size_t res1=insert_count_and_erase<multi_container>(
+                "ordered_non_unique",keys,probes,order),
+              res2=insert_count_and_erase<grouped_container>(
+                "ordered_grouped_non_unique",keys,probes,order);
+  if(res1!=res2)cout<<"  (unexpected result)"<<endl;
+}
+
+/* Batches of unrelated keys looked up with find one after another against
+ * find_batch, which interleaves their searches, for several batch sizes.
+ * Figures are meaningful for containers larger than the last level cache.
+ */
+
+struct find_each
+{
+  find_each(
+    const rb_container& c_,const vector<int>& keys_,std::size_t b_,
+    std::size_t& res_):
+    c(c_),keys(keys_),b(b_),res(res_){}
+
+  void operator()()const
+  {
+    vector<rb_container::iterator> its(b);
+    std::size_t                    n=0;
+    for(std::size_t i=0;i+b<=keys.size();i+=b){
+      for(std::size_t j=0;j<b;++j)its[j]=c.find(keys[i+j]);
+      for(std::size_t j=0;j<b;++j)if(its[j]!=c.end())++n;
+    }
+    res+=n;
+  }
+
+  const rb_container& c;
+  const vector<int>&  keys;
+  std::size_t         b;
+  std::size_t&        res;
+};
+
+struct find_batch_each
+{
+  find_batch_each(
+    const rb_container& c_,const vector<int>& keys_,std::size_t b_,
+    std::size_t& res_):
+    c(c_),keys(keys_),b(b_),res(res_){}
+
+  void operator()()const
+  {
+    vector<rb_container::iterator> its(b);
+    std::size_t                    n=0;
+    for(std::size_t i=0;i+b<=keys.size();i+=b){
+      c.find_batch(keys.begin()+i,keys.begin()+i+b,its.begin());
+      for(std::size_t j=0;j<b;++j)if(its[j]!=c.end())++n;
+    }
+    res+=n;
+  }
+
+  const rb_container& c;
+  const vector<int>&  keys;
+  std::size_t         b;
+  std::size_t&        res;
+};
+
+void test_batch_lookup(int n)
+{
+  rb_container c;
+  vector<int>  keys;
+  lcg          rnd;
+  for(int i=0;i<n;++i){
+    int x=static_cast<int>(rnd()>>1);
+    c.insert(x);
+    keys.push_back(x);
+  }
+
+  const std::size_t m=1<<20;
+  vector<int>       probes;
+  for(std::size_t i=0;i<m;++i)probes.push_back(keys[rnd()%keys.size()]);
+
+  cout<<fixed<<setprecision(2);
+  cout<<"find vs. find_batch, ordered_unique, "<<n<<" int keys"<<endl;
+  for(std::size_t b=8;b<=256;b*=2){
+    std::size_t res1=0,res2=0;
+    double      tfind=measure(find_each(c,probes,b,res1)),
+                tbatch=measure(find_batch_each(c,probes,b,res2));
+    if(res1!=runs*m||res2!=runs*m)cout<<"  (unexpected result)"<<endl;
+
+    cout<<"  batch "<<setw(3)<<b<<": find "
+        <<setw(6)<<m/tfind/1.E6<<" Mfinds/s, find_batch "
+        <<setw(6)<<m/tbatch/1.E6<<" Mfinds/s"<<endl;
+  }
+}
+
+int main(int argc,char* argv[])
+{
+  vector<int> sizes;
+  for(int i=1;i<argc;++i)sizes.push_back(atoi(argv[i]));
+  if(sizes.empty()){
+    sizes.push_back(1000000);
+    sizes.push_back(10000000);
+    sizes.push_back(100000000);
+  }
+
+  for(std::size_t i=0;i<sizes.size();++i)test_btree_index(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_sorted_build(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_finger_search(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_join_ops(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_freeze(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_aggregate(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_interval_index(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_threaded_index(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_prefix_index(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_grouped_index(sizes[i]);
+  for(std::size_t i=0;i<sizes.size();++i)test_batch_lookup(sizes[i]);
+
+  return 0;
+}
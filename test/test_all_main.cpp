@@ -1,6 +1,6 @@
 /* Boost.MultiIndex test suite.
  *
- * Copyright 2003-2020 Joaquin M Lopez Munoz.
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
  * Distributed under the Boost Software License, Version 1.0.
  * (See accompanying file LICENSE_1_0.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt)
@@ -10,13 +10,21 @@
 
 #include <boost/detail/lightweight_test.hpp>
 #include "test_alloc_awareness.hpp"
+#include "test_augmented_index.hpp"
 #include "test_basic.hpp"
+#include "test_btree_index.hpp"
 #include "test_capacity.hpp"
 #include "test_comparison.hpp"
 #include "test_composite_key.hpp"
+#include "test_concurrent.hpp"
 #include "test_conv_iterators.hpp"
 #include "test_copy_assignment.hpp"
+#include "test_fast_hash.hpp"
+#include "test_flat_hash.hpp"
+#include "test_forward_hash.hpp"
+#include "test_grouped_index.hpp"
 #include "test_hash_ops.hpp"
+#include "test_interval_index.hpp"
 #include "test_iterators.hpp"
 #include "test_key.hpp"
 #include "test_key_extractors.hpp"
@@ -25,6 +33,7 @@
 #include "test_mpl_ops.hpp"
 #include "test_node_handling.hpp"
 #include "test_observers.hpp"
+#include "test_prefix_index.hpp"
 #include "test_projection.hpp"
 #include "test_range.hpp"
 #include "test_rank_ops.hpp"
@@ -33,18 +42,27 @@
 #include "test_serialization.hpp"
 #include "test_set_ops.hpp"
 #include "test_special_set_ops.hpp"
+#include "test_threaded_index.hpp"
 #include "test_update.hpp"
 
 int main()
 {
   test_allocator_awareness();
+  test_augmented_index();
   test_basic();
+  test_btree_index();
   test_capacity();
   test_comparison();
   test_composite_key();
+  test_concurrent();
   test_conv_iterators();
   test_copy_assignment();
+  test_fast_hash();
+  test_flat_hash();
+  test_forward_hash();
+  test_grouped_index();
   test_hash_ops();
+  test_interval_index();
   test_iterators();
   test_key();
   test_key_extractors();
@@ -53,6 +71,7 @@ int main()
   test_mpl_ops();
   test_node_handling();
   test_observers();
+  test_prefix_index();
   test_projection();
   test_range();
   test_rank_ops();
@@ -61,6 +80,7 @@ int main()
   test_serialization();
   test_set_ops();
   test_special_set_ops();
+  test_threaded_index();
   test_update();
 
   return boost::report_errors();
@@ -0,0 +1,344 @@
+/* Boost.MultiIndex test for augmented indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_augmented_index.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+#include <boost/detail/lightweight_test.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/augmented_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+
+using namespace boost::multi_index;
+
+struct sum_summary
+{
+  typedef long result_type;
+
+  long operator()()const{return 0;}
+  long operator()(int x)const{return x;}
+  long operator()(long x,long y)const{return x+y;}
+};
+
+struct assign_int
+{
+  assign_int(int n_):n(n_){}
+  void operator()(int& x)const{x=n;}
+  int n;
+};
+
+struct item
+{
+  item(int k_,int v_):k(k_),v(v_){}
+
+  int k;
+  int v;
+};
+
+struct set_v
+{
+  set_v(int v_):v(v_){}
+  void operator()(item& x)const{x.v=v;}
+  int v;
+};
+
+struct set_k
+{
+  set_k(int k_):k(k_){}
+  void operator()(item& x)const{x.k=k;}
+  int k;
+};
+
+/* minimum and maximum of v, along with the number of elements */
+
+struct min_max
+{
+  int         lo,hi;
+  std::size_t n;
+};
+
+inline bool operator==(const min_max& x,const min_max& y)
+{
+  return x.n==y.n&&(x.n==0||(x.lo==y.lo&&x.hi==y.hi));
+}
+
+struct min_max_summary
+{
+  typedef min_max result_type;
+
+  min_max operator()()const
+  {
+    min_max res={0,0,0};
+    return res;
+  }
+
+  min_max operator()(const item& x)const
+  {
+    min_max res={x.v,x.v,1};
+    return res;
+  }
+
+  min_max operator()(const min_max& x,const min_max& y)const
+  {
+    if(x.n==0)return y;
+    if(y.n==0)return x;
+    min_max res={(std::min)(x.lo,y.lo),(std::max)(x.hi,y.hi),x.n+y.n};
+    return res;
+  }
+};
+
+/* non-commutative summary: elements in traversal order */
+
+struct concat
+{
+  unsigned long long digits;
+  unsigned long long scale;
+};
+
+inline bool operator==(const concat& x,const concat& y)
+{
+  return x.digits==y.digits&&x.scale==y.scale;
+}
+
+struct concat_summary
+{
+  typedef concat result_type;
+
+  concat operator()()const
+  {
+    concat res={0,1};
+    return res;
+  }
+
+  concat operator()(int x)const
+  {
+    concat res={(unsigned long long)(x%10),10};
+    return res;
+  }
+
+  concat operator()(const concat& x,const concat& y)const
+  {
+    concat res={x.digits*y.scale+y.digits,x.scale*y.scale};
+    return res;
+  }
+};
+
+/* the index is only passed in for Index to be deduced */
+
+template<typename Index>
+static typename Index::summary_type brute_aggregate(
+  const Index&,
+  typename Index::iterator first,typename Index::iterator last)
+{
+  typedef typename Index::summary_function summary_function;
+
+  summary_function                s;
+  typename Index::summary_type res=s();
+  for(;first!=last;++first)res=s(res,s(*first));
+  return res;
+}
+
+template<typename Index>
+static bool check_aggregates(const Index& i)
+{
+  typedef typename Index::iterator iterator;
+
+  if(!(i.aggregate()==brute_aggregate(i,i.begin(),i.end())))return false;
+
+  std::vector<iterator> its;
+  for(iterator it=i.begin();;++it){
+    its.push_back(it);
+    if(it==i.end())break;
+  }
+  std::size_t n=its.size();
+  std::size_t step=n>64?n/16:1;
+  for(std::size_t a=0;a<n;a+=step){
+    for(std::size_t b=a;b<n;b+=(b%3==0?1:step)){
+      if(!(i.aggregate(its[a],its[b])==brute_aggregate(i,its[a],its[b]))){
+        return false;
+      }
+    }
+    if(!(i.aggregate(its[a],i.end())==brute_aggregate(i,its[a],i.end()))){
+      return false;
+    }
+  }
+  return true;
+}
+
+static void test_int_summaries()
+{
+  typedef multi_index_container<
+    int,
+    indexed_by<
+      augmented_non_unique<sum_summary,identity<int> >,
+      augmented_unique<concat_summary,identity<int> >
+    >
+  > container;
+
+  container c;
+  BOOST_TEST(c.aggregate()==0);
+  BOOST_TEST(c.aggregate(c.begin(),c.end())==0);
+  BOOST_TEST(check_aggregates(c.get<1>()));
+
+  std::srand(1);
+  for(int i=0;i<300;++i){
+    c.insert(std::rand()%1000);
+    if(i%37==0){
+      BOOST_TEST(check_aggregates(c));
+      BOOST_TEST(check_aggregates(c.get<1>()));
+    }
+  }
+  BOOST_TEST(check_aggregates(c));
+  BOOST_TEST(check_aggregates(c.get<1>()));
+
+  for(int i=0;i<200;++i){
+    container::iterator it=c.lower_bound(std::rand()%1000);
+    if(it!=c.end())c.erase(it);
+    if(i%29==0){
+      BOOST_TEST(check_aggregates(c));
+      BOOST_TEST(check_aggregates(c.get<1>()));
+    }
+  }
+  BOOST_TEST(check_aggregates(c));
+  BOOST_TEST(check_aggregates(c.get<1>()));
+
+  /* failed modification with rollback */
+
+  for(int i=0;i<20;++i){
+    container::iterator it=c.begin(),it2=c.end();
+    std::advance(it,i);
+    std::advance(it2,-1-i);
+    int v=*it,v2=*it2;
+    if(v==v2)continue;
+    BOOST_TEST(!c.modify(it,assign_int(v2),assign_int(v)));
+    BOOST_TEST(*it==v);
+    BOOST_TEST(check_aggregates(c));
+    BOOST_TEST(check_aggregates(c.get<1>()));
+  }
+
+  container c2(c);
+  BOOST_TEST(check_aggregates(c2));
+  BOOST_TEST(check_aggregates(c2.get<1>()));
+  BOOST_TEST(c2.aggregate()==c.aggregate());
+
+  container c3;
+  for(int i=0;i<50;++i)c3.insert(i);
+  c3.swap(c2);
+  BOOST_TEST(c3.aggregate()==c.aggregate());
+  BOOST_TEST(c2.aggregate()==49*50/2);
+  BOOST_TEST(check_aggregates(c2));
+  BOOST_TEST(check_aggregates(c3.get<1>()));
+
+  c2.clear();
+  BOOST_TEST(c2.aggregate()==0);
+
+  std::vector<int> v;
+  for(int i=0;i<500;++i)v.push_back(i);
+  container c4(v.begin(),v.end());
+  BOOST_TEST(c4.aggregate()==499*500/2);
+  BOOST_TEST(check_aggregates(c4));
+  BOOST_TEST(check_aggregates(c4.get<1>()));
+}
+
+static void test_modification()
+{
+  typedef multi_index_container<
+    item,
+    indexed_by<
+      augmented_non_unique<min_max_summary,member<item,int,&item::k> >,
+      ordered_non_unique<member<item,int,&item::v> >
+    >
+  > container;
+
+  container c;
+  std::srand(2);
+  for(int i=0;i<200;++i)c.insert(item(std::rand()%100,std::rand()%1000));
+  BOOST_TEST(check_aggregates(c));
+
+  /* in-place changes of the summarized value */
+
+  for(int i=0;i<100;++i){
+    container::iterator it=c.lower_bound(std::rand()%100);
+    if(it==c.end())continue;
+    switch(i%3){
+      case 0: c.modify(it,set_v(std::rand()%1000));break;
+      case 1: c.replace(it,item(it->k,std::rand()%1000));break;
+      default:{
+        container::nth_index<1>::type& i1=c.get<1>();
+        i1.modify(c.project<1>(it),set_v(std::rand()%1000));
+      }
+    }
+    BOOST_TEST(check_aggregates(c));
+  }
+
+  /* changes relinking the element */
+
+  for(int i=0;i<100;++i){
+    container::iterator it=c.lower_bound(std::rand()%100);
+    if(it==c.end())continue;
+    if(i%2)c.modify(it,set_k(std::rand()%100));
+    else c.replace(it,item(std::rand()%100,std::rand()%1000));
+    BOOST_TEST(check_aggregates(c));
+  }
+
+  min_max mm=c.aggregate();
+  BOOST_TEST(mm.n==c.size());
+  BOOST_TEST(mm.lo==c.get<1>().begin()->v);
+  BOOST_TEST(mm.hi==(--c.get<1>().end())->v);
+}
+
+static void test_set_operations()
+{
+  typedef multi_index_container<
+    int,
+    indexed_by<augmented_unique<sum_summary,identity<int> > >
+  > container;
+
+  for(int n=0;n<4;++n){
+    container c1,c2;
+    std::srand(3+n);
+    for(int i=0;i<200*n;++i)c1.insert(std::rand()%1000);
+    for(int i=0;i<30;++i)c2.insert(std::rand()%1000);
+
+    container u1(c1),u2(c2);
+    u1.set_union(u2);
+    BOOST_TEST(check_aggregates(u1));
+    BOOST_TEST(check_aggregates(u2));
+
+    container i1(c1);
+    i1.set_intersection(c2);
+    BOOST_TEST(check_aggregates(i1));
+
+    container d1(c1);
+    d1.set_difference(c2);
+    BOOST_TEST(check_aggregates(d1));
+    BOOST_TEST(d1.aggregate()+i1.aggregate()==c1.aggregate());
+
+    container s1(c1),s2;
+    s1.split(500,s2);
+    BOOST_TEST(check_aggregates(s1));
+    BOOST_TEST(check_aggregates(s2));
+    BOOST_TEST(s1.aggregate()+s2.aggregate()==c1.aggregate());
+  }
+}
+
+void test_augmented_index()
+{
+  test_int_summaries();
+  test_modification();
+  test_set_operations();
+}
@@ -0,0 +1,409 @@
+/* Boost.MultiIndex test for B+tree ordered indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_btree_index.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/detail/lightweight_test.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_btree_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/next_prior.hpp>
+#include "non_std_allocator.hpp"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace boost::multi_index;
+
+struct employee
+{
+  employee(int id_,const std::string& name_,int age_):
+    id(id_),name(name_),age(age_){}
+
+  bool operator==(const employee& x)const
+  {
+    return id==x.id&&name==x.name&&age==x.age;
+  }
+
+  bool operator<(const employee& x)const{return id<x.id;}
+
+  int         id;
+  std::string name;
+  int         age;
+};
+
+struct name{};
+struct age{};
+
+typedef multi_index_container<
+  employee,
+  indexed_by<
+    ordered_btree_unique<member<employee,int,&employee::id> >,
+    ordered_btree_non_unique<
+      tag<name>,member<employee,std::string,&employee::name> >,
+    ordered_btree_non_unique<
+      tag<age>,member<employee,int,&employee::age>,std::greater<int> >,
+    sequenced<>
+  >
+> employee_set;
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    ordered_btree_non_unique<identity<int> >,
+    sequenced<>
+  >
+> int_multiset;
+
+typedef multi_index_container<
+  std::string,
+  indexed_by<
+    ordered_btree_unique<identity<std::string> >
+  >,
+  non_std_allocator<std::string>
+> string_set;
+
+/* Deterministic pseudorandom numbers, so that failures are reproducible */
+
+struct lcg
+{
+  lcg():n(12345u){}
+
+  int operator()(int m)
+  {
+    n=n*1103515245u+12345u;
+    return static_cast<int>((n>>8)%static_cast<unsigned int>(m));
+  }
+
+  unsigned int n;
+};
+
+template<typename Index,typename Set>
+void check_against(const Index& i,const Set& s)
+{
+  BOOST_TEST(i.size()==s.size());
+  BOOST_TEST((std::size_t)std::distance(i.begin(),i.end())==s.size());
+  BOOST_TEST(std::equal(i.begin(),i.end(),s.begin()));
+  BOOST_TEST(std::equal(i.rbegin(),i.rend(),s.rbegin()));
+}
+
+struct assign_value
+{
+  assign_value(int n_):n(n_){}
+  void operator()(int& x)const{x=n;}
+  int n;
+};
+
+struct assign_id
+{
+  assign_id(int n_):n(n_){}
+  void operator()(employee& e)const{e.id=n;}
+  int n;
+};
+
+struct assign_name
+{
+  assign_name(const std::string& n_):n(n_){}
+  void operator()(employee& e)const{e.name=n;}
+  std::string n;
+};
+
+/* bounders for range() */
+
+struct at_least
+{
+  at_least(int n_):n(n_){}
+  bool operator()(int x)const{return n<=x;}
+  int n;
+};
+
+struct greater_than
+{
+  greater_than(int n_):n(n_){}
+  bool operator()(int x)const{return n<x;}
+  int n;
+};
+
+struct at_most
+{
+  at_most(int n_):n(n_){}
+  bool operator()(int x)const{return x<=n;}
+  int n;
+};
+
+struct less_than
+{
+  less_than(int n_):n(n_){}
+  bool operator()(int x)const{return x<n;}
+  int n;
+};
+
+template<typename Iterator>
+bool is_ascending(Iterator first,Iterator last)
+{
+  typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+  return std::adjacent_find(first,last,std::greater<value_type>())==last;
+}
+
+static std::string name_of(int n)
+{
+  std::string s;
+  do{
+    s+=static_cast<char>('a'+n%26);
+    n/=26;
+  }while(n);
+  return s;
+}
+
+static void test_random_ops()
+{
+  lcg                rnd;
+  int_multiset       c;
+  std::multiset<int> s;
+
+  for(int i=0;i<10000;++i){
+    int x=rnd(5000);
+    switch(rnd(8)){
+      case 0:case 1:case 2:
+        c.insert(x);
+        s.insert(x);
+        break;
+      case 3:{ /* hinted insertion, good hint or not */
+        int_multiset::iterator it=c.lower_bound(rnd(5000));
+        c.insert(it,x);
+        s.insert(x);
+        break;
+      }
+      case 4:
+        BOOST_TEST(c.erase(x)==s.erase(x));
+        break;
+      case 5:
+        if(!c.empty()){
+          int_multiset::iterator it=c.find(x);
+          if(it!=c.end()){
+            c.erase(it);
+            s.erase(s.find(x));
+          }
+        }
+        break;
+      case 6:{
+        int_multiset::iterator it=c.find(x);
+        if(it!=c.end()){
+          int y=rnd(5000);
+          BOOST_TEST(c.modify(it,assign_value(y)));
+          BOOST_TEST(*it==y);
+          s.erase(s.find(x));
+          s.insert(y);
+        }
+        break;
+      }
+      default:{
+        int_multiset::iterator it=c.find(x);
+        if(it!=c.end()){
+          int y=rnd(5000);
+          BOOST_TEST(c.replace(it,y));
+          s.erase(s.find(x));
+          s.insert(y);
+        }
+        break;
+      }
+    }
+    if(i%1000==0)check_against(c,s);
+  }
+  check_against(c,s);
+
+  for(int x=-1;x<=5000;++x){
+    BOOST_TEST(c.count(x)==s.count(x));
+    BOOST_TEST(
+      std::distance(c.begin(),c.lower_bound(x))==
+      std::distance(s.begin(),s.lower_bound(x)));
+    BOOST_TEST(
+      std::distance(c.begin(),c.upper_bound(x))==
+      std::distance(s.begin(),s.upper_bound(x)));
+    std::pair<int_multiset::iterator,int_multiset::iterator> p=
+      c.equal_range(x);
+    BOOST_TEST(p.first==c.lower_bound(x)&&p.second==c.upper_bound(x));
+  }
+
+  /* erasure down to empty, sweeping from both ends */
+
+  while(!c.empty()){
+    c.erase(c.begin());
+    s.erase(s.begin());
+    if(!c.empty()){
+      c.erase(boost::prior(c.end()));
+      s.erase(boost::prior(s.end()));
+    }
+    if(c.size()%997==0)check_against(c,s);
+  }
+  check_against(c,s);
+}
+
+static void test_hinted_insertion()
+{
+  int_multiset c;
+  for(int i=0;i<10000;++i)c.insert(c.end(),i);
+  for(int i=-1;i>-10000;--i)c.insert(c.begin(),i);
+  BOOST_TEST(c.size()==19999);
+  int n=-9999;
+  for(int_multiset::iterator it=c.begin();it!=c.end();++it){
+    BOOST_TEST(*it==n++);
+  }
+
+  /* hints in the middle, both right and wrong */
+
+  int_multiset::iterator it=c.find(5000);
+  c.insert(it,5000);
+  c.insert(it,4999);
+  c.insert(it,-5000);
+  BOOST_TEST(c.count(5000)==2&&c.count(4999)==2&&c.count(-5000)==2);
+  BOOST_TEST(is_ascending(c.begin(),c.end()));
+
+  std::vector<int> v;
+  for(int i=0;i<10000;++i)v.push_back(i*3%10000);
+  int_multiset d;
+  d.insert(v.begin(),v.end());
+  BOOST_TEST(d.size()==10000);
+  BOOST_TEST(is_ascending(d.begin(),d.end()));
+}
+
+static void test_range()
+{
+  int_multiset c;
+  for(int i=0;i<1000;++i)c.insert(i/2);
+
+  std::pair<int_multiset::iterator,int_multiset::iterator> p=
+    c.range(at_least(10),less_than(20));
+  BOOST_TEST(p.first==c.lower_bound(10)&&p.second==c.lower_bound(20));
+  p=c.range(unbounded,at_most(20));
+  BOOST_TEST(p.first==c.begin()&&p.second==c.upper_bound(20));
+  p=c.range(greater_than(498),unbounded);
+  BOOST_TEST(p.first==c.lower_bound(499)&&p.second==c.end());
+  p=c.range(unbounded,unbounded);
+  BOOST_TEST(p.first==c.begin()&&p.second==c.end());
+  p=c.range(greater_than(30),less_than(30));
+  BOOST_TEST(p.first==p.second);
+  p=c.range(at_least(1000),less_than(2000));
+  BOOST_TEST(p.first==c.end()&&p.second==c.end());
+}
+
+static void test_employees()
+{
+  employee_set es;
+  for(int i=0;i<2000;++i){
+    BOOST_TEST(es.insert(employee(i,name_of(i%500),20+i%45)).second);
+  }
+  BOOST_TEST(!es.insert(employee(7,"Joe",31)).second);
+  BOOST_TEST(es.size()==2000);
+
+  employee_set::index<name>::type& ni=es.get<name>();
+  employee_set::index<age>::type&  ai=es.get<age>();
+  BOOST_TEST(ni.count(name_of(3))==4);
+  BOOST_TEST(ai.count(20)==45&&ai.count(19)==0);
+  BOOST_TEST(ai.begin()->age==64);
+  BOOST_TEST(std::distance(ai.lower_bound(30),ai.end())==11*45);
+
+  /* non-in-place modification on each index */
+
+  BOOST_TEST(es.modify(es.find(3),assign_id(5000)));
+  BOOST_TEST(es.count(3)==0&&es.find(5000)->name==name_of(3));
+  BOOST_TEST(boost::prior(es.end())->id==5000);
+  BOOST_TEST(ni.modify(ni.find(name_of(4)),assign_name("zzzzz")));
+  BOOST_TEST(ni.count(name_of(4))==3&&boost::prior(ni.end())->name=="zzzzz");
+
+  /* failed modification rolled back: position and key are kept */
+
+  employee_set::iterator it=es.find(5000);
+  BOOST_TEST(!es.modify(it,assign_id(10),assign_id(5000)));
+  BOOST_TEST(es.size()==2000&&it->id==5000&&es.count(5000)==1);
+  BOOST_TEST(boost::prior(es.end())==it);
+  BOOST_TEST(es.count(10)==1);
+
+  /* failed modification without rollback erases the element */
+
+  BOOST_TEST(!es.modify(es.find(5000),assign_id(10)));
+  BOOST_TEST(es.size()==1999&&ni.count(name_of(3))==3);
+
+  BOOST_TEST(!es.replace(es.find(11),employee(12,"Joe",31)));
+  BOOST_TEST(es.find(11)->name==name_of(11));
+  BOOST_TEST(es.replace(es.find(11),employee(-1,"Joe",31)));
+  BOOST_TEST(es.begin()->id==-1&&ni.find(std::string("Joe"))->id==-1);
+
+  employee_set es2(es);
+  BOOST_TEST(es2==es);
+  BOOST_TEST(es2.get<name>()==ni&&es2.get<age>()==ai);
+  es2.erase(es2.begin(),es2.find(1000));
+  BOOST_TEST(es2.size()==1000&&es2.begin()->id==1000);
+
+  es2.swap(es);
+  BOOST_TEST(es.size()==1000&&es2.size()==1999);
+  BOOST_TEST(ni.size()==1000&&ni.count(std::string("Joe"))==0);
+
+  employee_set es3;
+  es3=es2;
+  BOOST_TEST(es3==es2);
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+  employee_set es4(boost::move(es3));
+  BOOST_TEST(es4==es2&&es3.empty());
+  es3=boost::move(es4);
+  BOOST_TEST(es3==es2&&es4.empty());
+#endif
+
+  employee_set::node_type nh=es3.extract(500);
+  BOOST_TEST(es3.count(500)==0);
+  nh.value().id=-500;
+  BOOST_TEST(es3.insert(boost::move(nh)).inserted);
+  BOOST_TEST(es3.begin()->id==-500);
+
+  ai.erase(30);
+  BOOST_TEST(ai.count(30)==0);
+  es3.clear();
+  BOOST_TEST(es3.empty()&&es3.get<name>().begin()==es3.get<name>().end());
+  es3.insert(employee(0,"Joe",31));
+  BOOST_TEST(es3.size()==1&&es3.get<age>().find(31)->id==0);
+}
+
+static void test_uncached_keys()
+{
+  string_set ss;
+  for(int i=0;i<3000;++i)ss.insert(name_of(i*7));
+  BOOST_TEST(ss.size()==3000);
+  BOOST_TEST(is_ascending(ss.begin(),ss.end()));
+  for(int i=0;i<3000;++i){
+    BOOST_TEST(ss.count(name_of(i*7))==1);
+  }
+  for(int i=0;i<3000;i+=3)ss.erase(name_of(i*7));
+  BOOST_TEST(ss.size()==2000);
+  BOOST_TEST(ss.find(name_of(0))==ss.end());
+
+  string_set ss2(ss);
+  BOOST_TEST(ss2==ss);
+  ss2.clear();
+  BOOST_TEST(ss2.empty()&&ss2!=ss);
+}
+
+void test_btree_index()
+{
+  test_random_ops();
+  test_hinted_insertion();
+  test_range();
+  test_employees();
+  test_uncached_keys();
+}
@@ -0,0 +1,18 @@
+/* Boost.MultiIndex test for B+tree ordered indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include <boost/detail/lightweight_test.hpp>
+#include "test_btree_index.hpp"
+
+int main()
+{
+  test_btree_index();
+  return boost::report_errors();
+}
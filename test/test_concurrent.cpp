@@ -0,0 +1,279 @@
+/* Boost.MultiIndex test for concurrent_multi_index_container.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_concurrent.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <boost/detail/lightweight_test.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_MUTEX)&&\
+    !defined(BOOST_NO_CXX11_HDR_ATOMIC)&&\
+    !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+#include "pre_multi_index.hpp"
+#include <boost/multi_index/concurrent_multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)
+#include <thread>
+#endif
+
+using namespace boost::multi_index;
+
+struct employee
+{
+  employee(int id_,const std::string& name_,int age_):
+    id(id_),name(name_),age(age_){}
+
+  bool operator==(const employee& x)const
+  {
+    return id==x.id&&name==x.name&&age==x.age;
+  }
+
+  int         id;
+  std::string name;
+  int         age;
+};
+
+typedef concurrent_multi_index_container<
+  employee,
+  indexed_by<
+    hashed_unique<member<employee,int,&employee::id> >,
+    hashed_unique<member<employee,std::string,&employee::name> >,
+    hashed_non_unique<member<employee,int,&employee::age> >
+  >
+> employee_set;
+
+struct pair_key
+{
+  pair_key(int first_,int second_):first(first_),second(second_){}
+
+  int first;
+  int second;
+};
+
+typedef concurrent_multi_index_container<
+  pair_key,
+  indexed_by<
+    hashed_unique<member<pair_key,int,&pair_key::first> >,
+    hashed_unique<member<pair_key,int,&pair_key::second> >
+  >
+> pair_set;
+
+template<typename Value>
+struct collect
+{
+  collect(std::vector<Value>& v_):v(&v_){}
+  void operator()(const Value& x)const{v->push_back(x);}
+
+  std::vector<Value>* v;
+};
+
+/* every element is reachable through each index and visited once */
+
+static void check_employees(const employee_set& es)
+{
+  std::vector<employee> v;
+  es.visit_all(collect<employee>(v));
+  BOOST_TEST(v.size()==es.size());
+  for(std::size_t i=0;i<v.size();++i){
+    BOOST_TEST(es.count<0>(v[i].id)==1);
+    BOOST_TEST(es.count<1>(v[i].name)==1);
+    BOOST_TEST(es.count<2>(v[i].age)>=1);
+  }
+}
+
+static void check_pairs(const pair_set& ps)
+{
+  std::vector<pair_key> v;
+  ps.visit_all(collect<pair_key>(v));
+  BOOST_TEST(v.size()==ps.size());
+  for(std::size_t i=0;i<v.size();++i){
+    BOOST_TEST(ps.count<0>(v[i].first)==1);
+    BOOST_TEST(ps.count<1>(v[i].second)==1);
+  }
+}
+
+static std::string name_of(int n)
+{
+  std::string s("employee");
+  for(;n;n/=10)s+=static_cast<char>('0'+n%10);
+  return s;
+}
+
+static void test_single_thread()
+{
+  employee_set es(0,4);
+  BOOST_TEST(es.empty());
+  BOOST_TEST(es.stripe_count()==4);
+  BOOST_TEST(es.max_load_factor()==1.0f);
+
+  BOOST_TEST(es.insert(employee(0,"Joe",31)));
+  BOOST_TEST(es.insert(employee(1,"Robert",27)));
+  BOOST_TEST(es.insert(employee(2,"John",40)));
+  BOOST_TEST(!es.insert(employee(0,"Albert",20)));   /* dup id */
+  BOOST_TEST(!es.insert(employee(3,"Joe",20)));      /* dup name */
+  BOOST_TEST(es.insert(employee(3,"Albert",31)));    /* dup age is OK */
+  BOOST_TEST(es.size()==4);
+  check_employees(es);
+
+  employee e(-1,"",-1);
+  BOOST_TEST(es.find<1>(std::string("Robert"),e));
+  BOOST_TEST(e==employee(1,"Robert",27));
+  BOOST_TEST(!es.find<0>(5,e));
+  BOOST_TEST(es.contains<0>(2));
+  BOOST_TEST(!es.contains<1>(std::string("Anna")));
+  BOOST_TEST(es.count<2>(31)==2);
+
+  std::vector<employee> v;
+  BOOST_TEST(es.visit<2>(31,collect<employee>(v))==2);
+  BOOST_TEST(v.size()==2);
+
+  BOOST_TEST(es.erase<1>(std::string("Joe"))==1);
+  BOOST_TEST(es.erase<1>(std::string("Joe"))==0);
+  BOOST_TEST(!es.contains<0>(0));
+  BOOST_TEST(es.count<2>(31)==1);
+  BOOST_TEST(es.size()==3);
+  check_employees(es);
+
+  for(int i=4;i<2000;++i)es.insert(employee(i,name_of(i),i%50));
+  BOOST_TEST(es.size()==1999);
+  BOOST_TEST(es.bucket_count()>=1999);
+  check_employees(es);
+
+  BOOST_TEST(es.erase<2>(10)==40);
+  BOOST_TEST(es.count<2>(10)==0);
+  BOOST_TEST(es.size()==1959);
+  check_employees(es);
+
+  std::size_t bc=es.bucket_count();
+  es.rehash(4*bc);
+  BOOST_TEST(es.bucket_count()>=4*bc);
+  check_employees(es);
+  es.max_load_factor(0.25f);
+  BOOST_TEST(es.max_load_factor()==0.25f);
+  BOOST_TEST(es.size()<=0.25f*es.bucket_count());
+  check_employees(es);
+  es.rehash(0);
+  BOOST_TEST(es.size()<=0.25f*es.bucket_count());
+  check_employees(es);
+
+  es.clear();
+  BOOST_TEST(es.empty());
+  BOOST_TEST(!es.contains<0>(1));
+  BOOST_TEST(es.insert(employee(1,"Robert",27)));
+  check_employees(es);
+
+  pair_set ps;
+  BOOST_TEST(ps.insert(pair_key(0,0)));
+  BOOST_TEST(ps.insert(pair_key(1,2)));
+  BOOST_TEST(ps.insert(pair_key(2,1)));
+  BOOST_TEST(!ps.insert(pair_key(3,1)));
+  BOOST_TEST(ps.erase<1>(2)==1);
+  BOOST_TEST(ps.erase<0>(1)==0);
+  BOOST_TEST(ps.size()==2);
+  check_pairs(ps);
+}
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)
+static const int num_threads=8;
+static const int per_thread=2000;
+
+/* Thread t inserts keys t,t+num_threads,..., then erases the odd ones
+ * through the second index while looking up keys of all threads. The
+ * second key is a permutation of the first, so that the stripes locked
+ * on both indices differ.
+ */
+
+struct insert_erase_lookup
+{
+  insert_erase_lookup(pair_set& ps_,int t_):ps(&ps_),t(t_){}
+
+  void operator()()const
+  {
+    const int n=num_threads*per_thread;
+    for(int i=t;i<n;i+=num_threads)ps->insert(pair_key(i,(i*7919)%n));
+    for(int i=t;i<n;i+=num_threads){
+      if(i%2)ps->erase<1>((i*7919)%n);
+      ps->count<0>((i*31)%n);
+    }
+  }
+
+  pair_set* ps;
+  int       t;
+};
+
+/* all threads race to insert the same keys */
+
+struct insert_same
+{
+  insert_same(pair_set& ps_,std::size_t& inserted_):
+    ps(&ps_),inserted(&inserted_){}
+
+  void operator()()const
+  {
+    for(int i=0;i<per_thread;++i){
+      if(ps->insert(pair_key(i,per_thread-i)))++*inserted;
+    }
+  }
+
+  pair_set*    ps;
+  std::size_t* inserted;
+};
+
+static void test_multiple_threads()
+{
+  {
+    pair_set                 ps(0,4);
+    std::vector<std::thread> threads;
+    for(int t=0;t<num_threads;++t){
+      threads.push_back(std::thread(insert_erase_lookup(ps,t)));
+    }
+    for(int t=0;t<num_threads;++t)threads[t].join();
+
+    BOOST_TEST(ps.size()==(std::size_t)num_threads*per_thread/2);
+    for(int i=0;i<num_threads*per_thread;++i){
+      BOOST_TEST(ps.count<0>(i)==(i%2?0u:1u));
+    }
+    check_pairs(ps);
+  }
+  {
+    pair_set                 ps;
+    std::vector<std::size_t> inserted(num_threads,0);
+    std::vector<std::thread> threads;
+    for(int t=0;t<num_threads;++t){
+      threads.push_back(std::thread(insert_same(ps,inserted[t])));
+    }
+    for(int t=0;t<num_threads;++t)threads[t].join();
+
+    std::size_t total=0;
+    for(int t=0;t<num_threads;++t)total+=inserted[t];
+    BOOST_TEST(total==(std::size_t)per_thread);
+    BOOST_TEST(ps.size()==(std::size_t)per_thread);
+    check_pairs(ps);
+  }
+}
+#else
+static void test_multiple_threads(){}
+#endif
+
+void test_concurrent()
+{
+  test_single_thread();
+  test_multiple_threads();
+}
+#else
+void test_concurrent(){}
+#endif
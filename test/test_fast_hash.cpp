@@ -0,0 +1,199 @@
+/* Boost.MultiIndex test for fast_hash.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_fast_hash.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/detail/lightweight_test.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/fast_hash.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <climits>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace boost::multi_index;
+
+enum colour{red,green,blue};
+
+struct record
+{
+  record(int id_,const std::string& name_):id(id_),name(name_){}
+
+  int         id;
+  std::string name;
+};
+
+static std::size_t bit_count(std::size_t x)
+{
+  std::size_t n=0;
+  for(;x;x&=x-1)++n;
+  return n;
+}
+
+/* byte sequences of all lengths up to some distance beyond the stripe
+ * threshold, so that every code path is exercised
+ */
+
+static std::string make_string(std::size_t n,unsigned int seed)
+{
+  std::string s(n,'\0');
+  for(std::size_t i=0;i<n;++i){
+    s[i]=static_cast<char>((i*31+seed*7+(i>>3))&0xFF);
+  }
+  return s;
+}
+
+static void test_strings()
+{
+  fast_hash<std::string> h;
+
+  for(std::size_t n=0;n<=1200;++n){
+    std::string s=make_string(n,(unsigned int)n),t(s.begin(),s.end());
+    BOOST_TEST(h(s)==h(t));
+    if(n>0){
+      t[0]=static_cast<char>(t[0]^1);
+      BOOST_TEST(h(s)!=h(t));
+      t[0]=s[0];
+      t[n-1]=static_cast<char>(t[n-1]^0x80);
+      BOOST_TEST(h(s)!=h(t));
+      t[n-1]=s[n-1];
+      t[n/2]=static_cast<char>(t[n/2]+1);
+      BOOST_TEST(h(s)!=h(t));
+    }
+    BOOST_TEST(h(s)!=h(s+'\0'));
+  }
+
+  std::wstring ws(L"multi_index");
+  BOOST_TEST(fast_hash<std::wstring>()(ws)==
+             fast_hash<std::wstring>()(std::wstring(ws)));
+  BOOST_TEST(fast_hash<std::wstring>()(ws)!=
+             fast_hash<std::wstring>()(ws+L'!'));
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+  std::string s=make_string(300,1);
+  BOOST_TEST(fast_hash<std::string_view>()(s)==h(s));
+  BOOST_TEST(fast_hash<std::string_view>()("abc")==h("abc"));
+#endif
+}
+
+static void test_integers()
+{
+  fast_hash<int>          hi;
+  fast_hash<unsigned int> hu;
+  fast_hash<colour>       hc;
+
+  BOOST_TEST(hi(12345)==hi(12345));
+  BOOST_TEST(hu(12345u)==hi(12345));
+  BOOST_TEST(hc(green)!=hc(blue));
+  BOOST_TEST(fast_hash<double>()(1.5)==fast_hash<double>()(1.5));
+  BOOST_TEST(fast_hash<double>()(1.5)!=fast_hash<double>()(2.5));
+
+  /* distinct integers keep distinct hash values */
+
+  if(sizeof(std::size_t)*CHAR_BIT>=64){
+    std::vector<std::size_t> v;
+    for(int i=-1000;i<10000;++i)v.push_back(hi(i));
+    std::sort(v.begin(),v.end());
+    BOOST_TEST(std::adjacent_find(v.begin(),v.end())==v.end());
+  }
+
+  /* flipping any input bit flips about half the output bits */
+
+  const std::size_t samples=200,
+                    width=sizeof(std::size_t)*CHAR_BIT;
+  for(std::size_t b=0;b<sizeof(unsigned int)*CHAR_BIT;++b){
+    std::size_t flips=0;
+    for(unsigned int i=0;i<samples;++i){
+      unsigned int x=i*0x9E3779B1u;
+      flips+=bit_count(hu(x)^hu(x^(1u<<b)));
+    }
+    BOOST_TEST(flips*10>samples*width*4);
+    BOOST_TEST(flips*10<samples*width*6);
+  }
+}
+
+static void test_indices()
+{
+  typedef multi_index_container<
+    std::string,
+    indexed_by<
+      hashed_unique<identity<std::string>,fast_hash<std::string> >
+    >
+  > string_set;
+
+  string_set ss;
+  for(std::size_t n=0;n<600;++n)ss.insert(make_string(n,3));
+  BOOST_TEST(ss.size()==600);
+  for(std::size_t n=0;n<600;++n){
+    BOOST_TEST(ss.count(make_string(n,3))==1);
+    BOOST_TEST(n==0||ss.count(make_string(n,4))==0);
+  }
+
+  /* keys multiple of a power of two spread over power-of-two buckets */
+
+  typedef multi_index_container<
+    unsigned int,
+    indexed_by<
+      hashed_unique<
+        identity<unsigned int>,fast_hash<unsigned int>,
+        std::equal_to<unsigned int>,power_2_buckets<>
+      >
+    >
+  > int_set;
+
+  int_set is;
+  for(unsigned int i=0;i<4096;++i)is.insert(i<<12);
+  BOOST_TEST(is.bucket_count()>=4096);
+  BOOST_TEST(is.stats().max_chain_length<16);
+  BOOST_TEST(is.stats().empty_bucket_count<is.bucket_count()/2);
+  for(unsigned int i=0;i<4096;++i)BOOST_TEST(is.count(i<<12)==1);
+
+  /* composite keys are hashed through composite_key_hash */
+
+  typedef composite_key<
+    record,
+    member<record,int,&record::id>,
+    member<record,std::string,&record::name>
+  >                                                 record_key;
+  typedef multi_index_container<
+    record,
+    indexed_by<
+      hashed_unique<
+        record_key,
+        composite_key_hash<fast_hash<int>,fast_hash<std::string> >
+      >
+    >
+  > record_set;
+
+  record_set rs;
+  rs.insert(record(1,"Joe"));
+  rs.insert(record(1,"Jane"));
+  rs.insert(record(2,"Joe"));
+  BOOST_TEST(!rs.insert(record(1,"Joe")).second);
+  BOOST_TEST(rs.size()==3);
+  BOOST_TEST(rs.count(boost::make_tuple(1,std::string("Jane")))==1);
+  BOOST_TEST(rs.count(boost::make_tuple(2,std::string("Jane")))==0);
+  BOOST_TEST(rs.find(boost::make_tuple(2,std::string("Joe")))->id==2);
+}
+
+void test_fast_hash()
+{
+  test_strings();
+  test_integers();
+  test_indices();
+}
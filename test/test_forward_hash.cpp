@@ -0,0 +1,269 @@
+/* Boost.MultiIndex test for forward hashed indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_forward_hash.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <boost/detail/lightweight_test.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_forward_index.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include "non_std_allocator.hpp"
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace boost::multi_index;
+
+struct employee
+{
+  employee(int id_,const std::string& name_,int age_):
+    id(id_),name(name_),age(age_){}
+
+  bool operator==(const employee& x)const
+  {
+    return id==x.id&&name==x.name&&age==x.age;
+  }
+
+  int         id;
+  std::string name;
+  int         age;
+};
+
+struct name{};
+
+typedef multi_index_container<
+  employee,
+  indexed_by<
+    hashed_forward_unique<member<employee,int,&employee::id> >,
+    hashed_forward_unique<
+      tag<name>,member<employee,std::string,&employee::name> >,
+    ordered_non_unique<member<employee,int,&employee::age> >,
+    sequenced<>
+  >
+> employee_set;
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_forward_unique<identity<int> >,
+    sequenced<>
+  >
+> int_set;
+
+/* nodes keep the bucket-ending mark apart from a non-raw next pointer */
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_forward_unique<identity<int> >
+  >,
+  non_std_allocator<int>
+> non_raw_int_set;
+
+/* all elements share the same bucket */
+
+struct constant_hash
+{
+  std::size_t operator()(int)const{return 0;}
+};
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_forward_unique<identity<int>,constant_hash>
+  >
+> colliding_set;
+
+template<typename Container>
+void check_forward_hash(
+  const Container& c,int first,int last,int stride)
+{
+  std::size_t n=0;
+  for(int i=first;i<last;i+=stride,++n){
+    BOOST_TEST(c.count(i)==1);
+    BOOST_TEST(c.find(i)!=c.end()&&*c.find(i)==i);
+    BOOST_TEST(c.find(i+stride/2)==c.end()||stride==1);
+  }
+  BOOST_TEST(c.size()==n);
+  BOOST_TEST((std::size_t)std::distance(c.begin(),c.end())==n);
+  BOOST_TEST(c.load_factor()<=c.max_load_factor());
+
+  std::size_t m=0;
+  for(std::size_t b=0;b<c.bucket_count();++b)m+=c.bucket_size(b);
+  BOOST_TEST(m==n);
+
+  std::vector<int> v(c.begin(),c.end());
+  std::sort(v.begin(),v.end());
+  BOOST_TEST(std::unique(v.begin(),v.end())==v.end());
+}
+
+struct assign_value
+{
+  assign_value(int n_):n(n_){}
+  void operator()(int& x)const{x=n;}
+  int n;
+};
+
+struct assign_id
+{
+  assign_id(int n_):n(n_){}
+  void operator()(employee& e)const{e.id=n;}
+  int n;
+};
+
+void test_forward_hash()
+{
+  {
+    /* one link per node where the bucket-ending mark fits in the pointer */
+
+    typedef detail::hashed_forward_index_node_impl<
+      std::allocator<char> >                               node_impl;
+    BOOST_TEST(sizeof(node_impl)==sizeof(void*));
+  }
+  {
+    int_set s;
+    for(int i=0;i<10000;++i)s.insert(i*1024);
+    check_forward_hash(s,0,10000*1024,1024);
+    BOOST_TEST(!s.insert(1024).second);
+    BOOST_TEST(*s.insert(1024).first==1024);
+
+    for(int i=0;i<10000;i+=2)BOOST_TEST(s.erase(i*1024)==1);
+    BOOST_TEST(s.erase(0)==0);
+    check_forward_hash(s,1024,10000*1024,2048);
+    BOOST_TEST(get<1>(s).size()==s.size());
+
+    /* steady size with a high turnover of elements */
+
+    int_set t;
+    t.reserve(1000);
+    std::size_t bc=t.bucket_count();
+    for(int i=0;i<1000;++i)t.insert(i);
+    for(int i=1000;i<50000;++i){
+      t.erase(i-1000);
+      t.insert(i);
+    }
+    check_forward_hash(t,49000,50000,1);
+    BOOST_TEST(t.bucket_count()==bc);
+
+    t.rehash(4*bc);
+    BOOST_TEST(t.bucket_count()>=4*bc);
+    check_forward_hash(t,49000,50000,1);
+    t.rehash(0);
+    BOOST_TEST(t.bucket_count()>=4*bc);
+
+    int_set u(s);
+    BOOST_TEST(get<0>(u)==get<0>(s));
+    BOOST_TEST(u.bucket_count()==s.bucket_count());
+    check_forward_hash(u,1024,10000*1024,2048);
+    u.erase(1024);
+    BOOST_TEST(get<0>(u)!=get<0>(s));
+
+    u.swap(t);
+    check_forward_hash(t,3*1024,10000*1024,2048);
+    check_forward_hash(u,49000,50000,1);
+    t.clear();
+    BOOST_TEST(t.empty()&&t.begin()==t.end());
+    t.insert(5);
+    check_forward_hash(t,5,6,1);
+
+    s.max_load_factor(4.0f);
+    s.rehash(0);
+    BOOST_TEST(s.max_load_factor()==4.0f);
+    check_forward_hash(s,1024,10000*1024,2048);
+    s.max_load_factor(0.5f);
+    s.insert(0);
+    BOOST_TEST(s.load_factor()<=0.5f);
+    BOOST_TEST(s.bucket(0)<s.bucket_count());
+    s.erase(s.find(0));
+    BOOST_TEST(s.count(0)==0);
+
+    /* erasure through another index locates the bucket by itself */
+
+    get<1>(s).erase(std::find(get<1>(s).begin(),get<1>(s).end(),3*1024));
+    BOOST_TEST(s.count(3*1024)==0);
+    s.insert(3*1024);
+
+    int_set::node_type nh=s.extract(1024);
+    BOOST_TEST(s.find(1024)==s.end());
+    nh.value()=1;
+    BOOST_TEST(s.insert(boost::move(nh)).inserted);
+    BOOST_TEST(s.count(1)==1);
+  }
+  {
+    non_raw_int_set s;
+    for(int i=0;i<1000;++i)s.insert(i);
+    check_forward_hash(s,0,1000,1);
+    for(int i=0;i<1000;i+=2)s.erase(i);
+    check_forward_hash(s,1,1000,2);
+    BOOST_TEST(s.modify(s.find(1),assign_value(0)));
+    BOOST_TEST(s.count(0)==1&&s.count(1)==0);
+
+    non_raw_int_set t(s);
+    BOOST_TEST(t==s);
+  }
+  {
+    colliding_set cs;
+    for(int i=0;i<300;++i)cs.insert(i);
+    check_forward_hash(cs,0,300,1);
+    BOOST_TEST(cs.find(300)==cs.end());
+    for(int i=1;i<300;i+=2)cs.erase(i);
+    check_forward_hash(cs,0,300,2);
+
+    BOOST_TEST(cs.modify(cs.find(0),assign_value(1)));
+    BOOST_TEST(cs.count(0)==0&&cs.count(1)==1);
+    BOOST_TEST(!cs.modify(cs.find(1),assign_value(2)));
+    BOOST_TEST(cs.count(1)==0&&cs.count(2)==1);
+    BOOST_TEST(cs.size()==149);
+    BOOST_TEST(
+      !cs.modify(cs.find(2),assign_value(4),assign_value(2)));
+    BOOST_TEST(cs.count(2)==1&&cs.size()==149);
+    BOOST_TEST(cs.replace(cs.find(2),1));
+    BOOST_TEST(!cs.replace(cs.find(1),4));
+    BOOST_TEST(cs.erase(1)==1);
+    check_forward_hash(cs,4,300,2);
+  }
+  {
+    employee_set es;
+    es.insert(employee(0,"Joe",31));
+    es.insert(employee(1,"Robert",27));
+    es.insert(employee(2,"John",40));
+    BOOST_TEST(!es.insert(employee(0,"Anna",25)).second);
+    BOOST_TEST(!es.insert(employee(3,"Joe",25)).second);
+    BOOST_TEST(es.size()==3);
+
+    employee_set::index<name>::type& ni=es.get<name>();
+    BOOST_TEST(ni.find(std::string("Robert"))->id==1);
+    BOOST_TEST(
+      !es.replace(es.find(1),employee(1,"John",27)));
+    BOOST_TEST(
+      es.replace(es.find(1),employee(1,"Rob",28)));
+    BOOST_TEST(ni.count(std::string("Robert"))==0);
+    BOOST_TEST(ni.find(std::string("Rob"))->age==28);
+
+    BOOST_TEST(es.modify(es.find(2),assign_id(20)));
+    BOOST_TEST(es.count(2)==0&&es.find(20)->name=="John");
+    BOOST_TEST(
+      !es.modify(es.find(20),assign_id(0),assign_id(20)));
+    BOOST_TEST(es.find(20)->name=="John"&&es.size()==3);
+    BOOST_TEST(!es.modify(es.find(20),assign_id(1)));
+    BOOST_TEST(es.size()==2&&ni.count(std::string("John"))==0);
+    BOOST_TEST(es.get<2>().size()==2&&es.get<3>().size()==2);
+
+    BOOST_TEST(ni.erase(std::string("Joe"))==1);
+    BOOST_TEST(es.size()==1&&es.begin()->name=="Rob");
+  }
+}
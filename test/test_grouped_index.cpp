@@ -0,0 +1,323 @@
+/* Boost.MultiIndex test for grouped ordered indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_grouped_index.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <boost/detail/lightweight_test.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_grouped_index.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+
+using namespace boost::multi_index;
+
+struct record
+{
+  record(int id_,int status_):id(id_),status(status_){}
+
+  int id;
+  int status;
+};
+
+struct set_status
+{
+  set_status(int status_):status(status_){}
+  void operator()(record& r)const{r.status=status;}
+  int status;
+};
+
+struct set_id
+{
+  set_id(int id_):id(id_){}
+  void operator()(record& r)const{r.id=id;}
+  int id;
+};
+
+struct set_id_status
+{
+  set_id_status(int id_,int status_):id(id_),status(status_){}
+  void operator()(record& r)const{r.id=id;r.status=status;}
+  int id,status;
+};
+
+/* orders statuses by their tens, coarser than std::less<int> */
+
+struct tens_less
+{
+  bool operator()(int x,int y)const{return x/10<y/10;}
+};
+
+struct not_below
+{
+  not_below(int k_):k(k_){}
+  bool operator()(int x)const{return k<=x;}
+  int k;
+};
+
+struct below
+{
+  below(int k_):k(k_){}
+  bool operator()(int x)const{return x<k;}
+  int k;
+};
+
+struct by_status{};
+struct by_id{};
+
+typedef multi_index_container<
+  record,
+  indexed_by<
+    ordered_grouped_non_unique<
+      tag<by_status>,member<record,int,&record::status> >,
+    ordered_non_unique<member<record,int,&record::status> >,
+    ordered_unique<tag<by_id>,member<record,int,&record::id> >
+  >
+> record_set;
+
+/* both indices sort equivalent elements by insertion order */
+
+static bool same_order(const record_set& rs)
+{
+  const record_set::nth_index<0>::type& g=rs.get<0>();
+  const record_set::nth_index<1>::type& o=rs.get<1>();
+
+  record_set::nth_index<0>::type::iterator it=g.begin();
+  record_set::nth_index<1>::type::iterator it2=o.begin();
+  for(;it!=g.end();++it,++it2){
+    if(it2==o.end()||&*it!=&*it2)return false;
+  }
+  if(it2!=o.end())return false;
+
+  for(it=g.end(),it2=o.end();it!=g.begin();){
+    if(&*--it!=&*--it2)return false;
+  }
+  return true;
+}
+
+template<typename Iterator1,typename Iterator2>
+static bool same_position(
+  Iterator1 it,const Iterator1& end,Iterator2 it2,const Iterator2& end2)
+{
+  if(it==end||it2==end2)return it==end&&it2==end2;
+  return &*it==&*it2;
+}
+
+static bool same_lookups(const record_set& rs,int k)
+{
+  const record_set::nth_index<0>::type& g=rs.get<0>();
+  const record_set::nth_index<1>::type& o=rs.get<1>();
+
+  if(!same_position(g.find(k),g.end(),o.find(k),o.end()))return false;
+  if(g.count(k)!=o.count(k))return false;
+  if(!same_position(
+    g.lower_bound(k),g.end(),o.lower_bound(k),o.end()))return false;
+  if(!same_position(
+    g.upper_bound(k),g.end(),o.upper_bound(k),o.end()))return false;
+  if(g.equal_range(k).first!=g.lower_bound(k)||
+     g.equal_range(k).second!=g.upper_bound(k))return false;
+
+  tens_less comp;
+  if(!same_position(
+    g.find(k,comp),g.end(),o.find(k,comp),o.end()))return false;
+  if(g.count(k,comp)!=o.count(k,comp))return false;
+  if(!same_position(
+    g.equal_range(k,comp).first,g.end(),
+    o.equal_range(k,comp).first,o.end()))return false;
+  if(!same_position(
+    g.equal_range(k,comp).second,g.end(),
+    o.equal_range(k,comp).second,o.end()))return false;
+
+  if(!same_position(
+    g.range(not_below(k),below(k+5)).first,g.end(),
+    o.range(not_below(k),below(k+5)).first,o.end()))return false;
+  if(!same_position(
+    g.range(not_below(k),below(k+5)).second,g.end(),
+    o.range(not_below(k),below(k+5)).second,o.end()))return false;
+  if(!same_position(
+    g.range(not_below(k),unbounded).first,g.end(),
+    o.range(not_below(k),unbounded).first,o.end()))return false;
+  return true;
+}
+
+static bool check(const record_set& rs)
+{
+  if(!same_order(rs))return false;
+  for(int k=-2;k<40;++k){
+    if(!same_lookups(rs,k))return false;
+  }
+  return true;
+}
+
+void test_grouped_index()
+{
+  std::srand(1);
+
+  record_set rs;
+  BOOST_TEST(check(rs));
+  for(int i=0;i<1000;++i){
+    rs.insert(record(i,std::rand()%30));
+    if(i%100==0)BOOST_TEST(check(rs));
+  }
+  BOOST_TEST(check(rs));
+  BOOST_TEST(rs.get<by_status>().count(7)==rs.get<1>().count(7));
+
+  /* modify and replace take elements out of their group, whether or not
+   * they succeed; clashes in the unique index restore them in place
+   */
+
+  record_set::index<by_id>::type& ids=rs.get<by_id>();
+  for(int i=0;i<600;++i){
+    record_set::index<by_id>::type::iterator it=ids.find(std::rand()%1000);
+    if(it==ids.end())continue;
+    int status=std::rand()%35;
+    switch(i%6){
+      case 0: ids.modify(it,set_status(status));break;
+      case 1: ids.replace(it,record(it->id,status));break;
+      case 2: ids.replace(it,record(std::rand()%1000,status));break;
+      case 3: ids.modify(
+                it,set_id(std::rand()%1000),set_id(it->id));break;
+      case 4: rs.modify(rs.iterator_to(*it),set_status(status));break;
+      default: ids.erase(it);
+    }
+    if(i%60==0)BOOST_TEST(check(rs));
+  }
+  BOOST_TEST(check(rs));
+
+  {
+    /* a modification clashing in the unique index is rolled back */
+
+    record_set::index<by_id>::type::iterator it=ids.begin(),it2=it;
+    ++it2;
+    int id=it->id,status=it->status;
+    BOOST_TEST(!rs.modify(
+      rs.iterator_to(*it),set_id_status(it2->id,status+3),
+      set_id_status(id,status)));
+    BOOST_TEST(it->id==id&&it->status==status);
+    BOOST_TEST(check(rs));
+  }
+
+  {
+    /* an element alone in its group goes back to where it was */
+
+    record_set s;
+    for(int i=0;i<5;++i)s.insert(record(i,i));
+    record_set::index<by_id>::type::iterator it=s.get<by_id>().find(2);
+    BOOST_TEST(!s.get<by_id>().replace(it,record(0,50)));
+    BOOST_TEST(!s.get<by_id>().modify(
+      it,set_id_status(4,-1),set_id_status(2,2)));
+    BOOST_TEST(it->status==2);
+    BOOST_TEST(check(s));
+    BOOST_TEST(s.get<by_status>().count(2)==1);
+  }
+
+  /* hinted insertion puts elements as close as possible before the hint */
+
+  {
+    record_set hs(rs);
+    record_set::index<by_status>::type& statuses=hs.get<by_status>();
+    record_set::index<by_status>::type::iterator it=statuses.find(5);
+    ++it;
+    BOOST_TEST(it->status==5);
+    record_set::index<by_status>::type::iterator it2=
+      statuses.insert(it,record(2000,5));
+    BOOST_TEST(it2->id==2000);
+    BOOST_TEST(++it2==it);
+    it=statuses.upper_bound(5);
+    it2=statuses.insert(it,record(2001,5));
+    BOOST_TEST(++it2==it);
+    it2=statuses.insert(it,record(2002,6));
+    BOOST_TEST(it2==statuses.find(6));
+    statuses.insert(statuses.end(),record(2003,100));
+    statuses.insert(statuses.begin(),record(2004,-1));
+    statuses.insert(statuses.begin(),record(2005,12));
+    BOOST_TEST(statuses.begin()->id==2004);
+    BOOST_TEST((--statuses.end())->id==2003);
+    BOOST_TEST(statuses.count(5)==rs.get<by_status>().count(5)+2);
+  }
+
+  /* node handles */
+
+  record_set::index<by_status>::type& statuses=rs.get<by_status>();
+  {
+    record_set::index<by_status>::type::node_type nh=statuses.extract(12);
+    BOOST_TEST(!nh.empty());
+    BOOST_TEST(check(rs));
+    statuses.insert(boost::move(nh));
+    BOOST_TEST(check(rs));
+  }
+
+  std::size_t n=statuses.count(7);
+  BOOST_TEST(statuses.erase(7)==n);
+  BOOST_TEST(statuses.count(7)==0);
+  BOOST_TEST(check(rs));
+
+  record_set rs2(rs);
+  BOOST_TEST(check(rs2));
+  BOOST_TEST(rs2.size()==rs.size());
+  rs2.get<by_status>().erase(rs2.get<by_status>().begin());
+  BOOST_TEST(check(rs2));
+
+  rs.swap(rs2);
+  BOOST_TEST(check(rs)&&check(rs2));
+  BOOST_TEST(rs.size()+1==rs2.size());
+
+  rs2=rs;
+  BOOST_TEST(check(rs2));
+
+  rs.clear();
+  BOOST_TEST(check(rs));
+  rs.insert(record(0,3));
+  BOOST_TEST(check(rs));
+
+  typedef multi_index_container<
+    int,
+    indexed_by<ordered_grouped_non_unique<identity<int> > >
+  > int_multiset;
+
+  int_multiset s;
+  for(int i=0;i<10000;++i)s.insert(i%10);
+  BOOST_TEST(s.count(3)==1000);
+  BOOST_TEST(std::distance(s.begin(),s.end())==10000);
+  BOOST_TEST(*s.upper_bound(3)==4);
+  BOOST_TEST(s.erase(4)==1000);
+  BOOST_TEST(*s.upper_bound(3)==5);
+  BOOST_TEST(s.count(4)==0&&s.find(4)==s.end());
+
+  /* copying maps nodes through the grouped index's own position */
+
+  typedef multi_index_container<
+    int,
+    indexed_by<
+      ordered_unique<identity<int> >,
+      ordered_grouped_non_unique<tag<by_status>,identity<int> >
+    >
+  > int_set;
+
+  int_set is;
+  for(int i=0;i<100;++i)is.insert(i);
+  int_set is2(is);
+  BOOST_TEST(is2.size()==is.size());
+  BOOST_TEST(std::equal(
+    is.get<by_status>().begin(),is.get<by_status>().end(),
+    is2.get<by_status>().begin()));
+  is2.erase(50);
+  is=is2;
+  BOOST_TEST(is.size()==99);
+  BOOST_TEST(is.get<by_status>().count(50)==0);
+  BOOST_TEST(std::equal(
+    is.get<by_status>().begin(),is.get<by_status>().end(),
+    is2.get<by_status>().begin()));
+}
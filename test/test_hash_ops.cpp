@@ -1,6 +1,6 @@
 /* Boost.MultiIndex test for standard hash operations.
  *
- * Copyright 2003-2013 Joaquin M Lopez Munoz.
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
  * Distributed under the Boost Software License, Version 1.0.
  * (See accompanying file LICENSE_1_0.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt)
@@ -11,12 +11,20 @@
 #include "test_hash_ops.hpp"
 
 #include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
 #include <iterator>
 #include <boost/detail/lightweight_test.hpp>
 #include "pre_multi_index.hpp"
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/hashed_index_parallel_rehash.hpp>
 #include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <iostream>
@@ -32,6 +40,17 @@ void check_load_factor(const HashedContainer& hc)
   BOOST_TEST(lf<=hc.max_load_factor()+1.E-6);
 }
 
+/* Containers are filled through ranges so that invariant checking, which
+ * is enabled for tests, runs once rather than once per element.
+ */
+
+std::vector<int> int_range(int first,int last)
+{
+  std::vector<int> v;
+  for(int n=first;n<last;++n)v.push_back(n);
+  return v;
+}
+
 typedef multi_index_container<
   int,
   indexed_by<
@@ -39,6 +58,1075 @@ typedef multi_index_container<
   >
 > hash_container;
 
+struct counting_hash
+{
+  std::size_t operator()(int x)const
+  {
+    ++calls;
+    return boost::hash<int>()(x/2); /* forces some collisions */
+  }
+
+  static int calls;
+};
+
+int counting_hash::calls=0;
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_unique<identity<int>,counting_hash>
+  >
+> counted_hash_container;
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_unique<identity<int>,counting_hash,store_hash<> >
+  >
+> counted_stored_hash_container;
+
+/* Number of calls to counting_hash when rehashing a container of n elements
+ * to bc buckets.
+ */
+
+template<typename HashedContainer>
+int rehash_hash_calls(int n,std::size_t bc)
+{
+  HashedContainer hc;
+  for(int i=0;i<n;++i)hc.insert(i);
+  int calls=counting_hash::calls;
+  hc.rehash(bc);
+  return counting_hash::calls-calls;
+}
+
+typedef std::pair<int,std::string> stored_hash_element;
+
+typedef multi_index_container<
+  stored_hash_element,
+  indexed_by<
+    hashed_unique<
+      member<stored_hash_element,int,&stored_hash_element::first>,
+      counting_hash,store_hash<>
+    >,
+    hashed_non_unique<
+      member<stored_hash_element,std::string,&stored_hash_element::second>,
+      hashed_index_options<store_hash<> >
+    >
+  >
+> stored_hash_container;
+
+struct assign_first
+{
+  assign_first(int n_):n(n_){}
+  void operator()(stored_hash_element& x)const{x.first=n;}
+  int n;
+};
+
+struct assign_second
+{
+  assign_second(const std::string& str_):str(str_){}
+  void operator()(stored_hash_element& x)const{x.second=str;}
+  std::string str;
+};
+
+void test_stored_hash()
+{
+  stored_hash_container shc;
+  std::string           strs[]={"a","bb","ccc","dddd","eeeee"};
+
+  for(int n=0;n<1000;++n){
+    shc.insert(stored_hash_element(n,strs[n%5]));
+  }
+  BOOST_TEST(shc.size()==1000);
+  BOOST_TEST(!shc.insert(stored_hash_element(500,"x")).second);
+  BOOST_TEST(shc.get<1>().count("ccc")==200);
+
+  BOOST_TEST(
+    rehash_hash_calls<counted_hash_container>(1000,5000)-
+    rehash_hash_calls<counted_stored_hash_container>(1000,5000)==1000);
+
+  shc.rehash(4*shc.bucket_count());
+  shc.get<1>().rehash(4*shc.get<1>().bucket_count());
+  shc.reserve(10000);
+
+  for(int n=0;n<1000;++n){
+    BOOST_TEST(shc.find(n)!=shc.end()&&shc.find(n)->first==n);
+  }
+  BOOST_TEST(shc.find(1000)==shc.end());
+  BOOST_TEST(shc.get<1>().find("eeeee")->second=="eeeee");
+  BOOST_TEST(shc.get<1>().count(std::string("e"))==0);
+  BOOST_TEST(
+    std::distance(
+      shc.get<1>().equal_range("a").first,
+      shc.get<1>().equal_range("a").second)==200);
+
+  stored_hash_container::iterator it=shc.find(10);
+  BOOST_TEST(shc.modify(it,assign_first(2000)));
+  BOOST_TEST(shc.count(10)==0&&shc.count(2000)==1);
+  BOOST_TEST(!shc.modify(shc.find(11),assign_first(12),assign_first(11)));
+  BOOST_TEST(shc.count(11)==1&&shc.count(12)==1);
+  BOOST_TEST(
+    !shc.modify(shc.find(11),assign_second("bb"),assign_second("bb"))||
+    shc.find(11)->second=="bb");
+  BOOST_TEST(shc.get<1>().modify(
+    shc.get<1>().find("dddd"),assign_second("ffffff")));
+  BOOST_TEST(shc.get<1>().count("ffffff")==1);
+  BOOST_TEST(shc.replace(shc.find(20),stored_hash_element(3000,"a")));
+  BOOST_TEST(shc.count(20)==0&&shc.count(3000)==1);
+  BOOST_TEST(shc.erase(21)==1&&shc.count(21)==0);
+  BOOST_TEST(shc.get<1>().erase("bb")>=199);
+
+  stored_hash_container shc2(shc);
+  BOOST_TEST(shc2==shc);
+  shc2.rehash(8*shc2.bucket_count());
+  BOOST_TEST(shc2==shc);
+}
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_unique<identity<int>,power_2_buckets<> >,
+    hashed_non_unique<
+      identity<int>,
+      hashed_index_options<power_2_buckets<>,store_hash<> >
+    >
+  >
+> pow2_container;
+
+template<typename HashedIndex>
+bool power_of_2_buckets(const HashedIndex& hi)
+{
+  typename HashedIndex::size_type bc=hi.bucket_count();
+  return bc!=0&&(bc&(bc-1))==0;
+}
+
+void test_power_2_buckets()
+{
+  pow2_container pc;
+  BOOST_TEST(power_of_2_buckets(pc));
+  BOOST_TEST(power_of_2_buckets(pc.get<1>()));
+
+  /* keys with zeroed low bits, ill-suited for masking */
+
+  for(int n=0;n<10000;++n)pc.insert(n*1024);
+  BOOST_TEST(pc.size()==10000);
+  BOOST_TEST(power_of_2_buckets(pc));
+  BOOST_TEST(power_of_2_buckets(pc.get<1>()));
+  check_load_factor(pc);
+  check_load_factor(pc.get<1>());
+
+  pow2_container::size_type max_bucket_size=0;
+  for(pow2_container::size_type buc=0;buc<pc.bucket_count();++buc){
+    if(pc.bucket_size(buc)>max_bucket_size){
+      max_bucket_size=pc.bucket_size(buc);
+    }
+  }
+  BOOST_TEST(max_bucket_size<16);
+
+  for(int n=0;n<10000;++n){
+    BOOST_TEST(pc.count(n*1024)==1);
+    BOOST_TEST(pc.get<1>().count(n*1024)==1);
+    BOOST_TEST(pc.bucket(n*1024)<pc.bucket_count());
+  }
+  BOOST_TEST(pc.find(1)==pc.end());
+
+  pow2_container::size_type bc=pc.bucket_count();
+  pc.rehash(bc+1);
+  BOOST_TEST(pc.bucket_count()==2*bc);
+  pc.rehash(0);
+  BOOST_TEST(pc.bucket_count()==2*bc); /* no shrinking */
+  pc.get<1>().reserve(100000);
+  BOOST_TEST(power_of_2_buckets(pc.get<1>()));
+  BOOST_TEST(pc.get<1>().bucket_count()>=100000);
+
+  pow2_container pc2(pc);
+  BOOST_TEST(pc2==pc);
+  BOOST_TEST(pc2.bucket_count()==pc.bucket_count());
+}
+
+struct third
+{
+  typedef int result_type;
+
+  int operator()(int x)const{return x/3;} /* groups of equivalent elements */
+};
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_unique<
+      identity<int>,
+      hashed_index_options<power_2_buckets<>,incremental_rehash<> >
+    >,
+    hashed_non_unique<
+      third,
+      hashed_index_options<power_2_buckets<>,incremental_rehash<> >
+    >
+  >
+> incremental_container;
+
+struct assign_value
+{
+  assign_value(int n_):n(n_){}
+  void operator()(int& x)const{x=n;}
+  int n;
+};
+
+/* Checks that every element is reachable both by lookup and through the
+ * local iterators of its bucket.
+ */
+
+template<typename HashedIndex>
+void check_buckets(const HashedIndex& hi)
+{
+  typedef typename HashedIndex::size_type            size_type;
+  typedef typename HashedIndex::const_local_iterator const_local_iterator;
+
+  size_type s=0;
+  for(size_type buc=0;buc<hi.bucket_count();++buc){
+    size_type bs=0;
+    for(const_local_iterator it=hi.begin(buc),it_end=hi.end(buc);
+        it!=it_end;++it,++bs){
+      BOOST_TEST(hi.bucket(hi.key_extractor()(*it))==buc);
+    }
+    BOOST_TEST(bs==hi.bucket_size(buc));
+    s+=bs;
+  }
+  BOOST_TEST(s==hi.size());
+  BOOST_TEST((size_type)std::distance(hi.begin(),hi.end())==hi.size());
+
+  for(typename HashedIndex::const_iterator it=hi.begin(),it_end=hi.end();
+      it!=it_end;++it){
+    typename HashedIndex::key_type k=hi.key_extractor()(*it);
+    BOOST_TEST(
+      (size_type)std::distance(
+        hi.equal_range(k).first,hi.equal_range(k).second)==hi.count(k));
+    BOOST_TEST(hi.key_extractor()(*hi.find(k))==k);
+  }
+}
+
+typedef std::pair<int,int> keyed_element; /* (key,insertion order) */
+
+typedef multi_index_container<
+  keyed_element,
+  indexed_by<
+    hashed_non_unique<
+      member<keyed_element,int,&keyed_element::first>,
+      hashed_index_options<power_2_buckets<>,incremental_rehash<> >
+    >
+  >
+> incremental_multimap;
+
+/* equivalent elements are inserted at the front of their group */
+
+template<typename HashedIndex>
+bool newest_first(const HashedIndex& hi)
+{
+  for(typename HashedIndex::const_iterator it=hi.begin(),it_end=hi.end();
+      it!=it_end;++it){
+    typename HashedIndex::const_iterator it2=hi.find(it->first),it3=it2;
+    for(++it3;it3!=hi.end()&&it3->first==it->first;it2=it3++){
+      if(it3->second>it2->second)return false;
+    }
+  }
+  return true;
+}
+
+void test_incremental_rehash()
+{
+  incremental_container ic;
+  int                   migrating_inserts=0,bucket_counts=0;
+
+  for(int n=0;n<5000;++n){
+    incremental_container::size_type bc=ic.bucket_count();
+    ic.insert(n);
+    if(ic.bucket_count()!=bc)++bucket_counts;
+    if(!power_of_2_buckets(ic)){ /* old and new arrays coexist */
+      ++migrating_inserts;
+      if(migrating_inserts%16==0){
+        check_buckets(ic);
+        check_buckets(ic.get<1>());
+      }
+    }
+  }
+  BOOST_TEST(migrating_inserts>bucket_counts);
+  BOOST_TEST(ic.size()==5000&&ic.get<1>().count(1000)==3);
+
+  /* migration keeps equivalent elements in their relative order, groups
+   * of two included
+   */
+
+  incremental_multimap im;
+  for(int n=0;n<1500;++n){
+    im.insert(keyed_element(n%500,n));
+    if(!power_of_2_buckets(im)&&n%10==0)BOOST_TEST(newest_first(im));
+  }
+  BOOST_TEST(newest_first(im));
+  check_buckets(im);
+
+  /* bring the first index to the middle of a migration */
+
+  int n=5000;
+  while(power_of_2_buckets(ic))ic.insert(n++);
+  check_buckets(ic);
+  check_load_factor(ic);
+
+  incremental_container ic2(ic);
+  BOOST_TEST(ic2==ic);
+  BOOST_TEST(ic2.bucket_count()==ic.bucket_count());
+  check_buckets(ic2);
+  ic2.insert(-1);
+  check_buckets(ic2);
+  check_buckets(ic2.get<1>());
+
+  incremental_container ic3;
+  ic3.insert(-2);
+  ic3.swap(ic2);
+  BOOST_TEST(ic3.count(-1)==1&&ic2.count(-2)==1&&ic2.size()==1);
+  check_buckets(ic3);
+
+  BOOST_TEST(ic3.erase(-1)==1);
+  BOOST_TEST(ic3==ic);
+  BOOST_TEST(ic3.modify(ic3.find(0),assign_value(-3)));
+  BOOST_TEST(ic3.replace(ic3.find(1),-4));
+  BOOST_TEST(ic3.count(0)==0&&ic3.count(1)==0);
+  BOOST_TEST(ic3.get<1>().count(0)==1&&ic3.get<1>().count(-1)==2);
+  check_buckets(ic3);
+  check_buckets(ic3.get<1>());
+
+  /* erasure does not migrate, so traversal is unaffected */
+
+  std::size_t erased=0;
+  for(incremental_container::iterator it=ic3.begin();it!=ic3.end();){
+    if(*it%2==0){
+      it=ic3.erase(it);
+      ++erased;
+    }
+    else ++it;
+  }
+  BOOST_TEST(ic3.size()==ic.size()-erased);
+  BOOST_TEST(!power_of_2_buckets(ic3));
+  check_buckets(ic3);
+
+  ic3.rehash(0);
+  BOOST_TEST(power_of_2_buckets(ic3));
+  check_buckets(ic3);
+
+  ic.clear();
+  BOOST_TEST(power_of_2_buckets(ic));
+  ic.insert(0);
+  check_buckets(ic);
+}
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_unique<identity<int> >,
+    hashed_non_unique<third>,
+    hashed_non_unique<third,hashed_index_options<store_hash<> > >
+  >
+> parallel_rehash_container;
+
+struct throwing_hash
+{
+  std::size_t operator()(int x)const
+  {
+    if(x==throw_on)throw 0;
+    return boost::hash<int>()(x);
+  }
+
+  static int throw_on;
+};
+
+int throwing_hash::throw_on=-1;
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_unique<identity<int>,throwing_hash>
+  >
+> throwing_hash_container;
+
+template<typename HashedIndex>
+bool same_groups(const HashedIndex& hi1,const HashedIndex& hi2)
+{
+  for(typename HashedIndex::const_iterator it=hi1.begin(),it_end=hi1.end();
+      it!=it_end;++it){
+    typename HashedIndex::key_type k=hi1.key_extractor()(*it);
+    if(!std::equal(
+      hi1.equal_range(k).first,hi1.equal_range(k).second,
+      hi2.equal_range(k).first))return false;
+  }
+  return true;
+}
+
+void test_parallel_rehash()
+{
+  std::vector<int> v;
+  for(int n=0;n<20000;++n)v.push_back((n*7919)%20000);
+  parallel_rehash_container prc(v.begin(),v.end());
+
+  parallel_rehash_container prc2(prc);
+  parallel_rehash(prc2,4*prc2.bucket_count(),4);
+  BOOST_TEST(prc2.bucket_count()>=4*prc.bucket_count());
+  BOOST_TEST(prc2==prc);
+  check_buckets(prc2);
+  check_buckets(prc2.get<1>());
+  check_buckets(prc2.get<2>());
+  check_load_factor(prc2);
+
+  /* equivalent elements keep their relative order */
+
+  BOOST_TEST(same_groups(prc2.get<1>(),prc.get<1>()));
+  BOOST_TEST(same_groups(prc2.get<2>(),prc.get<2>()));
+
+  prc2.get<1>().max_load_factor(0.25f);
+  parallel_rehash(prc2.get<1>(),0);
+  check_load_factor(prc2.get<1>());
+  check_buckets(prc2.get<1>());
+  BOOST_TEST(same_groups(prc2.get<1>(),prc.get<1>()));
+
+  /* small indices fall back to regular rehashing */
+
+  parallel_rehash_container prc3;
+  prc3.insert(0);
+  parallel_rehash(prc3,1000,4);
+  BOOST_TEST(prc3.bucket_count()>=1000);
+  check_buckets(prc3);
+
+  /* a throwing hash leaves the index untouched */
+
+  v=int_range(0,20000);
+  throwing_hash_container thc(v.begin(),v.end());
+  v.assign(thc.begin(),thc.end());
+  throwing_hash_container::size_type bc=thc.bucket_count();
+  throwing_hash::throw_on=12345;
+  try{
+    parallel_rehash(thc,4*bc,4);
+    BOOST_TEST(false);
+  }
+  catch(int){}
+  throwing_hash::throw_on=-1;
+  BOOST_TEST(thc.bucket_count()==bc);
+  BOOST_TEST(std::equal(v.begin(),v.end(),thc.begin()));
+  check_buckets(thc);
+
+  /* pending migrations are completed; growing past 8192 elements starts
+   * one
+   */
+
+  v=int_range(0,8193);
+  incremental_container ic(v.begin(),v.end());
+  int n=8193;
+  while(power_of_2_buckets(ic))ic.insert(n++);
+  parallel_rehash(ic,0,4);
+  BOOST_TEST(power_of_2_buckets(ic));
+  check_buckets(ic);
+  check_buckets(ic.get<1>());
+}
+
+struct string_as_int_hash
+{
+  std::size_t operator()(const std::string& str)const
+  {
+    return boost::hash<int>()(std::atoi(str.c_str()));
+  }
+};
+
+struct string_as_int_equal
+{
+  bool operator()(const std::string& str,int x)const
+  {
+    return std::atoi(str.c_str())==x;
+  }
+};
+
+void test_find_many()
+{
+  parallel_rehash_container prc;
+  for(int n=0;n<1000;++n)prc.insert((n*7919)%1000);
+
+  std::vector<int> keys;
+  for(int n=-100;n<1100;n+=3)keys.push_back(n); /* hits and misses */
+
+  typedef parallel_rehash_container::iterator iterator;
+  std::vector<iterator> its;
+  prc.find_many(keys.begin(),keys.end(),std::back_inserter(its));
+  BOOST_TEST(its.size()==keys.size());
+  for(std::size_t i=0;i<keys.size();++i)BOOST_TEST(its[i]==prc.find(keys[i]));
+
+  std::vector<std::size_t> counts;
+  prc.get<1>().count_many(
+    keys.begin(),keys.end(),std::back_inserter(counts));
+  BOOST_TEST(counts.size()==keys.size());
+  for(std::size_t i=0;i<keys.size();++i){
+    BOOST_TEST(counts[i]==prc.get<1>().count(keys[i]));
+  }
+
+  std::vector<std::size_t> counts2(keys.size());
+  BOOST_TEST(
+    prc.get<2>().count_many(keys.begin(),keys.end(),counts2.begin())==
+    counts2.end());
+  BOOST_TEST(counts2==counts);
+
+  /* compatible keys */
+
+  std::vector<std::string> strs;
+  strs.push_back("5");
+  strs.push_back("-5");
+  strs.push_back("999");
+  strs.push_back("1000");
+  its.clear();
+  prc.find_many(
+    strs.begin(),strs.end(),std::back_inserter(its),
+    string_as_int_hash(),string_as_int_equal());
+  BOOST_TEST(its.size()==4);
+  BOOST_TEST(its[0]==prc.find(5)&&its[1]==prc.end());
+  BOOST_TEST(its[2]==prc.find(999)&&its[3]==prc.end());
+
+  std::vector<long> lkeys(keys.begin(),keys.end());
+  counts.clear();
+  prc.count_many(lkeys.begin(),lkeys.end(),std::back_inserter(counts));
+  for(std::size_t i=0;i<keys.size();++i){
+    BOOST_TEST(counts[i]==(keys[i]>=0&&keys[i]<1000?1u:0u));
+  }
+
+  /* empty range and indices in the middle of an incremental rehash */
+
+  std::vector<iterator> none;
+  prc.find_many(keys.end(),keys.end(),std::back_inserter(none));
+  BOOST_TEST(none.empty());
+
+  incremental_container ic;
+  int n=0;
+  while(n<1000||power_of_2_buckets(ic))ic.insert(n++);
+  std::vector<incremental_container::iterator> iits;
+  ic.find_many(keys.begin(),keys.end(),std::back_inserter(iits));
+  for(std::size_t i=0;i<keys.size();++i){
+    BOOST_TEST(iits[i]==ic.find(keys[i]));
+  }
+}
+
+/* inserts into a container when converted to int */
+
+struct inserting_int
+{
+  inserting_int(counted_hash_container& c_,int n_,int m_):c(&c_),n(n_),m(m_){}
+
+  operator int()const{c->insert(m);return n;}
+
+  counted_hash_container* c;
+  int                     n,m;
+};
+
+void test_precomputed_hash()
+{
+  counted_hash_container chc;
+  counting_hash          hash;
+  for(int n=0;n<100;++n)chc.insert(n);
+
+  std::size_t hs[]={hash(10),hash(100),hash(11),hash(-1),hash(12),
+                    hash(-5),hash(13),hash(13),hash(200)};
+  int         calls=counting_hash::calls;
+  BOOST_TEST(chc.find(10,hs[0])!=chc.end()&&*chc.find(10,hs[0])==10);
+  BOOST_TEST(chc.find(100,hs[1])==chc.end());
+  BOOST_TEST(chc.count(11,hs[2])==1&&chc.count(-1,hs[3])==0);
+  BOOST_TEST(*chc.equal_range(12,hs[4]).first==12);
+
+  /* the hasher is only invoked by safe mode checks */
+
+#if defined(BOOST_MULTI_INDEX_ENABLE_SAFE_MODE)
+  BOOST_TEST(counting_hash::calls-calls==6);
+#else
+  BOOST_TEST(counting_hash::calls==calls);
+#endif
+
+  BOOST_TEST(chc.emplace_hashed(hs[5],-5).second);
+  BOOST_TEST(!chc.emplace_hashed(hs[6],13).second);
+  BOOST_TEST(chc.erase(13,hs[7])==1);
+  BOOST_TEST(chc.erase(200,hs[8])==0);
+  BOOST_TEST(chc.size()==100&&chc.count(-5)==1&&chc.count(13)==0);
+  check_buckets(chc);
+
+  /* emplace_hashed may trigger a rehash */
+
+  counted_hash_container chc2;
+  for(int n=0;n<1000;++n)chc2.emplace_hashed(hash(n),n);
+  BOOST_TEST(chc2.size()==1000);
+  check_buckets(chc2);
+
+  /* the hash is not used for insertions made while constructing the value */
+
+  BOOST_TEST(chc2.emplace_hashed(
+    hash(-1),inserting_int(chc2,-1,-2)).second);
+  BOOST_TEST(chc2.count(-1)==1&&chc2.count(-2)==1);
+  BOOST_TEST(chc2.find(-2,hash(-2))!=chc2.end());
+  check_buckets(chc2);
+
+  parallel_rehash_container prc;
+  third                     thd;
+  for(int n=0;n<30;++n){
+    prc.get<1>().emplace_hashed(boost::hash<int>()(thd(n)),n);
+  }
+  BOOST_TEST(prc.get<1>().count(4,boost::hash<int>()(4))==3);
+  BOOST_TEST(prc.get<2>().count(4,boost::hash<int>()(4))==3);
+  BOOST_TEST(prc.get<1>().erase(4,boost::hash<int>()(4))==3);
+  BOOST_TEST(prc.size()==27);
+  check_buckets(prc.get<1>());
+}
+
+struct constant_hash
+{
+  std::size_t operator()(int)const{return 0;}
+};
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    hashed_unique<identity<int>,constant_hash>
+  >
+> constant_hash_container;
+
+/* Checks the figures of stats() that can be told from the bucket
+ * interface.
+ */
+
+template<typename HashedIndex>
+void check_stats(const HashedIndex& hi)
+{
+  typedef typename HashedIndex::size_type  size_type;
+  typedef typename HashedIndex::stats_type stats_type;
+
+  stats_type  st=hi.stats();
+  std::size_t hist[stats_type::chain_length_histogram_size]={0},
+              empty=0,max_len=0,buckets=0,elements=0;
+  for(size_type buc=0;buc<hi.bucket_count();++buc){
+    std::size_t len=hi.bucket_size(buc);
+    if(len==0)++empty;
+    if(len>max_len)max_len=len;
+    ++hist[len<stats_type::chain_length_histogram_size?
+      len:stats_type::chain_length_histogram_size-1];
+  }
+  for(std::size_t i=0;i<stats_type::chain_length_histogram_size;++i){
+    BOOST_TEST(st.chain_length_histogram[i]==hist[i]);
+    buckets+=st.chain_length_histogram[i];
+    elements+=i*st.chain_length_histogram[i];
+  }
+  BOOST_TEST(st.bucket_count==hi.bucket_count()&&buckets==st.bucket_count);
+  BOOST_TEST(st.empty_bucket_count==empty);
+  BOOST_TEST(st.max_chain_length==max_len);
+  BOOST_TEST(elements<=hi.size());
+  BOOST_TEST(st.group_count<=hi.size());
+  BOOST_TEST(st.max_group_size<=st.max_chain_length);
+  BOOST_TEST(st.bucket_bytes>=st.bucket_count*sizeof(void*));
+  BOOST_TEST(st.node_bytes>=hi.size()*sizeof(int));
+}
+
+void test_stats()
+{
+  hash_container hc;
+  check_stats(hc);
+  for(int n=0;n<1000;++n)hc.insert(n);
+  check_stats(hc);
+  BOOST_TEST(hc.stats().group_count==1000);
+  BOOST_TEST(hc.stats().max_group_size==1);
+
+  parallel_rehash_container prc;
+  for(int n=0;n<999;++n)prc.insert(n);
+  check_stats(prc.get<1>());
+  check_stats(prc.get<2>());
+  BOOST_TEST(prc.get<1>().stats().group_count==333);
+  BOOST_TEST(prc.get<1>().stats().max_group_size==3);
+  BOOST_TEST(prc.get<2>().stats().max_group_size==3);
+  prc.get<1>().erase(0);
+  prc.get<1>().emplace(1);
+  BOOST_TEST(prc.get<1>().stats().max_group_size==3);
+  BOOST_TEST(prc.get<1>().stats().group_count==333);
+
+  constant_hash_container chc;
+  for(int n=0;n<100;++n)chc.insert(n);
+  check_stats(chc);
+  BOOST_TEST(chc.stats().max_chain_length==100);
+  BOOST_TEST(chc.stats().empty_bucket_count==chc.bucket_count()-1);
+  BOOST_TEST(
+    chc.stats().chain_length_histogram[
+      constant_hash_container::stats_type::chain_length_histogram_size-1]==1);
+
+  incremental_container ic;
+  int n=0;
+  while(n<1000||power_of_2_buckets(ic))ic.insert(n++);
+  check_stats(ic);
+  check_stats(ic.get<1>());
+  BOOST_TEST(ic.stats().group_count==ic.size());
+}
+
+template<typename Container>
+void test_min_load_factor(Container& c)
+{
+  BOOST_TEST(c.min_load_factor()==0.0f);
+  c.min_load_factor(0.2f);
+  BOOST_TEST(c.min_load_factor()==0.2f);
+
+  std::vector<int> v=int_range(0,2000);
+  c.insert(v.begin(),v.end());
+  std::size_t bc=c.bucket_count();
+  typename Container::iterator it=c.begin();
+  std::advance(it,100);
+  c.erase(it,c.end()); /* no rehashing on erasure */
+  BOOST_TEST(c.size()==100);
+  BOOST_TEST(c.bucket_count()==bc);
+
+  c.insert(2000);
+  BOOST_TEST(c.bucket_count()<bc);
+  BOOST_TEST(c.load_factor()>=0.2f);
+  check_load_factor(c);
+  check_buckets(c);
+
+  /* steady churn does not make the index grow and shrink back and forth */
+
+  for(int i=0;i<3;++i){
+    std::size_t bc1=c.bucket_count();
+    for(int n=0;n<500;++n){
+      c.insert(3000+n);
+      c.erase(3000+n);
+    }
+    BOOST_TEST(c.bucket_count()==bc1);
+    while(c.load_factor()<=c.max_load_factor()*0.95f){
+      c.insert(4000+(int)c.size());
+    }
+    bc1=c.bucket_count();
+    for(int n=0;n<500;++n){
+      c.erase(c.begin());
+      c.insert(5000+n);
+    }
+    BOOST_TEST(c.bucket_count()==bc1);
+    it=c.begin();
+    std::advance(it,100);
+    c.erase(it,c.end());
+  }
+  check_buckets(c);
+
+  bc=c.bucket_count();
+  c.min_load_factor(0.0f);
+  c.erase(c.begin(),c.end());
+  c.insert(0);
+  BOOST_TEST(c.bucket_count()==bc);
+}
+
+void test_shrink()
+{
+  hash_container hc;
+  test_min_load_factor(hc);
+  incremental_container ic;
+  test_min_load_factor(ic);
+
+  /* min_load_factor is capped at max_load_factor/4 */
+
+  hash_container hc2;
+  hc2.min_load_factor(0.9f);
+  std::vector<int> v=int_range(0,1000);
+  hc2.insert(v.begin(),v.end());
+  for(int n=0;n<300;++n)hc2.erase(n);
+  std::size_t bc=hc2.bucket_count();
+  hc2.insert(-1);
+  BOOST_TEST(hc2.bucket_count()==bc);
+  for(int n=300;n<800;++n)hc2.erase(n);
+  hc2.insert(-2);
+  BOOST_TEST(hc2.bucket_count()<bc);
+  check_load_factor(hc2);
+
+  hc2.min_load_factor(0.0f);
+  hc2.insert(v.begin(),v.end());
+  hc2.erase(hc2.begin(),hc2.end());
+  hc2.insert(0);
+  bc=hc2.bucket_count();
+  hc2.shrink_to_fit();
+  BOOST_TEST(hc2.bucket_count()<bc);
+  bc=hc2.bucket_count();
+  hc2.shrink_to_fit();
+  BOOST_TEST(hc2.bucket_count()==bc);
+  BOOST_TEST(hc2.size()==1&&*hc2.begin()==0);
+
+  ic.insert(v.begin(),v.end());
+  while(power_of_2_buckets(ic))ic.insert((int)ic.size());
+  ic.shrink_to_fit();
+  BOOST_TEST(power_of_2_buckets(ic));
+  check_load_factor(ic);
+  check_buckets(ic);
+
+  /* clear() with shrinking enabled resets the bucket array */
+
+  hash_container hc3;
+  hc3.insert(v.begin(),v.end());
+  bc=hc3.bucket_count();
+  hc3.clear();
+  BOOST_TEST(hc3.bucket_count()==bc);
+  hc3.insert(v.begin(),v.end());
+  hc3.min_load_factor(0.1f);
+  hc3.clear();
+  BOOST_TEST(hc3.bucket_count()<bc);
+  hc3.insert(0);
+  BOOST_TEST(hc3.size()==1&&*hc3.begin()==0);
+  check_buckets(hc3);
+}
+
+template<typename HashedIndex>
+void check_lookups(const HashedIndex& hi,int first,int last)
+{
+  for(int n=first;n!=last;++n){
+    typename HashedIndex::size_type c=hi.count(n);
+    BOOST_TEST(c==(typename HashedIndex::size_type)
+      std::distance(hi.equal_range(n).first,hi.equal_range(n).second));
+    if(c==0)BOOST_TEST(hi.find(n)==hi.end());
+    else BOOST_TEST(hi.key_extractor()(*hi.find(n))==n);
+    BOOST_TEST(hi.find(n,hi.hash_function()(n))==hi.find(n));
+  }
+}
+
+void test_freeze()
+{
+  hash_container hc;
+  BOOST_TEST(!hc.frozen());
+  BOOST_TEST(hc.freeze());
+  BOOST_TEST(hc.frozen());
+  BOOST_TEST(hc.find(0)==hc.end());
+
+  for(int n=0;n<1000;++n)hc.insert(n);
+  BOOST_TEST(!hc.frozen());
+  BOOST_TEST(hc.freeze());
+  BOOST_TEST(hc.frozen());
+  BOOST_TEST(hc.freeze());
+  check_lookups(hc,-100,1100);
+
+  std::vector<int> keys;
+  for(int n=-100;n<1100;++n)keys.push_back(n);
+  std::vector<hash_container::iterator> its;
+  hc.find_many(keys.begin(),keys.end(),std::back_inserter(its));
+  for(std::size_t i=0;i<keys.size();++i)BOOST_TEST(its[i]==hc.find(keys[i]));
+
+  BOOST_TEST(!hc.insert(0).second);
+  BOOST_TEST(hc.frozen());
+  hc.insert(1000);
+  BOOST_TEST(!hc.frozen());
+  check_lookups(hc,-100,1100);
+
+  hc.freeze();
+  hash_container hc2(hc);
+  BOOST_TEST(!hc2.frozen());
+  BOOST_TEST(hc2==hc);
+  hc.swap(hc2);
+  BOOST_TEST(!hc.frozen()&&hc2.frozen());
+  check_lookups(hc2,-100,1100);
+  hc2.erase(0);
+  BOOST_TEST(!hc2.frozen());
+  hc2.freeze();
+  hc2.modify(hc2.find(1),assign_value(-1));
+  BOOST_TEST(!hc2.frozen());
+  hc2.freeze();
+  hc2.replace(hc2.find(2),2);
+  BOOST_TEST(hc2.frozen());
+
+  /* in-place modification to a key of the same bucket */
+
+  int k=2000;
+  while(hc2.bucket(k)!=hc2.bucket(4))++k;
+  BOOST_TEST(hc2.modify(hc2.find(4),assign_value(k)));
+  BOOST_TEST(!hc2.frozen());
+  BOOST_TEST(hc2.find(4)==hc2.end()&&hc2.find(k)!=hc2.end());
+  hc2.freeze();
+  BOOST_TEST(hc2.modify(hc2.find(k),assign_value(4)));
+  BOOST_TEST(!hc2.frozen());
+  BOOST_TEST(hc2.find(k)==hc2.end()&&hc2.find(4)!=hc2.end());
+  check_lookups(hc2,-100,1100);
+  hc2.unfreeze();
+  BOOST_TEST(!hc2.frozen());
+  hc2.freeze();
+  hc2.clear();
+  BOOST_TEST(!hc2.frozen());
+
+  parallel_rehash_container prc;
+  for(int n=0;n<999;++n)prc.insert(n);
+  BOOST_TEST(prc.get<1>().freeze());
+  BOOST_TEST(prc.get<2>().freeze());
+  check_lookups(prc.get<1>(),-10,340);
+  check_lookups(prc.get<2>(),-10,340);
+  std::vector<std::size_t> counts;
+  prc.get<1>().count_many(keys.begin(),keys.end(),std::back_inserter(counts));
+  for(std::size_t i=0;i<keys.size();++i){
+    BOOST_TEST(counts[i]==prc.get<1>().count(keys[i]));
+  }
+  prc.erase(3);
+  BOOST_TEST(!prc.get<1>().frozen()&&!prc.get<2>().frozen());
+  check_lookups(prc.get<1>(),-10,340);
+
+  constant_hash_container chc;
+  for(int n=0;n<100;++n)chc.insert(n);
+  BOOST_TEST(!chc.freeze());
+  BOOST_TEST(!chc.frozen());
+  check_lookups(chc,-10,110);
+
+  incremental_container ic;
+  int n=0;
+  while(n<1000||power_of_2_buckets(ic))ic.insert(n++);
+  BOOST_TEST(ic.freeze());
+  BOOST_TEST(ic.get<1>().freeze());
+  check_lookups(ic,-10,n+10);
+  check_lookups(ic.get<1>(),-10,n+10);
+}
+
+typedef std::pair<int,int> group_element; /* (group,id) */
+
+typedef multi_index_container<
+  group_element,
+  indexed_by<
+    sequenced<>,
+    hashed_non_unique<
+      member<group_element,int,&group_element::first>,
+      hashed_index_options<store_group_size<> >
+    >,
+    hashed_unique<member<group_element,int,&group_element::second> >
+  >
+> group_size_container;
+
+struct group_visitor
+{
+  group_visitor():groups(0),elements(0){}
+
+  template<typename Iterator>
+  void operator()(Iterator first,Iterator last,std::size_t n)
+  {
+    BOOST_TEST(n==(std::size_t)std::distance(first,last));
+    for(Iterator it=first;it!=last;++it)BOOST_TEST(it->first==first->first);
+    ++groups;
+    elements+=n;
+  }
+
+  std::size_t groups,elements;
+};
+
+template<typename GroupSizeContainer>
+void check_group_sizes(const GroupSizeContainer& c,int num_groups)
+{
+  const typename GroupSizeContainer::template nth_index<1>::type& i1=
+    c.template get<1>();
+
+  std::size_t groups=0;
+  for(int g=0;g<num_groups;++g){
+    std::size_t n=(std::size_t)std::distance(
+      i1.equal_range(g).first,i1.equal_range(g).second);
+    BOOST_TEST(i1.count(g)==n);
+    if(n!=0)++groups;
+  }
+
+  group_visitor v=i1.for_each_group(group_visitor());
+  BOOST_TEST(v.groups==groups);
+  BOOST_TEST(v.elements==c.size());
+}
+
+typedef multi_index_container<
+  group_element,
+  indexed_by<
+    sequenced<>,
+    hashed_non_unique<
+      member<group_element,int,&group_element::first>,
+      hashed_index_options<store_group_size<>,incremental_rehash<> >
+    >,
+    hashed_unique<member<group_element,int,&group_element::second> >
+  >
+> incremental_group_size_container;
+
+struct assign_group
+{
+  assign_group(int g_):g(g_){}
+  void operator()(group_element& x)const{x.first=g;}
+  int g;
+};
+
+void test_group_size()
+{
+  /* groups of sizes 0 to 9, elements inserted in interleaved order */
+
+  group_size_container c;
+  int                  id=0;
+  for(int round=0;round<10;++round){
+    for(int g=round;g<10;++g)c.push_back(group_element(g,id++));
+  }
+  check_group_sizes(c,10);
+  BOOST_TEST(c.get<1>().count(9)==10);
+
+  group_size_container c2(c);
+  check_group_sizes(c2,10);
+
+  /* erasure at every position of the groups */
+
+  srand(1);
+  while(c.size()>30){
+    group_size_container::iterator it=c.begin();
+    std::advance(it,std::rand()%c.size());
+    c.erase(it);
+    check_group_sizes(c,10);
+  }
+
+  /* modification within, across and out of groups */
+
+  for(group_size_container::iterator it=c2.begin();it!=c2.end();++it){
+    c2.modify(it,assign_group((it->first+it->second)%12));
+    check_group_sizes(c2,12);
+  }
+  for(int g=0;g<12;++g){
+    group_size_container::nth_index<1>::type::iterator it=
+      c2.get<1>().find(g);
+    if(it!=c2.get<1>().end()){
+      c2.get<1>().modify(it,assign_group(11-g),assign_group(g));
+      check_group_sizes(c2,12);
+    }
+  }
+
+  /* failed replacements leave group sizes untouched */
+
+  group_size_container::iterator it=c2.begin();
+  BOOST_TEST(!c2.replace(it,group_element(it->first+1,c2.back().second)));
+  check_group_sizes(c2,12);
+  BOOST_TEST(c2.replace(it,group_element(it->first+1,it->second)));
+  check_group_sizes(c2,12);
+
+  /* elements alone in their group moved to another key */
+
+  c2.push_back(group_element(100,1000));
+  BOOST_TEST(c2.replace(--c2.end(),group_element(101,1000)));
+  check_group_sizes(c2,102);
+  BOOST_TEST(!c2.replace(--c2.end(),group_element(102,c2.front().second)));
+  check_group_sizes(c2,102);
+  BOOST_TEST(c2.get<1>().count(101)==1);
+  BOOST_TEST(c2.modify(--c2.end(),assign_group(102),assign_group(101)));
+  check_group_sizes(c2,103);
+  BOOST_TEST(c2.get<1>().count(102)==1);
+  c2.pop_back();
+  check_group_sizes(c2,103);
+
+  c2.get<1>().erase(3);
+  BOOST_TEST(c2.get<1>().count(3)==0);
+  check_group_sizes(c2,12);
+  c2.clear();
+  check_group_sizes(c2,12);
+
+  /* group sizes survive incremental migration, groups of two included */
+
+  incremental_group_size_container ic;
+  for(int n=0;n<1200;++n){
+    ic.push_back(group_element(n%(400+n/600*200),n));
+    if(!power_of_2_buckets(ic.get<1>())&&n%50==0)check_group_sizes(ic,600);
+  }
+  check_group_sizes(ic,600);
+
+  incremental_group_size_container ic2(ic);
+  BOOST_TEST(ic2==ic);
+  check_group_sizes(ic2,600);
+  for(int g=0;g<600;++g){
+    BOOST_TEST(ic2.get<1>().count(g)==ic.get<1>().count(g));
+  }
+}
+
 void test_hash_ops()
 {
   hash_container hc;
@@ -115,4 +1203,15 @@ void test_hash_ops()
   bc3=hc3.bucket_count();
   hc3.reserve((hash_container::size_type)(3.0f*hc3.max_load_factor()*bc3));
   BOOST_TEST(hc3.bucket_count()>bc3);
+
+  test_stored_hash();
+  test_power_2_buckets();
+  test_incremental_rehash();
+  test_parallel_rehash();
+  test_find_many();
+  test_precomputed_hash();
+  test_stats();
+  test_shrink();
+  test_freeze();
+  test_group_size();
 }
@@ -0,0 +1,191 @@
+/* Boost.MultiIndex test for interval indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_interval_index.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <cstdlib>
+#include <vector>
+#include <boost/detail/lightweight_test.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/interval_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+
+using namespace boost::multi_index;
+
+struct interval
+{
+  interval(int id_,int lo_,int hi_):id(id_),lo(lo_),hi(hi_){}
+
+  int id;
+  int lo;
+  int hi;
+};
+
+struct set_hi
+{
+  set_hi(int hi_):hi(hi_){}
+  void operator()(interval& x)const{x.hi=hi;}
+  int hi;
+};
+
+struct set_lo_hi
+{
+  set_lo_hi(int lo_,int hi_):lo(lo_),hi(hi_){}
+  void operator()(interval& x)const{x.lo=lo;x.hi=hi;}
+  int lo,hi;
+};
+
+struct by_id{};
+struct by_interval{};
+
+typedef multi_index_container<
+  interval,
+  indexed_by<
+    interval_index<
+      tag<by_interval>,
+      member<interval,int,&interval::lo>,member<interval,int,&interval::hi>
+    >,
+    ordered_unique<tag<by_id>,member<interval,int,&interval::id> >
+  >
+> interval_set;
+
+template<typename Index>
+static std::vector<int> brute_overlapping(const Index& i,int a,int b)
+{
+  std::vector<int> res;
+  for(typename Index::iterator it=i.begin();it!=i.end();++it){
+    if(it->lo<=b&&a<=it->hi)res.push_back(it->id);
+  }
+  return res;
+}
+
+template<typename Index>
+static std::vector<int> query_overlapping(const Index& i,int a,int b)
+{
+  std::vector<int> res;
+  typedef typename Index::overlap_iterator overlap_iterator;
+  std::pair<overlap_iterator,overlap_iterator> p=i.overlapping(a,b);
+  for(;p.first!=p.second;++p.first)res.push_back(p.first->id);
+  return res;
+}
+
+template<typename Index>
+static std::vector<int> query_stabbing(const Index& i,int x)
+{
+  std::vector<int> res;
+  typedef typename Index::overlap_iterator overlap_iterator;
+  std::pair<overlap_iterator,overlap_iterator> p=i.stabbing(x);
+  for(;p.first!=p.second;++p.first)res.push_back(p.first->id);
+  return res;
+}
+
+template<typename Index>
+static bool check_queries(const Index& i)
+{
+  for(int a=-10;a<1010;a+=37){
+    for(int b=a-20;b<a+300;b+=(b<a?10:41)){
+      if(query_overlapping(i,a,b)!=brute_overlapping(i,a,b))return false;
+    }
+    if(query_stabbing(i,a)!=brute_overlapping(i,a,a))return false;
+  }
+  return true;
+}
+
+static interval random_interval(int id)
+{
+  int lo=std::rand()%1000,len=std::rand()%4?std::rand()%20:std::rand()%300;
+  return interval(id,lo,lo+len);
+}
+
+void test_interval_index()
+{
+  interval_set s;
+  BOOST_TEST(s.stabbing(0).first==s.stabbing(0).second);
+  BOOST_TEST(check_queries(s));
+
+  std::srand(1);
+  for(int i=0;i<400;++i){
+    s.insert(random_interval(i));
+    if(i%50==0)BOOST_TEST(check_queries(s));
+  }
+  BOOST_TEST(check_queries(s));
+
+  {
+    std::vector<int> v=query_stabbing(s,500);
+    for(std::size_t n=0;n<v.size();++n){
+      const interval& x=*s.get<by_id>().find(v[n]);
+      BOOST_TEST(x.lo<=500&&500<=x.hi);
+    }
+  }
+
+  /* changes of the end point leave elements in place */
+
+  interval_set::index<by_id>::type& ids=s.get<by_id>();
+  for(int i=0;i<100;++i){
+    interval_set::index<by_id>::type::iterator it=ids.find(std::rand()%400);
+    if(it==ids.end())continue;
+    switch(i%4){
+      case 0: ids.modify(it,set_hi(it->lo+std::rand()%500));break;
+      case 1: ids.replace(it,interval(it->id,it->lo,it->lo));break;
+      case 2: s.modify(s.iterator_to(*it),set_hi(it->lo+std::rand()%50));
+              break;
+      default:
+        ids.modify(
+          it,set_lo_hi(std::rand()%1000,std::rand()%1000+std::rand()%100));
+    }
+    if(i%10==0)BOOST_TEST(check_queries(s));
+  }
+  BOOST_TEST(check_queries(s));
+
+  for(int i=0;i<200;++i){
+    interval_set::index<by_id>::type::iterator it=ids.find(std::rand()%400);
+    if(it!=ids.end())ids.erase(it);
+    if(i%40==0)BOOST_TEST(check_queries(s));
+  }
+  BOOST_TEST(check_queries(s));
+
+  interval_set s2(s);
+  BOOST_TEST(check_queries(s2));
+  BOOST_TEST(query_stabbing(s2,300)==query_stabbing(s,300));
+
+  s2.clear();
+  BOOST_TEST(check_queries(s2));
+
+  /* overlap iterators dereference into the elements */
+
+  interval_set::index<by_interval>::type& ivs=s.get<by_interval>();
+  interval_set::index<by_interval>::type::overlap_iterator it=
+    ivs.overlapping(100,200).first;
+  if(it!=ivs.overlapping(100,200).second){
+    BOOST_TEST(&*ivs.iterator_to(*it)==&*it);
+    BOOST_TEST(it->lo<=200&&100<=it->hi);
+  }
+
+  typedef multi_index_container<
+    interval,
+    indexed_by<
+      interval_index<
+        member<interval,int,&interval::lo>,member<interval,int,&interval::hi>
+      >
+    >
+  > plain_interval_set;
+
+  plain_interval_set s3;
+  for(int i=0;i<1000;++i)s3.insert(interval(i,i,i));
+  BOOST_TEST(query_stabbing(s3,500).size()==1);
+  BOOST_TEST(query_overlapping(s3,10,19).size()==10);
+  BOOST_TEST(query_overlapping(s3,19,10).empty());
+  s3.insert(interval(1000,0,2000));
+  BOOST_TEST(query_stabbing(s3,500).size()==2);
+  BOOST_TEST(check_queries(s3));
+}
@@ -18,6 +18,8 @@
 #include <boost/move/utility_core.hpp>
 #include <boost/next_prior.hpp>
 #include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <functional>
 #include <iterator>
 #include <vector>
 #include "pre_multi_index.hpp"
@@ -157,6 +159,142 @@ struct change_int_and_throw
 };
 #endif
 
+struct tenths
+{
+  typedef int result_type;
+
+  int operator()(int x)const{return x/10;}
+};
+
+struct same_tenth
+{
+  same_tenth(int t_):t(t_){}
+
+  bool operator()(int x)const{return x/10==t;}
+
+  int t;
+};
+
+typedef multi_index_container<
+  int,
+  indexed_by<
+    ordered_unique<identity<int> >,
+    ranked_unique<identity<int> >,
+    ordered_non_unique<tenths>,
+    ordered_unique<identity<int>,std::greater<int> >,
+    sequenced<>
+  >
+> sorted_insertion_container;
+
+#if !(defined BOOST_NO_EXCEPTIONS)
+struct throwing_int_iterator:
+  boost::iterator_facade<
+    throwing_int_iterator,int,boost::forward_traversal_tag,int>
+{
+  throwing_int_iterator(int n_,int limit_):n(n_),limit(limit_){}
+
+  void increment(){++n;}
+  bool equal(const throwing_int_iterator& x)const{return n==x.n;}
+  int dereference()const{if(n==limit)throw 0;return n;}
+
+  int n,limit;
+};
+#endif
+
+static bool check_sorted_insertion(
+  const sorted_insertion_container& c,const std::vector<int>& v)
+{
+  std::vector<int> w(v);
+  std::sort(w.begin(),w.end());
+  w.erase(std::unique(w.begin(),w.end()),w.end());
+  if(c.size()!=w.size()||!std::equal(w.begin(),w.end(),c.begin()))
+    return false;
+
+  const sorted_insertion_container::nth_index<1>::type& i1=get<1>(c);
+  for(std::size_t n=0;n<w.size();++n){
+    if(*i1.nth(n)!=w[n]||i1.rank(i1.find(w[n]))!=n)return false;
+  }
+
+  const sorted_insertion_container::nth_index<2>::type& i2=get<2>(c);
+  for(std::size_t n=0;n<w.size();++n){
+    if(i2.count(w[n]/10)!=
+       (std::size_t)std::count_if(
+         w.begin(),w.end(),same_tenth(w[n]/10)))return false;
+  }
+
+  return std::equal(w.rbegin(),w.rend(),get<3>(c).begin());
+}
+
+static void test_sorted_insertion()
+{
+  /* sorted input of all sizes up to a few full levels */
+
+  for(int n=0;n<100;++n){
+    sorted_insertion_container c(tempvalue_iterator(0),tempvalue_iterator(n));
+    BOOST_TEST(check_sorted_insertion(
+      c,std::vector<int>(tempvalue_iterator(0),tempvalue_iterator(n))));
+  }
+
+  /* duplicates, and order broken halfway */
+
+  std::vector<int> v;
+  for(int i=0;i<500;++i){
+    v.push_back(i);
+    v.push_back(i);
+  }
+  {
+    sorted_insertion_container c(v.begin(),v.end());
+    BOOST_TEST(check_sorted_insertion(c,v));
+  }
+  for(int i=1000;i>500;--i)v.push_back(i);
+  {
+    sorted_insertion_container c(v.begin(),v.end());
+    BOOST_TEST(check_sorted_insertion(c,v));
+  }
+
+  /* range insertion into an empty and a non-empty index */
+
+  {
+    sorted_insertion_container c;
+    get<2>(c).insert(v.begin(),v.begin()+200);
+    BOOST_TEST(check_sorted_insertion(
+      c,std::vector<int>(v.begin(),v.begin()+200)));
+    get<0>(c).insert(v.begin(),v.end());
+    BOOST_TEST(check_sorted_insertion(c,v));
+  }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+  {
+    sorted_insertion_container c={0,1,1,2,3,5,8,13,21,34};
+    BOOST_TEST(c.size()==9);
+    BOOST_TEST(get<1>(c).nth(5)==get<1>(c).find(8));
+  }
+#endif
+
+#if !(defined BOOST_NO_EXCEPTIONS)
+  /* elements inserted before an exception stay in a consistent state */
+
+  try{
+    sorted_insertion_container c(
+      throwing_int_iterator(0,300),throwing_int_iterator(1000,300));
+    BOOST_TEST(false);
+  }
+  catch(int){}
+
+  {
+    sorted_insertion_container c;
+    try{
+      get<1>(c).insert(
+        throwing_int_iterator(0,300),throwing_int_iterator(1000,300));
+      BOOST_TEST(false);
+    }
+    catch(int){}
+    BOOST_TEST(check_sorted_insertion(
+      c,std::vector<int>(tempvalue_iterator(0),tempvalue_iterator(300))));
+  }
+#endif
+}
+
 void test_modifiers()
 {
   employee_set              es;
@@ -578,4 +716,6 @@ void test_modifiers()
     BOOST_TEST(ohc.size()==1);
     ohc.clear();
   }
+
+  test_sorted_insertion();
 }
@@ -0,0 +1,251 @@
+/* Boost.MultiIndex test for prefixed ordered indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_prefix_index.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/detail/lightweight_test.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/ordered_prefix_index.hpp>
+
+using namespace boost::multi_index;
+
+struct entry
+{
+  entry(int id_,const std::string& name_):id(id_),name(name_){}
+
+  int         id;
+  std::string name;
+};
+
+static bool operator!=(const entry& x,const entry& y)
+{
+  return x.name!=y.name;
+}
+
+struct set_name
+{
+  set_name(const std::string& name_):name(name_){}
+  void operator()(entry& e)const{e.name=name;}
+  std::string name;
+};
+
+struct by_name{};
+struct by_id{};
+
+typedef multi_index_container<
+  entry,
+  indexed_by<
+    ordered_prefix_non_unique<
+      tag<by_name>,member<entry,std::string,&entry::name> >,
+    ordered_non_unique<member<entry,std::string,&entry::name> >,
+    ordered_unique<tag<by_id>,member<entry,int,&entry::id> >
+  >
+> entry_set;
+
+typedef multi_index_container<
+  std::string,
+  indexed_by<
+    ordered_prefix_unique<identity<std::string> >,
+    ordered_unique<identity<std::string> >
+  >
+> string_set;
+
+/* selects either string of a pair, set at construction time */
+
+typedef std::pair<std::string,std::string> string_pair;
+
+struct select_string
+{
+  typedef std::string result_type;
+
+  explicit select_string(bool second_=false):second(second_){}
+
+  const std::string& operator()(const string_pair& p)const
+  {
+    return second?p.second:p.first;
+  }
+
+  bool second;
+};
+
+typedef multi_index_container<
+  string_pair,
+  indexed_by<
+    ordered_prefix_unique<select_string>,
+    ordered_unique<select_string>
+  >
+> string_pair_set;
+
+/* Keys sharing long prefixes, differing in their 8th or 9th byte, with
+ * embedded zeros and with bytes above 127, so that all the cases of the
+ * prefix comparison are exercised.
+ */
+
+static std::string random_key()
+{
+  static const char alphabet[]={'a','b','\0','\xff','\x80','z'};
+  std::string res;
+  if(std::rand()%2)res="http://www.example.com/";
+  std::size_t len=std::rand()%12;
+  for(std::size_t i=0;i<len;++i)res+=alphabet[std::rand()%6];
+  return res;
+}
+
+template<typename Container>
+static bool same_lookups(const Container& c,const std::string& k)
+{
+  typedef typename Container::template nth_index<0>::type prefixed;
+  typedef typename Container::template nth_index<1>::type plain;
+
+  const prefixed& p=c.template get<0>();
+  const plain&    q=c.template get<1>();
+
+  if((p.find(k)==p.end())!=(q.find(k)==q.end()))return false;
+  if(p.find(k)!=p.end()&&*p.find(k)!=*q.find(k))return false;
+  if(p.count(k)!=q.count(k))return false;
+  if(std::distance(p.begin(),p.lower_bound(k))!=
+     std::distance(q.begin(),q.lower_bound(k)))return false;
+  if(std::distance(p.begin(),p.upper_bound(k))!=
+     std::distance(q.begin(),q.upper_bound(k)))return false;
+  if(p.equal_range(k).first!=p.lower_bound(k)||
+     p.equal_range(k).second!=p.upper_bound(k))return false;
+  return true;
+}
+
+template<typename Container>
+static bool same_order(const Container& c)
+{
+  typedef typename Container::template nth_index<0>::type prefixed;
+  typedef typename Container::template nth_index<1>::type plain;
+
+  const prefixed& p=c.template get<0>();
+  const plain&    q=c.template get<1>();
+
+  typename prefixed::iterator it=p.begin();
+  typename plain::iterator    it2=q.begin();
+  for(;it!=p.end();++it,++it2){
+    if(it2==q.end()||*it!=*it2)return false;
+  }
+  return it2==q.end();
+}
+
+template<typename Container>
+static bool check(const Container& c)
+{
+  if(!same_order(c))return false;
+  for(int i=0;i<200;++i){
+    if(!same_lookups(c,random_key()))return false;
+  }
+  return true;
+}
+
+void test_prefix_index()
+{
+  std::srand(1);
+
+  entry_set es;
+  BOOST_TEST(check(es));
+  for(int i=0;i<1000;++i){
+    es.insert(entry(i,random_key()));
+    if(i%100==0)BOOST_TEST(check(es));
+  }
+  BOOST_TEST(check(es));
+
+  entry_set::index<by_id>::type& ids=es.get<by_id>();
+  for(int i=0;i<300;++i){
+    entry_set::index<by_id>::type::iterator it=ids.find(std::rand()%1000);
+    if(it==ids.end())continue;
+    switch(i%3){
+      case 0: ids.modify(it,set_name(random_key()));break;
+      case 1: ids.replace(it,entry(it->id,random_key()));break;
+      default: ids.erase(it);
+    }
+    if(i%30==0)BOOST_TEST(check(es));
+  }
+  BOOST_TEST(check(es));
+
+  /* lookups with types other than std::string take the regular path */
+
+  entry_set::index<by_name>::type& names=es.get<by_name>();
+  names.insert(entry(2000,"abc"));
+  BOOST_TEST(names.find("abc")!=names.end());
+  BOOST_TEST(names.find("abc")==names.find(std::string("abc")));
+  BOOST_TEST(names.lower_bound("ab")==names.lower_bound(std::string("ab")));
+
+  entry_set es2(es);
+  BOOST_TEST(check(es2));
+  es2.get<by_name>().erase(es2.get<by_name>().begin());
+  BOOST_TEST(check(es2));
+
+  string_set ss;
+  for(int i=0;i<2000;++i)ss.insert(random_key());
+  BOOST_TEST(check(ss));
+
+  {
+    std::string k1(9,'a'),k2(9,'a'),k3(8,'a');
+    k2[8]='b';
+    string_set s;
+    s.insert(k2);
+    s.insert(k1);
+    s.insert(k3);
+    s.insert(k3+'\0');
+    s.insert(std::string());
+    BOOST_TEST(s.size()==5);
+    BOOST_TEST(*s.begin()==std::string());
+    BOOST_TEST(*s.upper_bound(k3)==k3+'\0');
+    BOOST_TEST(*--s.end()==k2);
+    BOOST_TEST(s.count(k1)==1&&s.count(k3+'\0')==1);
+    BOOST_TEST(!s.insert(k3).second);
+    BOOST_TEST(check(s));
+  }
+
+  /* join-based set operations move nodes along with their prefixes */
+
+  string_set ss2;
+  for(int i=0;i<500;++i)ss2.get<0>().insert(random_key());
+  typedef multi_index_container<
+    std::string,
+    indexed_by<ordered_prefix_unique<identity<std::string> > >
+  > single_string_set;
+
+  single_string_set s1(ss.get<1>().begin(),ss.get<1>().end()),
+                    s2(ss2.get<1>().begin(),ss2.get<1>().end());
+  s1.set_union(s2);
+  for(string_set::iterator it=ss.begin();it!=ss.end();++it){
+    BOOST_TEST(s1.find(*it)!=s1.end());
+  }
+  for(string_set::iterator it=ss2.begin();it!=ss2.end();++it){
+    BOOST_TEST(s1.find(*it)!=s1.end());
+  }
+
+  ss.get<0>().freeze();
+  BOOST_TEST(check(ss));
+
+  /* prefixes are taken with the key extractor held by the index */
+
+  string_pair_set::ctor_args_list args;
+  boost::tuples::get<0>(args.get_head())=select_string(true);
+  boost::tuples::get<0>(args.get_tail().get_head())=select_string(true);
+  string_pair_set sps(args);
+  for(int i=0;i<500;++i)sps.insert(string_pair(random_key(),random_key()));
+  BOOST_TEST(check(sps));
+  string_pair_set sps2(sps);
+  BOOST_TEST(check(sps2));
+}
@@ -459,6 +459,41 @@ static void test_integral_bimap()
   CATCH_SAFE_MODE(safe_mode::invalid_iterator)
 }
 
+static void test_precomputed_hash()
+{
+  typedef multi_index_container<
+    int,
+    indexed_by<
+      hashed_unique<identity<int> >,
+      hashed_non_unique<identity<int> > >
+  > hashed_container;
+
+  hashed_container  c;
+  boost::hash<int>  h;
+  c.insert(0);
+
+  TRY_SAFE_MODE
+    c.find(0,h(1));
+  CATCH_SAFE_MODE(safe_mode::invalid_hash)
+
+  TRY_SAFE_MODE
+    c.get<1>().count(0,h(1));
+  CATCH_SAFE_MODE(safe_mode::invalid_hash)
+
+  TRY_SAFE_MODE
+    c.erase(0,h(1));
+  CATCH_SAFE_MODE(safe_mode::invalid_hash)
+
+  TRY_SAFE_MODE
+    c.emplace_hashed(h(1),2);
+  CATCH_SAFE_MODE(safe_mode::invalid_hash)
+
+  BOOST_TEST(c.size()==1);
+  BOOST_TEST(c.emplace_hashed(h(2),2).second);
+  BOOST_TEST(c.get<1>().emplace_hashed(h(3),3).second);
+  BOOST_TEST(c.size()==3);
+}
+
 void test_safe_mode()
 {
   local_test_safe_mode<employee_set_policy>();
@@ -501,4 +536,6 @@ void test_safe_mode()
   > bimap3_type;
 
   test_integral_bimap<bimap3_type>();
+
+  test_precomputed_hash();
 }
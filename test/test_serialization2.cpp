@@ -12,6 +12,7 @@
 #include "test_serialization_template.hpp"
 
 #include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/ordered_grouped_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index/random_access_index.hpp>
 #include <boost/multi_index/key_extractors.hpp>
@@ -78,4 +79,42 @@ void test_serialization2()
     m.insert(pair_of_ints(3,2));
     test_serialization(m);
   }
+  {
+    typedef multi_index_container<
+      pair_of_ints,
+      indexed_by<
+        sequenced<>,
+        ordered_grouped_non_unique<
+          BOOST_MULTI_INDEX_MEMBER(pair_of_ints,int,second)
+        >,
+        ordered_unique<
+          BOOST_MULTI_INDEX_MEMBER(pair_of_ints,int,first)
+        >
+      >
+    > multi_index_t;
+
+    multi_index_t m;
+    test_serialization(m);
+
+    /* hinted insertions leave equivalent elements out of insertion order,
+     * and reversing index #0 changes the order they are loaded in
+     */
+
+    typedef multi_index_t::nth_index<1>::type grouped_index_t;
+    grouped_index_t& g=get<1>(m);
+    for(int i=0;i<60;++i){
+      int k=i%4;
+      g.insert(i%3?g.lower_bound(k):g.upper_bound(k),pair_of_ints(i,k));
+    }
+    test_serialization(m);
+
+    m.reverse();
+    test_serialization(m);
+
+    g.erase(g.find(2));
+    g.insert(g.begin(),pair_of_ints(100,-1));
+    g.insert(g.end(),pair_of_ints(101,10));
+    m.reverse();
+    test_serialization(m);
+  }
 }
@@ -12,9 +12,12 @@
 
 #include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
 #include <algorithm>
+#include <functional>
+#include <iterator>
 #include <vector>
 #include "pre_multi_index.hpp"
 #include "employee.hpp"
+#include "pair_of_ints.hpp"
 #include <boost/detail/lightweight_test.hpp>
 
 using namespace boost::multi_index;
@@ -54,6 +57,319 @@ struct eq_type12
   bool operator()(type2,type1)const{return true;}
 };
 
+template<typename Index>
+static void test_cursor(Index& i,const std::vector<int>& v)
+{
+  typedef typename Index::iterator iterator;
+
+  /* v holds the keys of i in ascending order */
+
+  typename Index::cursor c=i.make_cursor();
+  BOOST_TEST(c.get()==i.begin());
+
+  bool ok=true;
+  for(int k=-2;k<=v.back()+2;++k){
+    if(c.seek(k)!=i.lower_bound(k))ok=false;
+  }
+  for(int k=v.back()+2;k>=-2;--k){
+    if(c.seek(k)!=i.lower_bound(k))ok=false;
+  }
+  unsigned int n=1;
+  for(int j=0;j<1000;++j){
+    n=n*1103515245u+12345u;
+    int k=(int)((n>>8)%(unsigned int)(v.back()+4))-2;
+    if(c.seek(k)!=i.lower_bound(k)||c.get()!=i.lower_bound(k))ok=false;
+  }
+  BOOST_TEST(ok);
+
+  c=i.make_cursor(i.end());
+  BOOST_TEST(c.seek(v.back()+1)==i.end());
+  BOOST_TEST(c.seek(v.front(),std::less<int>())==i.begin());
+
+  std::vector<int>      keys;
+  std::vector<iterator> res;
+  for(int k=-1;k<=v.back()+1;k+=3)keys.push_back(k);
+  i.lower_bound_many(keys.begin(),keys.end(),std::back_inserter(res));
+  BOOST_TEST(res.size()==keys.size());
+  for(std::size_t j=0;j<keys.size();++j){
+    BOOST_TEST(res[j]==i.lower_bound(keys[j]));
+  }
+}
+
+template<typename Index>
+static void test_batch(const Index& i,const std::vector<int>& v)
+{
+  typedef typename Index::iterator iterator;
+
+  /* more keys than searched at a time, in no particular order */
+
+  std::vector<int> keys;
+  unsigned int     n=1;
+  for(int j=0;j<1000;++j){
+    n=n*1103515245u+12345u;
+    keys.push_back((int)((n>>8)%(unsigned int)(v.back()+4))-2);
+  }
+
+  std::vector<iterator> res1,res2;
+  i.find_batch(keys.begin(),keys.end(),std::back_inserter(res1));
+  i.lower_bound_batch(
+    keys.begin(),keys.end(),std::back_inserter(res2),std::less<int>());
+  BOOST_TEST(res1.size()==keys.size()&&res2.size()==keys.size());
+  bool ok=true;
+  for(std::size_t j=0;j<keys.size();++j){
+    if(res1[j]!=i.find(keys[j])||res2[j]!=i.lower_bound(keys[j]))ok=false;
+  }
+  BOOST_TEST(ok);
+}
+
+static void increment_age(employee& e){++e.age;}
+
+template<typename Index>
+static void check_frozen_lookups(const Index& i,int first,int last)
+{
+  /* compares against the lookups of the unfrozen index */
+
+  Index& ii=const_cast<Index&>(i);
+  std::vector<typename Index::iterator> res;
+  ii.unfreeze();
+  for(int k=first;k!=last;++k){
+    res.push_back(i.find(k));
+    res.push_back(i.lower_bound(k));
+    res.push_back(i.upper_bound(k));
+  }
+  ii.freeze();
+  BOOST_TEST(i.frozen());
+
+  bool ok=true;
+  for(int k=first,j=0;k!=last;++k,j+=3){
+    if(i.find(k)!=res[j])ok=false;
+    if(i.lower_bound(k)!=res[j+1])ok=false;
+    if(i.upper_bound(k)!=res[j+2])ok=false;
+    if(i.lower_bound(k,std::less<int>())!=res[j+1])ok=false;
+    if(i.equal_range(k)!=std::make_pair(res[j+1],res[j+2]))ok=false;
+    if(i.count(k)!=(std::size_t)std::distance(res[j+1],res[j+2]))ok=false;
+  }
+  BOOST_TEST(ok);
+
+  std::vector<int>                      keys;
+  std::vector<typename Index::iterator> res2;
+  for(int k=first;k!=last;++k)keys.push_back(k);
+  i.find_batch(keys.begin(),keys.end(),std::back_inserter(res2));
+  i.lower_bound_batch(keys.begin(),keys.end(),std::back_inserter(res2));
+  ok=res2.size()==2*keys.size();
+  for(std::size_t j=0;ok&&j<keys.size();++j){
+    if(res2[j]!=res[3*j]||res2[keys.size()+j]!=res[3*j+1])ok=false;
+  }
+  BOOST_TEST(ok);
+}
+
+template<typename Container>
+static void test_freeze()
+{
+  Container c;
+  BOOST_TEST(!c.frozen());
+  c.freeze();
+  BOOST_TEST(c.frozen());
+  BOOST_TEST(c.find(0)==c.end());
+  BOOST_TEST(c.lower_bound(0)==c.end());
+
+  for(int n=1;n<=100;++n){
+    for(int j=0;j<n;++j)c.insert((j*7919)%n*2);
+    check_frozen_lookups(c,-2,2*n+2);
+    BOOST_TEST(c.frozen());
+    c.clear();
+    BOOST_TEST(!c.frozen());
+  }
+
+  for(int j=0;j<1000;++j)c.insert(j/2);
+  c.freeze();
+  c.insert(1000);
+  BOOST_TEST(!c.frozen());
+  c.freeze();
+  c.erase(3);
+  BOOST_TEST(!c.frozen());
+  c.freeze();
+  c.modify(c.begin(),increment_int);
+  BOOST_TEST(!c.frozen());
+  c.freeze();
+  c.replace(c.find(1000),1001);
+  BOOST_TEST(!c.frozen());
+  check_frozen_lookups(c,-2,1003);
+
+  Container c2(c);
+  BOOST_TEST(!c2.frozen());
+  c.swap(c2);
+  BOOST_TEST(!c.frozen()&&c2.frozen());
+  check_frozen_lookups(c2,-2,1003);
+  c2.unfreeze();
+  BOOST_TEST(!c2.frozen());
+}
+
+/* comparison throwing after a given number of calls */
+
+struct throwing_less
+{
+  static int countdown;
+
+  bool operator()(int x,int y)const
+  {
+    if(countdown>=0&&countdown--==0)throw int(0);
+    return x<y;
+  }
+};
+
+int throwing_less::countdown=-1;
+
+template<typename Container>
+static void fill_join_test(
+  Container& c,std::vector<int>& v,bool unique,int n,int step,int offset)
+{
+  for(int j=0;j<n;++j){
+    int x=(j*step+offset)%(n*3); /* repeated if gcd(step,n*3)>3 */
+    c.insert(x);
+    v.push_back(x);
+  }
+  std::sort(v.begin(),v.end());
+  if(unique)v.erase(std::unique(v.begin(),v.end()),v.end());
+}
+
+template<typename Container>
+static void test_join_ops(bool unique,int n0,int n1,int step)
+{
+  typedef std::vector<int> vector;
+
+  Container c0,c1;
+  vector    v0,v1,res;
+
+  fill_join_test(c0,v0,unique,n0,7,0);
+  fill_join_test(c1,v1,unique,n1,step,n0);
+  BOOST_TEST(c0.size()==v0.size()&&c1.size()==v1.size());
+
+  Container c2(c0),c3(c1);
+  c2.set_union(c3);
+  res.clear();
+  if(unique){
+    std::set_union(
+      v0.begin(),v0.end(),v1.begin(),v1.end(),std::back_inserter(res));
+  }
+  else{
+    std::merge(
+      v0.begin(),v0.end(),v1.begin(),v1.end(),std::back_inserter(res));
+  }
+  BOOST_TEST(c2.size()==res.size());
+  BOOST_TEST(std::equal(c2.begin(),c2.end(),res.begin()));
+  res.clear();
+  if(unique){
+    std::set_intersection(
+      v0.begin(),v0.end(),v1.begin(),v1.end(),std::back_inserter(res));
+  }
+  BOOST_TEST(c3.size()==res.size());
+  BOOST_TEST(std::equal(c3.begin(),c3.end(),res.begin()));
+
+  c2=c0;
+  c2.set_intersection(c1);
+  res.clear();
+  for(vector::iterator it=v0.begin();it!=v0.end();++it){
+    if(std::binary_search(v1.begin(),v1.end(),*it))res.push_back(*it);
+  }
+  BOOST_TEST(c2.size()==res.size());
+  BOOST_TEST(std::equal(c2.begin(),c2.end(),res.begin()));
+  BOOST_TEST(c1.size()==v1.size());
+
+  c2=c0;
+  c2.set_difference(c1);
+  res.clear();
+  for(vector::iterator it=v0.begin();it!=v0.end();++it){
+    if(!std::binary_search(v1.begin(),v1.end(),*it))res.push_back(*it);
+  }
+  BOOST_TEST(c2.size()==res.size());
+  BOOST_TEST(std::equal(c2.begin(),c2.end(),res.begin()));
+
+  for(int k=-1;k<=n1*3;k+=1+n1/7){
+    c2=c1;
+    c3.clear();
+    c2.split(k,c3);
+    vector::iterator it=std::lower_bound(v1.begin(),v1.end(),k);
+    BOOST_TEST(c2.size()==static_cast<std::size_t>(it-v1.begin()));
+    BOOST_TEST(std::equal(c2.begin(),c2.end(),v1.begin()));
+    BOOST_TEST(c3.size()==static_cast<std::size_t>(v1.end()-it));
+    BOOST_TEST(std::equal(c3.begin(),c3.end(),it));
+  }
+}
+
+template<typename Container>
+static void test_join_ops(bool unique)
+{
+  test_join_ops<Container>(unique,0,0,1);
+  test_join_ops<Container>(unique,0,100,1);
+  test_join_ops<Container>(unique,100,0,1);
+  test_join_ops<Container>(unique,1,1000,3);
+  test_join_ops<Container>(unique,1000,1,3);
+  test_join_ops<Container>(unique,10,1000,5);
+  test_join_ops<Container>(unique,1000,10,5);
+  test_join_ops<Container>(unique,500,700,2);
+  test_join_ops<Container>(unique,500,700,3);
+  test_join_ops<Container>(unique,600,700,6); /* repeated values */
+
+  Container c0,c1,c2;
+  for(int i=0;i<100;++i){
+    c0.insert(i*2);
+    c1.insert(i*3);
+  }
+  typename Container::iterator it=c0.find(98);
+  c0.set_difference(c1);
+  BOOST_TEST(*it==98&&c0.size()==66);
+  c0.set_union(c1);
+  BOOST_TEST(*it==98&&c0.size()==166&&c1.empty());
+  c0.set_union(c0);
+  c0.set_intersection(c0);
+  BOOST_TEST(c0.size()==166);
+  c0.split(100,c0);
+  BOOST_TEST(c0.size()==166);
+  c0.split(-1,c2);
+  BOOST_TEST(c0.empty()&&c2.size()==166);
+  c2.set_difference(c2);
+  BOOST_TEST(c2.empty());
+}
+
+template<typename Container>
+static void test_throwing_join_ops()
+{
+  for(int n=20;n<=200;n+=180){
+    for(int i=0;i<4;++i){
+      for(int j=0;;j+=37){
+        Container c0,c1,c2;
+        for(int k=0;k<200;++k)c0.insert(k*2);
+        for(int k=0;k<n;++k)c1.insert(k*3);
+        bool thrown=false;
+        throwing_less::countdown=j;
+        try{
+          switch(i){
+            case 0: c0.set_union(c1);break;
+            case 1: c0.set_intersection(c1);break;
+            case 2: c0.set_difference(c1);break;
+            default: c0.split(200,c2);break;
+          }
+        }
+        catch(int){
+          thrown=true;
+        }
+        throwing_less::countdown=-1;
+        if(!thrown)break;
+        BOOST_TEST(
+          c0.size()==
+          static_cast<std::size_t>(std::distance(c0.begin(),c0.end())));
+        BOOST_TEST(
+          c1.size()==
+          static_cast<std::size_t>(std::distance(c1.begin(),c1.end())));
+        BOOST_TEST(i!=0||(c0.empty()&&c1.empty()));
+        BOOST_TEST(i==0||c1.size()==static_cast<std::size_t>(n));
+        BOOST_TEST(c2.empty());
+      }
+    }
+  }
+}
+
 void test_set_ops()
 {
   employee_set               es;
@@ -124,4 +440,99 @@ void test_set_ops()
   c2.insert(type1());
 
   BOOST_TEST(c2.find(type3())==c2.begin());
+
+  /* finger search */
+
+  multi_index_container<
+    int,
+    indexed_by<
+      ordered_unique<identity<int> >,
+      ranked_non_unique<identity<int> >
+    >
+  >                c3;
+  std::vector<int> v;
+
+  BOOST_TEST(c3.make_cursor().seek(0)==c3.end());
+  for(int j=0;j<1000;++j){
+    c3.insert((j*7919)%1000*3); /* out of order for a less regular tree */
+    v.push_back(j*3);
+  }
+  test_cursor(c3,v);
+  test_cursor(c3.get<1>(),v);
+
+  /* batched lookup */
+
+  multi_index_container<int>                        c4;
+  std::vector<int>                                  keys(3,0);
+  std::vector<multi_index_container<int>::iterator> res;
+  c4.find_batch(keys.begin(),keys.end(),std::back_inserter(res));
+  BOOST_TEST(res.size()==3&&res[2]==c4.end());
+  test_batch(c3,v);
+  test_batch(c3.get<1>(),v);
+
+  /* join-based set operations */
+
+  test_join_ops<
+    multi_index_container<int,indexed_by<ordered_unique<identity<int> > > >
+  >(true);
+  test_join_ops<
+    multi_index_container<
+      int,indexed_by<ordered_non_unique<identity<int> > > >
+  >(false);
+  test_join_ops<
+    multi_index_container<int,indexed_by<ranked_unique<identity<int> > > >
+  >(true);
+  test_join_ops<
+    multi_index_container<
+      int,indexed_by<ranked_non_unique<identity<int> > > >
+  >(false);
+  test_throwing_join_ops<
+    multi_index_container<
+      int,indexed_by<ordered_unique<identity<int>,throwing_less> > >
+  >();
+  test_throwing_join_ops<
+    multi_index_container<
+      int,indexed_by<ranked_non_unique<identity<int>,throwing_less> > >
+  >();
+
+  /* frozen lookups */
+
+  test_freeze<
+    multi_index_container<int,indexed_by<ordered_unique<identity<int> > > >
+  >();
+  test_freeze<
+    multi_index_container<
+      int,indexed_by<ranked_non_unique<identity<int> > > >
+  >();
+
+  typedef multi_index_container<
+    employee,
+    indexed_by<
+      ordered_non_unique<
+        tag<name>,BOOST_MULTI_INDEX_MEMBER(employee,std::string,name)>,
+      ranked_non_unique<
+        tag<age>,BOOST_MULTI_INDEX_MEMBER(employee,int,age)>
+    >
+  >                       frozen_employee_set;
+  frozen_employee_set     fes;
+
+  fes.insert(employee(0,"Joe",31,1123));
+  fes.insert(employee(1,"Robert",27,5601));
+  fes.insert(employee(2,"John",40,7889));
+  fes.insert(employee(3,"Albert",20,9012));
+  fes.insert(employee(4,"John",57,1002));
+  fes.get<name>().freeze();
+  fes.get<age>().freeze();
+  BOOST_TEST(fes.get<name>().count("John")==2);
+  BOOST_TEST(fes.get<name>().find(std::string("Joe"))->id==0);
+  BOOST_TEST(fes.get<name>().lower_bound("K")->name=="Robert");
+  BOOST_TEST(fes.get<name>().upper_bound("Robert")==fes.get<name>().end());
+  BOOST_TEST(fes.get<age>().find(27)->id==1);
+  BOOST_TEST(fes.get<age>().rank(fes.get<age>().lower_bound(40))==3);
+  fes.modify(fes.get<name>().find("Albert"),increment_age);
+  BOOST_TEST(!fes.get<name>().frozen()&&!fes.get<age>().frozen());
+  fes.get<name>().freeze();
+  fes.get<age>().erase(fes.get<age>().begin());
+  BOOST_TEST(!fes.get<name>().frozen());
+  BOOST_TEST(fes.get<name>().find("Albert")==fes.get<name>().end());
 }
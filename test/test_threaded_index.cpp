@@ -0,0 +1,270 @@
+/* Boost.MultiIndex test for threaded ordered indices.
+ *
+ * Copyright 2003-2021 Joaquin M Lopez Munoz.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * See http://www.boost.org/libs/multi_index for library home page.
+ */
+
+#include "test_threaded_index.hpp"
+
+#include <boost/config.hpp> /* keep it first to prevent nasty warns in MSVC */
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+#include <boost/detail/lightweight_test.hpp>
+#include <boost/move/utility_core.hpp>
+#include "pre_multi_index.hpp"
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/identity.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/ordered_threaded_index.hpp>
+
+using namespace boost::multi_index;
+
+struct element
+{
+  element(int id_,int x_):id(id_),x(x_){}
+
+  int id;
+  int x;
+};
+
+struct set_x
+{
+  set_x(int x_):x(x_){}
+  void operator()(element& e)const{e.x=x;}
+  int x;
+};
+
+struct by_id{};
+struct by_x{};
+
+typedef multi_index_container<
+  element,
+  indexed_by<
+    ordered_threaded_unique<tag<by_id>,member<element,int,&element::id> >,
+    ordered_threaded_non_unique<tag<by_x>,member<element,int,&element::x> >,
+    ordered_non_unique<member<element,int,&element::x> >
+  >
+> element_set;
+
+typedef multi_index_container<
+  int,
+  indexed_by<ordered_threaded_unique<identity<int> > >
+> int_set;
+
+typedef multi_index_container<
+  int,
+  indexed_by<ordered_threaded_non_unique<identity<int> > >
+> int_multiset;
+
+/* threaded and plain iteration must visit the same elements in the same
+ * order, both ways
+ */
+
+static bool same_order(const element_set& s)
+{
+  const element_set::index<by_x>::type& tx=s.get<by_x>();
+  const element_set::nth_index<2>::type& px=s.get<2>();
+
+  element_set::index<by_x>::type::const_iterator it=tx.begin();
+  element_set::nth_index<2>::type::const_iterator pit=px.begin();
+  for(;it!=tx.end();++it,++pit){
+    if(pit==px.end()||it->x!=pit->x)return false;
+  }
+  if(pit!=px.end())return false;
+
+  /* equivalent elements may come in different order in both indices */
+
+  std::vector<int> v,pv;
+  while(it!=tx.begin()){
+    --it;
+    --pit;
+    v.push_back(it->x);
+    pv.push_back(pit->x);
+  }
+  if(v!=pv||pit!=px.begin())return false;
+
+  std::vector<int> ids;
+  for(element_set::const_iterator it2=s.begin();it2!=s.end();++it2){
+    ids.push_back(it2->id);
+  }
+  for(std::size_t n=1;n<ids.size();++n){
+    if(ids[n]<=ids[n-1])return false;
+  }
+  if(ids.size()!=s.size())return false;
+  return true;
+}
+
+template<typename Container>
+static std::vector<int> forward(const Container& c)
+{
+  return std::vector<int>(c.begin(),c.end());
+}
+
+template<typename Container>
+static std::vector<int> backward(const Container& c)
+{
+  std::vector<int> res(c.rbegin(),c.rend());
+  std::reverse(res.begin(),res.end());
+  return res;
+}
+
+template<typename Container>
+static bool check(const Container& c,std::vector<int> v)
+{
+  std::sort(v.begin(),v.end());
+  return forward(c)==v&&backward(c)==v;
+}
+
+void test_threaded_index()
+{
+  element_set s;
+  BOOST_TEST(s.begin()==s.end()&&same_order(s));
+
+  std::srand(1);
+  for(int i=0;i<500;++i){
+    s.insert(element(std::rand()%1000,std::rand()%100));
+    if(i%50==0)BOOST_TEST(same_order(s));
+  }
+  BOOST_TEST(same_order(s));
+
+  element_set::index<by_x>::type& xs=s.get<by_x>();
+  for(int i=0;i<200;++i){
+    element_set::iterator it=s.find(std::rand()%1000);
+    if(it==s.end())continue;
+    switch(i%4){
+      case 0: s.modify(it,set_x(std::rand()%100));break;
+      case 1: s.replace(it,element(std::rand()%1000,it->x));break;
+      case 2: xs.modify(s.project<by_x>(it),set_x(std::rand()%100));break;
+      default: s.erase(it);
+    }
+    if(i%20==0)BOOST_TEST(same_order(s));
+  }
+  BOOST_TEST(same_order(s));
+
+  xs.erase(xs.lower_bound(20),xs.upper_bound(40));
+  BOOST_TEST(same_order(s));
+  BOOST_TEST(xs.lower_bound(20)==xs.upper_bound(40));
+
+  element_set s2(s);
+  BOOST_TEST(same_order(s2)&&s2.size()==s.size());
+  s2.insert(element(-1,50));
+  s2.swap(s);
+  BOOST_TEST(same_order(s)&&same_order(s2));
+  BOOST_TEST(s.begin()->id==-1&&s2.begin()->id!=-1);
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+  element_set s3(boost::move(s2));
+  BOOST_TEST(same_order(s3)&&same_order(s2)&&s2.empty());
+  s2=boost::move(s3);
+  BOOST_TEST(same_order(s3)&&same_order(s2));
+#endif
+
+  if(!s.empty()){
+    int                id=s.begin()->id;
+    element_set::node_type nh=s.extract(s.begin());
+    BOOST_TEST(same_order(s)&&s.count(id)==0);
+    nh.value().id=100000;
+    BOOST_TEST(s.insert(boost::move(nh)).inserted);
+    BOOST_TEST(same_order(s)&&(--s.end())->id==100000);
+  }
+
+  s.clear();
+  BOOST_TEST(same_order(s)&&s.begin()==s.end());
+  s.insert(element(0,0));
+  BOOST_TEST(same_order(s)&&s.size()==1);
+
+  /* sorted ranges are appended and then rebalanced */
+
+  std::vector<int> v;
+  for(int i=0;i<1000;++i)v.push_back(i*2);
+  int_set is(v.begin(),v.end());
+  BOOST_TEST(check(is,v));
+  BOOST_TEST(*--is.end()==1998&&*--is.upper_bound(1001)==1000);
+
+  /* join-based set operations rebuild the threads */
+
+  int_set is2;
+  std::vector<int> v2;
+  for(int i=0;i<1000;++i){
+    int n=std::rand()%3000;
+    if(is2.insert(n).second)v2.push_back(n);
+  }
+  int_set is3(is2);
+  std::vector<int> v3(v2);
+
+  {
+    int_set x(is);
+    is2.set_union(x);
+    std::vector<int> u;
+    std::sort(v2.begin(),v2.end());
+    std::set_union(v2.begin(),v2.end(),v.begin(),v.end(),
+      std::back_inserter(u));
+    BOOST_TEST(check(is2,u));
+    std::vector<int> d;
+    std::set_intersection(v.begin(),v.end(),v2.begin(),v2.end(),
+      std::back_inserter(d));
+    BOOST_TEST(check(x,d));
+  }
+  {
+    int_set x(is3),y(is3);
+    x.set_intersection(is);
+    y.set_difference(is);
+    std::vector<int> i,d;
+    std::sort(v3.begin(),v3.end());
+    std::set_intersection(v3.begin(),v3.end(),v.begin(),v.end(),
+      std::back_inserter(i));
+    std::set_difference(v3.begin(),v3.end(),v.begin(),v.end(),
+      std::back_inserter(d));
+    BOOST_TEST(check(x,i));
+    BOOST_TEST(check(y,d));
+
+    int_set z;
+    x.split(1000,z);
+    BOOST_TEST(x.empty()||*--x.end()<1000);
+    BOOST_TEST(z.empty()||*z.begin()>=1000);
+    x.set_union(z);
+    BOOST_TEST(check(x,i)&&check(z,std::vector<int>()));
+  }
+
+  /* small unions link nodes one by one */
+
+  {
+    int_set x;
+    x.insert(-5);
+    x.insert(7);
+    x.insert(5000);
+    std::vector<int> u=forward(is);
+    u.push_back(-5);
+    u.push_back(7);
+    u.push_back(5000);
+    is.set_union(x);
+    BOOST_TEST(check(is,u));
+    BOOST_TEST(x.size()==0);
+  }
+
+  int_multiset ms;
+  std::vector<int> mv;
+  for(int i=0;i<2000;++i){
+    int n=std::rand()%100;
+    ms.insert(n);
+    mv.push_back(n);
+  }
+  BOOST_TEST(check(ms,mv));
+  BOOST_TEST(ms.erase(50)==(std::size_t)std::count(mv.begin(),mv.end(),50));
+  mv.erase(std::remove(mv.begin(),mv.end(),50),mv.end());
+  BOOST_TEST(check(ms,mv));
+  {
+    int_multiset x(ms);
+    ms.set_difference(x);
+    BOOST_TEST(ms.empty()&&check(ms,std::vector<int>()));
+    ms.set_union(x);
+    BOOST_TEST(check(ms,mv)&&x.empty());
+  }
+}